@@ -0,0 +1,22 @@
+/*
+ * Animation clock implementation.
+ */
+
+#include "anim_clock.h"
+#include "esp_timer.h"
+
+int64_t anim_clock_us(void) {
+    return esp_timer_get_time();
+}
+
+uint32_t anim_clock_ms(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+uint16_t anim_clock_phase(uint32_t period_ms) {
+    if (period_ms == 0) return 0;
+    /* Work in µs so short periods still have 16-bit resolution */
+    uint64_t period_us = (uint64_t)period_ms * 1000u;
+    uint64_t pos = (uint64_t)esp_timer_get_time() % period_us;
+    return (uint16_t)((pos << 16) / period_us);
+}
@@ -0,0 +1,33 @@
+/*
+ * Animation clock – shared timebase for LED and display animations.
+ *
+ * Animations compute their phase from absolute time instead of counting
+ * frames, so a late or dropped frame never changes their speed, and two
+ * animations with the same period (e.g. an LED pulse and an on-screen
+ * indicator) stay in step across tasks.
+ *
+ * Backed by esp_timer (µs since boot); callable from any task or ISR.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief  Microseconds since boot.
+ */
+int64_t anim_clock_us(void);
+
+/**
+ * @brief  Milliseconds since boot (wraps after ~49 days; use unsigned
+ *         subtraction for intervals).
+ */
+uint32_t anim_clock_ms(void);
+
+/**
+ * @brief  Position of "now" inside a repeating period as a 16-bit binary
+ *         angle (0..65535 = one full cycle, compatible with fixpt_sin()).
+ *
+ * @param  period_ms  Cycle length; 0 returns 0.
+ */
+uint16_t anim_clock_phase(uint32_t period_ms);
@@ -0,0 +1,210 @@
+/*
+ * App registry implementation.
+ *
+ * Requests are two atomics (current app, pause) written by any task; the
+ * display task is the only one that runs lifecycle callbacks and keeps
+ * the running app and the heap samples.  It also publishes the app whose
+ * init has completed, so input_task never calls on_input on an app that
+ * has not been initialised yet.  Statistics are shared and taken under a
+ * spinlock.
+ */
+
+#include "app_registry.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+
+#define TAG "app_registry"
+
+static const app_desc_t *s_apps[APP_REGISTRY_MAX_APPS];
+static app_stats_t       s_stats[APP_REGISTRY_MAX_APPS];
+static portMUX_TYPE      s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Requests: slot 0 is current at boot */
+static atomic_int  s_current;
+static atomic_bool s_pause_req;
+static uint8_t     s_home;
+
+/* App whose init has run and whose exit has not started (read by input) */
+static atomic_int  s_ready = APP_REGISTRY_NONE;
+
+/* Display task only */
+static uint8_t  s_running = APP_REGISTRY_NONE;
+static bool     s_paused;
+static uint32_t s_heap_enter;       /* Free heap when the running app was entered */
+static uint32_t s_heap_min;         /* Lowest free heap since */
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static const app_desc_t *app_at(uint8_t id) {
+    return id < APP_REGISTRY_MAX_APPS ? s_apps[id] : NULL;
+}
+
+static uint32_t heap_free(void) {
+    return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+/* Exit the running app and report its heap use */
+static void leave(void) {
+    const app_desc_t *app = app_at(s_running);
+    uint8_t id = s_running;
+    atomic_store(&s_ready, APP_REGISTRY_NONE);
+    s_running = APP_REGISTRY_NONE;
+    s_paused = false;
+    if (!app) return;
+
+    if (app->exit) app->exit();     /* Also after suspend: no resume first */
+
+    uint32_t now  = heap_free();
+    uint32_t peak = s_heap_enter > s_heap_min ? s_heap_enter - s_heap_min : 0;
+    uint32_t kept = s_heap_enter > now ? s_heap_enter - now : 0;
+    bool over = peak > app->heap_bytes + APP_REGISTRY_HEAP_SLACK;
+
+    portENTER_CRITICAL(&s_lock);
+    if (peak > s_stats[id].heap_peak) s_stats[id].heap_peak = peak;
+    if (over) s_stats[id].heap_over++;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (over) {
+        ESP_LOGW(TAG, "%s: heap peak %lu B over its %lu B budget, %lu B kept",
+                 app->name, (unsigned long)peak, (unsigned long)app->heap_bytes,
+                 (unsigned long)kept);
+    } else {
+        ESP_LOGI(TAG, "%s: heap peak %lu B (budget %lu B), %lu B kept",
+                 app->name, (unsigned long)peak, (unsigned long)app->heap_bytes,
+                 (unsigned long)kept);
+    }
+}
+
+static void enter(uint8_t id) {
+    s_running = id;
+    s_paused = false;
+    s_heap_enter = s_heap_min = heap_free();
+
+    const app_desc_t *app = app_at(id);
+    if (app && app->init) app->init();
+    atomic_store(&s_ready, id);
+}
+
+/* ── Setup ──────────────────────────────────────────────────────────────── */
+void app_registry_register(uint8_t id, const app_desc_t *app) {
+    if (id >= APP_REGISTRY_MAX_APPS) return;
+    s_apps[id] = app;
+    frame_pacer_configure(id, &app->frame);
+}
+
+void app_registry_set_home(uint8_t id) {
+    s_home = id;
+}
+
+const app_desc_t *app_registry_get(uint8_t id) {
+    return app_at(id);
+}
+
+/* ── Requests ───────────────────────────────────────────────────────────── */
+bool app_registry_start(uint8_t id) {
+    if (id >= APP_REGISTRY_MAX_APPS) return false;
+
+    const app_desc_t *app = s_apps[id];
+    if (app && app->heap_bytes) {
+        uint32_t avail = heap_free();
+        if (avail < app->heap_bytes + APP_REGISTRY_HEAP_RESERVE) {
+            portENTER_CRITICAL(&s_lock);
+            s_stats[id].refused++;
+            portEXIT_CRITICAL(&s_lock);
+            ESP_LOGW(TAG, "Not starting %s: needs %lu B, %lu B free",
+                     app->name, (unsigned long)app->heap_bytes, (unsigned long)avail);
+            return false;
+        }
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats[id].starts++;
+    portEXIT_CRITICAL(&s_lock);
+    atomic_store(&s_pause_req, false);
+    atomic_store(&s_current, id);
+    return true;
+}
+
+void app_registry_exit(void) {
+    app_registry_start(s_home);
+}
+
+void app_registry_pause(bool paused) {
+    atomic_store(&s_pause_req, paused);
+}
+
+uint8_t app_registry_current(void) {
+    return (uint8_t)atomic_load(&s_current);
+}
+
+bool app_registry_paused(void) {
+    return atomic_load(&s_pause_req);
+}
+
+bool app_registry_input(const btn_event_t *ev) {
+    uint8_t id = app_registry_current();
+    const app_desc_t *app = app_at(id);
+    if (!app || !app->on_input) return false;
+    /* Started but not initialised yet: its state is the last run's */
+    if (atomic_load(&s_ready) == id) app->on_input(ev);
+    return true;
+}
+
+/* ── Display task ───────────────────────────────────────────────────────── */
+uint8_t app_registry_sync(void) {
+    uint8_t want = app_registry_current();
+    if (want != s_running) {
+        leave();
+        enter(want);
+    }
+
+    const app_desc_t *app = app_at(s_running);
+    bool pause = atomic_load(&s_pause_req);
+    if (app && pause != s_paused) {
+        s_paused = pause;
+        if (pause && app->suspend) app->suspend();
+        if (!pause && app->resume) app->resume();
+    }
+
+    uint32_t free_now = heap_free();
+    if (free_now < s_heap_min) s_heap_min = free_now;
+    return s_running;
+}
+
+uint8_t app_registry_running(void) {
+    return s_running;
+}
+
+bool app_registry_has_frames(void) {
+    const app_desc_t *app = app_at(s_running);
+    return app && (app->update || app->render);
+}
+
+bool app_registry_frame(void) {
+    const app_desc_t *app = app_at(s_running);
+    if (!app || s_paused) return false;
+    if (app->update) app->update();
+    return app->render ? app->render() : false;
+}
+
+/* ── Reports ────────────────────────────────────────────────────────────── */
+bool app_registry_get_stats(uint8_t id, app_stats_t *out) {
+    if (id >= APP_REGISTRY_MAX_APPS) return false;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats[id];
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+void app_registry_log_stats(void) {
+    for (uint8_t id = 0; id < APP_REGISTRY_MAX_APPS; id++) {
+        const app_desc_t *app = s_apps[id];
+        app_stats_t st;
+        if (!app || !app_registry_get_stats(id, &st) || !(st.starts || st.refused)) continue;
+        ESP_LOGI(TAG, "%-16s %3lu starts, %lu refused, heap peak %6lu B / %6lu B budget, %lu over",
+                 app->name, (unsigned long)st.starts, (unsigned long)st.refused,
+                 (unsigned long)st.heap_peak, (unsigned long)app->heap_bytes,
+                 (unsigned long)st.heap_over);
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ * App registry – one lifecycle for every screen of the badge.
+ *
+ * Each app is a descriptor in a slot (main.c uses the app_state_t value,
+ * the same slot frame_pacer and latency_trace use): its frame-rate policy,
+ * the heap it needs while it runs and a table of lifecycle callbacks.
+ *
+ *   init      entered: allocate and reset                  (display task)
+ *   update    once per frame while running: advance state  (display task)
+ *   render    draw the frame, true if the panel changed    (display task)
+ *   on_input  every button event once init has run         (input_task)
+ *   suspend   paused: no frames until resumed              (display task)
+ *   resume    unpaused                                     (display task)
+ *   exit      left: free what init allocated               (display task)
+ *
+ * Every callback is optional.  Any task asks for a switch with
+ * app_registry_start(); it only records the request, after checking that
+ * the heap can hold the app's budget.  The display task applies it on its
+ * next app_registry_sync(): the running app exits and the new one is
+ * initialised there, so init/update/render/exit never race each other.
+ *
+ * Heap use is sampled on every sync.  When an app exits, its peak use
+ * (free heap at init minus the lowest free heap seen while it ran) and
+ * the bytes it left allocated are logged, with a warning when the peak
+ * exceeds its budget.  Other tasks allocate too, so the figures are an
+ * upper bound.
+ *
+ * Apps without update/render (update and render both NULL) are drawn by
+ * the caller; the registry still handles their policy, budget and
+ * init/exit.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "frame_pacer.h"
+#include "buttons.h"
+
+#define APP_REGISTRY_MAX_APPS        FRAME_PACER_MAX_SCREENS
+#define APP_REGISTRY_NONE            0xFF
+
+/* Free heap kept for the system when an app with a budget starts */
+#define APP_REGISTRY_HEAP_RESERVE    (16 * 1024)
+/* Peak use above budget + slack is reported (other tasks allocate too) */
+#define APP_REGISTRY_HEAP_SLACK      (4 * 1024)
+
+typedef struct {
+    const char        *name;
+    frame_pacer_cfg_t  frame;           /* Frame-rate policy */
+    uint32_t           heap_bytes;      /* Heap needed while running (0 = none) */
+
+    void (*init)(void);
+    void (*update)(void);
+    bool (*render)(void);
+    void (*on_input)(const btn_event_t *ev);
+    void (*suspend)(void);
+    void (*resume)(void);
+    void (*exit)(void);
+
+    const void        *ctx;             /* Owner's data, e.g. per-game hooks (may be NULL) */
+} app_desc_t;
+
+typedef struct {
+    uint32_t starts;
+    uint32_t refused;           /* Starts refused for lack of heap */
+    uint32_t heap_peak;         /* Highest peak use of any run, bytes */
+    uint32_t heap_over;         /* Runs whose peak exceeded the budget */
+} app_stats_t;
+
+/* ── Setup ──────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Register @p app in slot @p id and configure its frame pacer slot.
+ *         @p app must stay valid (static const).
+ */
+void app_registry_register(uint8_t id, const app_desc_t *app);
+
+/**
+ * @brief  App that app_registry_exit() returns to (the menu).
+ */
+void app_registry_set_home(uint8_t id);
+
+/**
+ * @brief  Descriptor in slot @p id, NULL if none.
+ */
+const app_desc_t *app_registry_get(uint8_t id);
+
+/* ── Requests (any task) ────────────────────────────────────────────────── */
+
+/**
+ * @brief  Make @p id the current app.
+ * @return false if its heap budget does not fit in the free heap (the
+ *         current app is kept).
+ */
+bool app_registry_start(uint8_t id);
+
+/**
+ * @brief  Return to the home app.
+ */
+void app_registry_exit(void);
+
+/**
+ * @brief  Pause (suspend) or resume the current app.
+ */
+void app_registry_pause(bool paused);
+
+/**
+ * @brief  Current app: the last one started (the display task may not
+ *         have switched to it yet).
+ */
+uint8_t app_registry_current(void);
+
+/**
+ * @brief  True if the current app is paused.
+ */
+bool app_registry_paused(void);
+
+/**
+ * @brief  Pass a button event to the current app's on_input.  Events
+ *         that arrive before the display task has run its init (between
+ *         app_registry_start() and the next sync) are dropped.
+ * @return false if the current app has no on_input (caller handles it).
+ */
+bool app_registry_input(const btn_event_t *ev);
+
+/* ── Display task ───────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Apply pending requests (exit / init, suspend / resume) and
+ *         sample the heap.  Call at the top of every display loop.
+ * @return The running app.
+ */
+uint8_t app_registry_sync(void);
+
+/**
+ * @brief  App whose init has run and whose exit has not (display task view).
+ */
+uint8_t app_registry_running(void);
+
+/**
+ * @brief  True if the running app draws through update/render.
+ */
+bool app_registry_has_frames(void);
+
+/**
+ * @brief  One frame of the running app: update, then render, unless it is
+ *         paused.
+ * @return true if the panel changed.
+ */
+bool app_registry_frame(void);
+
+/* ── Reports ────────────────────────────────────────────────────────────── */
+
+bool app_registry_get_stats(uint8_t id, app_stats_t *out);
+
+/**
+ * @brief  Log starts, refusals and heap use of every registered app.
+ */
+void app_registry_log_stats(void);
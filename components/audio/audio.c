@@ -3,11 +3,12 @@
  */
 
 #include "audio.h"
+#include "audio_fft.h"
 #include "driver/i2s_std.h"
 #include "esp_log.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <math.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -22,10 +23,30 @@
 
 /* Module state */
 static i2s_chan_handle_t s_rx_handle = NULL;
+static volatile uint32_t s_dma_overflows = 0;
+
+/* FFT plan for AUDIO_FFT_SIZE, built by audio_init() and shared read-only */
+static audio_fft_plan_t s_plan;
+
+/* DMA receive queue overflowed: nobody read the channel in time */
+static bool IRAM_ATTR on_recv_overflow(i2s_chan_handle_t handle, i2s_event_data_t *event,
+                                       void *user_ctx) {
+    (void)handle; (void)event; (void)user_ctx;
+    s_dma_overflows++;
+    return false;
+}
+
+#if AUDIO_CAPTURE_BITS == 32
+#define AUDIO_SLOT_WIDTH I2S_DATA_BIT_WIDTH_32BIT
+#elif AUDIO_CAPTURE_BITS == 16
+#define AUDIO_SLOT_WIDTH I2S_DATA_BIT_WIDTH_16BIT
+#else
+#error "AUDIO_CAPTURE_BITS must be 16 or 32"
+#endif
 
 /**
  * @brief  Initialise I2S input for ICS-43434 microphone.
- *         Configures for 48 kHz, 16-bit PCM, mono.
+ *         Configures for 48 kHz, AUDIO_CAPTURE_BITS-bit slots, mono.
  */
 void audio_init(void) {
     if (s_rx_handle != NULL) {
@@ -33,10 +54,16 @@ void audio_init(void) {
         return;
     }
 
+    if (!s_plan.n && !audio_fft_plan_init(&s_plan, AUDIO_FFT_SIZE)) {
+        ESP_LOGE(TAG, "FFT plan allocation failed");
+    }
+
     /* I2S channel configuration */
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(AUDIO_I2S_PORT, I2S_ROLE_MASTER);
-    chan_cfg.dma_desc_num = 4;
-    chan_cfg.dma_frame_num = 1024;
+    /* One DMA buffer is at most 4092 bytes: 512 frames of up to 4 bytes
+     * (two stream blocks), with 8 of them for the same ~85 ms of slack */
+    chan_cfg.dma_desc_num = 8;
+    chan_cfg.dma_frame_num = 2 * AUDIO_FFT_SIZE;
 
     esp_err_t ret = i2s_new_channel(&chan_cfg, NULL, &s_rx_handle);
     if (ret != ESP_OK) {
@@ -44,10 +71,10 @@ void audio_init(void) {
         return;
     }
 
-    /* Standard I2S configuration: Philips format, 48 kHz, 16-bit, mono */
+    /* Standard I2S configuration: Philips format, 48 kHz, mono */
     i2s_std_config_t std_cfg = {
         .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(AUDIO_SAMPLE_RATE),
-        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(AUDIO_SLOT_WIDTH, I2S_SLOT_MODE_MONO),
         .gpio_cfg = {
             .mclk = I2S_GPIO_UNUSED,
             .bclk = AUDIO_I2S_SCK,
@@ -70,6 +97,9 @@ void audio_init(void) {
         return;
     }
 
+    const i2s_event_callbacks_t cbs = { .on_recv_q_ovf = on_recv_overflow };
+    i2s_channel_register_event_callback(s_rx_handle, &cbs, NULL);
+
     /* Start I2S RX */
     ret = i2s_channel_enable(s_rx_handle);
     if (ret != ESP_OK) {
@@ -79,107 +109,74 @@ void audio_init(void) {
         return;
     }
 
-    ESP_LOGI(TAG, "I2S audio input ready (48 kHz, 16-bit mono)");
+    ESP_LOGI(TAG, "I2S audio input ready (48 kHz, %d-bit mono)", AUDIO_CAPTURE_BITS);
 }
 
 /**
  * @brief  Read AUDIO_FFT_SIZE samples from I2S microphone.
  */
-size_t audio_read_samples(audio_sample_t *samples) {
+size_t audio_read_samples(audio_sample_t *samples, int32_t *raw) {
     if (s_rx_handle == NULL) {
         ESP_LOGE(TAG, "audio_read_samples: I2S not initialized");
         return 0;
     }
 
+#if AUDIO_CAPTURE_BITS == 32
+    static int32_t s_raw[AUDIO_FFT_SIZE];
+    int32_t *buf = raw ? raw : s_raw;
+#else
+    audio_sample_t *buf = samples;
+#endif
+
     size_t bytes_read = 0;
-    esp_err_t ret = i2s_channel_read(s_rx_handle, samples, AUDIO_FFT_SIZE * sizeof(audio_sample_t),
+    esp_err_t ret = i2s_channel_read(s_rx_handle, buf, AUDIO_FFT_SIZE * sizeof(*buf),
                                      &bytes_read, pdMS_TO_TICKS(500));
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "I2S read failed: %s", esp_err_to_name(ret));
         return 0;
     }
+    size_t count = bytes_read / sizeof(*buf);
 
-    return bytes_read / sizeof(audio_sample_t);
-}
-
-/**
- * @brief  In-place complex FFT (radix-2 Cooley-Tukey).
- *         Input is real-valued (imaginary parts are zero).
- *         On output, first half contains magnitude spectrum.
- */
-static void fft_radix2(float *real, float *imag, int n) {
-    if (n <= 1) return;
-
-    /* Bit-reversal permutation */
-    int j = 0;
-    for (int i = 0; i < n - 1; i++) {
-        if (i < j) {
-            float tmp_r = real[i], tmp_i = imag[i];
-            real[i] = real[j];
-            imag[i] = imag[j];
-            real[j] = tmp_r;
-            imag[j] = tmp_i;
-        }
-        int m = n / 2;
-        while (j >= m) {
-            j -= m;
-            m /= 2;
-        }
-        j += m;
+#if AUDIO_CAPTURE_BITS == 32
+    /* Round the 24-bit word to 16 bits; the top half-LSB saturates */
+    for (size_t i = 0; i < count; i++) {
+        int32_t v = (int32_t)(((int64_t)buf[i] + 0x8000) >> 16);
+        samples[i] = (audio_sample_t)(v > INT16_MAX ? INT16_MAX : v);
     }
+#else
+    if (raw) {
+        for (size_t i = 0; i < count; i++) raw[i] = (int32_t)samples[i] << 16;
+    }
+#endif
+    return count;
+}
 
-    /* Cooley-Tukey FFT */
-    for (int len = 2; len <= n; len *= 2) {
-        float angle = -2.0f * M_PI / len;
-        for (int i = 0; i < n; i += len) {
-            for (int j = 0; j < len / 2; j++) {
-                float w_r = cosf(angle * j);
-                float w_i = sinf(angle * j);
-
-                int idx1 = i + j;
-                int idx2 = i + j + len / 2;
-
-                float t_r = w_r * real[idx2] - w_i * imag[idx2];
-                float t_i = w_r * imag[idx2] + w_i * real[idx2];
-
-                real[idx2] = real[idx1] - t_r;
-                imag[idx2] = imag[idx1] - t_i;
+uint32_t audio_dma_overflows(void) {
+    return s_dma_overflows;
+}
 
-                real[idx1] += t_r;
-                imag[idx1] += t_i;
-            }
-        }
-    }
+const audio_fft_plan_t *audio_block_plan(void) {
+    return s_plan.n ? &s_plan : NULL;
 }
 
 /**
  * @brief  Compute FFT magnitude spectrum with Hann window.
  */
 void audio_compute_fft(audio_sample_t *samples, audio_magnitude_t *magnitude) {
-    /* Allocate working buffers */
-    static float real[AUDIO_FFT_SIZE];
-    static float imag[AUDIO_FFT_SIZE];
-
-    /* Apply Hann window and convert to float */
-    for (int i = 0; i < AUDIO_FFT_SIZE; i++) {
-        float w = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (AUDIO_FFT_SIZE - 1)));
-        real[i] = (float)samples[i] * w / 32768.0f;
-        imag[i] = 0.0f;
+    static float work[AUDIO_FFT_SIZE];
+    static float power[AUDIO_FREQ_BINS];
+
+    if (!s_plan.n) {
+        memset(magnitude, 0, AUDIO_FREQ_BINS);
+        return;
     }
 
-    /* Compute FFT */
-    fft_radix2(real, imag, AUDIO_FFT_SIZE);
+    audio_fft_power(&s_plan, samples, work, power);
 
-    /* Extract magnitude spectrum (first half only, DC to Nyquist) */
+    /* Power to dB, then -80 dB .. 0 dB → 0-255 */
     for (int i = 0; i < AUDIO_FREQ_BINS; i++) {
-        float mag = sqrtf(real[i] * real[i] + imag[i] * imag[i]);
-        
-        /* Apply log scale and normalize to 0-255 */
-        mag = 20.0f * log10f(mag + 1e-6f);      /* Convert to dB */
-        mag = (mag + 80.0f) / 80.0f;            /* Normalize: -80dB to 0dB → 0-1 */
-        mag = fmaxf(0.0f, fminf(1.0f, mag));    /* Clamp to [0, 1] */
-
-        magnitude[i] = (uint8_t)(mag * 255.0f);
+        float mag = (audio_fft_db(power[i]) + 80.0f) * (255.0f / 80.0f);
+        magnitude[i] = mag <= 0.0f ? 0 : mag >= 255.0f ? 255 : (uint8_t)mag;
     }
 }
 
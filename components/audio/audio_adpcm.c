@@ -0,0 +1,78 @@
+/*
+ * Audio ADPCM implementation – IMA step tables and the nibble encoder.
+ */
+
+#include "audio_adpcm.h"
+#include <string.h>
+
+static const int16_t s_step[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8_t s_index_adjust[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+void audio_adpcm_init(audio_adpcm_t *st) {
+    memset(st, 0, sizeof(*st));
+}
+
+/* One sample → 4-bit code, updating the predictor exactly as a decoder will */
+static uint8_t encode_sample(audio_adpcm_t *st, int32_t sample) {
+    int32_t step   = s_step[st->index];
+    int32_t diff   = sample - st->predictor;
+    uint8_t code   = 0;
+    int32_t vpdiff = step >> 3;
+
+    if (diff < 0) { code = 8; diff = -diff; }
+    if (diff >= step) { code |= 4; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; vpdiff += step; }
+
+    st->predictor += (code & 8) ? -vpdiff : vpdiff;
+    if (st->predictor > 32767)  st->predictor = 32767;
+    if (st->predictor < -32768) st->predictor = -32768;
+
+    int idx = st->index + s_index_adjust[code & 7];
+    st->index = (uint8_t)(idx < 0 ? 0 : idx > 88 ? 88 : idx);
+    return code;
+}
+
+size_t audio_adpcm_encode(audio_adpcm_t *st, const int16_t *in, size_t count, uint8_t *block) {
+    size_t n = 0;
+    if (count && st->pos == 0) {
+        /* Block header: first sample verbatim, then the running step index */
+        st->predictor = in[0];
+        block[0] = (uint8_t)(in[0] & 0xFF);
+        block[1] = (uint8_t)((uint16_t)in[0] >> 8);
+        block[2] = st->index;
+        block[3] = 0;
+        st->pos  = 1;
+        n = 1;
+    }
+    for (; n < count && st->pos < AUDIO_ADPCM_BLOCK_SAMPLES; n++, st->pos++) {
+        uint8_t  code = encode_sample(st, in[n]);
+        uint8_t *b    = &block[4 + (st->pos - 1) / 2];
+        if ((st->pos - 1) & 1) *b |= (uint8_t)(code << 4);
+        else                   *b  = code;
+    }
+    if (st->pos == AUDIO_ADPCM_BLOCK_SAMPLES) st->pos = 0;
+    return n;
+}
+
+bool audio_adpcm_finish(audio_adpcm_t *st, uint8_t *block) {
+    if (st->pos == 0) return false;
+    /* Zero codes decode as tiny steps; the WAV fact chunk gives the true length */
+    size_t used = 4 + st->pos / 2;
+    memset(&block[used], 0, AUDIO_ADPCM_BLOCK_ALIGN - used);
+    st->pos = 0;
+    return true;
+}
@@ -0,0 +1,159 @@
+/*
+ * Audio analyzer implementation – hop scheduling, averaging and rebinning.
+ */
+
+#include "audio_analyzer.h"
+#include "audio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "audio_analyzer"
+
+void audio_analyzer_axis(audio_band_scale_t scale, uint16_t *f_lo, uint16_t *f_hi) {
+    *f_lo = scale == AUDIO_SCALE_LINEAR ? 0 : AUDIO_SPECTRUM_MIN_HZ;
+    *f_hi = AUDIO_SPECTRUM_MAX_HZ;
+}
+
+uint8_t audio_overlap_percent(audio_overlap_t overlap) {
+    static const uint8_t pct[AUDIO_OVERLAP_COUNT] = { 0, 50, 75 };
+    return overlap < AUDIO_OVERLAP_COUNT ? pct[overlap] : 0;
+}
+
+/* ── Setup ──────────────────────────────────────────────────────────────── */
+void audio_analyzer_free(audio_analyzer_t *an) {
+    audio_fft_plan_free(&an->plan);
+    free(an->hist);
+    free(an->work);
+    free(an->power);
+    free(an->avg);
+    memset(an, 0, sizeof(*an));
+}
+
+bool audio_analyzer_init(audio_analyzer_t *an, const audio_analyzer_config_t *cfg) {
+    audio_analyzer_free(an);
+
+    uint16_t n = cfg->fft_size;
+    if (n < AUDIO_ANALYZER_MIN_N || n > AUDIO_ANALYZER_MAX_N || (n & (n - 1))) {
+        ESP_LOGE(TAG, "Unsupported FFT size %u", n);
+        return false;
+    }
+    if (!audio_fft_plan_init_kind(&an->plan, n, cfg->kind)) goto oom;
+    an->hist  = malloc(n * sizeof(int16_t));
+    an->work  = malloc(n * sizeof(float));
+    an->power = malloc(n / 2 * sizeof(float));
+    an->avg   = calloc(n / 2, sizeof(float));
+    if (!an->hist || !an->work || !an->power || !an->avg) goto oom;
+
+    an->cfg = *cfg;
+    if (an->cfg.smoothing < 0.0f)  an->cfg.smoothing = 0.0f;
+    if (an->cfg.smoothing > 0.99f) an->cfg.smoothing = 0.99f;
+    an->hop = (uint16_t)(n - n * audio_overlap_percent(cfg->overlap) / 100);
+
+    /* A full-scale tone reads the same at every size: power scales with n² */
+    float ratio = (float)n / AUDIO_ANALYZER_MIN_N;
+    an->db_offset = audio_fft_db(ratio * ratio);
+
+    uint16_t f_lo, f_hi;
+    audio_analyzer_axis(cfg->scale, &f_lo, &f_hi);
+    uint8_t count = cfg->scale == AUDIO_SCALE_MEL ? AUDIO_MEL_BANDS : AUDIO_SPECTRUM_BARS;
+    if (!audio_bands_build(&an->bands, cfg->scale, count, n, f_lo, f_hi)) {
+        ESP_LOGE(TAG, "Bad band scale %d", cfg->scale);
+        audio_analyzer_free(an);
+        return false;
+    }
+
+    ESP_LOGI(TAG, "FFT %u %s, hop %u (%u%% overlap), %.1f Hz bins, %u %s bands",
+             n, audio_fft_kind_name(cfg->kind), an->hop, audio_overlap_percent(cfg->overlap),
+             (float)AUDIO_SAMPLE_RATE / n, an->bands.count,
+             audio_bands_scale_name(cfg->scale));
+    return true;
+
+oom:
+    ESP_LOGE(TAG, "Out of memory for %u-point analyzer", n);
+    audio_analyzer_free(an);
+    return false;
+}
+
+/* ── Processing ─────────────────────────────────────────────────────────── */
+static void process_frame(audio_analyzer_t *an) {
+    uint16_t bins = an->plan.n / 2;
+    audio_fft_power(&an->plan, an->hist, an->work, an->power);
+
+    /* avg += (1 − s) × (power − avg); the first frame seeds the average */
+    float k = an->frames ? 1.0f - an->cfg.smoothing : 1.0f;
+    for (uint16_t i = 0; i < bins; i++) {
+        an->avg[i] += k * (an->power[i] - an->avg[i]);
+    }
+    an->frames++;
+}
+
+int audio_analyzer_feed(audio_analyzer_t *an, const int16_t *samples, size_t count) {
+    if (!an->plan.n) return 0;
+
+    int64_t  t0 = esp_timer_get_time();
+    uint16_t n  = an->plan.n;
+    int frames  = 0;
+
+    for (size_t done = 0; done < count; ) {
+        size_t take = count - done;
+        if (take > (size_t)(n - an->fill)) take = n - an->fill;
+        memcpy(&an->hist[an->fill], &samples[done], take * sizeof(int16_t));
+        an->fill += take;
+        done     += take;
+
+        if (an->fill == n) {
+            process_frame(an);
+            frames++;
+            /* Keep the last n − hop samples as the start of the next frame */
+            memmove(an->hist, &an->hist[an->hop], (n - an->hop) * sizeof(int16_t));
+            an->fill = n - an->hop;
+        }
+    }
+
+    /* Latch CPU cost once per second of audio */
+    an->busy_us        += esp_timer_get_time() - t0;
+    an->window_samples += count;
+    if (an->window_samples >= AUDIO_SAMPLE_RATE) {
+        int64_t audio_us = (int64_t)an->window_samples * 1000000 / AUDIO_SAMPLE_RATE;
+        an->cpu_permille   = (uint16_t)(an->busy_us * 1000 / audio_us);
+        an->busy_us        = 0;
+        an->window_samples = 0;
+    }
+    return frames;
+}
+
+const float *audio_analyzer_power(const audio_analyzer_t *an) {
+    return an->plan.n ? an->avg : NULL;
+}
+
+void audio_analyzer_bars(const audio_analyzer_t *an, uint8_t *bars) {
+    if (!an->plan.n) {
+        memset(bars, 0, AUDIO_SPECTRUM_BARS);
+        return;
+    }
+    float   band[AUDIO_BANDS_MAX];
+    uint8_t level[AUDIO_BANDS_MAX];
+    uint8_t count = an->bands.count;
+
+    audio_bands_aggregate(&an->bands, an->avg, band);
+    for (int b = 0; b < count; b++) {
+        float mag = (audio_fft_db(band[b]) - an->db_offset + 80.0f) * (255.0f / 80.0f);
+        level[b] = mag <= 0.0f ? 0 : mag >= 255.0f ? 255 : (uint8_t)mag;
+    }
+    /* Stretch count bands over the bars (identity for the linear scale) */
+    for (int i = 0; i < AUDIO_SPECTRUM_BARS; i++) {
+        bars[i] = level[i * count / AUDIO_SPECTRUM_BARS];
+    }
+}
+
+void audio_analyzer_get_stats(const audio_analyzer_t *an, audio_analyzer_stats_t *out) {
+    out->fft_size     = an->plan.n;
+    out->hop          = an->hop;
+    out->bin_hz       = an->plan.n ? (float)AUDIO_SAMPLE_RATE / an->plan.n : 0.0f;
+    out->frames       = an->frames;
+    out->cpu_permille = an->cpu_permille;
+    out->scale        = an->cfg.scale;
+    out->kind         = an->cfg.kind;
+}
@@ -0,0 +1,153 @@
+/*
+ * Audio bands implementation – band edge tables and one-pass aggregation.
+ */
+
+#include "audio_bands.h"
+#include "audio.h"
+#include "audio_fft.h"
+#include <math.h>
+#include <string.h>
+
+/* ── Scales ─────────────────────────────────────────────────────────────── */
+static float hz_to_mel(float hz) { return 2595.0f * log10f(1.0f + hz / 700.0f); }
+static float mel_to_hz(float m)  { return 700.0f * (powf(10.0f, m / 2595.0f) - 1.0f); }
+
+const char *audio_bands_scale_name(audio_band_scale_t scale) {
+    static const char *const names[AUDIO_SCALE_COUNT] = { "lin", "1/3oct", "mel", "custom" };
+    return scale < AUDIO_SCALE_COUNT ? names[scale] : "?";
+}
+
+float audio_bands_position(audio_band_scale_t scale, uint16_t f_lo, uint16_t f_hi, float hz) {
+    float lo = f_lo, hi = f_hi, pos;
+    switch (scale) {
+    case AUDIO_SCALE_THIRD_OCTAVE:
+        if (lo < 1.0f) lo = 1.0f;
+        pos = logf(hz / lo) / logf(hi / lo);
+        break;
+    case AUDIO_SCALE_MEL:
+        pos = (hz_to_mel(hz) - hz_to_mel(lo)) / (hz_to_mel(hi) - hz_to_mel(lo));
+        break;
+    default:
+        pos = (hz - lo) / (hi - lo);
+        break;
+    }
+    return pos < 0.0f ? 0.0f : pos > 1.0f ? 1.0f : pos;
+}
+
+/* ── Map building ───────────────────────────────────────────────────────── */
+/* Set band @p b to the bins covering [f0, f1) Hz */
+static void set_band(audio_band_map_t *map, int b, float f0, float f1) {
+    uint16_t bins    = map->fft_size / 2;
+    float    per_bin = (float)AUDIO_SAMPLE_RATE / map->fft_size;
+
+    int lo = (int)(f0 / per_bin + 0.5f);
+    int hi = (int)(f1 / per_bin + 0.5f);
+    if (hi <= lo) {
+        /* Narrower than a bin: use the bin nearest the centre */
+        lo = (int)(0.5f * (f0 + f1) / per_bin + 0.5f);
+        hi = lo + 1;
+    }
+    if (lo < 1) lo = 1;
+    if (lo > bins - 1) lo = bins - 1;
+    if (hi <= lo) hi = lo + 1;
+    if (hi > bins) hi = bins;
+
+    map->lo[b]        = (uint16_t)lo;
+    map->hi[b]        = (uint16_t)hi;
+    map->center_hz[b] = (uint16_t)(map->scale == AUDIO_SCALE_LINEAR ? 0.5f * (f0 + f1)
+                                                                    : sqrtf(f0 * f1));
+}
+
+bool audio_bands_build(audio_band_map_t *map, audio_band_scale_t scale, uint8_t count,
+                       uint16_t fft_size, uint16_t f_lo, uint16_t f_hi) {
+    memset(map, 0, sizeof(*map));
+    if (count == 0 || count > AUDIO_BANDS_MAX || f_hi <= f_lo ||
+        f_hi > AUDIO_SAMPLE_RATE / 2 || fft_size < AUDIO_FFT_MIN_N ||
+        (fft_size & (fft_size - 1)) || scale == AUDIO_SCALE_CUSTOM) {
+        return false;
+    }
+    map->scale    = scale;
+    map->mode     = scale == AUDIO_SCALE_LINEAR ? AUDIO_BANDS_PEAK : AUDIO_BANDS_SUM;
+    map->fft_size = fft_size;
+
+    switch (scale) {
+    case AUDIO_SCALE_LINEAR:
+        for (int b = 0; b < count; b++) {
+            set_band(map, b, f_lo + (float)(f_hi - f_lo) * b / count,
+                             f_lo + (float)(f_hi - f_lo) * (b + 1) / count);
+        }
+        map->count = count;
+        break;
+
+    case AUDIO_SCALE_THIRD_OCTAVE: {
+        /* Centres 1000·2^(k/3), edges at ±1/6 octave */
+        const float edge = 1.12246205f;         /* 2^(1/6) */
+        int k = (int)floorf(3.0f * log2f((f_lo > 0 ? f_lo : 1) / 1000.0f));
+        for (; map->count < count; k++) {
+            float fc = 1000.0f * powf(2.0f, k / 3.0f);
+            if (fc < f_lo) continue;
+            if (fc > f_hi) break;
+            set_band(map, map->count++, fc / edge, fc * edge);
+        }
+        break;
+    }
+
+    case AUDIO_SCALE_MEL: {
+        float m0 = hz_to_mel(f_lo), m1 = hz_to_mel(f_hi);
+        for (int b = 0; b < count; b++) {
+            set_band(map, b, mel_to_hz(m0 + (m1 - m0) * b / count),
+                             mel_to_hz(m0 + (m1 - m0) * (b + 1) / count));
+        }
+        map->count = count;
+        break;
+    }
+
+    default:
+        break;
+    }
+    return map->count > 0;
+}
+
+bool audio_bands_build_custom(audio_band_map_t *map, const uint16_t *edges_hz,
+                              uint8_t count, uint16_t fft_size) {
+    memset(map, 0, sizeof(*map));
+    if (count == 0 || count > AUDIO_BANDS_MAX || fft_size < AUDIO_FFT_MIN_N ||
+        (fft_size & (fft_size - 1))) {
+        return false;
+    }
+    for (int b = 0; b < count; b++) {
+        if (edges_hz[b + 1] <= edges_hz[b]) return false;
+    }
+    map->scale    = AUDIO_SCALE_CUSTOM;
+    map->mode     = AUDIO_BANDS_SUM;
+    map->fft_size = fft_size;
+    for (int b = 0; b < count; b++) set_band(map, b, edges_hz[b], edges_hz[b + 1]);
+    map->count = count;
+    return true;
+}
+
+/* ── Aggregation ────────────────────────────────────────────────────────── */
+void audio_bands_aggregate(const audio_band_map_t *map, const float *power, float *out) {
+    if (map->mode == AUDIO_BANDS_PEAK) {
+        for (int b = 0; b < map->count; b++) {
+            float v = 0.0f;
+            for (uint16_t i = map->lo[b]; i < map->hi[b]; i++) {
+                if (power[i] > v) v = power[i];
+            }
+            out[b] = v;
+        }
+    } else {
+        for (int b = 0; b < map->count; b++) {
+            float v = 0.0f;
+            for (uint16_t i = map->lo[b]; i < map->hi[b]; i++) v += power[i];
+            out[b] = v;
+        }
+    }
+}
+
+float audio_bands_dbfs(const audio_band_map_t *map, float power) {
+    /* Hann-windowed full-scale RMS over n samples sums to 0.1875·n² in the
+     * n/2 positive bins (Parseval with the window's 3/8 power gain) */
+    float n = map->fft_size;
+    return audio_fft_db(power) - audio_fft_db(0.1875f * n * n);
+}
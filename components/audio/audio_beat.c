@@ -0,0 +1,168 @@
+/*
+ * Audio beat implementation – onset task and the published snapshot.
+ */
+
+#include "audio_beat.h"
+#include "audio_onset.h"
+#include "audio_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <string.h>
+
+#define TAG "audio_beat"
+
+#define UNLOCKED_PHASE_US   500000  /* Phase ramp without a tempo */
+
+_Static_assert(AUDIO_ONSET_HOP == AUDIO_STREAM_BLOCK, "onset hop must be one stream block");
+
+/* Task control */
+static TaskHandle_t  s_task = NULL;
+static volatile bool s_running = false;
+static uint32_t      s_users = 0;
+static portMUX_TYPE  s_lock = portMUX_INITIALIZER_UNLOCKED;
+static audio_sub_t   s_sub;
+
+/* Engine (owned by the task) and published results (under s_lock) */
+static audio_onset_t       s_onset;
+static audio_beat_state_t  s_state;
+static audio_beat_stats_t  s_stats;
+
+/* ── Task ───────────────────────────────────────────────────────────────── */
+static void beat_task(void *arg) {
+    (void)arg;
+    static audio_block_t block;
+
+    ESP_LOGI(TAG, "Beat tracker started");
+
+    while (s_running) {
+        if (!audio_stream_read(&s_sub, &block, 100)) continue;
+
+        int64_t t0 = esp_timer_get_time();
+        audio_onset_result_t r;
+        audio_onset_process(&s_onset, block.samples, &r);
+        uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+        /* Stamp with the capture time of the block's last sample */
+        int64_t t_us  = block.timestamp_us + AUDIO_ONSET_HOP_US;
+        bool    locked = audio_onset_locked(&s_onset);
+
+        portENTER_CRITICAL(&s_lock);
+        if (r.onset) {
+            s_state.onsets++;
+            s_state.last_onset_us = t_us;
+            s_state.strength      = r.strength;
+        }
+        if (r.beat) {
+            s_state.beats++;
+            s_state.last_beat_us = t_us;
+            s_state.predicted    = r.predicted;
+        }
+        s_state.bpm        = locked ? r.bpm : 0.0f;
+        s_state.confidence = r.confidence;
+        s_stats.blocks++;
+        s_stats.overruns = s_sub.overruns;
+        if (us > s_stats.max_block_us) s_stats.max_block_us = us;
+        portEXIT_CRITICAL(&s_lock);
+    }
+
+    audio_stream_unsubscribe(&s_sub);
+    ESP_LOGI(TAG, "Beat tracker stopped (%lu blocks, %lu beats, %lu overruns, max %lu us)",
+             (unsigned long)s_stats.blocks, (unsigned long)s_state.beats,
+             (unsigned long)s_stats.overruns, (unsigned long)s_stats.max_block_us);
+    s_task = NULL;  /* Clear handle before self-deleting */
+    vTaskDelete(NULL);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+bool audio_beat_start(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool first = s_users++ == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (!first) return true;
+
+    /* A previous task may still be winding down */
+    for (int i = 0; i < 50 && s_task != NULL; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    memset(&s_state, 0, sizeof(s_state));
+    memset(&s_stats, 0, sizeof(s_stats));
+    if (!audio_onset_init(&s_onset)) {
+        ESP_LOGE(TAG, "Out of memory for the onset FFT");
+        s_users = 0;
+        return false;
+    }
+
+    audio_stream_start();
+    if (!audio_stream_subscribe(&s_sub)) {
+        ESP_LOGE(TAG, "No free audio stream slot");
+        audio_onset_free(&s_onset);
+        s_users = 0;
+        return false;
+    }
+
+    s_running = true;
+    xTaskCreatePinnedToCore(
+        beat_task,
+        "audio_beat",
+        3072,
+        NULL,
+        5,
+        &s_task,
+        0  /* CPU0 */
+    );
+    return true;
+}
+
+void audio_beat_stop(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool last = s_users > 0 && --s_users == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (!last || !s_running) return;
+
+    s_running = false;
+
+    /* Wait for the task to actually finish (up to 500ms) */
+    for (int i = 0; i < 50 && s_task != NULL; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    if (s_task != NULL) {
+        ESP_LOGW(TAG, "Beat task did not stop in time, forcing delete");
+        vTaskDelete(s_task);
+        s_task = NULL;
+        audio_stream_unsubscribe(&s_sub);
+    }
+    audio_onset_free(&s_onset);
+
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_state, 0, sizeof(s_state));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool audio_beat_running(void) {
+    return s_running;
+}
+
+void audio_beat_get(audio_beat_state_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_state;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+float audio_beat_phase(const audio_beat_state_t *st, int64_t now_us) {
+    if (!st->beats) return 1.0f;
+    float span  = st->bpm > 0 ? 60e6f / st->bpm : UNLOCKED_PHASE_US;
+    float phase = (float)(now_us - st->last_beat_us) / span;
+    if (phase < 0) return 0.0f;
+    if (st->bpm > 0) return phase - (int)phase;
+    return phase > 1.0f ? 1.0f : phase;
+}
+
+void audio_beat_get_stats(audio_beat_stats_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
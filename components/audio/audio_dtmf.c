@@ -0,0 +1,100 @@
+/*
+ * Audio DTMF implementation – per-block classification and debouncing.
+ */
+
+#include "audio_dtmf.h"
+#include <string.h>
+
+static const uint16_t s_row_hz[4] = { 697, 770, 852, 941 };
+static const uint16_t s_col_hz[4] = { 1209, 1336, 1477, 1633 };
+static const char     s_keys[4][4] = {
+    { '1', '2', '3', 'A' },
+    { '4', '5', '6', 'B' },
+    { '7', '8', '9', 'C' },
+    { '*', '0', '#', 'D' },
+};
+
+bool audio_dtmf_init(audio_dtmf_t *d, uint32_t sample_rate) {
+    memset(d, 0, sizeof(*d));
+    audio_goertzel_config_t cfg = {
+        .sample_rate = sample_rate,
+        .block_size  = (uint16_t)(sample_rate * AUDIO_DTMF_BLOCK_MS / 1000),
+        .count       = 8,
+    };
+    for (int i = 0; i < 4; i++) {
+        cfg.freq_hz[i]     = s_row_hz[i];
+        cfg.freq_hz[4 + i] = s_col_hz[i];
+    }
+    return audio_goertzel_init(&d->bank, &cfg);
+}
+
+/* ── Classification ─────────────────────────────────────────────────────── */
+/* Index of the strongest of four ratios; *runner_up gets the next one */
+static int strongest(const uint32_t *r, uint32_t *runner_up) {
+    int best = 0;
+    for (int i = 1; i < 4; i++) if (r[i] > r[best]) best = i;
+    *runner_up = 0;
+    for (int i = 0; i < 4; i++) if (i != best && r[i] > *runner_up) *runner_up = r[i];
+    return best;
+}
+
+char audio_dtmf_block_key(const audio_dtmf_t *d) {
+    const audio_goertzel_t *g = &d->bank;
+    if (!g->blocks || audio_goertzel_block_dbfs(g) < AUDIO_DTMF_MIN_DBFS) return 0;
+
+    uint32_t row_next, col_next;
+    int      row = strongest(&g->ratio_q16[0], &row_next);
+    int      col = strongest(&g->ratio_q16[4], &col_next);
+    uint64_t rp  = g->ratio_q16[row], cp = g->ratio_q16[4 + col];
+
+    /* A clean pair puts ~0.5 of the energy in each tone; speech and music
+     * spread it.  Ratios are in Q16. */
+    if (rp + cp < AUDIO_GOERTZEL_RATIO_ONE * 6 / 10) return 0;
+    if (rp < 4 * (uint64_t)row_next || cp < 4 * (uint64_t)col_next) return 0;   /* 6 dB */
+    /* Twist: column (high group) may be up to 8 dB weaker or 4 dB stronger */
+    if (cp * 100 > rp * 251 || cp * 631 < rp * 100) return 0;
+    return s_keys[row][col];
+}
+
+/* ── Debouncing ─────────────────────────────────────────────────────────── */
+/* One event at most per block: a key change releases first, presses next */
+static bool update(audio_dtmf_t *d, audio_dtmf_event_t *ev) {
+    char k = audio_dtmf_block_key(d);
+    if (k == d->candidate) {
+        if (d->hits < 255) d->hits++;
+    } else {
+        d->candidate = k;
+        d->hits      = 1;
+    }
+    if (d->key) d->key_blocks++;
+
+    if (d->key && d->candidate != d->key && d->hits >= AUDIO_DTMF_HITS) {
+        /* Dropout blocks at the end do not count as held time */
+        ev->key         = d->key;
+        ev->down        = false;
+        ev->duration_ms = (d->key_blocks - d->hits) * AUDIO_DTMF_BLOCK_MS;
+        d->key = 0;
+        return true;
+    }
+    if (!d->key && d->candidate && d->hits >= AUDIO_DTMF_HITS) {
+        d->key        = d->candidate;
+        d->key_blocks = d->hits;
+        ev->key         = d->key;
+        ev->down        = true;
+        ev->duration_ms = 0;
+        return true;
+    }
+    return false;
+}
+
+size_t audio_dtmf_feed(audio_dtmf_t *d, const int16_t *samples, size_t count,
+                       audio_dtmf_event_t *ev, bool *has_event) {
+    size_t used = 0;
+    *has_event = false;
+    while (used < count && !*has_event) {
+        bool done;
+        used += audio_goertzel_feed(&d->bank, &samples[used], count - used, &done);
+        if (done) *has_event = update(d, ev);
+    }
+    return used;
+}
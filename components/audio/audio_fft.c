@@ -0,0 +1,402 @@
+/*
+ * Audio FFT implementation – radix-4 complex core and real-input split.
+ *
+ * For a complex transform of M = n/2 points the input is bit-reversed,
+ * then (if log2 M is odd) one radix-2 pass of span 1 runs, followed by
+ * radix-4 passes of span h = 1 or 2, 4h, 16h, ... Each radix-4 butterfly
+ * merges two radix-2 stages and needs three twiddle multiplies instead of
+ * four, on half the number of passes over the buffer.
+ */
+
+#include "audio_fft.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TWO_PI      6.28318530717958647692
+
+/* ── Plan ───────────────────────────────────────────────────────────────── */
+static uint8_t ilog2(uint32_t v) {
+    uint8_t r = 0;
+    while (v >>= 1) r++;
+    return r;
+}
+
+/* Number of twiddle floats the radix-4 passes of an M-point FFT use */
+static uint32_t twiddle_floats(uint32_t m) {
+    uint32_t total = 0;
+    for (uint32_t h = (ilog2(m) & 1) ? 2 : 1; 4 * h <= m; h *= 4) total += 6 * h;
+    return total;
+}
+
+static inline int16_t to_q15(double v) {
+    long q = lround(v * 32767.0);
+    return (int16_t)(q > 32767 ? 32767 : q < -32767 ? -32767 : q);
+}
+
+bool audio_fft_plan_init(audio_fft_plan_t *plan, uint16_t n) {
+    return audio_fft_plan_init_kind(plan, n, AUDIO_FFT_DEFAULT_KIND);
+}
+
+bool audio_fft_plan_init_kind(audio_fft_plan_t *plan, uint16_t n, audio_fft_kind_t kind) {
+    memset(plan, 0, sizeof(*plan));
+    if (n < AUDIO_FFT_MIN_N || (n & (n - 1))) return false;
+
+    uint32_t m     = n / 2;
+    uint32_t n_tw  = twiddle_floats(m);
+    uint32_t n_spl = (n / 4 + 1) * 2;
+    bool     q15   = (kind == AUDIO_FFT_Q15);
+    if (q15) {
+        plan->window_q  = malloc(n * sizeof(int16_t));
+        plan->twiddle_q = malloc(n_tw * sizeof(int16_t));
+        plan->split_q   = malloc(n_spl * sizeof(int16_t));
+    } else {
+        plan->window  = malloc(n * sizeof(float));
+        plan->twiddle = malloc(n_tw * sizeof(float));
+        plan->split   = malloc(n_spl * sizeof(float));
+    }
+    plan->swaps = malloc(m * sizeof(uint16_t));
+    if (!plan->swaps || (q15 ? (!plan->window_q || !plan->twiddle_q || !plan->split_q)
+                             : (!plan->window || !plan->twiddle || !plan->split))) {
+        audio_fft_plan_free(plan);
+        return false;
+    }
+    plan->n     = n;
+    plan->log2n = ilog2(n);
+    plan->kind  = kind;
+
+    /* Hann window, 0.5·(1 − cos(2πi/(n−1))); the float one folds in the
+     * int16 scale, the Q15 one is applied as Q15 × int16 */
+    for (uint32_t i = 0; i < n; i++) {
+        double w = 0.5 * (1.0 - cos(TWO_PI * i / (n - 1)));
+        if (q15) plan->window_q[i] = to_q15(w);
+        else     plan->window[i]   = (float)(w / 32768.0);
+    }
+
+    /* Per-pass twiddles W_4h^j, W_4h^2j, W_4h^3j in butterfly order */
+    uint32_t t = 0;
+    for (uint32_t h = (ilog2(m) & 1) ? 2 : 1; 4 * h <= m; h *= 4) {
+        for (uint32_t j = 0; j < h; j++) {
+            for (uint32_t k = 1; k <= 3; k++, t += 2) {
+                double a = -TWO_PI * (double)(k * j) / (4.0 * h);
+                if (q15) {
+                    plan->twiddle_q[t]     = to_q15(cos(a));
+                    plan->twiddle_q[t + 1] = to_q15(sin(a));
+                } else {
+                    plan->twiddle[t]     = (float)cos(a);
+                    plan->twiddle[t + 1] = (float)sin(a);
+                }
+            }
+        }
+    }
+
+    /* Real-split twiddles exp(-2πik/n), k = 0 .. n/4 */
+    for (uint32_t k = 0; k <= n / 4; k++) {
+        double a = -TWO_PI * k / n;
+        if (q15) {
+            plan->split_q[2 * k]     = to_q15(cos(a));
+            plan->split_q[2 * k + 1] = to_q15(sin(a));
+        } else {
+            plan->split[2 * k]     = (float)cos(a);
+            plan->split[2 * k + 1] = (float)sin(a);
+        }
+    }
+
+    /* Bit-reversal swap pairs for M points */
+    uint8_t bits = ilog2(m);
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t r = 0;
+        for (uint8_t b = 0; b < bits; b++) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        if (i < r) {
+            plan->swaps[plan->num_swaps++] = (uint16_t)i;
+            plan->swaps[plan->num_swaps++] = (uint16_t)r;
+        }
+    }
+    return true;
+}
+
+void audio_fft_plan_free(audio_fft_plan_t *plan) {
+    free(plan->window);
+    free(plan->twiddle);
+    free(plan->split);
+    free(plan->window_q);
+    free(plan->twiddle_q);
+    free(plan->split_q);
+    free(plan->swaps);
+    memset(plan, 0, sizeof(*plan));
+}
+
+const char *audio_fft_kind_name(audio_fft_kind_t kind) {
+    return kind == AUDIO_FFT_Q15 ? "q15" : "f32";
+}
+
+/* ── Complex FFT ────────────────────────────────────────────────────────── */
+void audio_fft_complex(const audio_fft_plan_t *plan, float *buf) {
+    uint32_t m = plan->n / 2;
+
+    for (uint32_t s = 0; s < plan->num_swaps; s += 2) {
+        float *a = &buf[2 * plan->swaps[s]];
+        float *b = &buf[2 * plan->swaps[s + 1]];
+        float tr = a[0], ti = a[1];
+        a[0] = b[0]; a[1] = b[1];
+        b[0] = tr;   b[1] = ti;
+    }
+
+    uint32_t h = 1;
+    if (!(plan->log2n & 1)) {
+        /* log2(M) = log2(n) − 1 is odd: one twiddle-free radix-2 pass */
+        for (uint32_t i = 0; i < 2 * m; i += 4) {
+            float r0 = buf[i], i0 = buf[i + 1];
+            float r1 = buf[i + 2], i1 = buf[i + 3];
+            buf[i]     = r0 + r1; buf[i + 1] = i0 + i1;
+            buf[i + 2] = r0 - r1; buf[i + 3] = i0 - i1;
+        }
+        h = 2;
+    }
+
+    const float *tw_pass = plan->twiddle;
+    for (; 4 * h <= m; h *= 4) {
+        for (uint32_t base = 0; base < m; base += 4 * h) {
+            const float *tw = tw_pass;
+            for (uint32_t j = 0; j < h; j++, tw += 6) {
+                float *p0 = &buf[2 * (base + j)];
+                float *p1 = p0 + 2 * h;
+                float *p2 = p1 + 2 * h;
+                float *p3 = p2 + 2 * h;
+
+                /* After bit reversal, p1 is the odd half of the first
+                 * radix-2 stage: a = x0, b = W²·x1, c = W·x2, d = W³·x3 */
+                float ar = p0[0], ai = p0[1];
+                float br = tw[2] * p1[0] - tw[3] * p1[1];
+                float bi = tw[2] * p1[1] + tw[3] * p1[0];
+                float cr = tw[0] * p2[0] - tw[1] * p2[1];
+                float ci = tw[0] * p2[1] + tw[1] * p2[0];
+                float dr = tw[4] * p3[0] - tw[5] * p3[1];
+                float di = tw[4] * p3[1] + tw[5] * p3[0];
+
+                float s0r = ar + br, s0i = ai + bi;     /* a + b */
+                float d0r = ar - br, d0i = ai - bi;     /* a − b */
+                float s1r = cr + dr, s1i = ci + di;     /* c + d */
+                float d1r = cr - dr, d1i = ci - di;     /* c − d */
+
+                p0[0] = s0r + s1r; p0[1] = s0i + s1i;
+                p2[0] = s0r - s1r; p2[1] = s0i - s1i;
+                p1[0] = d0r + d1i; p1[1] = d0i - d1r;   /* (a − b) − i(c − d) */
+                p3[0] = d0r - d1i; p3[1] = d0i + d1r;   /* (a − b) + i(c − d) */
+            }
+        }
+        tw_pass += 6 * h;
+    }
+}
+
+/* ── Q15 block-floating-point FFT ───────────────────────────────────────── */
+/* Bits needed for the magnitude bound @p acc (an OR of |x| values) */
+static inline int bit_len(uint32_t acc) {
+    return acc ? 32 - __builtin_clz(acc) : 0;
+}
+
+static inline int16_t shr_round(int32_t v, int s) {
+    return (int16_t)(s ? (v + (1 << (s - 1))) >> s : v);
+}
+
+/* OR of one's-complement magnitudes: its bit length bounds max |x| */
+static uint32_t magnitude_bits(const int16_t *buf, uint32_t count) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t v = buf[i];
+        acc |= (uint32_t)(v ^ (v >> 31));
+    }
+    return acc;
+}
+
+int audio_fft_complex_q15(const audio_fft_plan_t *plan, int16_t *buf) {
+    uint32_t m   = plan->n / 2;
+    int      exp = 0;
+
+    for (uint32_t s = 0; s < plan->num_swaps; s += 2) {
+        int16_t *a = &buf[2 * plan->swaps[s]];                  /* re/im pair */
+        int16_t *b = &buf[2 * plan->swaps[s + 1]];
+        int16_t tr = a[0], ti = a[1];
+        a[0] = b[0]; a[1] = b[1];
+        b[0] = tr;   b[1] = ti;
+    }
+
+    uint32_t h = 1;
+    uint32_t acc = magnitude_bits(buf, 2 * m);
+    if (!(plan->log2n & 1)) {
+        /* Radix-2 pass grows each component at most 2×: keep 14 bits */
+        int sh = bit_len(acc) > 14 ? bit_len(acc) - 14 : 0;
+        acc = 0;
+        for (uint32_t i = 0; i < 2 * m; i += 4) {
+            int32_t r0 = shr_round(buf[i], sh),     i0 = shr_round(buf[i + 1], sh);
+            int32_t r1 = shr_round(buf[i + 2], sh), i1 = shr_round(buf[i + 3], sh);
+            int32_t v[4] = { r0 + r1, i0 + i1, r0 - r1, i0 - i1 };
+            for (int k = 0; k < 4; k++) {
+                buf[i + k] = (int16_t)v[k];
+                acc |= (uint32_t)(v[k] ^ (v[k] >> 31));
+            }
+        }
+        exp += sh;
+        h = 2;
+    }
+
+    const int16_t *tw_pass = plan->twiddle_q;
+    for (; 4 * h <= m; h *= 4) {
+        /* A radix-4 butterfly grows a component by up to 4·√2: keep 12 bits */
+        int sh = bit_len(acc) > 12 ? bit_len(acc) - 12 : 0;
+        exp += sh;
+        acc = 0;
+        for (uint32_t base = 0; base < m; base += 4 * h) {
+            const int16_t *tw = tw_pass;
+            for (uint32_t j = 0; j < h; j++, tw += 6) {
+                int16_t *p0 = &buf[2 * (base + j)];
+                int16_t *p1 = p0 + 2 * h;
+                int16_t *p2 = p1 + 2 * h;
+                int16_t *p3 = p2 + 2 * h;
+
+                int32_t ar = shr_round(p0[0], sh), ai = shr_round(p0[1], sh);
+                int32_t x1r = shr_round(p1[0], sh), x1i = shr_round(p1[1], sh);
+                int32_t x2r = shr_round(p2[0], sh), x2i = shr_round(p2[1], sh);
+                int32_t x3r = shr_round(p3[0], sh), x3i = shr_round(p3[1], sh);
+
+                /* Same butterfly as the float path, Q15 twiddles */
+                int32_t br = (tw[2] * x1r - tw[3] * x1i + 16384) >> 15;
+                int32_t bi = (tw[2] * x1i + tw[3] * x1r + 16384) >> 15;
+                int32_t cr = (tw[0] * x2r - tw[1] * x2i + 16384) >> 15;
+                int32_t ci = (tw[0] * x2i + tw[1] * x2r + 16384) >> 15;
+                int32_t dr = (tw[4] * x3r - tw[5] * x3i + 16384) >> 15;
+                int32_t di = (tw[4] * x3i + tw[5] * x3r + 16384) >> 15;
+
+                int32_t s0r = ar + br, s0i = ai + bi;
+                int32_t d0r = ar - br, d0i = ai - bi;
+                int32_t s1r = cr + dr, s1i = ci + di;
+                int32_t d1r = cr - dr, d1i = ci - di;
+
+                int32_t v[8] = {
+                    s0r + s1r, s0i + s1i,       /* p0 */
+                    d0r + d1i, d0i - d1r,       /* p1 */
+                    s0r - s1r, s0i - s1i,       /* p2 */
+                    d0r - d1i, d0i + d1r,       /* p3 */
+                };
+                p0[0] = (int16_t)v[0]; p0[1] = (int16_t)v[1];
+                p1[0] = (int16_t)v[2]; p1[1] = (int16_t)v[3];
+                p2[0] = (int16_t)v[4]; p2[1] = (int16_t)v[5];
+                p3[0] = (int16_t)v[6]; p3[1] = (int16_t)v[7];
+                for (int k = 0; k < 8; k++) acc |= (uint32_t)(v[k] ^ (v[k] >> 31));
+            }
+        }
+        tw_pass += 6 * h;
+    }
+    return exp;
+}
+
+static void power_q15(const audio_fft_plan_t *plan, const int16_t *samples,
+                      int16_t *buf, float *power) {
+    uint32_t n = plan->n, m = n / 2;
+
+    /* Window in Q15 × int16, then normalise the block to 14 bits */
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t v = samples[i] * plan->window_q[i];
+        acc |= (uint32_t)(v ^ (v >> 31));
+    }
+    if (!acc) {
+        memset(power, 0, m * sizeof(float));
+        return;
+    }
+    int norm = bit_len(acc) > 14 ? bit_len(acc) - 14 : 0;
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t v = samples[i] * plan->window_q[i];
+        buf[i] = (int16_t)(norm ? (v + (1 << (norm - 1))) >> norm : v);
+    }
+
+    int exp = norm + audio_fft_complex_q15(plan, buf);
+
+    /* buf × 2^exp / (32767 · 32768) is the float path's value; the split
+     * below works on 2·X, hence the extra 1/4 on the power */
+    float amp   = ldexpf(1.0f / (32767.0f * 32768.0f), exp);
+    float scale = 0.25f * amp * amp;
+
+    int32_t z0 = buf[0] + buf[1];
+    power[0] = 4.0f * scale * (float)z0 * (float)z0;
+
+    for (uint32_t k = 1; k <= m / 2; k++) {
+        uint32_t kc = m - k;
+        int32_t zr = buf[2 * k],  zi = buf[2 * k + 1];
+        int32_t cr = buf[2 * kc], ci = buf[2 * kc + 1];
+
+        int32_t er = zr + cr, ei = zi - ci;             /* 2·E[k] */
+        int32_t or_ = zi + ci, oi = cr - zr;            /* 2·O[k] */
+
+        int32_t wr = plan->split_q[2 * k], wi = plan->split_q[2 * k + 1];
+        int32_t tr = (int32_t)(((int64_t)wr * or_ - (int64_t)wi * oi + 16384) >> 15);
+        int32_t ti = (int32_t)(((int64_t)wr * oi + (int64_t)wi * or_ + 16384) >> 15);
+
+        float xr = (float)(er + tr), xi = (float)(ei + ti);
+        power[k] = scale * (xr * xr + xi * xi);
+        if (kc != k) {
+            float yr = (float)(er - tr), yi = (float)(ei - ti);
+            power[kc] = scale * (yr * yr + yi * yi);
+        }
+    }
+}
+
+/* ── Real-input power spectrum ──────────────────────────────────────────── */
+static void power_float(const audio_fft_plan_t *plan, const int16_t *samples,
+                        float *work, float *power) {
+    uint32_t n = plan->n, m = n / 2;
+
+    /* Window and pack even/odd samples as re/im of M complex points */
+    for (uint32_t i = 0; i < n; i++) work[i] = samples[i] * plan->window[i];
+
+    audio_fft_complex(plan, work);
+
+    /* Split Z into X: X[k] = E[k] + W^k·O[k] with
+     *   E[k] = (Z[k] + conj Z[M−k]) / 2,  O[k] = −i·(Z[k] − conj Z[M−k]) / 2.
+     * Bins k and M − k share E/O, so each iteration emits both. */
+    float z0r = work[0], z0i = work[1];
+    power[0] = (z0r + z0i) * (z0r + z0i);
+
+    for (uint32_t k = 1; k <= m / 2; k++) {
+        uint32_t kc = m - k;
+        float zr = work[2 * k],  zi = work[2 * k + 1];
+        float cr = work[2 * kc], ci = work[2 * kc + 1];
+
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi - ci);
+        float or_ = 0.5f * (zi + ci), oi = -0.5f * (zr - cr);
+
+        /* W^k for k ≤ n/4 from the table */
+        float wr = plan->split[2 * k], wi = plan->split[2 * k + 1];
+        float tr = wr * or_ - wi * oi;
+        float ti = wr * oi + wi * or_;
+
+        float xr = er + tr, xi = ei + ti;
+        power[k] = xr * xr + xi * xi;
+
+        if (kc != k) {
+            /* W^(M−k) = −conj W^k, so X[M−k] = conj(E[k] − W^k·O[k]) */
+            float yr = er - tr, yi = -(ei - ti);
+            power[kc] = yr * yr + yi * yi;
+        }
+    }
+}
+
+void audio_fft_power(const audio_fft_plan_t *plan, const int16_t *samples,
+                     float *work, float *power) {
+    if (plan->kind == AUDIO_FFT_Q15) power_q15(plan, samples, (int16_t *)work, power);
+    else                             power_float(plan, samples, work, power);
+}
+
+/* ── Fast dB ────────────────────────────────────────────────────────────── */
+float audio_fft_db(float power) {
+    if (!(power > 0.0f)) return -200.0f;
+
+    union { float f; uint32_t u; } v = { .f = power };
+    int   e = (int)((v.u >> 23) & 0xFF) - 127;
+    v.u = (v.u & 0x007FFFFFu) | 0x3F800000u;        /* Mantissa in [1, 2) */
+    float x = v.f;
+
+    /* log2(x) on [1, 2): cubic minimax, |error| < 6.5e-4 */
+    float l = ((0.15823348f * x - 1.05176843f) * x + 3.04767126f) * x - 2.15349246f;
+    return 3.01029996f * ((float)e + l);             /* 10·log10(2) · log2 */
+}
@@ -0,0 +1,278 @@
+/*
+ * Audio FFT benchmark and accuracy report.
+ *
+ * Times the real-input radix-4 path (audio_fft_power) against the previous
+ * approach – an n-point complex radix-2 FFT with a zero imaginary part –
+ * and checks both against a double-precision reference DFT for a tone plus
+ * noise input (worst bin magnitude error, in dB below the spectral peak).
+ * The Q15 block-floating-point path is timed and checked the same way,
+ * and both kinds are compared at falling input levels: the SNR of a tone
+ * against the reference spectrum shows what block floating point keeps
+ * for quiet signals (a fixed-scale Q15 FFT loses 6 dB per halving).
+ * Also reports the worst-case error of audio_fft_db() against log10 over
+ * the full dynamic range.
+ *
+ * Each accuracy figure is checked against a limit below; a miss is
+ * flagged FAIL and audio_fft_bench_run() returns false.
+ *
+ * On target the cost is CPU cycles per transform; on the host it is
+ * nanoseconds.  Host build: `make audio_fft_bench` from the repo root
+ * (exits non-zero if a limit is missed).
+ */
+
+#include "audio_fft.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "esp_log.h"
+#define TAG "audio_fft"
+#define UNIT "cyc"
+#define REPORT(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+static inline uint32_t bench_now(void) { return esp_cpu_get_cycle_count(); }
+#else
+#include <time.h>
+#define UNIT "ns"
+#define REPORT(fmt, ...) printf(fmt "\n", ##__VA_ARGS__)
+static inline uint32_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#endif
+
+#define MAX_N       1024
+#define ITERATIONS  32
+#define TWO_PI      6.28318530717958647692
+
+/* Accuracy limits: worst bin error below the peak, and audio_fft_db() */
+#define MAX_ERR_F32_DB  (-120.0)
+#define MAX_ERR_Q15_DB  (-60.0)
+#define MAX_ERR_LOG_DB  0.002
+/* Minimum tone SNR at every input level (block floating point holds Q15
+ * near 60 dB however quiet the input) */
+#define MIN_SNR_F32_DB  120.0
+#define MIN_SNR_Q15_DB  55.0
+
+static int16_t s_in[MAX_N];
+static float   s_work[2 * MAX_N];
+static float   s_power[MAX_N / 2];
+static double  s_ref[MAX_N / 2];
+static bool    s_pass;
+
+static const char *verdict(bool ok) {
+    if (!ok) s_pass = false;
+    return ok ? "ok" : "FAIL";
+}
+
+/* ── Previous implementation: n-point complex radix-2 ───────────────────── */
+static void radix2_power(const audio_fft_plan_t *plan, const float *tw, const int16_t *x,
+                         float *buf, float *power) {
+    int n = plan->n;
+    for (int i = 0; i < n; i++) {
+        buf[2 * i]     = x[i] * plan->window[i];
+        buf[2 * i + 1] = 0.0f;
+    }
+    for (int i = 0, j = 0; i < n - 1; i++) {
+        if (i < j) {
+            float tr = buf[2 * i], ti = buf[2 * i + 1];
+            buf[2 * i] = buf[2 * j]; buf[2 * i + 1] = buf[2 * j + 1];
+            buf[2 * j] = tr;         buf[2 * j + 1] = ti;
+        }
+        int m = n / 2;
+        while (j >= m) { j -= m; m /= 2; }
+        j += m;
+    }
+    for (int len = 2; len <= n; len *= 2) {
+        int stride = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int j = 0; j < len / 2; j++) {
+                float wr = tw[2 * j * stride], wi = tw[2 * j * stride + 1];
+                float *a = &buf[2 * (i + j)], *b = &buf[2 * (i + j + len / 2)];
+                float tr = wr * b[0] - wi * b[1];
+                float ti = wr * b[1] + wi * b[0];
+                b[0] = a[0] - tr; b[1] = a[1] - ti;
+                a[0] += tr;       a[1] += ti;
+            }
+        }
+    }
+    for (int k = 0; k < n / 2; k++) {
+        power[k] = buf[2 * k] * buf[2 * k] + buf[2 * k + 1] * buf[2 * k + 1];
+    }
+}
+
+/* ── Reference DFT (double) ─────────────────────────────────────────────── */
+static void reference_power(const audio_fft_plan_t *plan, const int16_t *x, double *power) {
+    int n = plan->n;
+    double *cs = malloc(2 * n * sizeof(double));   /* cos/sin(-2πi/n) */
+    double *xw = malloc(n * sizeof(double));        /* Windowed input */
+    if (!cs || !xw) {
+        for (int k = 0; k < n / 2; k++) power[k] = 0;
+        free(cs);
+        free(xw);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        cs[2 * i]     = cos(-TWO_PI * i / n);
+        cs[2 * i + 1] = sin(-TWO_PI * i / n);
+        xw[i] = x[i] * 0.5 * (1.0 - cos(TWO_PI * i / (n - 1))) / 32768.0;
+    }
+    for (int k = 0; k < n / 2; k++) {
+        double re = 0, im = 0;
+        for (int i = 0; i < n; i++) {
+            int a = (int)(((uint32_t)k * i) & (n - 1));
+            re += xw[i] * cs[2 * a];
+            im += xw[i] * cs[2 * a + 1];
+        }
+        power[k] = re * re + im * im;
+    }
+    free(cs);
+    free(xw);
+}
+
+/* 1 kHz-ish tone of peak @p amp plus white noise 44 dB below it */
+static void make_input(int n, double amp) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int noise = (int)(seed >> 22) - 512;
+        s_in[i] = (int16_t)lrint(amp * (sin(TWO_PI * 5.3 * i / 256.0) + noise / 163840.0));
+    }
+}
+
+/* Worst magnitude error of s_power vs s_ref, in dB below the peak magnitude */
+static double spectrum_error(int n) {
+    double peak = 0, err = 0;
+    for (int k = 0; k < n / 2; k++) {
+        if (s_ref[k] > peak) peak = s_ref[k];
+        double e = fabs(sqrt(s_power[k]) - sqrt(s_ref[k]));
+        if (e > err) err = e;
+    }
+    return err > 0 ? 20.0 * log10(err / sqrt(peak)) : -300.0;
+}
+
+static float time_power(const audio_fft_plan_t *plan) {
+    uint32_t t0 = bench_now();
+    for (int i = 0; i < ITERATIONS; i++) audio_fft_power(plan, s_in, s_work, s_power);
+    return (float)(bench_now() - t0) / ITERATIONS;
+}
+
+static void bench_size(uint16_t n) {
+    audio_fft_plan_t plan, plan_q;
+    float *tw = malloc(n * sizeof(float));
+    if (!tw || !audio_fft_plan_init_kind(&plan, n, AUDIO_FFT_FLOAT)) {
+        REPORT("n=%u: out of memory  %s", n, verdict(false));
+        free(tw);
+        return;
+    }
+    if (!audio_fft_plan_init_kind(&plan_q, n, AUDIO_FFT_Q15)) {
+        REPORT("n=%u: out of memory  %s", n, verdict(false));
+        audio_fft_plan_free(&plan);
+        free(tw);
+        return;
+    }
+    for (int k = 0; k < n / 2; k++) {
+        tw[2 * k]     = (float)cos(-TWO_PI * k / n);
+        tw[2 * k + 1] = (float)sin(-TWO_PI * k / n);
+    }
+    make_input(n, 16384.0);
+
+    reference_power(&plan, s_in, s_ref);
+
+    uint32_t t0 = bench_now();
+    for (int i = 0; i < ITERATIONS; i++) radix2_power(&plan, tw, s_in, s_work, s_power);
+    float  t_old   = (float)(bench_now() - t0) / ITERATIONS;
+    double err_old = spectrum_error(n);
+
+    float  t_new   = time_power(&plan);
+    double err_new = spectrum_error(n);
+    float  t_q     = time_power(&plan_q);
+    double err_q   = spectrum_error(n);
+
+    bool ok = err_new <= MAX_ERR_F32_DB && err_q <= MAX_ERR_Q15_DB;
+    REPORT("n=%-5u radix-2 %8.0f " UNIT " (%4.0f dB)  f32 %8.0f " UNIT " (%4.0f dB)  x%.1f"
+           "  q15 %8.0f " UNIT " (%4.0f dB)  %s",
+           n, t_old, err_old, t_new, err_new, t_new > 0 ? t_old / t_new : 0.0f,
+           t_q, err_q, verdict(ok));
+
+    audio_fft_plan_free(&plan);
+    audio_fft_plan_free(&plan_q);
+    free(tw);
+}
+
+/* Tone power over the error power (all bins), dB */
+static double spectrum_snr(int n) {
+    double sig = 0, err = 0;
+    for (int k = 0; k < n / 2; k++) {
+        double e = sqrt(s_power[k]) - sqrt(s_ref[k]);
+        sig += s_ref[k];
+        err += e * e;
+    }
+    return err > 0 ? 10.0 * log10(sig / err) : 300.0;
+}
+
+static void bench_levels(void) {
+    const uint16_t n = 1024;
+    audio_fft_plan_t plan, plan_q;
+    if (!audio_fft_plan_init_kind(&plan, n, AUDIO_FFT_FLOAT)) {
+        REPORT("levels: out of memory  %s", verdict(false));
+        return;
+    }
+    if (!audio_fft_plan_init_kind(&plan_q, n, AUDIO_FFT_Q15)) {
+        REPORT("levels: out of memory  %s", verdict(false));
+        audio_fft_plan_free(&plan);
+        return;
+    }
+    for (int dbfs = -6; dbfs >= -66; dbfs -= 20) {
+        make_input(n, 32767.0 * pow(10.0, dbfs / 20.0));
+        reference_power(&plan, s_in, s_ref);
+        audio_fft_power(&plan, s_in, s_work, s_power);
+        double snr_f = spectrum_snr(n);
+        audio_fft_power(&plan_q, s_in, s_work, s_power);
+        double snr_q = spectrum_snr(n);
+        bool ok = snr_f >= MIN_SNR_F32_DB && snr_q >= MIN_SNR_Q15_DB;
+        REPORT("n=%-5u tone %3d dBFS  SNR f32 %5.1f dB  q15 %5.1f dB  %s",
+               n, dbfs, snr_f, snr_q, verdict(ok));
+    }
+    audio_fft_plan_free(&plan);
+    audio_fft_plan_free(&plan_q);
+}
+
+static void bench_db(void) {
+    double err = 0;
+    for (float p = 1e-12f; p < 1e9f; p *= 1.0137f) {
+        double e = fabs(audio_fft_db(p) - 10.0 * log10(p));
+        if (e > err) err = e;
+    }
+
+    volatile float sink = 0;
+    uint32_t t0 = bench_now();
+    for (int i = 1; i <= 1024; i++) sink += 10.0f * log10f((float)i * 0.37f);
+    float t_libm = (float)(bench_now() - t0) / 1024;
+    t0 = bench_now();
+    for (int i = 1; i <= 1024; i++) sink += audio_fft_db((float)i * 0.37f);
+    float t_fast = (float)(bench_now() - t0) / 1024;
+    (void)sink;
+
+    REPORT("dB      log10f %6.1f " UNIT "  fast %6.1f " UNIT "  (x%.1f)  max err %.4f dB  %s",
+           t_libm, t_fast, t_fast > 0 ? t_libm / t_fast : 0.0f, err,
+           verdict(err < MAX_ERR_LOG_DB));
+}
+
+bool audio_fft_bench_run(void) {
+    s_pass = true;
+    REPORT("audio FFT benchmark: %d transforms each, cost per transform", ITERATIONS);
+    for (uint16_t n = 64; n <= MAX_N; n *= 2) bench_size(n);
+    bench_levels();
+    bench_db();
+    REPORT("audio FFT accuracy: %s", s_pass ? "all within limits" : "LIMIT MISSED");
+    return s_pass;
+}
+
+#ifndef ESP_PLATFORM
+int main(void) {
+    return audio_fft_bench_run() ? 0 : 1;
+}
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Audio FSK implementation – tone synthesis, per-block tone energies,
+ * preamble search and symbol decisions.
+ */
+
+#include "audio_fsk.h"
+#include <math.h>
+#include <string.h>
+
+#define TWO_PI          6.28318530717958647692
+#define HISTORY_MASK    (AUDIO_FSK_HISTORY - 1)
+#define RAMP            32      /* Raised-cosine edge of each symbol, samples */
+#define SYNC_THRESHOLD  0.5f    /* Mean preamble tone share of its bank */
+#define HEADER_BYTES    2
+#define CRC_BYTES       2
+
+_Static_assert((AUDIO_FSK_HISTORY & HISTORY_MASK) == 0, "history must be a power of two");
+_Static_assert(AUDIO_FSK_BINS <= 2 * AUDIO_GOERTZEL_MAX_TONES, "two Goertzel banks");
+
+/* Tones chosen so that each appears once per bank and no two adjacent
+ * symbols are neighbours in frequency */
+static const uint8_t s_preamble[AUDIO_FSK_PREAMBLE] = { 0, 7, 3, 4, 1, 6, 2, 5 };
+
+/* Offset from AUDIO_FSK_FIRST_BIN of @p tone in the bank used by symbol @p k */
+static inline int tone_bin(uint32_t k, int tone) {
+    return tone * AUDIO_FSK_BANKS + (int)(k % AUDIO_FSK_BANKS);
+}
+
+static uint32_t data_symbols(size_t frame_len) {
+    return (uint32_t)((frame_len * 8 + AUDIO_FSK_BITS - 1) / AUDIO_FSK_BITS);
+}
+
+uint32_t audio_fsk_airtime(size_t len) {
+    return (AUDIO_FSK_PREAMBLE + data_symbols(HEADER_BYTES + len + CRC_BYTES)) * AUDIO_FSK_SYMBOL;
+}
+
+uint16_t audio_fsk_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)(crc << 1) ^ 0x1021 : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/* ── Transmitter ────────────────────────────────────────────────────────── */
+static int16_t s_sine[AUDIO_FSK_HOP];      /* One cycle, Q15 */
+static int16_t s_ramp[RAMP];                /* Rising edge, Q15 */
+static bool    s_tables_ready = false;
+
+static void init_tables(void) {
+    if (s_tables_ready) return;
+    for (int i = 0; i < AUDIO_FSK_HOP; i++) {
+        s_sine[i] = (int16_t)lround(32767.0 * sin(TWO_PI * i / AUDIO_FSK_HOP));
+    }
+    for (int i = 0; i < RAMP; i++) {
+        s_ramp[i] = (int16_t)lround(32767.0 * 0.5 * (1.0 - cos(TWO_PI * (i + 0.5) / (2 * RAMP))));
+    }
+    s_tables_ready = true;
+}
+
+bool audio_fsk_tx_init(audio_fsk_tx_t *tx, const uint8_t *data, size_t len, int16_t amplitude) {
+    memset(tx, 0, sizeof(*tx));
+    if (len > AUDIO_FSK_MAX_PAYLOAD) return false;
+    init_tables();
+
+    tx->frame[0] = (uint8_t)len;
+    tx->frame[1] = (uint8_t)~len;
+    if (len) memcpy(&tx->frame[HEADER_BYTES], data, len);
+    uint16_t crc = audio_fsk_crc16(tx->frame, HEADER_BYTES + len);
+    tx->frame[HEADER_BYTES + len]     = (uint8_t)(crc >> 8);
+    tx->frame[HEADER_BYTES + len + 1] = (uint8_t)crc;
+    tx->frame_len = (uint16_t)(HEADER_BYTES + len + CRC_BYTES);
+    tx->symbols   = (uint16_t)data_symbols(tx->frame_len);
+    tx->total     = audio_fsk_airtime(len);
+    tx->amplitude = amplitude;
+    return true;
+}
+
+/* Tone of data symbol @p i: AUDIO_FSK_BITS bits of the frame, MSB first */
+static int data_tone(const audio_fsk_tx_t *tx, uint32_t i) {
+    int tone = 0;
+    for (int b = 0; b < AUDIO_FSK_BITS; b++) {
+        uint32_t bit = i * AUDIO_FSK_BITS + b;
+        int v = bit < tx->frame_len * 8u ? (tx->frame[bit / 8] >> (7 - bit % 8)) & 1 : 0;
+        tone = (tone << 1) | v;
+    }
+    return tone;
+}
+
+size_t audio_fsk_tx_render(audio_fsk_tx_t *tx, int16_t *out, size_t max) {
+    size_t n = 0;
+    while (n < max && tx->pos < tx->total) {
+        uint32_t k    = tx->pos / AUDIO_FSK_SYMBOL;
+        uint32_t in   = tx->pos % AUDIO_FSK_SYMBOL;
+        int      tone = k < AUDIO_FSK_PREAMBLE ? s_preamble[k] : data_tone(tx, k - AUDIO_FSK_PREAMBLE);
+        uint32_t bin  = AUDIO_FSK_FIRST_BIN + tone_bin(k, tone);
+
+        /* Rest of this symbol: a whole number of cycles per hop, so the
+         * phase restarts at 0 on every symbol */
+        size_t run = AUDIO_FSK_SYMBOL - in;
+        if (run > max - n) run = max - n;
+        for (size_t j = 0; j < run; j++, in++) {
+            int32_t s = (int32_t)tx->amplitude * s_sine[(bin * in) % AUDIO_FSK_HOP] >> 15;
+            if (in < RAMP)                          s = s * s_ramp[in] >> 15;
+            else if (in >= AUDIO_FSK_SYMBOL - RAMP) s = s * s_ramp[AUDIO_FSK_SYMBOL - 1 - in] >> 15;
+            out[n++] = (int16_t)s;
+        }
+        tx->pos += (uint32_t)run;
+    }
+    return n;
+}
+
+/* ── Receiver ───────────────────────────────────────────────────────────── */
+bool audio_fsk_rx_init(audio_fsk_rx_t *rx) {
+    memset(rx, 0, sizeof(*rx));
+    for (int b = 0; b < 2; b++) {
+        audio_goertzel_config_t cfg = {
+            .sample_rate = AUDIO_SAMPLE_RATE,
+            .block_size  = AUDIO_FSK_HOP,
+            .count       = AUDIO_GOERTZEL_MAX_TONES,
+        };
+        for (int i = 0; i < AUDIO_GOERTZEL_MAX_TONES; i++) {
+            int bin = AUDIO_FSK_FIRST_BIN + b * AUDIO_GOERTZEL_MAX_TONES + i;
+            cfg.freq_hz[i] = (uint16_t)lround((double)bin * AUDIO_SAMPLE_RATE / AUDIO_FSK_HOP);
+        }
+        if (!audio_goertzel_init(&rx->bank[b], &cfg)) return false;
+    }
+    return true;
+}
+
+/* Energy of @p bin over the decision blocks of the symbol starting at @p hop */
+static float symbol_energy(const audio_fsk_rx_t *rx, uint32_t hop, int bin) {
+    float e = 0.0f;
+    for (uint32_t h = hop + 1; h < hop + AUDIO_FSK_HOPS_PER_SYM; h++) {
+        e += rx->energy[h & HISTORY_MASK][bin];
+    }
+    return e;
+}
+
+/* Strongest tone of symbol @p k, starting at @p hop */
+static int decide(const audio_fsk_rx_t *rx, uint32_t hop, uint32_t k) {
+    float best_e = -1.0f;
+    int   best = 0;
+    for (int t = 0; t < AUDIO_FSK_TONES; t++) {
+        float e = symbol_energy(rx, hop, tone_bin(k, t));
+        if (e > best_e) {
+            best_e = e;
+            best   = t;
+        }
+    }
+    return best;
+}
+
+/* Mean share of the expected tone over a preamble starting at @p hop */
+static float preamble_score(const audio_fsk_rx_t *rx, uint32_t hop) {
+    float score = 0.0f;
+    for (uint32_t k = 0; k < AUDIO_FSK_PREAMBLE; k++, hop += AUDIO_FSK_HOPS_PER_SYM) {
+        float sum = 0.0f;
+        for (int t = 0; t < AUDIO_FSK_TONES; t++) sum += symbol_energy(rx, hop, tone_bin(k, t));
+        if (sum > 0.0f) score += symbol_energy(rx, hop, tone_bin(k, s_preamble[k])) / sum;
+    }
+    return score / AUDIO_FSK_PREAMBLE;
+}
+
+/* Called with the index of each new block; locks on the best preamble
+ * offset once the offsets a symbol later have been compared */
+static void search(audio_fsk_rx_t *rx, uint32_t now) {
+    const uint32_t span = AUDIO_FSK_PREAMBLE * AUDIO_FSK_HOPS_PER_SYM;
+    if (now + 1 < span) return;
+    uint32_t start = now + 1 - span;
+    if (start < rx->search_from) return;
+
+    float score = preamble_score(rx, start);
+    if (score >= SYNC_THRESHOLD && score > rx->cand_score) {
+        rx->cand_score = score;
+        rx->cand_hop   = start;
+    }
+    if (rx->cand_score > 0.0f && start >= rx->cand_hop + AUDIO_FSK_HOPS_PER_SYM - 1) {
+        rx->locked     = true;
+        rx->score      = rx->cand_score;
+        rx->sym_hop    = rx->cand_hop + span;
+        rx->sym        = 0;
+        rx->need       = 0;
+        rx->bits       = 0;
+        rx->nbits      = 0;
+        rx->nbytes     = 0;
+        rx->cand_score = 0.0f;
+        rx->stats.syncs++;
+    }
+}
+
+static void unlock(audio_fsk_rx_t *rx) {
+    rx->locked      = false;
+    rx->search_from = rx->sym_hop;
+}
+
+/* Decide every symbol whose blocks have all arrived */
+static audio_fsk_result_t decode(audio_fsk_rx_t *rx) {
+    while (rx->locked && rx->sym_hop + AUDIO_FSK_HOPS_PER_SYM <= rx->hops) {
+        int tone = decide(rx, rx->sym_hop, AUDIO_FSK_PREAMBLE + rx->sym);
+        rx->sym++;
+        rx->sym_hop += AUDIO_FSK_HOPS_PER_SYM;
+        rx->bits   = (rx->bits << AUDIO_FSK_BITS) | (uint32_t)tone;
+        rx->nbits += AUDIO_FSK_BITS;
+        if (rx->nbits < 8) continue;
+
+        rx->nbits -= 8;
+        rx->frame[rx->nbytes++] = (uint8_t)(rx->bits >> rx->nbits);
+        rx->bits &= (1u << rx->nbits) - 1;
+
+        if (rx->nbytes == HEADER_BYTES) {
+            if ((rx->frame[0] ^ rx->frame[1]) != 0xFF) {
+                rx->stats.bad_header++;
+                unlock(rx);
+                return AUDIO_FSK_NONE;
+            }
+            rx->need = (uint16_t)(HEADER_BYTES + rx->frame[0] + CRC_BYTES);
+        }
+        if (rx->need && rx->nbytes == rx->need) {
+            uint16_t len = rx->frame[0];
+            uint16_t crc = (uint16_t)(rx->frame[HEADER_BYTES + len] << 8 | rx->frame[HEADER_BYTES + len + 1]);
+            memcpy(rx->data, &rx->frame[HEADER_BYTES], len);
+            rx->len = len;
+            /* Padding bits of the last symbol are dropped with it */
+            unlock(rx);
+            if (crc != audio_fsk_crc16(rx->frame, HEADER_BYTES + len)) {
+                rx->stats.bad_crc++;
+                return AUDIO_FSK_BAD_CRC;
+            }
+            rx->stats.frames++;
+            return AUDIO_FSK_FRAME;
+        }
+    }
+    return AUDIO_FSK_NONE;
+}
+
+audio_fsk_result_t audio_fsk_rx_feed(audio_fsk_rx_t *rx, const int16_t *hop) {
+    float *e = rx->energy[rx->hops & HISTORY_MASK];
+    for (int b = 0; b < 2; b++) {
+        bool done;
+        audio_goertzel_feed(&rx->bank[b], hop, AUDIO_FSK_HOP, &done);
+        for (int i = 0; i < AUDIO_GOERTZEL_MAX_TONES; i++) {
+            e[b * AUDIO_GOERTZEL_MAX_TONES + i] = (float)rx->bank[b].power[i];
+        }
+    }
+    uint32_t now = rx->hops++;
+
+    if (!rx->locked) search(rx, now);
+    return rx->locked ? decode(rx) : AUDIO_FSK_NONE;
+}
@@ -0,0 +1,95 @@
+/*
+ * Audio Goertzel implementation – integer recursion, per-block results.
+ */
+
+#include "audio_goertzel.h"
+#include <math.h>
+#include <string.h>
+
+#define TWO_PI  6.28318530717958647692
+
+bool audio_goertzel_init(audio_goertzel_t *g, const audio_goertzel_config_t *cfg) {
+    memset(g, 0, sizeof(*g));
+    if (cfg->count == 0 || cfg->count > AUDIO_GOERTZEL_MAX_TONES ||
+        cfg->block_size < 16 || cfg->sample_rate == 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < cfg->count; i++) {
+        double w = TWO_PI * cfg->freq_hz[i] / cfg->sample_rate;
+        if (cfg->freq_hz[i] == 0 || 2u * cfg->freq_hz[i] >= cfg->sample_rate) return false;
+        /* |s| ≤ block · 32768 / |sin ω|; keeping it below 2^30 also keeps
+         * the int64 power terms in finish_block() from overflowing */
+        if ((double)cfg->block_size * 32768.0 / fabs(sin(w)) >= 1073741824.0) return false;
+        g->coeff[i] = (int32_t)lround(2.0 * cos(w) * 16384.0);
+    }
+    g->block_size = cfg->block_size;
+    g->count      = cfg->count;
+    return true;
+}
+
+void audio_goertzel_reset(audio_goertzel_t *g) {
+    memset(g->s1, 0, sizeof(g->s1));
+    memset(g->s2, 0, sizeof(g->s2));
+    g->energy = 0;
+    g->pos    = 0;
+}
+
+/* ── Block end ──────────────────────────────────────────────────────────── */
+static void finish_block(audio_goertzel_t *g) {
+    /* N·E in units of 2^-16, so 2|X|² / that is the ratio in Q16 */
+    uint64_t denom = ((uint64_t)g->block_size * g->energy) >> 16;
+
+    for (uint8_t i = 0; i < g->count; i++) {
+        int64_t s1 = g->s1[i], s2 = g->s2[i];
+        int64_t p  = s1 * s1 + s2 * s2 - ((g->coeff[i] * s1 >> 14) * s2);
+        g->power[i]     = p > 0 ? (uint64_t)p : 0;
+        g->ratio_q16[i] = denom ? (uint32_t)(2 * g->power[i] / denom) : 0;
+    }
+    g->block_energy = g->energy;
+    g->blocks++;
+    audio_goertzel_reset(g);
+}
+
+/* ── Streaming ──────────────────────────────────────────────────────────── */
+size_t audio_goertzel_feed(audio_goertzel_t *g, const int16_t *samples, size_t count,
+                           bool *block_done) {
+    size_t take = g->block_size - g->pos;
+    if (take > count) take = count;
+    *block_done = false;
+    if (!g->block_size) return count;
+
+    for (uint8_t i = 0; i < g->count; i++) {
+        int32_t c = g->coeff[i], s1 = g->s1[i], s2 = g->s2[i];
+        for (size_t n = 0; n < take; n++) {
+            int32_t s0 = samples[n] + (int32_t)(((int64_t)c * s1) >> 14) - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        g->s1[i] = s1;
+        g->s2[i] = s2;
+    }
+    uint64_t e = 0;
+    for (size_t n = 0; n < take; n++) e += (int32_t)samples[n] * samples[n];
+    g->energy += e;
+    g->pos    += take;
+
+    if (g->pos == g->block_size) {
+        finish_block(g);
+        *block_done = true;
+    }
+    return take;
+}
+
+/* ── Levels ─────────────────────────────────────────────────────────────── */
+float audio_goertzel_dbfs(const audio_goertzel_t *g, uint8_t i) {
+    /* A full-scale sine on the filter gives |X| = N · 32767 / 2 */
+    double full = (double)g->block_size * 32767.0 / 2.0;
+    double p    = (double)g->power[i];
+    return p > 0 ? (float)(10.0 * log10(p / (full * full))) : -200.0f;
+}
+
+float audio_goertzel_block_dbfs(const audio_goertzel_t *g) {
+    /* Full-scale sine: mean square 32767² / 2 */
+    double ms = (double)g->block_energy / g->block_size;
+    return ms > 0 ? (float)(10.0 * log10(ms / (32767.0 * 32767.0 / 2.0))) : -200.0f;
+}
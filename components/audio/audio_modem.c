@@ -0,0 +1,185 @@
+/*
+ * Audio modem implementation – receiver task, frame queue and WAV output.
+ */
+
+#include "audio_modem.h"
+#include "audio_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "audio_modem"
+
+#define WAV_SILENCE     (AUDIO_SAMPLE_RATE / 4)     /* Each side of a file */
+#define WAV_CHUNK       256
+
+/* Task control */
+static TaskHandle_t  s_task = NULL;
+static volatile bool s_running = false;
+static QueueHandle_t s_queue = NULL;
+static audio_sub_t   s_sub;
+
+/* Receiver state, owned by the task while it runs */
+static audio_fsk_rx_t      s_rx;
+static audio_modem_stats_t s_stats;
+
+/* ── Task ───────────────────────────────────────────────────────────────── */
+_Static_assert(AUDIO_STREAM_BLOCK % AUDIO_FSK_HOP == 0, "stream blocks must hold whole hops");
+
+static void modem_task(void *arg) {
+    (void)arg;
+    static audio_block_t       block;
+    static audio_modem_frame_t frame;
+
+    ESP_LOGI(TAG, "Receiver started");
+
+    while (s_running) {
+        if (!audio_stream_read(&s_sub, &block, 100)) continue;
+
+        for (size_t i = 0; i < AUDIO_STREAM_BLOCK; i += AUDIO_FSK_HOP) {
+            s_stats.blocks++;
+            audio_fsk_result_t res = audio_fsk_rx_feed(&s_rx, &block.samples[i]);
+            if (res == AUDIO_FSK_BAD_CRC) {
+                ESP_LOGD(TAG, "Frame failed CRC (%u bytes)", s_rx.len);
+            }
+            if (res != AUDIO_FSK_FRAME) continue;
+
+            memcpy(frame.data, s_rx.data, s_rx.len);
+            frame.len          = s_rx.len;
+            frame.score        = s_rx.score;
+            frame.timestamp_us = block.timestamp_us +
+                                 (int64_t)(i + AUDIO_FSK_HOP) * 1000000 / AUDIO_SAMPLE_RATE;
+            if (xQueueSend(s_queue, &frame, 0) != pdTRUE) s_stats.dropped++;
+            ESP_LOGI(TAG, "Frame received (%u bytes, preamble %.2f)", frame.len, frame.score);
+        }
+    }
+
+    s_stats.overruns = s_sub.overruns;
+    audio_stream_unsubscribe(&s_sub);
+    ESP_LOGI(TAG, "Receiver stopped (%lu frames, %lu bad CRC, %lu dropped, %lu overruns)",
+             (unsigned long)s_rx.stats.frames, (unsigned long)s_rx.stats.bad_crc,
+             (unsigned long)s_stats.dropped, (unsigned long)s_stats.overruns);
+    s_task = NULL;  /* Clear handle before self-deleting */
+    vTaskDelete(NULL);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+bool audio_modem_start(void) {
+    if (s_running) return true;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    if (!audio_fsk_rx_init(&s_rx)) return false;
+
+    if (!s_queue) s_queue = xQueueCreate(AUDIO_MODEM_QUEUE_LEN, sizeof(audio_modem_frame_t));
+    if (!s_queue) return false;
+
+    audio_stream_start();
+    if (!audio_stream_subscribe(&s_sub)) {
+        ESP_LOGE(TAG, "No free audio stream slot");
+        return false;
+    }
+
+    s_running = true;
+    xTaskCreatePinnedToCore(
+        modem_task,
+        "audio_modem",
+        3072,
+        NULL,
+        5,
+        &s_task,
+        0  /* CPU0 */
+    );
+    return true;
+}
+
+void audio_modem_stop(void) {
+    if (!s_running) return;
+
+    s_running = false;
+
+    /* Wait for the task to actually finish (up to 500ms) */
+    for (int i = 0; i < 50 && s_task != NULL; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    if (s_task != NULL) {
+        ESP_LOGW(TAG, "Receiver task did not stop in time, forcing delete");
+        vTaskDelete(s_task);
+        s_task = NULL;
+        audio_stream_unsubscribe(&s_sub);
+    }
+    xQueueReset(s_queue);
+}
+
+bool audio_modem_running(void) {
+    return s_running;
+}
+
+bool audio_modem_receive(audio_modem_frame_t *frame, uint32_t timeout_ms) {
+    if (!s_queue) return false;
+    return xQueueReceive(s_queue, frame, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+void audio_modem_get_stats(audio_modem_stats_t *out) {
+    *out     = s_stats;
+    out->fsk = s_rx.stats;
+    if (s_running) out->overruns = s_sub.overruns;
+}
+
+/* ── WAV output ─────────────────────────────────────────────────────────── */
+static void put16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+bool audio_modem_write_wav(const char *path, const uint8_t *data, size_t len) {
+    static audio_fsk_tx_t tx;
+    static int16_t        chunk[WAV_CHUNK];
+
+    if (!audio_fsk_tx_init(&tx, data, len, AUDIO_MODEM_AMPLITUDE)) return false;
+    uint32_t samples = tx.total + 2 * WAV_SILENCE;
+    uint32_t bytes   = samples * sizeof(int16_t);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        ESP_LOGE(TAG, "Cannot create %s", path);
+        return false;
+    }
+
+    uint8_t h[44];
+    memcpy(h, "RIFF", 4);
+    put32(h + 4, 36 + bytes);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put32(h + 16, 16);
+    put16(h + 20, 1);
+    put16(h + 22, 1);
+    put32(h + 24, AUDIO_SAMPLE_RATE);
+    put32(h + 28, AUDIO_SAMPLE_RATE * sizeof(int16_t));
+    put16(h + 32, sizeof(int16_t));
+    put16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    put32(h + 40, bytes);
+    bool ok = fwrite(h, 1, sizeof(h), f) == sizeof(h);
+
+    /* Lead-in silence, the transmission, then trailing silence */
+    memset(chunk, 0, sizeof(chunk));
+    for (uint32_t n = 0; ok && n < WAV_SILENCE; n += WAV_CHUNK) {
+        size_t k = WAV_SILENCE - n < WAV_CHUNK ? WAV_SILENCE - n : WAV_CHUNK;
+        ok = fwrite(chunk, sizeof(int16_t), k, f) == k;
+    }
+    for (size_t k; ok && (k = audio_fsk_tx_render(&tx, chunk, WAV_CHUNK)) > 0; ) {
+        ok = fwrite(chunk, sizeof(int16_t), k, f) == k;
+    }
+    memset(chunk, 0, sizeof(chunk));
+    for (uint32_t n = 0; ok && n < WAV_SILENCE; n += WAV_CHUNK) {
+        size_t k = WAV_SILENCE - n < WAV_CHUNK ? WAV_SILENCE - n : WAV_CHUNK;
+        ok = fwrite(chunk, sizeof(int16_t), k, f) == k;
+    }
+
+    if (fclose(f) != 0) ok = false;
+    if (!ok) ESP_LOGE(TAG, "Write to %s failed", path);
+    else     ESP_LOGI(TAG, "Wrote %u byte message to %s (%.2f s)", (unsigned)len, path,
+                      (double)tx.total / AUDIO_SAMPLE_RATE);
+    return ok;
+}
@@ -0,0 +1,235 @@
+/*
+ * Audio onset implementation – spectral flux, adaptive threshold,
+ * autocorrelation tempo and the beat grid.
+ */
+
+#include "audio_onset.h"
+#include <math.h>
+#include <string.h>
+
+#define FLOOR_DB        (-70.0f)    /* Band levels below this count as silence */
+#define MIN_FLUX_DB     1.0f        /* Absolute onset floor */
+#define STAT_ALPHA      (1.0f / 64) /* Running mean / deviation, ~0.34 s */
+#define WARMUP_HOPS     32          /* Let the statistics settle first */
+#define REFRACTORY_HOPS 10          /* ~53 ms between onsets */
+#define PRIOR_BPM       120.0f
+#define PRIOR_OCTAVES   0.8f        /* Width of the tempo prior */
+#define LOCK_CONFIDENCE 0.2f
+#define ENV_POWER_FULL  0.4f        /* Mean envelope² (dB²) for full confidence */
+#define TEMPO_MATCH     0.06f       /* Relative period difference treated as "same" */
+#define GRID_TOLERANCE  0.2f        /* Fraction of a period around a grid point */
+#define GRID_PULL       0.5f        /* Share of a late onset's offset applied to the grid */
+#define PHASE_BEATS     4           /* Comb teeth for the phase search */
+
+bool audio_onset_init(audio_onset_t *o) {
+    memset(o, 0, sizeof(*o));
+    if (!audio_fft_plan_init(&o->plan, AUDIO_ONSET_FFT)) return false;
+    /* Kick drums to hi-hats; mel spacing keeps the low bands narrow */
+    audio_bands_build(&o->bands, AUDIO_SCALE_MEL, AUDIO_ONSET_BANDS, AUDIO_ONSET_FFT, 40, 16000);
+    for (int b = 0; b < AUDIO_ONSET_BANDS; b++) o->band_db[b] = FLOOR_DB;
+    return true;
+}
+
+void audio_onset_free(audio_onset_t *o) {
+    audio_fft_plan_free(&o->plan);
+}
+
+bool audio_onset_locked(const audio_onset_t *o) {
+    return o->period > 0 && o->confidence >= LOCK_CONFIDENCE;
+}
+
+/* ── Onsets ─────────────────────────────────────────────────────────────── */
+static float spectral_flux(audio_onset_t *o, const int16_t *hop) {
+    float band[AUDIO_ONSET_BANDS];
+
+    memmove(o->frame, o->frame + AUDIO_ONSET_HOP,
+            (AUDIO_ONSET_FFT - AUDIO_ONSET_HOP) * sizeof(int16_t));
+    memcpy(o->frame + AUDIO_ONSET_FFT - AUDIO_ONSET_HOP, hop, AUDIO_ONSET_HOP * sizeof(int16_t));
+    audio_fft_power(&o->plan, o->frame, o->work, o->power);
+    audio_bands_aggregate(&o->bands, o->power, band);
+
+    /* Only rises count: decays and steady tones add nothing */
+    float flux = 0;
+    for (int b = 0; b < o->bands.count; b++) {
+        float db = audio_bands_dbfs(&o->bands, band[b]);
+        if (db < FLOOR_DB) db = FLOOR_DB;
+        if (db > o->band_db[b]) flux += db - o->band_db[b];
+        o->band_db[b] = db;
+    }
+    return o->bands.count ? flux / o->bands.count : 0;
+}
+
+/* ── Tempo ──────────────────────────────────────────────────────────────── */
+/* Autocorrelation of the envelope over the beat-period lags; returns the
+ * best period in hops (0 if the envelope is empty) and its confidence */
+static float estimate_period(audio_onset_t *o, float *confidence) {
+    float   *score = o->acf;
+    uint32_t head  = o->hops + 1;               /* Oldest entry in the ring */
+    float r0 = 0, r_sum = 0;
+    int   best = 0;
+
+    for (int i = 0; i < AUDIO_ONSET_HISTORY; i++) {
+        float e = o->env[i];
+        r0 += e * e;
+    }
+    *confidence = 0;
+    if (r0 <= 0) return 0;
+
+    for (int lag = AUDIO_ONSET_LAG_MIN; lag <= AUDIO_ONSET_LAG_MAX + 1; lag++) {
+        float r = 0;
+        for (int i = lag; i < AUDIO_ONSET_HISTORY; i++) {
+            r += o->env[(head + i) & (AUDIO_ONSET_HISTORY - 1)] *
+                 o->env[(head + i - lag) & (AUDIO_ONSET_HISTORY - 1)];
+        }
+        /* Normalise for the shrinking overlap */
+        r *= (float)AUDIO_ONSET_HISTORY / (AUDIO_ONSET_HISTORY - lag);
+        score[lag] = r;
+        if (lag <= AUDIO_ONSET_LAG_MAX) r_sum += r;
+    }
+
+    float best_w = -1;
+    for (int lag = AUDIO_ONSET_LAG_MIN; lag <= AUDIO_ONSET_LAG_MAX; lag++) {
+        float bpm = 60.0f * AUDIO_ONSET_RATE / lag;
+        float oct = log2f(bpm / PRIOR_BPM) / PRIOR_OCTAVES;
+        float w   = score[lag] * expf(-0.5f * oct * oct);
+        if (w > best_w) {
+            best_w = w;
+            best   = lag;
+        }
+    }
+
+    /* How far the peak stands out, scaled down for a faint envelope: a pad
+     * or noise can be periodic, but it has no beat */
+    float r_mean = r_sum / (AUDIO_ONSET_LAG_MAX - AUDIO_ONSET_LAG_MIN + 1);
+    float c = (score[best] - r_mean) / (r0 - r_mean + 1e-9f);
+    float energy = r0 / AUDIO_ONSET_HISTORY;
+    if (energy < ENV_POWER_FULL) c *= energy / ENV_POWER_FULL;
+    *confidence = c < 0 ? 0 : c > 1 ? 1 : c;
+
+    /* Parabolic interpolation between the neighbouring lags */
+    float period = best;
+    if (best > AUDIO_ONSET_LAG_MIN) {
+        float a = score[best - 1], b = score[best], d = score[best + 1];
+        float den = a - 2 * b + d;
+        if (den < 0) period += 0.5f * (a - d) / den;
+    }
+    return period;
+}
+
+static void update_period(audio_onset_t *o, float period) {
+    if (o->period > 0 && fabsf(period / o->period - 1) < TEMPO_MATCH) {
+        o->period += 0.25f * (period - o->period);
+        o->pending = 0;
+    } else if (o->period == 0 ||
+               (o->pending > 0 && fabsf(period / o->pending - 1) < TEMPO_MATCH)) {
+        /* First estimate, or a new tempo seen twice running */
+        o->period  = period;
+        o->pending = 0;
+    } else {
+        o->pending = period;
+    }
+}
+
+/* Hops since the strongest beat position: the comb offset (over the last
+ * PHASE_BEATS periods, three hops per tooth) collecting the most envelope */
+static int estimate_phase(const audio_onset_t *o) {
+    int   p = (int)(o->period + 0.5f), best = 0;
+    float best_sum = -1;
+    for (int phi = 0; phi < p; phi++) {
+        float sum = 0;
+        for (int k = 0; k < PHASE_BEATS; k++) {
+            int back = phi + (int)(k * o->period + 0.5f);
+            if (back + 1 >= AUDIO_ONSET_HISTORY) break;
+            for (int j = back - 1; j <= back + 1; j++) {
+                if (j >= 0) sum += o->env[(o->hops - j) & (AUDIO_ONSET_HISTORY - 1)];
+            }
+        }
+        if (sum > best_sum) {
+            best_sum = sum;
+            best     = phi;
+        }
+    }
+    return best;
+}
+
+static void update_tempo(audio_onset_t *o) {
+    float conf;
+    float period = estimate_period(o, &conf);
+    o->confidence += 0.5f * (conf - o->confidence);
+    if (period <= 0) return;
+
+    update_period(o, period);
+    if (!audio_onset_locked(o)) return;
+
+    /* Re-anchor the grid if it drifted onto the wrong phase */
+    float phi  = (float)estimate_phase(o);
+    float grid = o->have_beat ? fmodf(o->hops - o->last_beat, o->period) : phi;
+    float diff = fabsf(grid - phi);
+    if (diff > o->period - diff) diff = o->period - diff;
+    if (!o->have_beat || diff > GRID_TOLERANCE * o->period) {
+        o->last_beat = (float)o->hops - phi;
+        o->have_beat = true;
+    }
+}
+
+/* ── Beat grid ──────────────────────────────────────────────────────────── */
+static void track_beat(audio_onset_t *o, bool onset, audio_onset_result_t *r) {
+    float now   = (float)o->hops;
+    float since = o->have_beat ? now - o->last_beat : 1e9f;
+
+    if (!audio_onset_locked(o)) {
+        if (onset && since >= AUDIO_ONSET_LAG_MIN) {
+            r->beat = true;
+            o->last_beat = now;
+            o->have_beat = true;
+        }
+        return;
+    }
+
+    float p = o->period;
+    if (onset) {
+        if (since >= (1 - GRID_TOLERANCE) * p) {
+            r->beat = true;
+            o->last_beat = now;
+            o->have_beat = true;
+        } else if (since <= GRID_TOLERANCE * p) {
+            o->last_beat += GRID_PULL * since;      /* Grid ran slightly early */
+        }
+    } else if (since >= p) {
+        r->beat      = true;
+        r->predicted = true;
+        o->last_beat = since < 2 * p ? o->last_beat + p : now;
+        o->have_beat = true;
+    }
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+void audio_onset_process(audio_onset_t *o, const int16_t *hop, audio_onset_result_t *r) {
+    memset(r, 0, sizeof(*r));
+    float flux = spectral_flux(o, hop);
+    r->flux = flux;
+
+    float thresh = o->mean + AUDIO_ONSET_THRESH_K * o->dev + MIN_FLUX_DB;
+    if (o->hops >= WARMUP_HOPS && flux > thresh &&
+        o->hops - o->last_onset >= REFRACTORY_HOPS) {
+        r->onset    = true;
+        r->strength = (flux - o->mean) / (o->dev + 1e-3f);
+        o->last_onset = o->hops;
+    }
+
+    /* Envelope for the tempo search: flux more than one deviation above its
+     * mean, so steady material (pads, noise) leaves it near zero */
+    float e = flux - o->mean - o->dev;
+    o->env[o->hops & (AUDIO_ONSET_HISTORY - 1)] = e > 0 ? e : 0;
+    o->mean += STAT_ALPHA * (flux - o->mean);
+    o->dev  += STAT_ALPHA * (fabsf(flux - o->mean) - o->dev);
+
+    if (o->hops >= AUDIO_ONSET_HISTORY / 2 && o->hops % AUDIO_ONSET_TEMPO_EVERY == 0) {
+        update_tempo(o);
+    }
+
+    track_beat(o, r->onset, r);
+    r->bpm        = o->period > 0 ? 60.0f * AUDIO_ONSET_RATE / o->period : 0;
+    r->confidence = o->confidence;
+    o->hops++;
+}
@@ -0,0 +1,350 @@
+/*
+ * Audio recorder implementation – capture/writer tasks and WAV layout.
+ */
+
+#include "audio_recorder.h"
+#include "audio_adpcm.h"
+#include "audio_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TAG "audio_rec"
+
+typedef struct {
+    int8_t   buf;           /* Buffer index, -1 = end of recording */
+    uint16_t len;
+} rec_chunk_t;
+
+/* Task control */
+static TaskHandle_t  s_capture = NULL;
+static TaskHandle_t  s_writer  = NULL;
+static volatile bool s_running = false;
+static QueueHandle_t s_free_q  = NULL;     /* Empty buffer indices */
+static QueueHandle_t s_full_q  = NULL;     /* rec_chunk_t for the writer */
+static audio_sub_t   s_sub;
+
+/* Recording state */
+static audio_rec_config_t s_cfg;
+static char               s_path[64];
+static int                s_fd = -1;
+static uint8_t           *s_buf[AUDIO_REC_BUFFERS];
+static uint32_t           s_capacity;       /* Data bytes pre-allocated */
+static audio_rec_stats_t  s_stats;
+static int64_t            s_synced_us;      /* Writer only: last fsync */
+
+/* Capture task only */
+static int8_t        s_cur = -1;            /* Buffer being filled, -1 = none */
+static uint32_t      s_fill;
+static uint32_t      s_queued;              /* Data bytes handed to the writer */
+static audio_adpcm_t s_adpcm;
+
+uint32_t audio_recorder_bytes_per_second(audio_rec_format_t format) {
+    if (format == AUDIO_REC_IMA_ADPCM) {
+        return (uint32_t)(((uint64_t)AUDIO_SAMPLE_RATE * AUDIO_ADPCM_BLOCK_ALIGN +
+                           AUDIO_ADPCM_BLOCK_SAMPLES / 2) / AUDIO_ADPCM_BLOCK_SAMPLES);
+    }
+    return AUDIO_SAMPLE_RATE * sizeof(audio_sample_t);
+}
+
+/* ── WAV header ─────────────────────────────────────────────────────────── */
+static void put16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+/* RIFF, fmt (+ fact for ADPCM), JUNK padding, then "data" in the last 8 bytes */
+static void build_header(uint8_t *h, uint32_t data_bytes, uint32_t samples) {
+    bool     adpcm = s_cfg.format == AUDIO_REC_IMA_ADPCM;
+    uint8_t *p     = h;
+    uint8_t *data  = h + AUDIO_REC_HEADER - 8;
+
+    memset(h, 0, AUDIO_REC_HEADER);
+    memcpy(p, "RIFF", 4);
+    put32(p + 4, AUDIO_REC_HEADER - 8 + data_bytes);
+    memcpy(p + 8, "WAVE", 4);
+    p += 12;
+
+    memcpy(p, "fmt ", 4);
+    put32(p + 4,  adpcm ? 20 : 16);
+    put16(p + 8,  adpcm ? 0x11 : 1);
+    put16(p + 10, 1);
+    put32(p + 12, AUDIO_SAMPLE_RATE);
+    put32(p + 16, audio_recorder_bytes_per_second(s_cfg.format));
+    put16(p + 20, adpcm ? AUDIO_ADPCM_BLOCK_ALIGN : sizeof(audio_sample_t));
+    put16(p + 22, adpcm ? 4 : 16);
+    if (adpcm) {
+        put16(p + 24, 2);
+        put16(p + 26, AUDIO_ADPCM_BLOCK_SAMPLES);
+        p += 28;
+        memcpy(p, "fact", 4);
+        put32(p + 4, 4);
+        put32(p + 8, samples);
+        p += 12;
+    } else {
+        p += 24;
+    }
+
+    memcpy(p, "JUNK", 4);
+    put32(p + 4, (uint32_t)(data - p - 8));
+    memcpy(data, "data", 4);
+    put32(data + 4, data_bytes);
+}
+
+static uint32_t samples_in(uint32_t data_bytes) {
+    if (s_cfg.format == AUDIO_REC_IMA_ADPCM) {
+        return data_bytes / AUDIO_ADPCM_BLOCK_ALIGN * AUDIO_ADPCM_BLOCK_SAMPLES;
+    }
+    return data_bytes / sizeof(audio_sample_t);
+}
+
+/* ── Writer task ────────────────────────────────────────────────────────── */
+/* Patch the header with the real sizes and drop the unused pre-allocation */
+static void finalise(void) {
+    uint32_t samples = s_stats.bytes == s_queued ? s_stats.samples : samples_in(s_stats.bytes);
+
+    build_header(s_buf[0], s_stats.bytes, samples);
+    if (lseek(s_fd, 0, SEEK_SET) != 0 ||
+        write(s_fd, s_buf[0], AUDIO_REC_HEADER) != AUDIO_REC_HEADER ||
+        ftruncate(s_fd, AUDIO_REC_HEADER + s_stats.bytes) != 0 ||
+        fsync(s_fd) != 0) {
+        ESP_LOGE(TAG, "Failed to finalise %s", s_cfg.path);
+        s_stats.write_error = true;
+    }
+    close(s_fd);
+    s_fd = -1;
+
+    for (int i = 0; i < AUDIO_REC_BUFFERS; i++) {
+        free(s_buf[i]);
+        s_buf[i] = NULL;
+    }
+}
+
+static void writer_task(void *arg) {
+    (void)arg;
+    rec_chunk_t c;
+
+    for (;;) {
+        xQueueReceive(s_full_q, &c, portMAX_DELAY);
+        if (c.buf < 0) break;
+
+        if (!s_stats.write_error) {
+            int64_t t0 = esp_timer_get_time();
+            ssize_t n  = write(s_fd, s_buf[c.buf], c.len);
+            uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+            bool     ok = n == c.len;
+            if (ok) {
+                s_stats.bytes += c.len;
+                s_stats.chunks++;
+                if (us > s_stats.max_write_us) s_stats.max_write_us = us;
+            }
+            /* Commit data and FAT now and then, so a reset loses little */
+            if (ok && t0 - s_synced_us >= AUDIO_REC_SYNC_MS * 1000LL) {
+                ok = fsync(s_fd) == 0;
+                s_synced_us = t0;
+            }
+            if (!ok) {
+                ESP_LOGE(TAG, "Write failed after %lu bytes", (unsigned long)s_stats.bytes);
+                s_stats.write_error = true;
+                s_running = false;
+            }
+        }
+        xQueueSend(s_free_q, &c.buf, 0);
+    }
+
+    finalise();
+    ESP_LOGI(TAG, "Saved %s: %lu samples, %lu bytes, %lu chunks (max %lu us), "
+             "%lu dropped, %lu overruns",
+             s_cfg.path, (unsigned long)s_stats.samples, (unsigned long)s_stats.bytes,
+             (unsigned long)s_stats.chunks, (unsigned long)s_stats.max_write_us,
+             (unsigned long)s_stats.dropped_blocks, (unsigned long)s_stats.overruns);
+    s_stats.active = false;
+    s_writer = NULL;  /* Clear handle before self-deleting */
+    vTaskDelete(NULL);
+}
+
+/* ── Capture task ───────────────────────────────────────────────────────── */
+static void send_chunk(void) {
+    rec_chunk_t c = { .buf = s_cur, .len = (uint16_t)s_fill };
+    xQueueSend(s_full_q, &c, portMAX_DELAY);    /* Never full: one slot per buffer + end */
+    s_queued += s_fill;
+    s_cur  = -1;
+    s_fill = 0;
+}
+
+/* Append samples to the current chunk; chunks always end on ADPCM block
+ * boundaries.  With no free buffer the rest of the stream block is lost. */
+static void append(const audio_sample_t *s, size_t n) {
+    while (n && s_queued < s_capacity) {
+        if (s_cur < 0 && xQueueReceive(s_free_q, &s_cur, 0) != pdTRUE) {
+            s_cur = -1;
+            s_stats.dropped_blocks++;
+            return;
+        }
+
+        uint8_t *buf = s_buf[s_cur];
+        size_t   used;
+        if (s_cfg.format == AUDIO_REC_IMA_ADPCM) {
+            used = audio_adpcm_encode(&s_adpcm, s, n, buf + s_fill);
+            if (s_adpcm.pos == 0) s_fill += AUDIO_ADPCM_BLOCK_ALIGN;
+        } else {
+            used = (AUDIO_REC_CHUNK - s_fill) / sizeof(audio_sample_t);
+            if (used > n) used = n;
+            memcpy(buf + s_fill, s, used * sizeof(audio_sample_t));
+            s_fill += used * sizeof(audio_sample_t);
+        }
+        s += used;
+        n -= used;
+        s_stats.samples += used;
+
+        if (s_fill == AUDIO_REC_CHUNK) send_chunk();
+    }
+}
+
+static void capture_task(void *arg) {
+    (void)arg;
+    static audio_block_t block;
+
+    while (s_running && s_queued < s_capacity) {
+        if (!audio_stream_read(&s_sub, &block, 100)) continue;
+        append(block.samples, AUDIO_STREAM_BLOCK);
+        s_stats.overruns = s_sub.overruns;
+    }
+
+    /* Flush the partial chunk, padding an open ADPCM block */
+    if (s_cur >= 0) {
+        if (s_cfg.format == AUDIO_REC_IMA_ADPCM &&
+            audio_adpcm_finish(&s_adpcm, s_buf[s_cur] + s_fill)) {
+            s_fill += AUDIO_ADPCM_BLOCK_ALIGN;
+        }
+        if (s_fill) send_chunk();
+        else xQueueSend(s_free_q, &s_cur, 0);
+    }
+    rec_chunk_t end = { .buf = -1 };
+    xQueueSend(s_full_q, &end, portMAX_DELAY);
+
+    s_stats.overruns = s_sub.overruns;
+    audio_stream_unsubscribe(&s_sub);
+    s_running = false;
+    s_capture = NULL;  /* Clear handle before self-deleting */
+    vTaskDelete(NULL);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+bool audio_recorder_start(const audio_rec_config_t *cfg) {
+    if (s_stats.active) {
+        ESP_LOGW(TAG, "Already recording %s", s_cfg.path);
+        return false;
+    }
+    uint32_t capacity = cfg->max_bytes > AUDIO_REC_HEADER
+                      ? (cfg->max_bytes - AUDIO_REC_HEADER) / AUDIO_REC_CHUNK * AUDIO_REC_CHUNK : 0;
+    if (capacity == 0) {
+        ESP_LOGE(TAG, "No room to record (%lu bytes)", (unsigned long)cfg->max_bytes);
+        return false;
+    }
+
+    if (!s_free_q) s_free_q = xQueueCreate(AUDIO_REC_BUFFERS, sizeof(int8_t));
+    if (!s_full_q) s_full_q = xQueueCreate(AUDIO_REC_BUFFERS + 1, sizeof(rec_chunk_t));
+    if (!s_free_q || !s_full_q) return false;
+    xQueueReset(s_free_q);
+    xQueueReset(s_full_q);
+
+    for (int8_t i = 0; i < AUDIO_REC_BUFFERS; i++) {
+        s_buf[i] = malloc(AUDIO_REC_CHUNK);
+        if (!s_buf[i]) {
+            ESP_LOGE(TAG, "Out of memory for chunk buffers");
+            for (int j = 0; j < i; j++) { free(s_buf[j]); s_buf[j] = NULL; }
+            return false;
+        }
+        xQueueSend(s_free_q, &i, 0);
+    }
+
+    snprintf(s_path, sizeof(s_path), "%s", cfg->path);
+    s_cfg      = *cfg;
+    s_cfg.path = s_path;
+    s_capacity = capacity;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.format   = cfg->format;
+    s_stats.capacity = capacity;
+    s_cur    = -1;
+    s_fill   = 0;
+    s_queued = 0;
+    audio_adpcm_init(&s_adpcm);
+
+    /* Allocate every cluster now, then write a header covering all of them */
+    s_fd = open(cfg->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = s_fd >= 0 &&
+              lseek(s_fd, AUDIO_REC_HEADER + capacity, SEEK_SET) == (off_t)(AUDIO_REC_HEADER + capacity) &&
+              lseek(s_fd, 0, SEEK_SET) == 0;
+    if (ok) {
+        build_header(s_buf[0], capacity, samples_in(capacity));
+        ok = write(s_fd, s_buf[0], AUDIO_REC_HEADER) == AUDIO_REC_HEADER &&
+             fsync(s_fd) == 0;  /* Size and header on flash before any audio */
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "Cannot create %s (%lu bytes)", cfg->path,
+                 (unsigned long)(AUDIO_REC_HEADER + capacity));
+        if (s_fd >= 0) close(s_fd);
+        s_fd = -1;
+        for (int i = 0; i < AUDIO_REC_BUFFERS; i++) { free(s_buf[i]); s_buf[i] = NULL; }
+        return false;
+    }
+
+    audio_stream_start();
+    if (!audio_stream_subscribe(&s_sub)) {
+        ESP_LOGE(TAG, "No free audio stream slot");
+        close(s_fd);
+        s_fd = -1;
+        unlink(cfg->path);
+        for (int i = 0; i < AUDIO_REC_BUFFERS; i++) { free(s_buf[i]); s_buf[i] = NULL; }
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Recording %s (%s, %lu s max)", cfg->path,
+             cfg->format == AUDIO_REC_IMA_ADPCM ? "IMA ADPCM" : "PCM16",
+             (unsigned long)(capacity / audio_recorder_bytes_per_second(cfg->format)));
+
+    s_stats.active = true;
+    s_running = true;
+    s_synced_us = esp_timer_get_time();
+    xTaskCreatePinnedToCore(
+        writer_task,
+        "audio_rec_wr",
+        3072,
+        NULL,
+        2,          /* Below the UI: flash stalls only delay this task */
+        &s_writer,
+        0  /* CPU0 */
+    );
+    xTaskCreatePinnedToCore(
+        capture_task,
+        "audio_rec",
+        3072,
+        NULL,
+        5,
+        &s_capture,
+        0  /* CPU0 */
+    );
+    return true;
+}
+
+/* The capture task sees this within one stream read (100 ms), flushes its
+ * partial chunk and queues the end marker; the writer then finalises */
+void audio_recorder_stop(void) {
+    if (!s_stats.active || !s_running) return;
+    s_running = false;
+    ESP_LOGI(TAG, "Stopping %s", s_cfg.path);
+}
+
+bool audio_recorder_active(void) {
+    return s_stats.active;
+}
+
+void audio_recorder_get_stats(audio_rec_stats_t *out) {
+    *out = s_stats;
+}
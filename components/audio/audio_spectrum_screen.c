@@ -4,12 +4,15 @@
 
 #include "audio_spectrum_screen.h"
 #include "audio.h"
+#include "audio_stream.h"
+#include "audio_beat.h"
 #include "st7789.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
 #include <string.h>
-#include <math.h>
 
 #define TAG "audio_spectrum"
 
@@ -19,33 +22,156 @@
 #define SPECTRUM_W      312     /* 320 - 2*4 px margins */
 #define SPECTRUM_H      110     /* Height of spectrum area */
 #define BAR_WIDTH       3       /* Width of each frequency bar */
-#define BAR_SPACING     0       /* Gap between bars */
-#define MAX_DISPLAY_BINS 107    /* Display up to 20 kHz (20000/187.5 ≈ 107) */
+
+/* Beat indicator: tempo after the title, a flashing square far right */
+#define BEAT_TEXT_X     200
+#define BEAT_DOT_X      304
+#define BEAT_FLASH_US   100000
+
+/* Waterfall layout: a fixed label strip on the left, the rest scrolls */
+#define WF_AXIS_W       32
+#define WF_SCROLL_W     (ST7789_WIDTH - WF_AXIS_W)
+#define WF_H            ST7789_HEIGHT
 
 /* Colors */
 #define COLOR_BG        0x0000  /* Black */
 #define COLOR_TEXT      0xFFFF  /* White */
 #define COLOR_GRID      0x4208  /* Dark gray */
 #define COLOR_SPECTRUM  0x07E0  /* Green */
+#define COLOR_PEAK      0xAFE0  /* Bright green */
+#define COLOR_MAX_HOLD  0x041F  /* Dark blue */
+
+/* Delta renderer tuning */
+#define RUN_MERGE_GAP   6       /* Unchanged rows bridged inside one bar */
+#define MAX_RUNS        4       /* Dirty runs tracked per bar */
+#define WINDOW_COST_PX  96      /* set_window overhead, in pixel-equivalents */
+#define WINDOW_MAX_PX   4096    /* Largest batched window (8 KB buffer) */
 
 /* Task control */
 static TaskHandle_t s_audio_task = NULL;
 static volatile bool s_audio_task_running = false;
 
+/* Analyzer settings: written by the input task, applied by the capture task */
+static audio_analyzer_config_t s_cfg = AUDIO_ANALYZER_DEFAULT_CONFIG();
+static volatile bool s_reconfigure = true;
+static portMUX_TYPE  s_cfg_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /* Draw state – reset on init */
 static bool s_title_drawn = false;
-static uint8_t s_last_spectrum[AUDIO_FREQ_BINS];
+static int  s_hold_drawn = -1;              /* HOLD indicator on screen */
+static int  s_bpm_drawn = -1;               /* Tempo shown, 0 = none */
+static int  s_flash_drawn = -1;             /* Beat square lit */
+
+/* What each bar column currently shows, in rows of the spectrum area */
+typedef struct {
+    uint8_t bar;        /* Green height */
+    uint8_t max;        /* Max-hold height (0 = off) */
+    uint8_t peak;       /* Peak marker row + 1 (0 = none) */
+} bar_state_t;
+
+static bar_state_t s_bar_state[AUDIO_SPECTRUM_BARS];
+
+/* Bar-view SPI accounting, logged when the screen is left */
+static uint32_t s_bar_frames, s_bar_windows, s_bar_pixels;
+static audio_analyzer_stats_t s_last_stats;
+static int s_axis_scale = -1;
+static bool s_drawn_waterfall = false;      /* View the screen is set up for */
+
+/* Waterfall state */
+static uint16_t s_wf_lut[256];              /* Magnitude → RGB565, wire byte order */
+static uint8_t  s_wf_row_bar[WF_H];         /* Screen row → bar index */
+static uint16_t s_wf_pos;                   /* Next column in the scroll ring */
+static uint32_t s_wf_frame;                 /* Last spectrum frame drawn */
+
+/* Black → blue → magenta → yellow-red → white heat map */
+static void build_wf_lut(void) {
+    for (int t = 0; t < 256; t++) {
+        int q = t & 63, r, g, b;
+        switch (t >> 6) {
+        case 0:  r = 0;       g = 0;       b = q * 4;         break;
+        case 1:  r = q * 4;   g = 0;       b = 255;           break;
+        case 2:  r = 255;     g = q * 4;   b = 255 - q * 4;   break;
+        default: r = 255;     g = 255;     b = q * 4;         break;
+        }
+        uint16_t c = RGB565(r, g, b);
+        s_wf_lut[t] = (c >> 8) | (c << 8);
+    }
+}
 
 void audio_spectrum_screen_init(audio_spectrum_screen_t *screen) {
     memset(screen, 0, sizeof(*screen));
     /* Reset draw state so everything is redrawn on next entry */
     s_title_drawn = false;
-    memset(s_last_spectrum, 0, sizeof(s_last_spectrum));
+    memset(&s_last_stats, 0, sizeof(s_last_stats));
+    s_axis_scale = -1;
+    s_drawn_waterfall = false;
+    if (!s_wf_lut[255]) build_wf_lut();
+}
+
+void audio_spectrum_toggle_view(audio_spectrum_screen_t *screen) {
+    screen->waterfall = !screen->waterfall;
+    ESP_LOGI(TAG, "%s view", screen->waterfall ? "Waterfall" : "Bar");
+}
+
+void audio_spectrum_cycle_scale(void) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    /* Linear → 1/3-octave → mel (custom maps are for API users) */
+    s_cfg.scale = (audio_band_scale_t)((s_cfg.scale + 1) % AUDIO_SCALE_CUSTOM);
+    s_reconfigure = true;
+    portEXIT_CRITICAL(&s_cfg_lock);
+}
+
+void audio_spectrum_toggle_fft_kind(void) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    s_cfg.kind = s_cfg.kind == AUDIO_FFT_Q15 ? AUDIO_FFT_FLOAT : AUDIO_FFT_Q15;
+    s_reconfigure = true;
+    portEXIT_CRITICAL(&s_cfg_lock);
+}
+
+/* Frequency labels above the bars, placed along the current scale */
+static void draw_axis(audio_band_scale_t scale) {
+    static const struct { uint16_t hz; const char *text; } lin[] = {
+        { 0, "DC" }, { 5000, "5k" }, { 10000, "10k" }, { 15000, "15k" }, { 20000, "20k" },
+    }, log[] = {
+        { 20, "20" }, { 100, "100" }, { 500, "500" }, { 1000, "1k" },
+        { 5000, "5k" }, { 10000, "10k" }, { 20000, "20k" },
+    };
+    const bool linear = (scale == AUDIO_SCALE_LINEAR);
+    const int  count  = linear ? (int)(sizeof(lin) / sizeof(lin[0])) : (int)(sizeof(log) / sizeof(log[0]));
+    uint16_t f_lo, f_hi;
+    audio_analyzer_axis(scale, &f_lo, &f_hi);
+
+    st7789_fill_rect(0, SPECTRUM_Y - 12, 320, 8, COLOR_BG);
+    for (int i = 0; i < count; i++) {
+        uint16_t    hz   = linear ? lin[i].hz : log[i].hz;
+        const char *text = linear ? lin[i].text : log[i].text;
+        int w = (int)strlen(text) * 8;
+        int x = SPECTRUM_X + (int)(audio_bands_position(scale, f_lo, f_hi, hz) *
+                                   AUDIO_SPECTRUM_BARS * BAR_WIDTH) - w / 2;
+        if (x < SPECTRUM_X) x = SPECTRUM_X;
+        if (x > 320 - w) x = 320 - w;
+        st7789_draw_string(x, SPECTRUM_Y - 12, text, COLOR_GRID, COLOR_BG, 1);
+    }
+}
+
+void audio_spectrum_adjust(int size_step, int overlap_step) {
+    portENTER_CRITICAL(&s_cfg_lock);
+    uint16_t n = s_cfg.fft_size;
+    if (size_step > 0 && n < AUDIO_ANALYZER_MAX_N) n *= 2;
+    if (size_step < 0 && n > AUDIO_ANALYZER_MIN_N) n /= 2;
+    int ov = (int)s_cfg.overlap + overlap_step;
+    if (ov < 0) ov = 0;
+    if (ov >= AUDIO_OVERLAP_COUNT) ov = AUDIO_OVERLAP_COUNT - 1;
+    bool changed = (n != s_cfg.fft_size || ov != (int)s_cfg.overlap);
+    s_cfg.fft_size = n;
+    s_cfg.overlap  = (audio_overlap_t)ov;
+    if (changed) s_reconfigure = true;
+    portEXIT_CRITICAL(&s_cfg_lock);
 }
 
 void audio_spectrum_screen_update(audio_spectrum_screen_t *screen, uint8_t *new_spectrum) {
     /* Update spectrum and peak hold */
-    for (int i = 0; i < AUDIO_FREQ_BINS; i++) {
+    for (int i = 0; i < AUDIO_SPECTRUM_BARS; i++) {
         screen->spectrum[i] = new_spectrum[i];
         
         /* Peak hold: decay slowly */
@@ -63,108 +189,313 @@ void audio_spectrum_screen_update(audio_spectrum_screen_t *screen, uint8_t *new_
     screen->frame_count++;
 }
 
-void audio_spectrum_screen_draw(audio_spectrum_screen_t *screen) {
-    /* Draw title, frequency markers, and indicators once */
-    if (!s_title_drawn) {
-        st7789_fill(COLOR_BG);
-        st7789_draw_string(4, 8, "Audio Spectrum (0-20kHz)", COLOR_TEXT, COLOR_BG, 1);
-        
-        /* Frequency markers at top */
-        st7789_draw_string(4, 20, "DC", COLOR_GRID, COLOR_BG, 1);
-        st7789_draw_string(135, 20, "10k", COLOR_GRID, COLOR_BG, 1);
-        st7789_draw_string(280, 20, "20k", COLOR_GRID, COLOR_BG, 1);
-        
-        st7789_draw_string(4, 160, "EXIT: SELECT/A     HOLD: B", COLOR_TEXT, COLOR_BG, 1);
+/* ── Waterfall ──────────────────────────────────────────────────────────── */
+/* Labels in the fixed strip; rows map top = high to bottom = low frequency */
+static void draw_wf_axis(audio_band_scale_t scale) {
+    static const struct { uint16_t hz; const char *text; } lin[] = {
+        { 20000, "20k" }, { 15000, "15k" }, { 10000, "10k" }, { 5000, "5k" },
+    }, log[] = {
+        { 10000, "10k" }, { 1000, "1k" }, { 100, "100" },
+    };
+    const bool linear = (scale == AUDIO_SCALE_LINEAR);
+    const int  count  = linear ? (int)(sizeof(lin) / sizeof(lin[0])) : (int)(sizeof(log) / sizeof(log[0]));
+    uint16_t f_lo, f_hi;
+    audio_analyzer_axis(scale, &f_lo, &f_hi);
+
+    st7789_fill_rect(0, 0, WF_AXIS_W, WF_H, COLOR_BG);
+    st7789_fill_rect(WF_AXIS_W - 1, 0, 1, WF_H, COLOR_GRID);
+    for (int i = 0; i < count; i++) {
+        uint16_t    hz   = linear ? lin[i].hz : log[i].hz;
+        const char *text = linear ? lin[i].text : log[i].text;
+        int y = (int)((1.0f - audio_bands_position(scale, f_lo, f_hi, hz)) * (WF_H - 1)) - 8;
+        if (y < 0) y = 0;
+        if (y > WF_H - 16) y = WF_H - 16;
+        st7789_draw_string(0, y, text, COLOR_GRID, COLOR_BG, 1);
+    }
 
-        /* Frequency axis labels at bottom */
-        st7789_draw_string(4, SPECTRUM_Y + SPECTRUM_H + 5, "DC", COLOR_TEXT, COLOR_BG, 1);
-        st7789_draw_string(140, SPECTRUM_Y + SPECTRUM_H + 5, "10k", COLOR_TEXT, COLOR_BG, 1);
-        st7789_draw_string(290, SPECTRUM_Y + SPECTRUM_H + 5, "20k", COLOR_TEXT, COLOR_BG, 1);
+    /* Bars are already spaced along the scale: stretch them over the rows */
+    for (int y = 0; y < WF_H; y++) {
+        s_wf_row_bar[y] = (uint8_t)((WF_H - 1 - y) * AUDIO_SPECTRUM_BARS / WF_H);
+    }
+}
 
-        s_title_drawn = true;
+static void waterfall_draw(audio_spectrum_screen_t *screen) {
+    static uint16_t column[WF_H];
+
+    if (!s_drawn_waterfall) {
+        st7789_scroll_reset();
+        st7789_fill(COLOR_BG);
+        st7789_scroll_area(WF_AXIS_W, 0);
+        s_wf_pos = 0;
+        st7789_scroll_to(WF_AXIS_W);
+        s_axis_scale = -1;
+        s_drawn_waterfall = true;
+    }
+    if ((int)screen->stats.scale != s_axis_scale) {
+        draw_wf_axis(screen->stats.scale);
+        s_axis_scale = screen->stats.scale;
     }
 
-    /* Draw max hold status indicator (top right area) */
-    uint16_t status_x = 250;
-    st7789_fill_rect(status_x, 8, 70, 16, COLOR_BG);  /* Clear status area */
-    
-    if (screen->max_hold_enabled) {
-        st7789_draw_string(status_x, 8, "HOLD", 0xF800, COLOR_BG, 1);  /* Red text */
+    /* One column per new spectrum; hold freezes the history */
+    if (screen->max_hold_enabled || screen->frame_count == s_wf_frame) return;
+    s_wf_frame = screen->frame_count;
+
+    for (int y = 0; y < WF_H; y++) column[y] = s_wf_lut[screen->spectrum[s_wf_row_bar[y]]];
+    st7789_draw_buffer(WF_AXIS_W + s_wf_pos, 0, 1, WF_H, column);
+
+    /* Start the ring just after the new column so it lands at the right edge */
+    s_wf_pos = (s_wf_pos + 1) % WF_SCROLL_W;
+    st7789_scroll_to(WF_AXIS_W + s_wf_pos);
+}
+
+void audio_spectrum_screen_leave(void) {
+    if (s_drawn_waterfall) st7789_scroll_reset();
+    s_drawn_waterfall = false;
+    if (s_bar_frames) {
+        ESP_LOGI(TAG, "Bar view: %lu frames, %lu windows and %lu px per frame",
+                 (unsigned long)s_bar_frames, (unsigned long)(s_bar_windows / s_bar_frames),
+                 (unsigned long)(s_bar_pixels / s_bar_frames));
     }
+    s_bar_frames = s_bar_windows = s_bar_pixels = 0;
+}
 
-    /* Only redraw spectrum area that actually changed (up to 20 kHz) */
-    for (int i = 0; i < MAX_DISPLAY_BINS && i < AUDIO_FREQ_BINS; i++) {
-        uint8_t mag = screen->spectrum[i];
-        uint8_t peak = screen->peak_hold[i];
-        uint8_t max_mag = screen->max_hold_enabled ? screen->max_hold[i] : 0;
-        uint8_t last_mag = s_last_spectrum[i];
+/* ── Delta bar renderer ─────────────────────────────────────────────────── */
+/*
+ * Each bar column is fully described by bar_state_t, so the renderer
+ * compares the state on screen with the new one row by row and repaints
+ * only the rows that differ.  Dirty runs of neighbouring bars are batched
+ * into one window when the extra unchanged pixels cost less than another
+ * set_window (WINDOW_COST_PX); every pixel in a window is painted from the
+ * new state, so batching never shows stale content.
+ */
+typedef struct { uint8_t b0, b1, y0, y1; } dirty_rect_t;   /* Bars and rows, inclusive */
+
+static bar_state_t bar_target(const audio_spectrum_screen_t *screen, int i) {
+    bar_state_t st = {
+        .bar = (uint8_t)(screen->spectrum[i] * SPECTRUM_H / 255),
+        .max = screen->max_hold_enabled ? (uint8_t)(screen->max_hold[i] * SPECTRUM_H / 255) : 0,
+        .peak = screen->peak_hold[i] ? (uint8_t)(SPECTRUM_H - screen->peak_hold[i] * SPECTRUM_H / 255 + 1) : 0,
+    };
+    if (st.peak > SPECTRUM_H) st.peak = SPECTRUM_H;
+    return st;
+}
 
-        /* Skip if nothing changed */
-        if (mag == last_mag && peak <= 0 && max_mag <= 0) continue;
+/* Same layering as before: background/grid, max hold, bar, peak on top */
+static inline uint16_t bar_pixel(const bar_state_t *b, int y, bool grid) {
+    if (b->peak && y == b->peak - 1)    return COLOR_PEAK;
+    if (y >= SPECTRUM_H - b->bar)       return COLOR_SPECTRUM;
+    if (y >= SPECTRUM_H - b->max)       return COLOR_MAX_HOLD;
+    return grid ? COLOR_GRID : COLOR_BG;
+}
 
-        uint16_t bar_x = SPECTRUM_X + (i * (BAR_WIDTH + BAR_SPACING));
-        
-        /* Clear old bar */
-        st7789_fill_rect(bar_x, SPECTRUM_Y, BAR_WIDTH, SPECTRUM_H, COLOR_BG);
+static void flush_rect(const dirty_rect_t *r) {
+    static uint16_t buf[WINDOW_MAX_PX];
+    uint16_t x = SPECTRUM_X + r->b0 * BAR_WIDTH;
+    uint16_t w = (r->b1 - r->b0 + 1) * BAR_WIDTH;
+    uint16_t h = r->y1 - r->y0 + 1;
+    if (x >= ST7789_WIDTH) return;
+    if (x + w > ST7789_WIDTH) w = ST7789_WIDTH - x;     /* Last bar runs off the edge */
+
+    uint32_t k = 0;
+    for (int y = r->y0; y <= r->y1; y++) {
+        for (int c = 0; c < w; c++) {
+            int i = r->b0 + c / BAR_WIDTH;
+            uint16_t px = bar_pixel(&s_bar_state[i], y, c % BAR_WIDTH == 0 && i % 16 == 0);
+            buf[k++] = (px >> 8) | (px << 8);
+        }
+    }
+    st7789_draw_buffer(x, SPECTRUM_Y + r->y0, w, h, buf);
+    s_bar_windows++;
+    s_bar_pixels += k;
+}
+
+static inline uint32_t rect_px(const dirty_rect_t *r) {
+    return (uint32_t)(r->b1 - r->b0 + 1) * BAR_WIDTH * (r->y1 - r->y0 + 1);
+}
 
-        /* Draw grid line */
-        if (i % 16 == 0) {
-            st7789_fill_rect(bar_x, SPECTRUM_Y, 1, SPECTRUM_H, COLOR_GRID);
+/* Row runs where @p old and @p new differ, gaps ≤ RUN_MERGE_GAP bridged */
+static int dirty_runs(const bar_state_t *old, const bar_state_t *new,
+                      uint8_t y0[MAX_RUNS], uint8_t y1[MAX_RUNS]) {
+    int runs = 0;
+    for (int y = 0; y < SPECTRUM_H; y++) {
+        if (bar_pixel(old, y, false) == bar_pixel(new, y, false)) continue;
+        if (runs && y - y1[runs - 1] <= RUN_MERGE_GAP + 1) {
+            y1[runs - 1] = (uint8_t)y;
+        } else if (runs == MAX_RUNS) {
+            y1[runs - 1] = (uint8_t)y;
+        } else {
+            y0[runs] = y1[runs] = (uint8_t)y;
+            runs++;
         }
+    }
+    return runs;
+}
 
-        /* Draw max hold bar (if enabled, shown as dim blue) */
-        if (screen->max_hold_enabled && max_mag > 0) {
-            uint16_t max_h = (uint16_t)max_mag * SPECTRUM_H / 255;
-            uint16_t max_y = SPECTRUM_Y + SPECTRUM_H - max_h;
-            st7789_fill_rect(bar_x, max_y, BAR_WIDTH, max_h, 0x041F);  /* Dark blue */
+static void draw_bars_delta(const audio_spectrum_screen_t *screen) {
+    dirty_rect_t pending;
+    bool have = false;
+
+    for (int i = 0; i < AUDIO_SPECTRUM_BARS; i++) {
+        bar_state_t next = bar_target(screen, i);
+        uint8_t y0[MAX_RUNS], y1[MAX_RUNS];
+        int runs = dirty_runs(&s_bar_state[i], &next, y0, y1);
+        /* Commit now: windows are painted from the new state */
+        s_bar_state[i] = next;
+
+        for (int r = 0; r < runs; r++) {
+            dirty_rect_t run = { (uint8_t)i, (uint8_t)i, y0[r], y1[r] };
+            if (have && pending.b1 + 1 >= i) {
+                dirty_rect_t u = {
+                    pending.b0, (uint8_t)i,
+                    pending.y0 < run.y0 ? pending.y0 : run.y0,
+                    pending.y1 > run.y1 ? pending.y1 : run.y1,
+                };
+                uint32_t cost = rect_px(&u);
+                if (cost <= WINDOW_MAX_PX &&
+                    cost <= rect_px(&pending) + rect_px(&run) + WINDOW_COST_PX) {
+                    pending = u;
+                    continue;
+                }
+            }
+            if (have) flush_rect(&pending);
+            pending = run;
+            have = true;
         }
+    }
+    if (have) flush_rect(&pending);
+    s_bar_frames++;
+}
+
+/* Tempo from the shared beat tracker and a square lit for each beat */
+static void draw_beat(void) {
+    audio_beat_state_t beat;
+    audio_beat_get(&beat);
+
+    int bpm = (int)(beat.bpm + 0.5f);
+    if (bpm != s_bpm_drawn) {
+        char txt[8];
+        if (bpm) snprintf(txt, sizeof(txt), "%3dBPM", bpm);
+        else     snprintf(txt, sizeof(txt), "---BPM");
+        st7789_draw_string(BEAT_TEXT_X, 8, txt, COLOR_GRID, COLOR_BG, 1);
+        s_bpm_drawn = bpm;
+    }
 
-        /* Draw new bar (green) */
-        uint16_t bar_h = (uint16_t)mag * SPECTRUM_H / 255;
-        if (bar_h > 0) {
-            uint16_t bar_y = SPECTRUM_Y + SPECTRUM_H - bar_h;
-            st7789_fill_rect(bar_x, bar_y, BAR_WIDTH, bar_h, COLOR_SPECTRUM);
+    int flash = beat.beats && esp_timer_get_time() - beat.last_beat_us < BEAT_FLASH_US;
+    if (flash != s_flash_drawn) {
+        st7789_fill_rect(BEAT_DOT_X, 8, 8, 8, flash ? COLOR_PEAK : COLOR_BG);
+        s_flash_drawn = flash;
+    }
+}
+
+void audio_spectrum_screen_draw(audio_spectrum_screen_t *screen) {
+    if (screen->waterfall) {
+        waterfall_draw(screen);
+        return;
+    }
+    if (s_drawn_waterfall) {
+        /* Back from the waterfall: unscroll and redraw everything */
+        audio_spectrum_screen_leave();
+        s_title_drawn = false;
+        s_axis_scale  = -1;
+        memset(&s_last_stats, 0, sizeof(s_last_stats));
+    }
+
+    /* Draw title, frequency markers, and indicators once */
+    if (!s_title_drawn) {
+        st7789_fill(COLOR_BG);
+        st7789_draw_string(4, 8, "Audio Spectrum (0-20kHz)", COLOR_TEXT, COLOR_BG, 1);
+        
+        st7789_draw_string(4, 160, "A:EXIT B:HOLD SEL:VIEW ST:F/Q STK:AXIS", COLOR_TEXT, COLOR_BG, 1);
+
+        /* Empty bars over the grid: the delta renderer starts from here */
+        for (int i = 0; i < AUDIO_SPECTRUM_BARS; i += 16) {
+            st7789_fill_rect(SPECTRUM_X + i * BAR_WIDTH, SPECTRUM_Y, 1, SPECTRUM_H, COLOR_GRID);
         }
+        memset(s_bar_state, 0, sizeof(s_bar_state));
+        s_hold_drawn  = -1;
+        s_bpm_drawn   = -1;
+        s_flash_drawn = -1;
 
-        /* Draw peak indicator (brighter green) */
-        if (peak > 0) {
-            uint16_t peak_y = SPECTRUM_Y + SPECTRUM_H - (peak * SPECTRUM_H / 255);
-            if (peak_y >= SPECTRUM_Y) {
-                st7789_fill_rect(bar_x, peak_y, BAR_WIDTH, 1, 0xAFE0);
-            }
+        s_title_drawn = true;
+    }
+
+    /* Max hold status indicator (top right area), only when it changes */
+    if ((int)screen->max_hold_enabled != s_hold_drawn) {
+        st7789_fill_rect(250, 8, 40, 16, COLOR_BG);
+        if (screen->max_hold_enabled) {
+            st7789_draw_string(250, 8, "HOLD", 0xF800, COLOR_BG, 1);  /* Red text */
         }
+        s_hold_drawn = screen->max_hold_enabled;
+    }
+
+    draw_beat();
 
-        s_last_spectrum[i] = mag;
+    /* Analyzer status line and frequency axis */
+    audio_analyzer_stats_t st = screen->stats;
+    if (st.fft_size && (int)st.scale != s_axis_scale) {
+        draw_axis(st.scale);
+        s_axis_scale = st.scale;
     }
+    if (st.fft_size != s_last_stats.fft_size || st.hop != s_last_stats.hop ||
+        st.cpu_permille != s_last_stats.cpu_permille || st.scale != s_last_stats.scale ||
+        st.kind != s_last_stats.kind) {
+        char line[48];
+        unsigned ovl = st.fft_size ? 100u - 100u * st.hop / st.fft_size : 0;
+        snprintf(line, sizeof(line), "N=%-4u %2u%% %5.1fHz %-6s %s CPU%2u.%u%%",
+                 st.fft_size, ovl, st.bin_hz, audio_bands_scale_name(st.scale),
+                 audio_fft_kind_name(st.kind),
+                 st.cpu_permille / 10, st.cpu_permille % 10);
+        st7789_fill_rect(4, 20, 312, 8, COLOR_BG);
+        st7789_draw_string(4, 20, line, COLOR_GRID, COLOR_BG, 1);
+        s_last_stats = st;
+    }
+
+    /* Repaint only the pixels whose bar, max hold or peak changed */
+    draw_bars_delta(screen);
 }
 
-/* Background audio capture task */
+/* Background FFT task: consumes blocks from the shared audio stream */
 static void audio_capture_task(void *arg) {
     audio_spectrum_screen_t *screen = (audio_spectrum_screen_t *)arg;
-    audio_sample_t samples[AUDIO_FFT_SIZE];
-    audio_magnitude_t spectrum[AUDIO_FREQ_BINS];
+    static audio_sub_t sub;
+    static audio_block_t block;
+    static audio_analyzer_t analyzer;
+    uint8_t bars[AUDIO_SPECTRUM_BARS];
 
     ESP_LOGI(TAG, "Audio capture task started");
+    s_reconfigure = true;
+    audio_stream_subscribe(&sub);
 
     while (s_audio_task_running) {
-        /* Read samples from microphone */
-        size_t n = audio_read_samples(samples);
-        if (n != AUDIO_FFT_SIZE) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-            continue;
+        if (s_reconfigure) {
+            audio_analyzer_config_t cfg;
+            portENTER_CRITICAL(&s_cfg_lock);
+            cfg = s_cfg;
+            s_reconfigure = false;
+            portEXIT_CRITICAL(&s_cfg_lock);
+            if (!audio_analyzer_init(&analyzer, &cfg)) {
+                /* Not enough memory for this size: fall back to the smallest */
+                cfg.fft_size = AUDIO_ANALYZER_MIN_N;
+                audio_analyzer_init(&analyzer, &cfg);
+            }
+            audio_analyzer_get_stats(&analyzer, &screen->stats);
         }
 
-        /* Compute FFT */
-        audio_compute_fft(samples, spectrum);
-
-        /* Update screen spectrum */
-        audio_spectrum_screen_update(screen, spectrum);
+        /* Waits on the stream, never on the I2S channel */
+        if (!audio_stream_read(&sub, &block, 100)) continue;
 
-        /* Yield to allow display task to render */
-        vTaskDelay(pdMS_TO_TICKS(1));
+        /* Update the screen once per block, if at least one frame finished */
+        if (audio_analyzer_feed(&analyzer, block.samples, AUDIO_STREAM_BLOCK) == 0) continue;
+        audio_analyzer_bars(&analyzer, bars);
+        audio_analyzer_get_stats(&analyzer, &screen->stats);
+        audio_spectrum_screen_update(screen, bars);
     }
 
-    ESP_LOGI(TAG, "Audio capture task stopped");
+    audio_stream_unsubscribe(&sub);
+    ESP_LOGI(TAG, "Audio capture task stopped (%lu blocks, %lu overruns, %lu frames)",
+             (unsigned long)sub.blocks, (unsigned long)sub.overruns,
+             (unsigned long)analyzer.frames);
+    audio_analyzer_free(&analyzer);
     s_audio_task = NULL;  /* Clear handle before self-deleting */
     vTaskDelete(NULL);
 }
@@ -175,6 +506,7 @@ void audio_spectrum_task_start(audio_spectrum_screen_t *screen) {
         return;
     }
 
+    audio_beat_start();
     s_audio_task_running = true;
     xTaskCreatePinnedToCore(
         audio_capture_task,
@@ -202,6 +534,7 @@ void audio_spectrum_task_stop(void) {
         vTaskDelete(s_audio_task);
         s_audio_task = NULL;
     }
+    audio_beat_stop();
 }
 
 void audio_spectrum_toggle_max_hold(audio_spectrum_screen_t *screen) {
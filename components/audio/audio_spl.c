@@ -0,0 +1,110 @@
+/*
+ * Audio SPL implementation – stream tap, time weighting and the published
+ * levels.
+ */
+
+#include "audio_spl.h"
+#include "audio_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+#define TAG "audio_spl"
+
+#define BLOCK_S     ((float)AUDIO_STREAM_BLOCK / AUDIO_SAMPLE_RATE)
+#define BLOCK_US    ((uint32_t)(BLOCK_S * 1e6f))
+
+static bool         s_started = false;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Filter state (capture task only) */
+static audio_weighting_t s_weighting;
+static int32_t           s_work[AUDIO_STREAM_BLOCK];
+static float             s_k_fast, s_k_slow;
+
+/* Integrators as mean squares (under s_lock) */
+static float    s_fast[AUDIO_WEIGHT_COUNT];
+static float    s_slow[AUDIO_WEIGHT_COUNT];
+static float    s_max[AUDIO_WEIGHT_COUNT];
+static double   s_energy[AUDIO_WEIGHT_COUNT];   /* Σ block mean squares since reset */
+static uint32_t s_energy_blocks;
+static audio_spl_stats_t s_stats;
+static uint64_t s_busy_us;
+
+/* ── Tap (capture task) ─────────────────────────────────────────────────── */
+static void spl_tap(const int32_t *raw, size_t count, int64_t timestamp_us) {
+    (void)timestamp_us;
+    int64_t t0 = esp_timer_get_time();
+    float ms[AUDIO_WEIGHT_COUNT];
+    audio_weighting_process(&s_weighting, raw, s_work, count, ms);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    portENTER_CRITICAL(&s_lock);
+    for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) {
+        s_fast[k] += s_k_fast * (ms[k] - s_fast[k]);
+        s_slow[k] += s_k_slow * (ms[k] - s_slow[k]);
+        if (s_fast[k] > s_max[k]) s_max[k] = s_fast[k];
+        s_energy[k] += ms[k];
+    }
+    s_energy_blocks++;
+    s_stats.blocks++;
+    s_busy_us += us;
+    if (us > s_stats.max_block_us) s_stats.max_block_us = us;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+void audio_spl_start(void) {
+    if (s_started) return;
+    s_started = true;
+
+    audio_weighting_init(&s_weighting, AUDIO_SAMPLE_RATE);
+    s_k_fast = 1.0f - expf(-BLOCK_S * 1000.0f / AUDIO_SPL_FAST_MS);
+    s_k_slow = 1.0f - expf(-BLOCK_S * 1000.0f / AUDIO_SPL_SLOW_MS);
+    audio_spl_reset();
+
+    audio_stream_set_tap(spl_tap);
+    audio_stream_start();
+    ESP_LOGI(TAG, "Sound level meter running (%d-bit capture)", AUDIO_CAPTURE_BITS);
+}
+
+void audio_spl_get(audio_spl_level_t *out) {
+    float    fast[AUDIO_WEIGHT_COUNT], slow[AUDIO_WEIGHT_COUNT], max[AUDIO_WEIGHT_COUNT];
+    double   energy[AUDIO_WEIGHT_COUNT];
+    uint32_t blocks;
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(fast, s_fast, sizeof(fast));
+    memcpy(slow, s_slow, sizeof(slow));
+    memcpy(max, s_max, sizeof(max));
+    memcpy(energy, s_energy, sizeof(energy));
+    blocks = s_energy_blocks;
+    portEXIT_CRITICAL(&s_lock);
+
+    /* dB conversion outside the lock and off the capture path */
+    for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) {
+        out->fast[k] = audio_spl_db(fast[k]);
+        out->slow[k] = audio_spl_db(slow[k]);
+        out->max[k]  = audio_spl_db(max[k]);
+        out->leq[k]  = audio_spl_db(blocks ? (float)(energy[k] / blocks) : 0.0f);
+    }
+    out->leq_ms = (uint32_t)((uint64_t)blocks * BLOCK_US / 1000);
+}
+
+void audio_spl_reset(void) {
+    portENTER_CRITICAL(&s_lock);
+    memset(s_max, 0, sizeof(s_max));
+    memset(s_energy, 0, sizeof(s_energy));
+    s_energy_blocks = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void audio_spl_get_stats(audio_spl_stats_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    uint64_t busy = s_busy_us;
+    portEXIT_CRITICAL(&s_lock);
+    out->load = out->blocks ? (float)busy / ((float)out->blocks * BLOCK_US) : 0.0f;
+}
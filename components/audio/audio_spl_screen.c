@@ -0,0 +1,213 @@
+/*
+ * Sound Level screen implementation
+ */
+
+#include "audio_spl_screen.h"
+#include "audio_spl.h"
+#include "st7789.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdio.h>
+
+#define TAG "audio_spl_screen"
+
+/* Screen layout */
+#define READING_X       40
+#define READING_Y       34
+#define READING_SCALE   5       /* 40 px digits */
+#define BAR_X           4
+#define BAR_Y           86
+#define BAR_W           312
+#define BAR_H           14
+#define BAR_MIN_DB      30
+#define BAR_MAX_DB      120
+#define SCALE_Y         (BAR_Y + BAR_H + 5)
+#define ROWS_Y          122
+#define STATUS_Y        158
+
+/* Bar zones: comfortable, loud (hearing protection advised), harmful */
+#define ZONE_LOUD_DB    85
+#define ZONE_HARM_DB    100
+
+/* Colors */
+#define COLOR_BG        0x0000  /* Black */
+#define COLOR_TEXT      0xFFFF  /* White */
+#define COLOR_GRID      0x4208  /* Dark gray */
+#define COLOR_OK        0x07E0  /* Green */
+#define COLOR_LOUD      0xFFE0  /* Yellow */
+#define COLOR_HARM      0xF800  /* Red */
+#define COLOR_PEAK      0xAFE0  /* Bright green */
+
+static const char s_weight_name[AUDIO_WEIGHT_COUNT] = { 'A', 'C', 'Z' };
+
+/* View settings persist across visits */
+static audio_weight_t s_weight = AUDIO_WEIGHT_A;
+static bool           s_slow = false;
+
+/* Draw state – reset on init; levels in 0.1 dB */
+static bool s_frame_drawn = false;
+static int  s_label_drawn = -1;
+static int  s_reading_drawn = -1;
+static int  s_bar_drawn = -1;       /* Filled width */
+static int  s_max_drawn = -1;       /* Max marker x */
+static int  s_rows_drawn[4] = { -1, -1, -1, -1 };
+static uint32_t s_leq_s_drawn = UINT32_MAX;
+static int  s_load_drawn = -1;      /* 0.1 % */
+
+void audio_spl_screen_init(void) {
+    s_frame_drawn   = false;
+    s_label_drawn   = -1;
+    s_reading_drawn = -1;
+    s_bar_drawn     = -1;
+    s_max_drawn     = -1;
+    for (int i = 0; i < 4; i++) s_rows_drawn[i] = -1;
+    s_leq_s_drawn   = UINT32_MAX;
+    s_load_drawn    = -1;
+    ESP_LOGI(TAG, "Sound level screen initialized");
+}
+
+void audio_spl_screen_cycle_weighting(void) {
+    s_weight = (audio_weight_t)((s_weight + 1) % AUDIO_WEIGHT_COUNT);
+}
+
+void audio_spl_screen_toggle_speed(void) {
+    s_slow = !s_slow;
+}
+
+/* ── Drawing helpers ────────────────────────────────────────────────────── */
+static int tenths(float db) {
+    return (int)lroundf(db * 10.0f);
+}
+
+static int db_to_x(float db) {
+    if (db <= BAR_MIN_DB) return 0;
+    if (db >= BAR_MAX_DB) return BAR_W;
+    return (int)((db - BAR_MIN_DB) * BAR_W / (BAR_MAX_DB - BAR_MIN_DB));
+}
+
+/* Fill bar columns [x0, x1) with their zone colours (or background) */
+static void fill_bar(int x0, int x1, bool lit) {
+    static const struct { int db; uint16_t color; } zones[] = {
+        { ZONE_LOUD_DB, COLOR_OK }, { ZONE_HARM_DB, COLOR_LOUD }, { BAR_MAX_DB, COLOR_HARM },
+    };
+    int start = 0;
+    for (size_t z = 0; z < sizeof(zones) / sizeof(zones[0]); z++) {
+        int end = db_to_x(zones[z].db);
+        int a = x0 > start ? x0 : start;
+        int b = x1 < end ? x1 : end;
+        if (a < b) {
+            st7789_fill_rect(BAR_X + a, BAR_Y, b - a, BAR_H, lit ? zones[z].color : COLOR_BG);
+        }
+        start = end;
+    }
+}
+
+static void draw_frame(void) {
+    char buf[16];
+    st7789_fill(COLOR_BG);
+    st7789_draw_string(4, 8, "Sound Level", COLOR_TEXT, COLOR_BG, 2);
+
+    /* Ticks under the bar every 10 dB, labelled every 30 */
+    for (int db = BAR_MIN_DB; db <= BAR_MAX_DB; db += 10) {
+        int x = BAR_X + db_to_x(db);
+        if (x > BAR_X + BAR_W - 1) x = BAR_X + BAR_W - 1;
+        st7789_fill_rect(x, BAR_Y + BAR_H + 1, 1, 3, COLOR_GRID);
+        if ((db - BAR_MIN_DB) % 30) continue;
+        int len = snprintf(buf, sizeof(buf), "%d", db);
+        int lx  = x - len * 4;
+        if (lx < BAR_X) lx = BAR_X;
+        if (lx + len * 8 > BAR_X + BAR_W) lx = BAR_X + BAR_W - len * 8;
+        st7789_draw_string(lx, SCALE_Y, buf, COLOR_GRID, COLOR_BG, 1);
+    }
+
+    st7789_draw_string(4, STATUS_Y, "SEL:wt L/R:F/S START:reset A:exit", COLOR_GRID, COLOR_BG, 1);
+    s_frame_drawn = true;
+}
+
+/* ── Draw ───────────────────────────────────────────────────────────────── */
+bool audio_spl_screen_draw(void) {
+    audio_spl_level_t lv;
+    audio_spl_stats_t st;
+    char buf[48];
+    bool changed = false;
+
+    audio_spl_get(&lv);
+    audio_spl_get_stats(&st);
+    if (!s_frame_drawn) draw_frame();
+
+    /* Main reading label: "LAF" / "LCS" ... */
+    int label = s_weight * 2 + s_slow;
+    if (label != s_label_drawn) {
+        snprintf(buf, sizeof(buf), "L%c%c", s_weight_name[s_weight], s_slow ? 'S' : 'F');
+        st7789_draw_string(4, READING_Y + 16, buf, COLOR_TEXT, COLOR_BG, 1);
+        s_label_drawn   = label;
+        s_reading_drawn = -1;
+        s_bar_drawn     = -1;           /* Repaints the bar and drops the old marker */
+        s_max_drawn     = -1;
+        for (int i = 0; i < 4; i++) s_rows_drawn[i] = -1;
+    }
+
+    float level = s_slow ? lv.slow[s_weight] : lv.fast[s_weight];
+    int   t = tenths(level);
+    if (t != s_reading_drawn) {
+        snprintf(buf, sizeof(buf), "%5.1f", t / 10.0f);
+        st7789_draw_string(READING_X, READING_Y, buf, COLOR_TEXT, COLOR_BG, READING_SCALE);
+        st7789_draw_string(READING_X + 5 * 8 * READING_SCALE + 6, READING_Y + 24, "dB",
+                           COLOR_TEXT, COLOR_BG, 2);
+        s_reading_drawn = t;
+        changed = true;
+    }
+
+    /* Level bar: only the columns between the old and new width */
+    int w = db_to_x(level);
+    if (s_bar_drawn < 0) {
+        fill_bar(0, BAR_W, false);
+        s_bar_drawn = 0;
+    }
+    if (w > s_bar_drawn)      fill_bar(s_bar_drawn, w, true);
+    else if (w < s_bar_drawn) fill_bar(w, s_bar_drawn, false);
+    s_bar_drawn = w;
+
+    /* Max marker: repaint the column it left, then draw it */
+    int mx = db_to_x(lv.max[s_weight]);
+    if (mx >= BAR_W) mx = BAR_W - 1;
+    if (mx != s_max_drawn) {
+        if (s_max_drawn >= 0) fill_bar(s_max_drawn, s_max_drawn + 1, s_max_drawn < w);
+        s_max_drawn = mx;
+    }
+    st7789_fill_rect(BAR_X + mx, BAR_Y, 1, BAR_H, COLOR_PEAK);
+
+    /* Other integrators for the selected weighting */
+    const float rows[4] = {
+        s_slow ? lv.fast[s_weight] : lv.slow[s_weight], lv.leq[s_weight], lv.max[s_weight],
+        lv.fast[(s_weight + 1) % AUDIO_WEIGHT_COUNT],
+    };
+    static const uint16_t row_x[4] = { 4, 82, 160, 246 };
+    char wt = s_weight_name[s_weight];
+    for (int i = 0; i < 4; i++) {
+        int rt = tenths(rows[i]);
+        if (rt == s_rows_drawn[i]) continue;
+        switch (i) {
+        case 0:  snprintf(buf, sizeof(buf), "L%c%c %5.1f", wt, s_slow ? 'F' : 'S', rt / 10.0f); break;
+        case 1:  snprintf(buf, sizeof(buf), "L%ceq%5.1f", wt, rt / 10.0f); break;
+        case 2:  snprintf(buf, sizeof(buf), "L%cmax%5.1f", wt, rt / 10.0f); break;
+        default: snprintf(buf, sizeof(buf), "L%cF %5.1f",
+                          s_weight_name[(s_weight + 1) % AUDIO_WEIGHT_COUNT], rt / 10.0f); break;
+        }
+        st7789_draw_string(row_x[i], ROWS_Y, buf, COLOR_TEXT, COLOR_BG, 1);
+        s_rows_drawn[i] = rt;
+    }
+
+    /* Leq time and metering cost */
+    uint32_t leq_s = lv.leq_ms / 1000;
+    int load = (int)lroundf(st.load * 1000.0f);
+    if (leq_s != s_leq_s_drawn || load != s_load_drawn) {
+        snprintf(buf, sizeof(buf), "Leq %02lu:%02lu:%02lu   CPU %d.%d%%  ",
+                 (unsigned long)(leq_s / 3600), (unsigned long)(leq_s / 60 % 60),
+                 (unsigned long)(leq_s % 60), load / 10, load % 10);
+        st7789_draw_string(4, ROWS_Y + 16, buf, COLOR_GRID, COLOR_BG, 1);
+        s_leq_s_drawn = leq_s;
+        s_load_drawn  = load;
+    }
+    return changed;
+}
@@ -0,0 +1,198 @@
+/*
+ * Audio stream implementation – capture task, block ring and subscribers.
+ */
+
+#include "audio_stream.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#define TAG "audio_stream"
+
+#define BLOCK_US        ((int64_t)AUDIO_STREAM_BLOCK * 1000000 / AUDIO_SAMPLE_RATE)
+#define MAX_LAG         (AUDIO_STREAM_BLOCKS - 2)   /* Slot being written + margin */
+
+#define CAPTURE_PRIO    7       /* Above input/display/LED: only wakes per block */
+
+/* Ring: slot seq is written last (release) so readers can validate a copy */
+static audio_block_t s_ring[AUDIO_STREAM_BLOCKS];
+static atomic_uint   s_slot_seq[AUDIO_STREAM_BLOCKS];
+static atomic_uint   s_head;                        /* Newest published seq */
+
+static audio_sub_t  *s_subs[AUDIO_STREAM_MAX_SUBS];
+static portMUX_TYPE  s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t  s_task = NULL;
+static uint32_t      s_read_errors;
+
+/* Full-resolution tap, called from the capture task */
+static audio_stream_tap_t volatile s_tap;
+static int32_t       s_raw[AUDIO_STREAM_BLOCK];
+
+/* ── Capture ────────────────────────────────────────────────────────────── */
+static void capture_task(void *arg) {
+    (void)arg;
+    uint32_t seq = 0;
+    SemaphoreHandle_t wake[AUDIO_STREAM_MAX_SUBS];
+
+    ESP_LOGI(TAG, "Capture started (%d-sample blocks, %d-block ring)",
+             AUDIO_STREAM_BLOCK, AUDIO_STREAM_BLOCKS);
+
+    while (1) {
+        uint32_t next = seq + 1;
+        uint32_t idx  = next % AUDIO_STREAM_BLOCKS;
+        audio_block_t *slot = &s_ring[idx];
+
+        /* Invalidate the slot before overwriting it */
+        atomic_store_explicit(&s_slot_seq[idx], 0, memory_order_release);
+
+        audio_stream_tap_t tap = s_tap;
+        if (audio_read_samples(slot->samples, tap ? s_raw : NULL) != AUDIO_STREAM_BLOCK) {
+            s_read_errors++;
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        slot->timestamp_us = esp_timer_get_time() - BLOCK_US;
+        slot->seq = next;
+
+        atomic_store_explicit(&s_slot_seq[idx], next, memory_order_release);
+        atomic_store_explicit(&s_head, next, memory_order_release);
+        seq = next;
+
+        if (tap) tap(s_raw, AUDIO_STREAM_BLOCK, slot->timestamp_us);
+
+        /* Fan out: wake every subscriber (outside the critical section) */
+        int n = 0;
+        portENTER_CRITICAL(&s_lock);
+        for (int i = 0; i < AUDIO_STREAM_MAX_SUBS; i++) {
+            if (s_subs[i]) wake[n++] = s_subs[i]->wake;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        for (int i = 0; i < n; i++) xSemaphoreGive(wake[i]);
+    }
+}
+
+void audio_stream_start(void) {
+    if (s_task) return;
+    audio_init();
+    xTaskCreatePinnedToCore(capture_task, "audio_stream", AUDIO_STREAM_STACK, NULL,
+                            CAPTURE_PRIO, &s_task, 0 /* CPU0 */);
+}
+
+/* ── Subscribers ────────────────────────────────────────────────────────── */
+bool audio_stream_subscribe(audio_sub_t *sub) {
+    /* The semaphore is kept across unsubscribe so a give racing with it
+     * never touches a deleted handle; subscribers are long-lived objects */
+    if (!sub->wake) {
+        sub->wake = xSemaphoreCreateBinary();
+        if (!sub->wake) return false;
+    }
+
+    bool ok = false;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < AUDIO_STREAM_MAX_SUBS; i++) {
+        if (s_subs[i] == sub) { ok = true; break; }
+    }
+    for (int i = 0; !ok && i < AUDIO_STREAM_MAX_SUBS; i++) {
+        if (!s_subs[i]) {
+            s_subs[i] = sub;
+            ok = true;
+        }
+    }
+    if (ok) {
+        sub->next_seq = atomic_load(&s_head) + 1;
+        sub->blocks   = 0;
+        sub->overruns = 0;
+        sub->active   = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!ok) ESP_LOGW(TAG, "No free subscriber slot");
+    return ok;
+}
+
+void audio_stream_unsubscribe(audio_sub_t *sub) {
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < AUDIO_STREAM_MAX_SUBS; i++) {
+        if (s_subs[i] == sub) s_subs[i] = NULL;
+    }
+    sub->active = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/* ── Reading ────────────────────────────────────────────────────────────── */
+/* Copy block @p seq; false if the writer reused the slot meanwhile */
+static bool copy_block(uint32_t seq, audio_block_t *out) {
+    uint32_t idx = seq % AUDIO_STREAM_BLOCKS;
+    if (atomic_load_explicit(&s_slot_seq[idx], memory_order_acquire) != seq) return false;
+    memcpy(out, &s_ring[idx], sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&s_slot_seq[idx], memory_order_relaxed) == seq;
+}
+
+bool audio_stream_read(audio_sub_t *sub, audio_block_t *out, uint32_t timeout_ms) {
+    if (!sub->active) return false;
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t limit = pdMS_TO_TICKS(timeout_ms);
+    uint32_t   head  = atomic_load_explicit(&s_head, memory_order_acquire);
+
+    while ((int32_t)(head - sub->next_seq) < 0) {
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= limit) return false;
+        xSemaphoreTake(sub->wake, limit - waited);
+        head = atomic_load_explicit(&s_head, memory_order_acquire);
+    }
+
+    for (;;) {
+        /* Fell too far behind: drop the oldest blocks */
+        uint32_t lag = head - sub->next_seq + 1;
+        if (lag > MAX_LAG) {
+            sub->overruns += lag - MAX_LAG;
+            sub->next_seq += lag - MAX_LAG;
+        }
+        if (copy_block(sub->next_seq, out)) break;
+        head = atomic_load_explicit(&s_head, memory_order_acquire);
+        if (head - sub->next_seq + 1 <= MAX_LAG) {
+            /* Not overwritten, just not valid: only possible on a failed read */
+            return false;
+        }
+    }
+
+    sub->next_seq++;
+    sub->blocks++;
+    return true;
+}
+
+bool audio_stream_read_latest(audio_sub_t *sub, audio_block_t *out) {
+    if (!sub->active) return false;
+
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+    if (head == 0 || (int32_t)(head - sub->next_seq) < 0) return false;
+    if (!copy_block(head, out)) return false;
+
+    xSemaphoreTake(sub->wake, 0);   /* Consume the pending wake-up */
+    sub->next_seq = head + 1;
+    sub->blocks++;
+    return true;
+}
+
+void audio_stream_set_tap(audio_stream_tap_t tap) {
+    s_tap = tap;
+}
+
+void audio_stream_get_stats(audio_stream_stats_t *out) {
+    out->blocks        = atomic_load(&s_head);
+    out->dma_overflows = audio_dma_overflows();
+    out->read_errors   = s_read_errors;
+
+    uint8_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < AUDIO_STREAM_MAX_SUBS; i++) {
+        if (s_subs[i]) n++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    out->subscribers = n;
+}
@@ -0,0 +1,192 @@
+/*
+ * Audio tones implementation – detector task, debouncing and event queue.
+ */
+
+#include "audio_tones.h"
+#include "audio_dtmf.h"
+#include "audio_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include <string.h>
+
+#define TAG "audio_tones"
+
+/* Task control */
+static TaskHandle_t  s_task = NULL;
+static volatile bool s_running = false;
+static QueueHandle_t s_queue = NULL;
+static audio_sub_t   s_sub;
+
+/* Detector state, owned by the task while it runs */
+static audio_tones_config_t s_cfg;
+static audio_goertzel_t     s_bank;
+static audio_dtmf_t         s_dtmf;
+static uint32_t             s_share_q16;
+static bool                 s_present[AUDIO_GOERTZEL_MAX_TONES];
+static uint8_t              s_flip[AUDIO_GOERTZEL_MAX_TONES];      /* Blocks disagreeing with s_present */
+static uint32_t             s_on_blocks[AUDIO_GOERTZEL_MAX_TONES];
+static audio_tones_stats_t  s_stats;
+
+static void post(const audio_tone_event_t *ev) {
+    if (xQueueSend(s_queue, ev, 0) == pdTRUE) s_stats.events++;
+    else s_stats.dropped++;
+}
+
+/* ── Tone bank ──────────────────────────────────────────────────────────── */
+static void bank_block(int64_t t_us) {
+    s_stats.blocks++;
+    for (uint8_t i = 0; i < s_bank.count; i++) {
+        bool now = s_bank.ratio_q16[i] >= s_share_q16 &&
+                   audio_goertzel_dbfs(&s_bank, i) >= s_cfg.min_dbfs;
+        if (s_present[i]) s_on_blocks[i]++;
+        if (now == s_present[i]) {
+            s_flip[i] = 0;
+            continue;
+        }
+        if (++s_flip[i] < s_cfg.debounce) continue;
+
+        audio_tone_event_t ev = {
+            .type         = now ? AUDIO_TONE_ON : AUDIO_TONE_OFF,
+            .tone         = i,
+            .freq_hz      = s_cfg.freq_hz[i],
+            .timestamp_us = t_us,
+        };
+        if (now) {
+            s_on_blocks[i] = s_flip[i];
+        } else {
+            /* The confirming silent blocks are not part of the tone */
+            ev.duration_ms = (s_on_blocks[i] - s_flip[i]) * s_cfg.block_ms;
+        }
+        s_present[i] = now;
+        s_flip[i]    = 0;
+        post(&ev);
+    }
+}
+
+/* ── Task ───────────────────────────────────────────────────────────────── */
+/* Events are stamped with the capture time of the sample ending their block */
+static void tones_task(void *arg) {
+    (void)arg;
+    static audio_block_t block;
+
+    ESP_LOGI(TAG, "Detector started (%u tones%s, %u ms blocks)",
+             s_cfg.count, s_cfg.dtmf ? " + DTMF" : "", s_cfg.block_ms);
+
+    while (s_running) {
+        if (!audio_stream_read(&s_sub, &block, 100)) continue;
+
+        for (size_t used = 0; s_cfg.count && used < AUDIO_STREAM_BLOCK; ) {
+            bool done;
+            used += audio_goertzel_feed(&s_bank, &block.samples[used],
+                                        AUDIO_STREAM_BLOCK - used, &done);
+            if (done) bank_block(block.timestamp_us + (int64_t)used * 1000000 / AUDIO_SAMPLE_RATE);
+        }
+        for (size_t used = 0; s_cfg.dtmf && used < AUDIO_STREAM_BLOCK; ) {
+            audio_dtmf_event_t d;
+            bool has;
+            used += audio_dtmf_feed(&s_dtmf, &block.samples[used],
+                                    AUDIO_STREAM_BLOCK - used, &d, &has);
+            if (!has) continue;
+            audio_tone_event_t ev = {
+                .type         = d.down ? AUDIO_TONE_DTMF_DOWN : AUDIO_TONE_DTMF_UP,
+                .key          = d.key,
+                .duration_ms  = d.duration_ms,
+                .timestamp_us = block.timestamp_us + (int64_t)used * 1000000 / AUDIO_SAMPLE_RATE,
+            };
+            post(&ev);
+        }
+    }
+
+    s_stats.overruns = s_sub.overruns;
+    audio_stream_unsubscribe(&s_sub);
+    ESP_LOGI(TAG, "Detector stopped (%lu blocks, %lu events, %lu dropped, %lu overruns)",
+             (unsigned long)s_stats.blocks, (unsigned long)s_stats.events,
+             (unsigned long)s_stats.dropped, (unsigned long)s_stats.overruns);
+    s_task = NULL;  /* Clear handle before self-deleting */
+    vTaskDelete(NULL);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+bool audio_tones_start(const audio_tones_config_t *cfg) {
+    audio_tones_stop();
+
+    if (cfg->block_ms == 0 || cfg->debounce == 0 || (!cfg->count && !cfg->dtmf)) {
+        ESP_LOGE(TAG, "Bad detector config");
+        return false;
+    }
+    s_cfg = *cfg;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_present, 0, sizeof(s_present));
+    memset(s_flip, 0, sizeof(s_flip));
+    s_share_q16 = (uint32_t)(cfg->min_share * AUDIO_GOERTZEL_RATIO_ONE);
+
+    if (cfg->count) {
+        audio_goertzel_config_t g = {
+            .sample_rate = AUDIO_SAMPLE_RATE,
+            .block_size  = (uint16_t)(AUDIO_SAMPLE_RATE / 1000 * cfg->block_ms),
+            .count       = cfg->count,
+        };
+        memcpy(g.freq_hz, cfg->freq_hz, sizeof(g.freq_hz));
+        if (!audio_goertzel_init(&s_bank, &g)) {
+            ESP_LOGE(TAG, "Unsupported tones / %u ms block", cfg->block_ms);
+            return false;
+        }
+    }
+    if (cfg->dtmf && !audio_dtmf_init(&s_dtmf, AUDIO_SAMPLE_RATE)) return false;
+
+    if (!s_queue) s_queue = xQueueCreate(AUDIO_TONES_QUEUE_LEN, sizeof(audio_tone_event_t));
+    if (!s_queue) return false;
+
+    audio_stream_start();
+    if (!audio_stream_subscribe(&s_sub)) {
+        ESP_LOGE(TAG, "No free audio stream slot");
+        return false;
+    }
+
+    s_running = true;
+    xTaskCreatePinnedToCore(
+        tones_task,
+        "audio_tones",
+        3072,
+        NULL,
+        5,
+        &s_task,
+        0  /* CPU0 */
+    );
+    return true;
+}
+
+void audio_tones_stop(void) {
+    if (!s_running) return;
+
+    s_running = false;
+
+    /* Wait for the task to actually finish (up to 500ms) */
+    for (int i = 0; i < 50 && s_task != NULL; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    if (s_task != NULL) {
+        ESP_LOGW(TAG, "Detector task did not stop in time, forcing delete");
+        vTaskDelete(s_task);
+        s_task = NULL;
+        audio_stream_unsubscribe(&s_sub);
+    }
+    xQueueReset(s_queue);
+}
+
+bool audio_tones_running(void) {
+    return s_running;
+}
+
+bool audio_tones_receive(audio_tone_event_t *ev, uint32_t timeout_ms) {
+    if (!s_queue) return false;
+    return xQueueReceive(s_queue, ev, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+void audio_tones_get_stats(audio_tones_stats_t *out) {
+    *out = s_stats;
+    if (s_running) out->overruns = s_sub.overruns;
+}
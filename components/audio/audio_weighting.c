@@ -0,0 +1,141 @@
+/*
+ * Audio weighting implementation – bilinear design of the A / C sections
+ * and the Q29 biquad cascade.
+ */
+
+#include "audio_weighting.h"
+#include <string.h>
+
+#define COEF_SHIFT      29
+#define COEF_ONE        (1 << COEF_SHIFT)
+#define IN_SHIFT        2           /* Full scale at 2^29: 4x headroom in 32 bits */
+#define SQ_SHIFT        4           /* Squares of (y >> 4) sum 1024 samples in 64 bits */
+#define FULL_SCALE_SQ   ((double)(1ull << (2 * (31 - IN_SHIFT - SQ_SHIFT))))
+
+/* IEC 61672-1 pole frequencies (the fourth, 12194 Hz, see below) */
+#define F1_HZ           20.598997
+#define F2_HZ           107.65265
+#define F3_HZ           737.86223
+#define F4_DIGITAL_HZ   11500.0     /* Where ω4 lands after pre-warping, fitted on the host */
+#define NORM_HZ         1000.0f
+
+#define TWO_PI          6.283185307179586
+
+/* ── Design ─────────────────────────────────────────────────────────────── */
+static int32_t quantise(double c) {
+    return (int32_t)lrint(c * COEF_ONE);
+}
+
+/* Bilinear transform of N(s) / ((s + p1)(s + p2)) with N = s² (high-pass)
+ * or p1·p2 (low-pass, unity at DC) */
+static void design_section(audio_biquad_t *bq, double p1, double p2, double fs, int highpass) {
+    double c  = 2.0 * fs;
+    double d0 = (c + p1) * (c + p2);
+    double d1 = (c + p1) * (p2 - c) + (p1 - c) * (c + p2);
+    double d2 = (p1 - c) * (p2 - c);
+    double g  = highpass ? c * c / d0 : p1 * p2 / d0;
+    double s  = highpass ? -1.0 : 1.0;
+
+    memset(bq, 0, sizeof(*bq));
+    bq->b0 = quantise(g);
+    bq->b1 = quantise(2.0 * s * g);
+    bq->b2 = quantise(g);
+    bq->a1 = quantise(d1 / d0);
+    bq->a2 = quantise(d2 / d0);
+}
+
+/* |H(e^jω)|² of one section from its quantised coefficients */
+static double section_power(const audio_biquad_t *bq, double w) {
+    double c1 = cos(w), s1 = sin(w), c2 = cos(2 * w), s2 = sin(2 * w);
+    double nr = bq->b0 + bq->b1 * c1 + bq->b2 * c2, ni = -(bq->b1 * s1 + bq->b2 * s2);
+    double dr = COEF_ONE + bq->a1 * c1 + bq->a2 * c2, di = -(bq->a1 * s1 + bq->a2 * s2);
+    return (nr * nr + ni * ni) / (dr * dr + di * di);
+}
+
+static double weighting_power(const audio_weighting_t *w, audio_weight_t kind, double hz) {
+    if (kind == AUDIO_WEIGHT_Z) return 1.0;
+    double om = TWO_PI * hz / w->sample_rate;
+    double p  = section_power(&w->hp, om) * section_power(&w->lp, om);
+    if (kind == AUDIO_WEIGHT_A) p *= section_power(&w->ac, om);
+    return p;
+}
+
+void audio_weighting_init(audio_weighting_t *w, uint32_t sample_rate) {
+    double fs = sample_rate;
+    double w1 = TWO_PI * F1_HZ, w2 = TWO_PI * F2_HZ, w3 = TWO_PI * F3_HZ;
+    /* The top pole sits half-way to Nyquist, where the bilinear transform
+     * squeezes the response.  Pre-warping it to land at F4_DIGITAL_HZ
+     * rather than at 12194 Hz keeps A and C within 0.35 dB of nominal up to
+     * 10 kHz (0.65 dB with the textbook pre-warp, 1.2 dB without) */
+    double w4 = 2.0 * fs * tan(TWO_PI * F4_DIGITAL_HZ / (2.0 * fs));
+
+    memset(w, 0, sizeof(*w));
+    w->sample_rate = sample_rate;
+    design_section(&w->hp, w1, w1, fs, 1);
+    design_section(&w->lp, w4, w4, fs, 0);
+    design_section(&w->ac, w2, w3, fs, 1);
+
+    for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) {
+        w->gain2[k] = (float)(1.0 / weighting_power(w, (audio_weight_t)k, NORM_HZ));
+    }
+}
+
+void audio_weighting_reset(audio_weighting_t *w) {
+    audio_biquad_t *s[] = { &w->hp, &w->lp, &w->ac };
+    for (int i = 0; i < 3; i++) {
+        s[i]->x1 = s[i]->x2 = s[i]->y1 = s[i]->y2 = s[i]->err = 0;
+    }
+}
+
+float audio_weighting_response_db(const audio_weighting_t *w, audio_weight_t kind, float hz) {
+    return (float)(10.0 * log10(weighting_power(w, kind, hz) * w->gain2[kind]));
+}
+
+/* ── Filtering ──────────────────────────────────────────────────────────── */
+/* One section over a block (in-place allowed); returns Σ (y >> SQ_SHIFT)² */
+static uint64_t run_section(audio_biquad_t *bq, const int32_t *in, int32_t *out, size_t n) {
+    int32_t b0 = bq->b0, b1 = bq->b1, b2 = bq->b2, a1 = bq->a1, a2 = bq->a2;
+    int32_t x1 = bq->x1, x2 = bq->x2, y1 = bq->y1, y2 = bq->y2;
+    int64_t err = bq->err;
+    uint64_t sq = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int32_t x   = in[i];
+        int64_t acc = (int64_t)b0 * x + (int64_t)b1 * x1 + (int64_t)b2 * x2
+                    - (int64_t)a1 * y1 - (int64_t)a2 * y2 + err;
+        int64_t y   = acc >> COEF_SHIFT;
+        err = acc - (y << COEF_SHIFT);          /* First-order error feedback */
+        if (y > INT32_MAX) y = INT32_MAX;
+        if (y < INT32_MIN) y = INT32_MIN;
+
+        x2 = x1; x1 = x;
+        y2 = y1; y1 = (int32_t)y;
+        out[i] = y1;
+
+        int32_t r = y1 >> SQ_SHIFT;
+        sq += (uint64_t)((int64_t)r * r);
+    }
+
+    bq->x1 = x1; bq->x2 = x2; bq->y1 = y1; bq->y2 = y2;
+    bq->err = (int32_t)err;
+    return sq;
+}
+
+void audio_weighting_process(audio_weighting_t *w, const int32_t *in, int32_t *work,
+                             size_t count, float ms[AUDIO_WEIGHT_COUNT]) {
+    uint64_t sq_z = 0;
+    for (size_t i = 0; i < count; i++) {
+        work[i] = in[i] >> IN_SHIFT;
+        int32_t r = work[i] >> SQ_SHIFT;
+        sq_z += (uint64_t)((int64_t)r * r);
+    }
+
+    run_section(&w->hp, work, work, count);
+    uint64_t sq_c = run_section(&w->lp, work, work, count);
+    uint64_t sq_a = run_section(&w->ac, work, work, count);
+
+    double scale = count ? 1.0 / (FULL_SCALE_SQ * count) : 0;
+    ms[AUDIO_WEIGHT_A] = (float)(sq_a * scale) * w->gain2[AUDIO_WEIGHT_A];
+    ms[AUDIO_WEIGHT_C] = (float)(sq_c * scale) * w->gain2[AUDIO_WEIGHT_C];
+    ms[AUDIO_WEIGHT_Z] = (float)(sq_z * scale);
+}
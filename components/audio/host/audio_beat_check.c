@@ -0,0 +1,333 @@
+/*
+ * Host-side onset / tempo / beat check against annotated WAV fixtures.
+ *
+ * Synthesises drum patterns (four-on-the-floor, rock backbeat, noisy
+ * dance, fast and slow tempi, a tempo change) over a sustained chord pad,
+ * plus inputs that must not lock a tempo.  Each fixture is written as a
+ * 16-bit PCM WAV with a matching .txt of annotated beat times, read back
+ * and run through audio_onset hop by hop.  Checked per fixture:
+ *
+ *   - beat F-measure (±70 ms) after a 3 s settling time, at least 0.9
+ *     (0.8 across a tempo change),
+ *   - final tempo within 2 % of the annotated one (or no lock at all),
+ *   - onset latency: an onset-driven beat must be reported less than one
+ *     FFT frame (AUDIO_ONSET_FFT samples) after the drum hit starts.  A
+ *     hit is seen only once the stream block holding it is complete, so
+ *     the worst case cannot be held under one block (AUDIO_ONSET_HOP).
+ *
+ * The exit status is non-zero if any fixture fails.  A WAV given on the
+ * command line is analysed instead (resampled to 48 kHz); with a beat
+ * annotation file (one time in seconds per line, extra columns ignored)
+ * it is scored too, so real recordings can be checked.
+ *
+ * Build and run (from the repo root): `make audio_beat_check`
+ *
+ * Usage:
+ *   audio_beat_check [-o dir]              generate fixtures in dir and check them
+ *   audio_beat_check file.wav [beats.txt]  analyse (and score) a recording
+ */
+
+#include "audio_onset.h"
+#include "host_wav.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TWO_PI      6.28318530717958647692
+#define RATE        AUDIO_SAMPLE_RATE
+#define MAX_SECONDS 20
+#define MAX_BEATS   1024
+#define TOLERANCE_S 0.070
+#define SETTLE_S    3.0
+
+/* ── Analysis ───────────────────────────────────────────────────────────── */
+typedef struct {
+    double beat[MAX_BEATS];         /* Reported beat times, s */
+    bool   predicted[MAX_BEATS];
+    size_t beats;
+    size_t onsets;
+    float  bpm, confidence;         /* At the end of the input */
+    bool   locked;
+} analysis_t;
+
+static void analyse(const int16_t *pcm, size_t count, analysis_t *a, bool verbose) {
+    static audio_onset_t o;
+    memset(a, 0, sizeof(*a));
+    if (!audio_onset_init(&o)) return;
+
+    for (size_t pos = 0; pos + AUDIO_ONSET_HOP <= count; pos += AUDIO_ONSET_HOP) {
+        audio_onset_result_t r;
+        audio_onset_process(&o, &pcm[pos], &r);
+        /* Reported when the hop is complete, as on the badge */
+        double t = (double)(pos + AUDIO_ONSET_HOP) / RATE;
+        if (r.onset) a->onsets++;
+        if (r.beat && a->beats < MAX_BEATS) {
+            a->predicted[a->beats] = r.predicted;
+            a->beat[a->beats++]    = t;
+        }
+        if (verbose && r.beat) {
+            printf("  %7.3f s  beat%s  %5.1f BPM  conf %.2f\n",
+                   t, r.predicted ? " (predicted)" : "          ", r.bpm, r.confidence);
+        }
+        a->bpm        = r.bpm;
+        a->confidence = r.confidence;
+    }
+    a->locked = audio_onset_locked(&o);
+    audio_onset_free(&o);
+}
+
+/* F-measure of the beats after SETTLE_S; also the worst and mean delay of
+ * onset-driven beats behind the annotation they match */
+static double score(const analysis_t *a, const double *ref, size_t refs,
+                    double *max_delay, double *mean_delay) {
+    size_t hits = 0, est = 0, truth = 0, delays = 0;
+    double sum = 0;
+    *max_delay = 0;
+    for (size_t i = 0; i < refs; i++) truth += ref[i] >= SETTLE_S;
+    for (size_t i = 0; i < a->beats; i++) {
+        if (a->beat[i] < SETTLE_S) continue;
+        est++;
+        for (size_t j = 0; j < refs; j++) {
+            double d = a->beat[i] - ref[j];
+            if (ref[j] < SETTLE_S || fabs(d) > TOLERANCE_S) continue;
+            hits++;
+            if (!a->predicted[i]) {
+                if (d > *max_delay) *max_delay = d;
+                sum += d;
+                delays++;
+            }
+            break;
+        }
+    }
+    *mean_delay = delays ? sum / delays : 0;
+    if (!est || !truth) return est == truth ? 1.0 : 0.0;
+    double p = (double)hits / est, r = (double)hits / truth;
+    return p + r > 0 ? 2 * p * r / (p + r) : 0;
+}
+
+/* ── Fixtures ───────────────────────────────────────────────────────────── */
+typedef struct {
+    const char *name;
+    float       bpm, bpm2;      /* Tempo, and after the halfway point (0 = same) */
+    float       seconds;
+    const char *pattern;        /* Per 8th note: K kick, S snare, B both, . none */
+    float       hats;           /* 8th-note hi-hat level, 0 = none */
+    float       pad;            /* Chord pad level */
+    float       noise;          /* White noise RMS, relative to full scale */
+    bool        expect_lock;
+    float       min_f;          /* Required F-measure */
+} fixture_t;
+
+static const fixture_t s_fixtures[] = {
+    { "four_floor_120", 120,   0, 12, "K.K.K.K.", 0.08f, 0.06f, 0,     true,  0.9f },
+    { "rock_100",       100,   0, 12, "K.S.K.S.", 0.06f, 0.06f, 0,     true,  0.9f },
+    { "dance_128_noisy",128,   0, 12, "K.K.K.K.", 0.08f, 0.05f, 0.02f, true,  0.9f },
+    { "fast_150",       150,   0, 12, "K.S.K.S.", 0.05f, 0.04f, 0,     true,  0.9f },
+    { "slow_80",         80,   0, 14, "K.S.K.S.", 0.03f, 0.06f, 0,     true,  0.9f },
+    /* The history window takes a few seconds to forget the old tempo */
+    { "change_110_130", 110, 130, 20, "K.S.K.S.", 0.05f, 0.05f, 0,     true,  0.8f },
+    { "pad_only",       100,   0, 12, "........", 0,     0.10f, 0,     false, 0    },
+    { "noise_only",     120,   0, 10, "........", 0,     0,     0.03f, false, 0    },
+};
+
+static uint32_t s_seed = 0x1234567u;
+
+static double noise(void) {
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return (s_seed >> 8) / 8388608.0 - 1.0;
+}
+
+/* Add a drum hit at @p start; returns nothing, mixes into @p mix */
+static void add_kick(double *mix, size_t n, size_t start) {
+    double phase = 0;
+    for (size_t i = 0; i < RATE / 4 && start + i < n; i++) {
+        double t = (double)i / RATE;
+        phase += TWO_PI * (50 + 100 * exp(-t / 0.03)) / RATE;
+        mix[start + i] += 0.5 * exp(-t / 0.12) * sin(phase);
+    }
+}
+
+static void add_snare(double *mix, size_t n, size_t start) {
+    for (size_t i = 0; i < RATE / 5 && start + i < n; i++) {
+        double t = (double)i / RATE;
+        mix[start + i] += exp(-t / 0.06) * (0.25 * noise() + 0.15 * sin(TWO_PI * 190 * t));
+    }
+}
+
+static void add_hat(double *mix, size_t n, size_t start, double level) {
+    double prev = 0;
+    for (size_t i = 0; i < RATE / 20 && start + i < n; i++) {
+        double t = (double)i / RATE, w = noise();
+        mix[start + i] += level * exp(-t / 0.015) * (w - prev);    /* Crude high-pass */
+        prev = w;
+    }
+}
+
+static size_t synthesise(const fixture_t *fx, int16_t *pcm, size_t max, double *beats, size_t *nbeats) {
+    static double mix[RATE * MAX_SECONDS];
+    size_t n = (size_t)(fx->seconds * RATE);
+    if (n > max) n = max;
+    memset(mix, 0, n * sizeof(double));
+    *nbeats = 0;
+
+    /* Drums, 8th note by 8th note, starting half a second in */
+    double t = 0.5;
+    for (int step = 0; t < fx->seconds - 0.5; step++) {
+        float  bpm  = fx->bpm2 > 0 && t >= fx->seconds / 2 ? fx->bpm2 : fx->bpm;
+        size_t at   = (size_t)(t * RATE);
+        char   hit  = fx->pattern[step % 8];
+        if (step % 2 == 0 && *nbeats < MAX_BEATS) beats[(*nbeats)++] = t;
+        if (hit == 'K' || hit == 'B') add_kick(mix, n, at);
+        if (hit == 'S' || hit == 'B') add_snare(mix, n, at);
+        if (fx->hats > 0) add_hat(mix, n, at, fx->hats);
+        t += 30.0 / bpm;
+    }
+    if (!strchr(fx->pattern, 'K') && !strchr(fx->pattern, 'S')) *nbeats = 0;
+
+    /* Sustained chords changing every 2 s with a soft 100 ms crossfade */
+    static const double chords[4][3] = {
+        { 220.0, 277.2, 329.6 }, { 196.0, 246.9, 293.7 },
+        { 174.6, 220.0, 261.6 }, { 164.8, 207.7, 246.9 },
+    };
+    for (size_t i = 0; fx->pad > 0 && i < n; i++) {
+        double s = (double)i / RATE, pos = fmod(s, 2.0);
+        int    c = (int)(s / 2.0) % 4;
+        double g = pos < 0.1 ? pos / 0.1 : 1.0;
+        for (int k = 0; k < 3; k++) {
+            mix[i] += fx->pad * g * sin(TWO_PI * chords[c][k] * s);
+            if (pos < 0.1) mix[i] += fx->pad * (1 - g) * sin(TWO_PI * chords[(c + 3) % 4][k] * s);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        double v = (mix[i] + fx->noise * 1.7320508 * noise()) * 32767.0;
+        pcm[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : lrint(v));
+    }
+    return n;
+}
+
+static bool write_beats(const char *path, const double *beats, size_t n) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    for (size_t i = 0; i < n; i++) fprintf(f, "%.4f\n", beats[i]);
+    fclose(f);
+    return true;
+}
+
+static size_t read_beats(const char *path, double *beats, size_t max) {
+    FILE *f = fopen(path, "r");
+    char  line[128];
+    size_t n = 0;
+    if (!f) return 0;
+    while (n < max && fgets(line, sizeof(line), f)) {
+        char *end;
+        double t = strtod(line, &end);
+        if (end != line) beats[n++] = t;
+    }
+    fclose(f);
+    return n;
+}
+
+/* Linear-interpolation resample to the badge rate; malloc'd */
+static int16_t *resample(const int16_t *in, size_t n, uint32_t rate, size_t *out_n) {
+    *out_n = (size_t)((double)n * RATE / rate);
+    int16_t *out = malloc(*out_n * sizeof(int16_t));
+    for (size_t i = 0; out && i < *out_n; i++) {
+        double x = (double)i * rate / RATE;
+        size_t k = (size_t)x;
+        double f = x - k;
+        int    b = k + 1 < n ? in[k + 1] : in[k];
+        out[i] = (int16_t)lrint(in[k] * (1 - f) + b * f);
+    }
+    return out;
+}
+
+static int run_fixtures(const char *dir) {
+    static int16_t pcm[RATE * MAX_SECONDS];
+    static double  ref[MAX_BEATS];
+    static analysis_t a;
+    char path[512], beats_path[512];
+    int  failed = 0;
+    const int count = (int)(sizeof(s_fixtures) / sizeof(s_fixtures[0]));
+    const double max_latency = (double)AUDIO_ONSET_FFT / RATE;
+
+    for (int i = 0; i < count; i++) {
+        const fixture_t *fx = &s_fixtures[i];
+        size_t refs;
+        size_t n = synthesise(fx, pcm, sizeof(pcm) / sizeof(pcm[0]), ref, &refs);
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, fx->name);
+        snprintf(beats_path, sizeof(beats_path), "%s/%s.txt", dir, fx->name);
+        if (!wav_write(path, pcm, n, RATE) || !write_beats(beats_path, ref, refs)) {
+            printf("FAIL %-16s cannot write %s\n", fx->name, path);
+            failed++;
+            continue;
+        }
+
+        size_t   got_n;
+        uint32_t rate;
+        int16_t *wav = wav_read(path, &got_n, &rate);
+        refs = read_beats(beats_path, ref, MAX_BEATS);
+        if (!wav) {
+            printf("FAIL %-16s cannot read %s\n", fx->name, path);
+            failed++;
+            continue;
+        }
+        analyse(wav, got_n, &a, false);
+        free(wav);
+
+        float  expect = fx->bpm2 > 0 ? fx->bpm2 : fx->bpm;
+        double max_d, mean_d;
+        double f = score(&a, ref, refs, &max_d, &mean_d);
+        bool ok;
+        if (fx->expect_lock) {
+            ok = a.locked && fabsf(a.bpm - expect) <= 0.02f * expect &&
+                 f >= fx->min_f && max_d < max_latency;
+            printf("%s %-16s %5.1f BPM  got %5.1f (conf %.2f)  F %.2f  "
+                   "onset delay mean %4.1f max %4.1f ms\n",
+                   ok ? "pass" : "FAIL", fx->name, expect, a.bpm, a.confidence, f,
+                   mean_d * 1000, max_d * 1000);
+        } else {
+            ok = !a.locked;
+            printf("%s %-16s no tempo    got %5.1f (conf %.2f)  %zu onsets, %zu beats\n",
+                   ok ? "pass" : "FAIL", fx->name, a.bpm, a.confidence, a.onsets, a.beats);
+        }
+        if (!ok) failed++;
+    }
+    printf("%d/%d fixtures passed (WAVs and beat annotations in %s, "
+           "latency limit %.1f ms)\n", count - failed, count, dir, max_latency * 1000);
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = "build/host/beat";
+    if (argc == 3 && !strcmp(argv[1], "-o")) {
+        dir = argv[2];
+    } else if (argc > 1) {
+        static analysis_t a;
+        static double ref[MAX_BEATS];
+        size_t   n, n48;
+        uint32_t rate;
+        int16_t *pcm = wav_read(argv[1], &n, &rate);
+        if (!pcm) {
+            printf("%s: not a 16-bit PCM WAV\n", argv[1]);
+            return 1;
+        }
+        int16_t *in = rate == RATE ? pcm : resample(pcm, n, rate, &n48);
+        if (rate == RATE) n48 = n;
+        printf("%s (%u Hz, %.2f s)\n", argv[1], (unsigned)rate, (double)n / rate);
+        analyse(in, n48, &a, true);
+        printf("  tempo %.1f BPM, confidence %.2f%s, %zu onsets, %zu beats\n",
+               a.bpm, a.confidence, a.locked ? "" : " (not locked)", a.onsets, a.beats);
+        if (argc > 2) {
+            double max_d, mean_d;
+            size_t refs = read_beats(argv[2], ref, MAX_BEATS);
+            double f = score(&a, ref, refs, &max_d, &mean_d);
+            printf("  F-measure %.3f against %zu annotated beats\n", f, refs);
+        }
+        if (in != pcm) free(in);
+        free(pcm);
+        return 0;
+    }
+    return run_fixtures(dir);
+}
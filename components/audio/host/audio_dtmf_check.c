@@ -0,0 +1,197 @@
+/*
+ * Host-side DTMF decoder check against WAV fixtures.
+ *
+ * Synthesises a set of fixture recordings (clean digits at 48 and 8 kHz,
+ * minimum-length digits, noise and twist, dropouts, and inputs that must
+ * not decode), writes each one as a 16-bit PCM WAV, reads it back and runs
+ * it through audio_dtmf at the file's sample rate.  The decoded string is
+ * compared with the expected one; the exit status is non-zero if any
+ * fixture fails.  WAV files given on the command line are decoded and
+ * printed instead, so real recordings from the badge can be checked too.
+ *
+ * Build and run (from the repo root): `make audio_dtmf_check`
+ *
+ * Usage:
+ *   audio_dtmf_check [-o dir]          generate fixtures in dir and check them
+ *   audio_dtmf_check file.wav ...      decode recordings
+ */
+
+#include "audio_dtmf.h"
+#include "host_wav.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TWO_PI      6.28318530717958647692
+#define MAX_SECONDS 8
+#define MAX_DIGITS  32
+
+/* ── Decoding ───────────────────────────────────────────────────────────── */
+static void decode(const int16_t *pcm, size_t count, uint32_t rate, char *digits, bool verbose) {
+    audio_dtmf_t d;
+    size_t n = 0;
+    digits[0] = '\0';
+    if (!audio_dtmf_init(&d, rate)) {
+        printf("  unsupported sample rate %u\n", (unsigned)rate);
+        return;
+    }
+    for (size_t used = 0; used < count; ) {
+        audio_dtmf_event_t ev;
+        bool has;
+        used += audio_dtmf_feed(&d, &pcm[used], count - used, &ev, &has);
+        if (!has) continue;
+        if (ev.down && n < MAX_DIGITS) {
+            digits[n++] = ev.key;
+            digits[n]   = '\0';
+        }
+        if (verbose) {
+            printf("  %7.3f s  %c %s", (double)used / rate, ev.key, ev.down ? "down" : "up");
+            if (!ev.down) printf(" (%u ms)", (unsigned)ev.duration_ms);
+            printf("\n");
+        }
+    }
+}
+
+/* ── Fixtures ───────────────────────────────────────────────────────────── */
+typedef struct {
+    const char *name;
+    uint32_t    rate;
+    const char *keys;       /* Played digits */
+    const char *expect;     /* Expected decode */
+    uint16_t    on_ms, off_ms;
+    float       dbfs;       /* Per-tone peak level */
+    float       twist_db;   /* Column level relative to row */
+    float       snr_db;     /* White noise below the tones, 0 = none */
+    uint16_t    dropout_ms; /* Gap cut into the middle of each digit */
+} fixture_t;
+
+static const fixture_t s_fixtures[] = {
+    { "clean_48k",    48000, "123A456B789C*0#D", "123A456B789C*0#D", 60, 60,  -10,  0,  0,  0 },
+    { "clean_8k",      8000, "0123456789",       "0123456789",       60, 60,  -10,  0,  0,  0 },
+    { "minimum_40ms", 48000, "159#",             "159#",             40, 40,  -10,  0,  0,  0 },
+    { "quiet",        48000, "2580",             "2580",             80, 80,  -36,  0,  0,  0 },
+    { "noise_15db",   48000, "13579",            "13579",            80, 80,  -12,  0, 15,  0 },
+    { "twist_-6db",   48000, "D*7",              "D*7",              80, 80,  -10, -6,  0,  0 },
+    { "twist_+3db",   48000, "ABC",              "ABC",              80, 80,  -10,  3,  0,  0 },
+    { "dropout_10ms", 48000, "44",               "44",              200, 80,  -10,  0,  0, 10 },
+    { "too_short",    48000, "123",              "",                 15, 60,  -10,  0,  0,  0 },
+    { "twist_+10db",  48000, "6",                "",                 80, 80,  -10, 10,  0,  0 },
+    { "noise_only",   48000, "",                 "",                  0,  0,  -20,  0,  0,  0 },
+};
+
+static const char *const s_keypad = "123A456B789C*0#D";
+
+static void key_tones(char key, float *row_hz, float *col_hz) {
+    static const float rows[4] = { 697, 770, 852, 941 };
+    static const float cols[4] = { 1209, 1336, 1477, 1633 };
+    int idx = (int)(strchr(s_keypad, key) - s_keypad);
+    *row_hz = rows[idx / 4];
+    *col_hz = cols[idx % 4];
+}
+
+static size_t synthesise(const fixture_t *fx, int16_t *pcm, size_t max) {
+    uint32_t seed = 0x2468ace1u;
+    size_t   n    = 0;
+    double   amp  = 32767.0 * pow(10.0, fx->dbfs / 20.0);
+    double   col  = pow(10.0, fx->twist_db / 20.0);
+    double   nrms = fx->snr_db > 0 ? amp * 0.7071 * pow(10.0, -fx->snr_db / 20.0) : 0.0;
+    if (!fx->keys[0]) nrms = amp;                       /* Noise-only fixture */
+    size_t lead = fx->rate / 10;                        /* 100 ms of lead-in and tail */
+
+    size_t total = lead * 2;
+    for (const char *k = fx->keys; *k; k++) total += (size_t)(fx->on_ms + fx->off_ms) * fx->rate / 1000;
+    if (total > max) total = max;
+
+    const char *k = fx->keys;
+    size_t key_start = lead, on = (size_t)fx->on_ms * fx->rate / 1000;
+    size_t period = on + (size_t)fx->off_ms * fx->rate / 1000;
+    size_t gap = (size_t)fx->dropout_ms * fx->rate / 1000;
+    for (n = 0; n < total; n++) {
+        double v = 0;
+        if (*k && n >= key_start) {
+            size_t t = n - key_start;
+            if (t >= period) {
+                key_start += period;
+                k++;
+                t -= period;
+            }
+            bool in_gap = gap && t >= (on - gap) / 2 && t < (on + gap) / 2;
+            if (*k && t < on && !in_gap) {
+                float rf, cf;
+                key_tones(*k, &rf, &cf);
+                v = amp * (sin(TWO_PI * rf * n / fx->rate) + col * sin(TWO_PI * cf * n / fx->rate));
+            }
+        }
+        if (nrms > 0) {
+            /* Sum of uniforms: roughly Gaussian, unit variance */
+            double u = 0;
+            for (int j = 0; j < 12; j++) {
+                seed = seed * 1664525u + 1013904223u;
+                u += (seed >> 8) / 16777216.0;
+            }
+            v += nrms * (u - 6.0);
+        }
+        pcm[n] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : lrint(v));
+    }
+    return n;
+}
+
+static int run_fixtures(const char *dir) {
+    static int16_t pcm[48000 * MAX_SECONDS];
+    char path[512], digits[MAX_DIGITS + 1];
+    int  failed = 0;
+    const int count = (int)(sizeof(s_fixtures) / sizeof(s_fixtures[0]));
+
+    for (int i = 0; i < count; i++) {
+        const fixture_t *fx = &s_fixtures[i];
+        size_t   n = synthesise(fx, pcm, sizeof(pcm) / sizeof(pcm[0]));
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, fx->name);
+        if (!wav_write(path, pcm, n, fx->rate)) {
+            printf("FAIL %-14s cannot write %s\n", fx->name, path);
+            failed++;
+            continue;
+        }
+
+        size_t   got_n;
+        uint32_t rate;
+        int16_t *wav = wav_read(path, &got_n, &rate);
+        if (!wav) {
+            printf("FAIL %-14s cannot read %s\n", fx->name, path);
+            failed++;
+            continue;
+        }
+        decode(wav, got_n, rate, digits, false);
+        free(wav);
+
+        bool ok = !strcmp(digits, fx->expect);
+        printf("%s %-14s %5u Hz  expected \"%s\"  got \"%s\"\n",
+               ok ? "pass" : "FAIL", fx->name, (unsigned)rate, fx->expect, digits);
+        if (!ok) failed++;
+    }
+    printf("%d/%d fixtures passed (WAVs in %s)\n", count - failed, count, dir);
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = "build/host/dtmf";
+    if (argc == 3 && !strcmp(argv[1], "-o")) dir = argv[2];
+    else if (argc > 1) {
+        char digits[MAX_DIGITS + 1];
+        for (int i = 1; i < argc; i++) {
+            size_t   n;
+            uint32_t rate;
+            int16_t *pcm = wav_read(argv[i], &n, &rate);
+            if (!pcm) {
+                printf("%s: not a 16-bit PCM WAV\n", argv[i]);
+                continue;
+            }
+            printf("%s (%u Hz, %.2f s)\n", argv[i], (unsigned)rate, (double)n / rate);
+            decode(pcm, n, rate, digits, true);
+            printf("  digits: \"%s\"\n", digits);
+            free(pcm);
+        }
+        return 0;
+    }
+    return run_fixtures(dir);
+}
@@ -0,0 +1,206 @@
+/*
+ * Host-side check of the spectrum screen's delta bar painter.
+ *
+ * audio_spectrum_screen.c is compiled unchanged against an in-memory
+ * framebuffer that stands in for the ST7789.  Frames of noisy bars (random
+ * walks with bursts and silent stretches, max hold toggled along the way)
+ * are fed through audio_spectrum_screen_update() and drawn; after every
+ * frame the spectrum area is compared pixel by pixel with the previous
+ * painter, which cleared and repainted every bar column in full:
+ * background, grid line, max hold, bar, then the peak marker on top.
+ *
+ * The old painter drew a peak marker of height 0 one row below the area
+ * (over the footer); the reference clamps it to the bottom row, as the
+ * delta painter does.
+ *
+ * Windows and pixels sent per frame are reported against the full-column
+ * cost.  The exit status is non-zero if any pixel differs or the delta
+ * painter sends more pixels than the full repaint.
+ *
+ * Build and run (from the repo root): `make audio_spectrum_check`
+ */
+
+#include "audio_spectrum_screen.h"
+#include "audio_stream.h"
+#include "audio_beat.h"
+#include "st7789.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRAMES          600
+#define HOLD_EVERY      150     /* Frames between max hold toggles */
+
+/* Layout and colours, as in audio_spectrum_screen.c */
+#define SPECTRUM_X      4
+#define SPECTRUM_Y      50
+#define SPECTRUM_H      110
+#define BAR_WIDTH       3
+#define COLOR_BG        0x0000
+#define COLOR_GRID      0x4208
+#define COLOR_SPECTRUM  0x07E0
+#define COLOR_PEAK      0xAFE0
+#define COLOR_MAX_HOLD  0x041F
+
+/* ── Display stand-in ───────────────────────────────────────────────────── */
+static uint16_t s_fb[ST7789_HEIGHT][ST7789_WIDTH];
+static uint32_t s_windows, s_pixels;        /* draw_buffer traffic */
+
+void st7789_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t colour) {
+    for (uint32_t yy = y; yy < (uint32_t)y + h && yy < ST7789_HEIGHT; yy++) {
+        for (uint32_t xx = x; xx < (uint32_t)x + w && xx < ST7789_WIDTH; xx++) {
+            s_fb[yy][xx] = colour;
+        }
+    }
+}
+
+void st7789_fill(uint16_t colour) {
+    st7789_fill_rect(0, 0, ST7789_WIDTH, ST7789_HEIGHT, colour);
+}
+
+/* Text is not checked: paint its background box */
+void st7789_draw_string(uint16_t x, uint16_t y, const char *s, uint16_t fg, uint16_t bg,
+                        uint8_t scale) {
+    (void)fg;
+    if (scale < 1) scale = 1;
+    st7789_fill_rect(x, y, (uint16_t)(strlen(s) * 8 * scale), 16 * scale, bg);
+}
+
+/* @p buf is in wire (big-endian) order */
+void st7789_draw_buffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *buf) {
+    for (uint32_t row = 0; row < h && y + row < ST7789_HEIGHT; row++) {
+        for (uint32_t col = 0; col < w && x + col < ST7789_WIDTH; col++) {
+            uint16_t px = buf[row * w + col];
+            s_fb[y + row][x + col] = (uint16_t)((px >> 8) | (px << 8));
+        }
+    }
+    s_windows++;
+    s_pixels += (uint32_t)w * h;
+}
+
+void st7789_scroll_area(uint16_t fixed_left, uint16_t fixed_right) {
+    (void)fixed_left; (void)fixed_right;
+}
+void st7789_scroll_to(uint16_t x) { (void)x; }
+void st7789_scroll_reset(void) {}
+
+/* ── Audio and RTOS stand-ins (the capture task is never started) ───────── */
+bool audio_stream_subscribe(audio_sub_t *sub) { sub->active = true; return true; }
+void audio_stream_unsubscribe(audio_sub_t *sub) { sub->active = false; }
+bool audio_stream_read(audio_sub_t *sub, audio_block_t *out, uint32_t timeout_ms) {
+    (void)sub; (void)out; (void)timeout_ms;
+    return false;
+}
+
+bool audio_beat_start(void) { return true; }
+void audio_beat_stop(void) {}
+void audio_beat_get(audio_beat_state_t *out) { memset(out, 0, sizeof(*out)); }
+
+int64_t esp_timer_get_time(void) { return 0; }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack,
+                                   void *arg, unsigned prio, TaskHandle_t *out, int core) {
+    (void)fn; (void)name; (void)stack; (void)arg; (void)prio; (void)out; (void)core;
+    return pdPASS;
+}
+void vTaskDelete(TaskHandle_t task) { (void)task; }
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
+
+/* ── Reference: the previous full-column painter ────────────────────────── */
+static uint16_t s_ref[SPECTRUM_H][ST7789_WIDTH];
+
+static void ref_fill(int x, int y, int w, int h, uint16_t colour) {
+    for (int yy = y; yy < y + h && yy < SPECTRUM_H; yy++) {
+        for (int xx = x; xx < x + w && xx < ST7789_WIDTH; xx++) s_ref[yy][xx] = colour;
+    }
+}
+
+static void ref_paint(const audio_spectrum_screen_t *screen) {
+    for (int i = 0; i < AUDIO_SPECTRUM_BARS; i++) {
+        int x = SPECTRUM_X + i * BAR_WIDTH;
+        int max_mag = screen->max_hold_enabled ? screen->max_hold[i] : 0;
+
+        ref_fill(x, 0, BAR_WIDTH, SPECTRUM_H, COLOR_BG);
+        if (i % 16 == 0) ref_fill(x, 0, 1, SPECTRUM_H, COLOR_GRID);
+        if (max_mag > 0) {
+            int h = max_mag * SPECTRUM_H / 255;
+            ref_fill(x, SPECTRUM_H - h, BAR_WIDTH, h, COLOR_MAX_HOLD);
+        }
+        int h = screen->spectrum[i] * SPECTRUM_H / 255;
+        if (h > 0) ref_fill(x, SPECTRUM_H - h, BAR_WIDTH, h, COLOR_SPECTRUM);
+        if (screen->peak_hold[i] > 0) {
+            int y = SPECTRUM_H - screen->peak_hold[i] * SPECTRUM_H / 255;
+            if (y > SPECTRUM_H - 1) y = SPECTRUM_H - 1;
+            ref_fill(x, y, BAR_WIDTH, 1, COLOR_PEAK);
+        }
+    }
+}
+
+static uint32_t compare(void) {
+    uint32_t bad = 0;
+    for (int y = 0; y < SPECTRUM_H; y++) {
+        for (int x = SPECTRUM_X; x < ST7789_WIDTH; x++) {
+            if (s_fb[SPECTRUM_Y + y][x] != s_ref[y][x]) bad++;
+        }
+    }
+    return bad;
+}
+
+/* ── Input: random walks with bursts and silent stretches ───────────────── */
+static uint32_t s_seed = 0x5EC7;
+
+static int rnd(int n) {
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return (int)((s_seed >> 8) % (uint32_t)n);
+}
+
+static void next_bars(int frame, uint8_t *bars) {
+    static int level[AUDIO_SPECTRUM_BARS];
+    bool silent = (frame / 50) % 6 == 5;
+    bool burst  = rnd(20) == 0;
+    for (int i = 0; i < AUDIO_SPECTRUM_BARS; i++) {
+        int v = level[i] + rnd(41) - 20;
+        if (burst && rnd(3) == 0) v += 120;
+        if (silent) v = level[i] / 2;
+        if (v < 0) v = 0;
+        if (v > 255) v = 255;
+        level[i] = v;
+        bars[i] = (uint8_t)v;
+    }
+}
+
+int main(void) {
+    static audio_spectrum_screen_t screen;
+    uint8_t bars[AUDIO_SPECTRUM_BARS];
+
+    audio_spectrum_screen_init(&screen);
+    audio_spectrum_screen_draw(&screen);
+
+    uint32_t bad = 0, bad_frames = 0;
+    s_windows = s_pixels = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        if (f && f % HOLD_EVERY == 0) audio_spectrum_toggle_max_hold(&screen);
+        next_bars(f, bars);
+        audio_spectrum_screen_update(&screen, bars);
+        audio_spectrum_screen_draw(&screen);
+
+        ref_paint(&screen);
+        uint32_t n = compare();
+        if (n && !bad_frames) printf("frame %d: %lu pixels differ\n", f, (unsigned long)n);
+        if (n) bad_frames++;
+        bad += n;
+    }
+    audio_spectrum_screen_leave();
+
+    uint32_t full = (uint32_t)(ST7789_WIDTH - SPECTRUM_X) * SPECTRUM_H;
+    printf("%d frames: %lu mismatched pixels in %lu frames\n", FRAMES,
+           (unsigned long)bad, (unsigned long)bad_frames);
+    printf("per frame: %lu windows, %lu px (full columns: %d windows, %lu px)\n",
+           (unsigned long)(s_windows / FRAMES), (unsigned long)(s_pixels / FRAMES),
+           AUDIO_SPECTRUM_BARS, (unsigned long)full);
+
+    int fails = (bad != 0) + (s_pixels / FRAMES >= full);
+    printf("%s (%d failures)\n", fails ? "FAILED" : "all checks passed", fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Host-side check of the A / C weighting filters and SPL calibration.
+ *
+ *   - The response of the quantised cascade at every 1/3-octave centre
+ *     from 10 Hz to 20 kHz is compared with the IEC 61672-1 nominal
+ *     weighting and its class 1 acceptance limits.
+ *   - Sines at known levels (94 dB SPL calibrator tone down to 25 dB SPL,
+ *     near the microphone's own noise) are run through the fixed-point
+ *     filters sample by sample and the measured levels compared with the
+ *     expected ones, which shows the filter's own noise and rounding.
+ *   - The cost per sample is printed for reference.
+ *
+ * The exit status is non-zero if any check fails.
+ *
+ * Build and run (from the repo root): `make audio_spl_check`
+ */
+
+#include "audio.h"
+#include "audio_weighting.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TWO_PI      6.28318530717958647692
+#define BLOCK       256
+#define SETTLE_S    1.0         /* 20.6 Hz high-pass settling before measuring */
+#define MEASURE_S   2.0
+#define LEVEL_TOL   0.2f        /* dB, sine level checks */
+
+/* ── IEC 61672-1 table ──────────────────────────────────────────────────── */
+typedef struct {
+    float hz;
+    float a, c;                 /* Nominal weighting, dB */
+    float tol_hi, tol_lo;       /* Class 1 limits (tol_lo < -90 = no lower limit) */
+} iec_row_t;
+
+static const iec_row_t s_iec[] = {
+    {    10, -70.4, -14.3, 3.5, -99 },
+    {  12.5, -63.4, -11.2, 3.0, -99 },
+    {    16, -56.7,  -8.5, 2.5, -4.5 },
+    {    20, -50.5,  -6.2, 2.5, -2.5 },
+    {    25, -44.7,  -4.4, 2.5, -2.0 },
+    {  31.5, -39.4,  -3.0, 2.0, -1.5 },
+    {    40, -34.6,  -2.0, 1.5, -1.5 },
+    {    50, -30.2,  -1.3, 1.5, -1.5 },
+    {    63, -26.2,  -0.8, 1.5, -1.5 },
+    {    80, -22.5,  -0.5, 1.5, -1.5 },
+    {   100, -19.1,  -0.3, 1.0, -1.0 },
+    {   125, -16.1,  -0.2, 1.0, -1.0 },
+    {   160, -13.4,  -0.1, 1.0, -1.0 },
+    {   200, -10.9,   0.0, 1.0, -1.0 },
+    {   250,  -8.6,   0.0, 1.0, -1.0 },
+    {   315,  -6.6,   0.0, 1.0, -1.0 },
+    {   400,  -4.8,   0.0, 1.0, -1.0 },
+    {   500,  -3.2,   0.0, 1.0, -1.0 },
+    {   630,  -1.9,   0.0, 1.0, -1.0 },
+    {   800,  -0.8,   0.0, 1.0, -1.0 },
+    {  1000,   0.0,   0.0, 0.7, -0.7 },
+    {  1250,   0.6,   0.0, 1.0, -1.0 },
+    {  1600,   1.0,  -0.1, 1.0, -1.0 },
+    {  2000,   1.2,  -0.2, 1.0, -1.0 },
+    {  2500,   1.3,  -0.3, 1.0, -1.0 },
+    {  3150,   1.2,  -0.5, 1.0, -1.0 },
+    {  4000,   1.0,  -0.8, 1.0, -1.0 },
+    {  5000,   0.5,  -1.3, 1.5, -1.5 },
+    {  6300,  -0.1,  -2.0, 1.5, -2.0 },
+    {  8000,  -1.1,  -3.0, 1.5, -2.5 },
+    { 10000,  -2.5,  -4.4, 2.0, -3.0 },
+    { 12500,  -4.3,  -6.2, 2.0, -5.0 },
+    { 16000,  -6.6,  -8.5, 2.5, -16.0 },
+    { 20000,  -9.3, -11.2, 3.0, -99 },
+};
+
+static int check_response(const audio_weighting_t *w) {
+    int fails = 0;
+    float worst[2] = { 0, 0 };
+
+    printf("   Hz      A nom    A got    C nom    C got\n");
+    for (size_t i = 0; i < sizeof(s_iec) / sizeof(s_iec[0]); i++) {
+        const iec_row_t *r = &s_iec[i];
+        float a = audio_weighting_response_db(w, AUDIO_WEIGHT_A, r->hz);
+        float c = audio_weighting_response_db(w, AUDIO_WEIGHT_C, r->hz);
+        float da = a - r->a, dc = c - r->c;
+        bool  ok = da <= r->tol_hi && dc <= r->tol_hi &&
+                   (r->tol_lo < -90 || (da >= r->tol_lo && dc >= r->tol_lo));
+        if (r->hz >= 20 && r->hz <= 10000) {
+            if (fabsf(da) > worst[0]) worst[0] = fabsf(da);
+            if (fabsf(dc) > worst[1]) worst[1] = fabsf(dc);
+        }
+        printf("%s %6g  %7.1f  %7.2f  %7.1f  %7.2f\n", ok ? "    " : "FAIL",
+               r->hz, r->a, a, r->c, c);
+        if (!ok) fails++;
+    }
+    printf("worst deviation 20 Hz - 10 kHz: A %.2f dB, C %.2f dB\n\n", worst[0], worst[1]);
+    return fails;
+}
+
+/* ── Levels ─────────────────────────────────────────────────────────────── */
+typedef struct {
+    float hz;
+    float spl;                  /* Level of the sine at the microphone */
+} tone_t;
+
+static const tone_t s_tones[] = {
+    { 1000,  94.0f },           /* Calibrator */
+    { 1000, 120.0f },           /* Full scale */
+    {  100,  80.0f },
+    {   50,  40.0f },           /* Low level next to the high-pass poles */
+    {  250,  30.0f },
+    { 1000,  25.0f },
+    { 8000,  60.0f },
+};
+
+/* Mean square per weighting of a sine at @p spl dB SPL */
+static void measure_tone(float hz, float spl, float ms[AUDIO_WEIGHT_COUNT], double *ns_per_sample) {
+    static audio_weighting_t w;
+    int32_t in[BLOCK], work[BLOCK];
+    double  amp   = pow(10.0, (spl - AUDIO_SPL_REF_DB + AUDIO_SPL_SENSITIVITY_DBFS) / 20.0);
+    size_t  total = (size_t)((SETTLE_S + MEASURE_S) * AUDIO_SAMPLE_RATE) / BLOCK * BLOCK;
+    size_t  skip  = (size_t)(SETTLE_S * AUDIO_SAMPLE_RATE) / BLOCK * BLOCK;
+    double  sum[AUDIO_WEIGHT_COUNT] = { 0 };
+    size_t  blocks = 0;
+    clock_t ticks = 0;
+
+    audio_weighting_init(&w, AUDIO_SAMPLE_RATE);
+    for (size_t n = 0; n < total; n += BLOCK) {
+        for (int i = 0; i < BLOCK; i++) {
+            double v = amp * 2147483647.0 * sin(TWO_PI * hz * (double)(n + i) / AUDIO_SAMPLE_RATE);
+            in[i] = (int32_t)lrint(v) & ~0xFF;      /* 24-bit word */
+        }
+        float block_ms[AUDIO_WEIGHT_COUNT];
+        clock_t t0 = clock();
+        audio_weighting_process(&w, in, work, BLOCK, block_ms);
+        ticks += clock() - t0;
+        if (n < skip) continue;
+        for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) sum[k] += block_ms[k];
+        blocks++;
+    }
+    for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) ms[k] = (float)(sum[k] / blocks);
+    *ns_per_sample = 1e9 * ticks / CLOCKS_PER_SEC / total;
+}
+
+static int check_levels(const audio_weighting_t *w) {
+    static const char *const names[AUDIO_WEIGHT_COUNT] = { "A", "C", "Z" };
+    int fails = 0;
+    double ns = 0;
+
+    for (size_t i = 0; i < sizeof(s_tones) / sizeof(s_tones[0]); i++) {
+        const tone_t *t = &s_tones[i];
+        float ms[AUDIO_WEIGHT_COUNT];
+        measure_tone(t->hz, t->spl, ms, &ns);
+
+        bool ok = true;
+        printf("%5g Hz %5.1f dB SPL:", t->hz, t->spl);
+        for (int k = 0; k < AUDIO_WEIGHT_COUNT; k++) {
+            float expect = t->spl + audio_weighting_response_db(w, (audio_weight_t)k, t->hz);
+            float got    = audio_spl_db(ms[k]);
+            bool  k_ok   = fabsf(got - expect) <= LEVEL_TOL;
+            printf("  %s %6.2f (%6.2f)%s", names[k], got, expect, k_ok ? "" : " FAIL");
+            ok = ok && k_ok;
+        }
+        printf("\n");
+        if (!ok) fails++;
+    }
+    printf("filter cost %.1f ns per sample on this host\n\n", ns);
+    return fails;
+}
+
+int main(void) {
+    static audio_weighting_t w;
+    audio_weighting_init(&w, AUDIO_SAMPLE_RATE);
+
+    int fails = check_response(&w) + check_levels(&w);
+    printf("%s (%d failures)\n", fails ? "FAILED" : "all checks passed", fails);
+    return fails ? 1 : 0;
+}
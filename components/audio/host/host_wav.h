@@ -0,0 +1,71 @@
+/*
+ * Minimal 16-bit PCM WAV reader / writer for the host audio checks.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void wav_put_u32(FILE *f, uint32_t v) { uint8_t b[4] = { v, v >> 8, v >> 16, v >> 24 }; fwrite(b, 1, 4, f); }
+static void wav_put_u16(FILE *f, uint16_t v) { uint8_t b[2] = { v, v >> 8 }; fwrite(b, 1, 2, f); }
+
+static bool wav_write(const char *path, const int16_t *pcm, size_t count, uint32_t rate) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fwrite("RIFF", 1, 4, f); wav_put_u32(f, 36 + count * 2);
+    fwrite("WAVEfmt ", 1, 8, f); wav_put_u32(f, 16);
+    wav_put_u16(f, 1); wav_put_u16(f, 1); wav_put_u32(f, rate); wav_put_u32(f, rate * 2);
+    wav_put_u16(f, 2); wav_put_u16(f, 16);
+    fwrite("data", 1, 4, f); wav_put_u32(f, count * 2);
+    for (size_t i = 0; i < count; i++) wav_put_u16(f, (uint16_t)pcm[i]);
+    fclose(f);
+    return true;
+}
+
+/* Reads mono or the first channel of multi-channel 16-bit PCM; malloc'd */
+static int16_t *wav_read(const char *path, size_t *count, uint32_t *rate) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    uint8_t hdr[12], ck[8];
+    uint16_t channels = 0, bits = 0;
+    int16_t *pcm = NULL;
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) goto out;
+
+    while (fread(ck, 1, 8, f) == 8) {
+        uint32_t len = ck[4] | ck[5] << 8 | ck[6] << 16 | (uint32_t)ck[7] << 24;
+        if (!memcmp(ck, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (len < 16 || fread(fmt, 1, 16, f) != 16) goto out;
+            fseek(f, len - 16 + (len & 1), SEEK_CUR);
+            channels = fmt[2] | fmt[3] << 8;
+            *rate    = fmt[4] | fmt[5] << 8 | fmt[6] << 16 | (uint32_t)fmt[7] << 24;
+            bits     = fmt[14] | fmt[15] << 8;
+            if ((fmt[0] | fmt[1] << 8) != 1) goto out;      /* PCM only */
+        } else if (!memcmp(ck, "data", 4)) {
+            if (bits != 16 || channels == 0) goto out;
+            size_t frames = len / (2u * channels);
+            int16_t *raw = malloc(len);
+            pcm = malloc(frames * sizeof(int16_t));
+            if (!raw || !pcm || fread(raw, 1, len, f) != len) {
+                free(raw); free(pcm); pcm = NULL;
+                goto out;
+            }
+            for (size_t i = 0; i < frames; i++) {
+                const uint8_t *b = (const uint8_t *)&raw[i * channels];
+                pcm[i] = (int16_t)(b[0] | b[1] << 8);
+            }
+            free(raw);
+            *count = frames;
+            goto out;
+        } else {
+            fseek(f, len + (len & 1), SEEK_CUR);
+        }
+    }
+out:
+    fclose(f);
+    return pcm;
+}
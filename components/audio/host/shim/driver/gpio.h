@@ -0,0 +1,4 @@
+/* Host shim: st7789.h only needs the pin names (headless paint check only) */
+#pragma once
+
+typedef int gpio_num_t;
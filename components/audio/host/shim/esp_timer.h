@@ -0,0 +1,5 @@
+/* Host shim: the check supplies the clock (headless paint check only) */
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
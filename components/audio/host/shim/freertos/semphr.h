@@ -0,0 +1,4 @@
+/* Host shim: audio_stream.h only needs the handle type (headless paint check only) */
+#pragma once
+
+typedef void *SemaphoreHandle_t;
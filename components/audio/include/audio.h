@@ -8,12 +8,17 @@
  *   audio_init()                    – initialise I2S peripheral
  *   audio_read_samples()            – read PCM samples (blocking)
  *   audio_compute_fft()             – compute FFT on sample buffer
+ *
+ * Application code does not read the microphone directly: the always-on
+ * capture task in audio_stream.h is the only I2S reader and shares blocks
+ * with any number of subscribers.
  */
 
 #pragma once
 
 #include <stdint.h>
 #include <stddef.h>
+#include "audio_fft.h"
 
 /* Audio buffer size for FFT (must be power of 2) */
 #define AUDIO_SAMPLE_RATE  48000
@@ -24,6 +29,13 @@
 #define AUDIO_MAX_FREQ     (AUDIO_SAMPLE_RATE / 2)
 #define AUDIO_BIN_WIDTH    (AUDIO_MAX_FREQ / AUDIO_FREQ_BINS)
 
+/* I2S slot width.  32 captures the ICS-43434's full 24-bit word (MSB
+ * aligned in a 32-bit slot) and derives the 16-bit stream samples from it;
+ * 16 reads 16-bit slots directly and loses the bottom 8 bits */
+#ifndef AUDIO_CAPTURE_BITS
+#define AUDIO_CAPTURE_BITS 32
+#endif
+
 /* Audio sample format: signed 16-bit PCM */
 typedef int16_t audio_sample_t;
 
@@ -32,25 +44,43 @@ typedef uint8_t audio_magnitude_t;
 
 /**
  * @brief  Initialise I2S input peripheral for microphone.
- *         Configures I2S for 48 kHz, 16-bit mono PCM input.
+ *         Configures I2S for 48 kHz mono PCM input with
+ *         AUDIO_CAPTURE_BITS-wide slots.
  */
 void audio_init(void);
 
 /**
  * @brief  Read AUDIO_FFT_SIZE samples from microphone (blocking).
  *         Returns raw PCM data in the provided buffer.
+ *         Called by the audio_stream capture task only.
  *
  * @param  samples  Output buffer (must hold AUDIO_FFT_SIZE samples)
+ * @param  raw      Optional output (AUDIO_FFT_SIZE entries) for the same
+ *                  samples at full capture resolution, MSB aligned in 32
+ *                  bits; NULL if not needed
  * @return Number of samples read, or 0 on error
  */
-size_t audio_read_samples(audio_sample_t *samples);
+size_t audio_read_samples(audio_sample_t *samples, int32_t *raw);
+
+/**
+ * @brief  Number of I2S DMA receive-queue overflows since init.
+ */
+uint32_t audio_dma_overflows(void);
+
+/**
+ * @brief  Shared read-only FFT plan for one AUDIO_FFT_SIZE stream block,
+ *         built by audio_init() (NULL before that or if it failed).  Lets
+ *         block consumers (VU, Python) run audio_fft_power() without
+ *         allocating their own tables.
+ */
+const audio_fft_plan_t *audio_block_plan(void);
 
 /**
  * @brief  Compute FFT on the provided sample buffer.
- *         Outputs magnitude spectrum (0-255) for each frequency bin.
- *         Uses in-place radix-2 Cooley-Tukey FFT.
+ *         Outputs magnitude spectrum (0-255, -80..0 dB) for each frequency
+ *         bin.  Uses the real-input radix-4 FFT in audio_fft.h.
  *
- * @param  samples    Input PCM samples (modified in-place during computation)
+ * @param  samples    Input PCM samples (not modified)
  * @param  magnitude  Output magnitudes, AUDIO_FREQ_BINS entries
  */
 void audio_compute_fft(audio_sample_t *samples, audio_magnitude_t *magnitude);
@@ -0,0 +1,43 @@
+/*
+ * Audio ADPCM – streaming IMA ADPCM encoder in WAV (format 0x11) blocks.
+ *
+ * Each block is AUDIO_ADPCM_BLOCK_ALIGN bytes: a 4-byte header holding the
+ * first sample verbatim and the step index, then 4-bit codes for the
+ * remaining AUDIO_ADPCM_BLOCK_SAMPLES − 1 samples (low nibble first).  The
+ * step index carries over between blocks.  16-bit PCM shrinks to ~4.06
+ * bits per sample, so 48 kHz mono is 24 KB/s instead of 96 KB/s.
+ *
+ * Block size is chosen so an integer number of blocks fills a 4 KB flash
+ * sector.  Pure C; no allocation.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define AUDIO_ADPCM_BLOCK_ALIGN     1024
+#define AUDIO_ADPCM_BLOCK_SAMPLES   ((AUDIO_ADPCM_BLOCK_ALIGN - 4) * 2 + 1)    /* 2041 */
+
+typedef struct {
+    int32_t  predictor;
+    uint8_t  index;         /* Step table index, 0..88 */
+    uint16_t pos;           /* Samples already in the current block */
+} audio_adpcm_t;
+
+void audio_adpcm_init(audio_adpcm_t *st);
+
+/**
+ * @brief  Encode up to @p count samples into @p block, stopping when the
+ *         block is full (st->pos wraps to 0; start the next block in a
+ *         fresh buffer).
+ * @return Number of samples consumed.
+ */
+size_t audio_adpcm_encode(audio_adpcm_t *st, const int16_t *in, size_t count, uint8_t *block);
+
+/**
+ * @brief  Pad a partly filled @p block to full size (no-op when empty).
+ * @return true if a padded block was produced.
+ */
+bool audio_adpcm_finish(audio_adpcm_t *st, uint8_t *block);
@@ -0,0 +1,127 @@
+/*
+ * Audio analyzer – overlapped, averaged spectrum for the display.
+ *
+ * Samples from the audio stream are appended to a history of fft_size
+ * samples; every hop (fft_size × (1 − overlap)) a Hann-windowed frame is
+ * transformed with audio_fft_power() and folded into an exponentially
+ * averaged power spectrum (Welch-style averaging over time).  The averaged
+ * spectrum is folded through an audio_bands map (linear 0 – 20 kHz, or
+ * 1/3-octave / mel 20 Hz – 20 kHz) and stretched to AUDIO_SPECTRUM_BARS
+ * display bars.
+ *
+ *   FFT size  bin width   overlap  frames/s
+ *     256     187.5 Hz     50 %     375
+ *    1024      46.9 Hz     50 %      94
+ *    4096      11.7 Hz     75 %      47
+ *
+ * Buffers are allocated by audio_analyzer_init() and sized for the chosen
+ * FFT size; reconfiguring frees and reallocates them.  CPU time spent in
+ * audio_analyzer_feed() is measured per second of audio so the size and
+ * overlap trade-off is visible (audio_analyzer_stats_t.cpu_permille).
+ *
+ * An analyzer is used by one task at a time.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "audio_fft.h"
+#include "audio_bands.h"
+
+#define AUDIO_ANALYZER_MIN_N    256
+#define AUDIO_ANALYZER_MAX_N    4096
+#define AUDIO_SPECTRUM_BARS     107     /* 3-px bars across the screen */
+#define AUDIO_SPECTRUM_MIN_HZ   20      /* Lower edge of the log scales */
+#define AUDIO_SPECTRUM_MAX_HZ   20000
+#define AUDIO_MEL_BANDS         40
+
+typedef enum {
+    AUDIO_OVERLAP_0 = 0,
+    AUDIO_OVERLAP_50,
+    AUDIO_OVERLAP_75,
+    AUDIO_OVERLAP_COUNT
+} audio_overlap_t;
+
+typedef struct {
+    uint16_t        fft_size;   /* Power of two, MIN_N .. MAX_N */
+    audio_overlap_t overlap;
+    float           smoothing;  /* 0 = no averaging .. 0.95 = slow; weight of the old average */
+    audio_band_scale_t scale;   /* Bar axis: linear, 1/3-octave or mel */
+    audio_fft_kind_t   kind;    /* Float or Q15 arithmetic */
+} audio_analyzer_config_t;
+
+#define AUDIO_ANALYZER_DEFAULT_CONFIG() \
+    { .fft_size = 1024, .overlap = AUDIO_OVERLAP_50, .smoothing = 0.5f, \
+      .scale = AUDIO_SCALE_LINEAR, .kind = AUDIO_FFT_DEFAULT_KIND }
+
+typedef struct {
+    uint16_t fft_size;
+    uint16_t hop;               /* Samples between frames */
+    float    bin_hz;
+    uint32_t frames;            /* Frames since init */
+    uint16_t cpu_permille;      /* Feed cost over the last second of audio, ‰ of one core */
+    audio_band_scale_t scale;
+    audio_fft_kind_t   kind;
+} audio_analyzer_stats_t;
+
+typedef struct {
+    audio_analyzer_config_t cfg;
+    audio_fft_plan_t plan;
+    uint16_t  hop;
+    uint16_t  fill;                             /* Samples in hist */
+    int16_t  *hist;                             /* fft_size samples */
+    float    *work;                             /* fft_size floats (int16 for Q15) */
+    float    *power;                            /* fft_size / 2: last frame */
+    float    *avg;                              /* fft_size / 2: averaged */
+    float     db_offset;                        /* Rescales to the 256-point level */
+    audio_band_map_t bands;                     /* Bars' bin ranges */
+    uint32_t  frames;
+    /* CPU accounting */
+    int64_t   busy_us;
+    uint32_t  window_samples;
+    uint16_t  cpu_permille;
+} audio_analyzer_t;
+
+/**
+ * @brief  Allocate buffers and tables for @p cfg.  Frees any previous
+ *         configuration of @p an first (call with a zeroed analyzer the
+ *         first time).
+ * @return false on an invalid size or allocation failure (analyzer empty).
+ */
+bool audio_analyzer_init(audio_analyzer_t *an, const audio_analyzer_config_t *cfg);
+
+/**
+ * @brief  Release all buffers; @p an can be re-initialised afterwards.
+ */
+void audio_analyzer_free(audio_analyzer_t *an);
+
+/**
+ * @brief  Append @p count samples, running one FFT per completed hop.
+ * @return Number of frames folded into the average.
+ */
+int audio_analyzer_feed(audio_analyzer_t *an, const int16_t *samples, size_t count);
+
+/**
+ * @brief  Averaged power spectrum, fft_size / 2 bins (NULL if empty).
+ */
+const float *audio_analyzer_power(const audio_analyzer_t *an);
+
+/**
+ * @brief  Fold the averaged spectrum into the configured bands and stretch
+ *         them to AUDIO_SPECTRUM_BARS bars, -80 .. 0 dB → 0 .. 255.
+ */
+void audio_analyzer_bars(const audio_analyzer_t *an, uint8_t *bars);
+
+void audio_analyzer_get_stats(const audio_analyzer_t *an, audio_analyzer_stats_t *out);
+
+/**
+ * @brief  Frequency range of the bar axis for @p scale.
+ */
+void audio_analyzer_axis(audio_band_scale_t scale, uint16_t *f_lo, uint16_t *f_hi);
+
+/**
+ * @brief  Overlap as a percentage (0, 50, 75).
+ */
+uint8_t audio_overlap_percent(audio_overlap_t overlap);
@@ -0,0 +1,91 @@
+/*
+ * Audio bands – aggregate FFT power into linear, 1/3-octave or mel bands.
+ *
+ * A band map is a precomputed table of FFT bin ranges, one per band, for
+ * a given FFT size.  audio_bands_aggregate() then folds a power spectrum
+ * (as produced by audio_fft_power() or the analyzer average) into band
+ * values in a single pass over the bins – no magnitudes, no logs, no
+ * allocation.  Maps are plain structs owned by the caller.
+ *
+ *   AUDIO_SCALE_LINEAR        equal-width bands (the classic bar view)
+ *   AUDIO_SCALE_THIRD_OCTAVE  ISO 1/3-octave bands, centres 1 kHz · 2^(k/3)
+ *   AUDIO_SCALE_MEL           equal steps of 2595·log10(1 + f/700)
+ *   AUDIO_SCALE_CUSTOM        caller-supplied band edges in Hz
+ *
+ * Bands narrower than one bin collapse onto the bin nearest their centre,
+ * so low 1/3-octave bands only separate at larger FFT sizes.  DC (bin 0)
+ * is never included.
+ *
+ * Used by the spectrum screen (via audio_analyzer), the LED VU meter and
+ * badge.mic.bands() in Python.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AUDIO_BANDS_MAX     128
+
+typedef enum {
+    AUDIO_SCALE_LINEAR = 0,
+    AUDIO_SCALE_THIRD_OCTAVE,
+    AUDIO_SCALE_MEL,
+    AUDIO_SCALE_CUSTOM,
+    AUDIO_SCALE_COUNT
+} audio_band_scale_t;
+
+typedef enum {
+    AUDIO_BANDS_SUM = 0,    /* Band energy: sum of bin powers */
+    AUDIO_BANDS_PEAK,       /* Strongest bin (tone level independent of width) */
+} audio_band_mode_t;
+
+typedef struct {
+    audio_band_scale_t scale;
+    audio_band_mode_t  mode;
+    uint8_t            count;
+    uint16_t           fft_size;
+    uint16_t           lo[AUDIO_BANDS_MAX];         /* First bin */
+    uint16_t           hi[AUDIO_BANDS_MAX];         /* One past the last bin */
+    uint16_t           center_hz[AUDIO_BANDS_MAX];
+} audio_band_map_t;
+
+/**
+ * @brief  Build a map of @p count bands between @p f_lo and @p f_hi Hz for
+ *         an @p fft_size-point FFT.  For AUDIO_SCALE_THIRD_OCTAVE the
+ *         standard bands inside the range are used and @p count is only an
+ *         upper limit.  Linear maps aggregate with AUDIO_BANDS_PEAK, the
+ *         others with AUDIO_BANDS_SUM; map->mode may be changed afterwards.
+ * @return false on invalid arguments (map->count is then 0).
+ */
+bool audio_bands_build(audio_band_map_t *map, audio_band_scale_t scale, uint8_t count,
+                       uint16_t fft_size, uint16_t f_lo, uint16_t f_hi);
+
+/**
+ * @brief  Build a map from @p count + 1 ascending band edges in Hz.
+ */
+bool audio_bands_build_custom(audio_band_map_t *map, const uint16_t *edges_hz,
+                              uint8_t count, uint16_t fft_size);
+
+/**
+ * @brief  Fold @p power (fft_size / 2 bins) into map->count band values.
+ */
+void audio_bands_aggregate(const audio_band_map_t *map, const float *power, float *out);
+
+/**
+ * @brief  Band power from audio_fft_power() in dB relative to a
+ *         full-scale signal of the same RMS (a full-scale sine in one band
+ *         reads about -3 dB).
+ */
+float audio_bands_dbfs(const audio_band_map_t *map, float power);
+
+/**
+ * @brief  Position of @p hz along a @p scale axis from @p f_lo to @p f_hi,
+ *         0.0 .. 1.0 (for drawing axis labels).
+ */
+float audio_bands_position(audio_band_scale_t scale, uint16_t f_lo, uint16_t f_hi, float hz);
+
+/**
+ * @brief  Short display name ("lin", "1/3oct", "mel", "custom").
+ */
+const char *audio_bands_scale_name(audio_band_scale_t scale);
@@ -0,0 +1,67 @@
+/*
+ * Audio beat – shared onset / tempo / beat state from the microphone.
+ *
+ * A background task feeds every audio stream block through audio_onset
+ * and publishes the result as one snapshot that any number of consumers
+ * poll: the LED beat mode, the spectrum screen and badge.mic.beat() all
+ * read the same state.  New beats and onsets are spotted by their
+ * counters changing; the timestamps (capture time of the end of the block
+ * that produced them) let a consumer place its effect on the beat, e.g.
+ * brightness from audio_beat_phase().
+ *
+ * Everything is decided on the newest block, so a beat is published at
+ * most one stream block (5.3 ms) after the block it falls in was captured.
+ *
+ * Start / stop calls nest: the task runs until every audio_beat_start()
+ * has been matched by an audio_beat_stop().
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t beats;             /* Beats since start */
+    uint32_t onsets;            /* Onsets since start */
+    int64_t  last_beat_us;      /* esp_timer time of the last beat */
+    int64_t  last_onset_us;
+    bool     predicted;         /* Last beat came from the tempo grid */
+    float    strength;          /* Last onset, deviations above the mean flux */
+    float    bpm;               /* 0 until a tempo is locked */
+    float    confidence;        /* Tempo confidence, 0..1 */
+} audio_beat_state_t;
+
+typedef struct {
+    uint32_t blocks;            /* Stream blocks processed */
+    uint32_t overruns;          /* Stream blocks lost by the beat task */
+    uint32_t max_block_us;      /* Slowest block (tempo updates included) */
+} audio_beat_stats_t;
+
+/**
+ * @brief  Start the beat task (or add a user to it).  Starts the audio
+ *         stream if needed.
+ * @return false if the task could not be started.
+ */
+bool audio_beat_start(void);
+
+/**
+ * @brief  Drop one user; the task stops when the last one is gone.
+ */
+void audio_beat_stop(void);
+
+bool audio_beat_running(void);
+
+/**
+ * @brief  Copy the current state (zeroed while stopped).
+ */
+void audio_beat_get(audio_beat_state_t *out);
+
+/**
+ * @brief  Position in the current beat, 0.0 at a beat rising to 1.0 at
+ *         the next, from @p st and the current time @p now_us.  Without a
+ *         tempo the phase runs over 500 ms and then stays at 1.0.
+ */
+float audio_beat_phase(const audio_beat_state_t *st, int64_t now_us);
+
+void audio_beat_get_stats(audio_beat_stats_t *out);
@@ -0,0 +1,67 @@
+/*
+ * Audio DTMF – telephone keypad tones decoded with a Goertzel bank.
+ *
+ *            1209  1336  1477  1633 Hz
+ *     697     1     2     3     A
+ *     770     4     5     6     B
+ *     852     7     8     9     C
+ *     941     *     0     #     D
+ *
+ * Samples are cut into AUDIO_DTMF_BLOCK_MS blocks (50 Hz filter
+ * resolution).  A block holds a key when:
+ *   - the block is louder than AUDIO_DTMF_MIN_DBFS,
+ *   - the strongest row and column tones carry most of the block energy,
+ *   - each beats the runner-up in its group by 6 dB, and
+ *   - the twist (row / column level) is within −4 .. +8 dB.
+ * A key goes down after AUDIO_DTMF_HITS consecutive blocks agree (40 ms,
+ * the shortest valid digit) and up after as many blocks without it, so a
+ * block of noise or a short dropout does not split or repeat a digit.
+ *
+ * Pure C on top of audio_goertzel (shared with the host check,
+ * `make audio_dtmf_check`); works at any sample rate the bank accepts.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "audio_goertzel.h"
+
+#define AUDIO_DTMF_BLOCK_MS     20
+#define AUDIO_DTMF_HITS         2
+#define AUDIO_DTMF_MIN_DBFS     (-45.0f)
+
+typedef struct {
+    char     key;           /* '0'-'9', '*', '#', 'A'-'D' */
+    bool     down;          /* true = key pressed, false = released */
+    uint32_t duration_ms;   /* Held time (release events only) */
+} audio_dtmf_event_t;
+
+typedef struct {
+    audio_goertzel_t bank;  /* 4 row tones then 4 column tones */
+    char     key;           /* Key held down, 0 = none */
+    char     candidate;     /* Key (or 0) seen in the last blocks */
+    uint8_t  hits;          /* Consecutive blocks agreeing on candidate */
+    uint32_t key_blocks;    /* Blocks since key went down */
+} audio_dtmf_t;
+
+/**
+ * @brief  Set up a decoder for @p sample_rate Hz input.
+ */
+bool audio_dtmf_init(audio_dtmf_t *d, uint32_t sample_rate);
+
+/**
+ * @brief  Feed up to @p count samples, stopping after a block that
+ *         produced an event.
+ * @param  ev       Written when the return leaves *has_event true.
+ * @return Number of samples consumed.
+ */
+size_t audio_dtmf_feed(audio_dtmf_t *d, const int16_t *samples, size_t count,
+                       audio_dtmf_event_t *ev, bool *has_event);
+
+/**
+ * @brief  Key detected in the last block on its own, before debouncing
+ *         (0 if none).
+ */
+char audio_dtmf_block_key(const audio_dtmf_t *d);
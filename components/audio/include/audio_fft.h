@@ -0,0 +1,125 @@
+/*
+ * Audio FFT – table-driven real-input FFT for the spectrum pipeline.
+ *
+ * A plan holds everything that depends only on the transform size: the
+ * Hann window (pre-scaled for int16 input), per-pass radix-4 twiddles,
+ * the real-FFT split twiddles and the bit-reversal swap list.  Building a
+ * plan is the only place trigonometry is evaluated; a transform is pure
+ * multiply/add.
+ *
+ *   - Real input of length n is packed as n/2 complex points, transformed
+ *     with radix-4 passes (plus one radix-2 pass when log2(n/2) is odd)
+ *     and split into the n/2 positive-frequency bins.
+ *   - Output is power |X[k]|² (no sqrt); audio_fft_db() turns it into dB
+ *     with a bit-level log2 approximation (max error < 0.002 dB).
+ *
+ * Two arithmetic kinds share the same plan layout and power output:
+ *
+ *   AUDIO_FFT_FLOAT  single-precision float throughout
+ *   AUDIO_FFT_Q15    int16 data and Q15 tables with block floating point:
+ *                    the windowed block is normalised to 14 bits and each
+ *                    pass shifts down only as far as its growth requires,
+ *                    tracking a shared exponent, so quiet input keeps its
+ *                    resolution.  Only the final n/2 power values are
+ *                    converted to float.
+ *
+ * The kind is chosen per plan (audio_fft_plan_init_kind()); plans built
+ * with audio_fft_plan_init() use AUDIO_FFT_DEFAULT_KIND, which can be set
+ * at compile time (e.g. -DAUDIO_FFT_DEFAULT_KIND=AUDIO_FFT_Q15).
+ *
+ * Pure C with no ESP-IDF dependencies; the host benchmark
+ * (`make audio_fft_bench`) checks both kinds against a reference DFT.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AUDIO_FFT_MIN_N     16
+
+typedef enum {
+    AUDIO_FFT_FLOAT = 0,
+    AUDIO_FFT_Q15,
+} audio_fft_kind_t;
+
+#ifndef AUDIO_FFT_DEFAULT_KIND
+#define AUDIO_FFT_DEFAULT_KIND  AUDIO_FFT_FLOAT
+#endif
+
+typedef struct {
+    uint16_t  n;            /* Real input length (power of two) */
+    uint8_t   log2n;
+    audio_fft_kind_t kind;
+    /* AUDIO_FFT_FLOAT tables */
+    float    *window;       /* n coefficients: Hann / 32768 */
+    float    *twiddle;      /* Radix-4 passes: {w1, w2, w3} re/im per butterfly */
+    float    *split;        /* n/4 + 1 complex: exp(-2πik/n) for the real split */
+    /* AUDIO_FFT_Q15 tables (same layout, Q15) */
+    int16_t  *window_q;
+    int16_t  *twiddle_q;
+    int16_t  *split_q;
+    uint16_t *swaps;        /* Bit-reversal pairs (i, j), i < j */
+    uint16_t  num_swaps;
+} audio_fft_plan_t;
+
+/**
+ * @brief  Allocate and fill the tables for an @p n-point real FFT of the
+ *         default kind.
+ * @return false if @p n is not a power of two ≥ AUDIO_FFT_MIN_N or on
+ *         allocation failure (the plan is left empty).
+ */
+bool audio_fft_plan_init(audio_fft_plan_t *plan, uint16_t n);
+
+/**
+ * @brief  As audio_fft_plan_init() with an explicit arithmetic @p kind.
+ */
+bool audio_fft_plan_init_kind(audio_fft_plan_t *plan, uint16_t n, audio_fft_kind_t kind);
+
+/**
+ * @brief  Release a plan's tables (safe on an empty plan).
+ */
+void audio_fft_plan_free(audio_fft_plan_t *plan);
+
+/**
+ * @brief  In-place complex FFT of plan->n / 2 interleaved (re, im) points
+ *         (float plans only).
+ */
+void audio_fft_complex(const audio_fft_plan_t *plan, float *buf);
+
+/**
+ * @brief  In-place block-floating-point complex FFT of plan->n / 2
+ *         interleaved Q15 points (Q15 plans only).
+ * @return Number of bits the data was shifted down; the true result is
+ *         buf × 2^return.
+ */
+int audio_fft_complex_q15(const audio_fft_plan_t *plan, int16_t *buf);
+
+/**
+ * @brief  Window @p samples, transform, and write plan->n / 2 power bins
+ *         (DC .. just below Nyquist) to @p power.
+ *
+ * @param  samples  plan->n signed 16-bit samples
+ * @param  work     Scratch, plan->n floats (Q15 plans use it as int16)
+ * @param  power    Output, plan->n / 2 floats (full-scale sine ≈ (n/4)²),
+ *                  identical scale for both kinds
+ */
+void audio_fft_power(const audio_fft_plan_t *plan, const int16_t *samples,
+                     float *work, float *power);
+
+/**
+ * @brief  Fast 10·log10(power), power > 0 (returns -200 dB for 0).
+ */
+float audio_fft_db(float power);
+
+/**
+ * @brief  Short name of @p kind ("f32", "q15").
+ */
+const char *audio_fft_kind_name(audio_fft_kind_t kind);
+
+/**
+ * @brief  Log speed and accuracy of the float and Q15 FFTs against the
+ *         previous radix-2 path and a reference DFT (audio_fft_bench.c).
+ * @return false if an accuracy figure misses its limit.
+ */
+bool audio_fft_bench_run(void);
@@ -0,0 +1,129 @@
+/*
+ * Audio FSK – multi-tone FSK modem for short badge-to-badge messages.
+ *
+ * Each symbol is one of AUDIO_FSK_TONES tones (AUDIO_FSK_BITS bits) and
+ * lasts AUDIO_FSK_HOPS_PER_SYM stream blocks.  Tones sit on the centres
+ * of the 256-sample DFT bins (187.5 Hz apart, 2.1 – 7.9 kHz), so a tone
+ * that fills a block leaves nothing in any other tone's bin.  Consecutive
+ * symbols rotate through AUDIO_FSK_BANKS interleaved tone banks: an echo
+ * of the last few symbols lands in banks the current symbol does not use.
+ *
+ *   frame = preamble (AUDIO_FSK_PREAMBLE symbols, fixed pattern)
+ *           length, ~length, payload[length], CRC-16/CCITT (big endian)
+ *
+ * Receiver: a Goertzel bank measures every tone bin on every 256-sample
+ * block of the stream.  The transmitter's start is not aligned to the
+ * receiver's blocks, so the first block of a symbol may be mixed with the
+ * previous one; it is the guard, and the symbol is decided on its other
+ * blocks.  The preamble is searched for at every block offset and locked
+ * on the best-matching one, which fixes the symbol timing for the frame.
+ *
+ * Transmitter: renders the frame as 16-bit samples in chunks of any size,
+ * for a speaker, a WAV file or a simulated channel.
+ *
+ * Up to 23 payload bytes per second (187.5 bit/s on air).  Pure C with no
+ * ESP-IDF dependencies; `make audio_modem_check` measures error rates
+ * through a simulated channel with echo and noise.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "audio.h"
+#include "audio_goertzel.h"
+
+#define AUDIO_FSK_HOP           256     /* Receiver block; sets the tone spacing */
+#define AUDIO_FSK_HOPS_PER_SYM  3       /* 16 ms symbols, the first block is the guard */
+#define AUDIO_FSK_SYMBOL        (AUDIO_FSK_HOP * AUDIO_FSK_HOPS_PER_SYM)
+#define AUDIO_FSK_BITS          3
+#define AUDIO_FSK_TONES         (1 << AUDIO_FSK_BITS)
+#define AUDIO_FSK_BANKS         4
+#define AUDIO_FSK_BINS          (AUDIO_FSK_TONES * AUDIO_FSK_BANKS)
+#define AUDIO_FSK_FIRST_BIN     11      /* 2062.5 Hz */
+#define AUDIO_FSK_PREAMBLE      8       /* Symbols */
+#define AUDIO_FSK_MAX_PAYLOAD   255
+#define AUDIO_FSK_MAX_FRAME     (2 + AUDIO_FSK_MAX_PAYLOAD + 2)
+#define AUDIO_FSK_HISTORY       32      /* Blocks of tone energy kept (power of two) */
+
+_Static_assert(AUDIO_FSK_HISTORY >= (AUDIO_FSK_PREAMBLE + 1) * AUDIO_FSK_HOPS_PER_SYM,
+               "history must hold the preamble");
+
+/* ── Transmitter ────────────────────────────────────────────────────────── */
+typedef struct {
+    uint8_t  frame[AUDIO_FSK_MAX_FRAME];
+    uint16_t frame_len;
+    uint16_t symbols;           /* Data symbols after the preamble */
+    uint32_t total;             /* Samples in the whole transmission */
+    uint32_t pos;               /* Samples rendered */
+    int16_t  amplitude;
+} audio_fsk_tx_t;
+
+/**
+ * @brief  Prepare to send @p len bytes (at most AUDIO_FSK_MAX_PAYLOAD) at
+ *         peak @p amplitude.
+ * @return false if @p len is too long.
+ */
+bool audio_fsk_tx_init(audio_fsk_tx_t *tx, const uint8_t *data, size_t len, int16_t amplitude);
+
+/**
+ * @brief  Render up to @p max samples of the transmission at
+ *         AUDIO_SAMPLE_RATE.
+ * @return Samples written; 0 once the frame has been sent.
+ */
+size_t audio_fsk_tx_render(audio_fsk_tx_t *tx, int16_t *out, size_t max);
+
+/* ── Receiver ───────────────────────────────────────────────────────────── */
+typedef enum {
+    AUDIO_FSK_NONE = 0,         /* Nothing finished on this block */
+    AUDIO_FSK_FRAME,            /* A frame with a good CRC is in data / len */
+    AUDIO_FSK_BAD_CRC,          /* A frame was received but failed its CRC */
+} audio_fsk_result_t;
+
+typedef struct {
+    uint32_t syncs;             /* Preambles locked */
+    uint32_t frames;            /* Good frames */
+    uint32_t bad_crc;
+    uint32_t bad_header;        /* Length byte and its complement disagreed */
+} audio_fsk_stats_t;
+
+typedef struct {
+    audio_goertzel_t bank[2];                           /* 16 bins each */
+    float    energy[AUDIO_FSK_HISTORY][AUDIO_FSK_BINS]; /* Per block, per bin */
+    uint32_t hops;
+    /* Preamble search */
+    uint32_t search_from;       /* No preamble may start before this block */
+    float    cand_score;        /* Best match so far, 0 = none */
+    uint32_t cand_hop;
+    /* Frame in progress */
+    uint32_t sym_hop;           /* First block of the next data symbol */
+    uint16_t sym;               /* Data symbols decided */
+    uint16_t need;              /* Data symbols in the frame (0 until the header) */
+    uint32_t bits;              /* Bit accumulator */
+    uint8_t  nbits;
+    uint16_t nbytes;
+    bool     locked;
+    uint8_t  frame[AUDIO_FSK_MAX_FRAME];
+    /* Result of the last finished frame */
+    uint8_t  data[AUDIO_FSK_MAX_PAYLOAD];
+    uint16_t len;
+    float    score;             /* Preamble match of the last lock, 0..1 */
+    audio_fsk_stats_t stats;
+} audio_fsk_rx_t;
+
+bool audio_fsk_rx_init(audio_fsk_rx_t *rx);
+
+/**
+ * @brief  Run one AUDIO_FSK_HOP-sample block through the receiver.
+ * @return AUDIO_FSK_FRAME when a frame completed (payload in rx->data,
+ *         rx->len); AUDIO_FSK_BAD_CRC leaves the corrupted payload there.
+ */
+audio_fsk_result_t audio_fsk_rx_feed(audio_fsk_rx_t *rx, const int16_t *hop);
+
+/**
+ * @brief  Samples on air for a @p len byte payload.
+ */
+uint32_t audio_fsk_airtime(size_t len);
+
+uint16_t audio_fsk_crc16(const uint8_t *data, size_t len);
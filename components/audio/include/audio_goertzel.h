@@ -0,0 +1,89 @@
+/*
+ * Audio Goertzel – fixed-point filter bank for a handful of known tones.
+ *
+ * Detecting a few frequencies (DTMF, a whistle command, a beacon) with an
+ * FFT computes hundreds of bins to look at eight.  A Goertzel filter
+ * evaluates one DFT term at an arbitrary frequency with one multiply per
+ * sample, so a bank of N tones costs N multiplies per sample and its
+ * resolution is set by the block length alone (sample_rate / block_size),
+ * not by a power-of-two transform size.
+ *
+ *   s[n] = x[n] + 2cos(ω)·s[n−1] − s[n−2]          per sample, per tone
+ *   |X(ω)|² = s1² + s2² − 2cos(ω)·s1·s2             once per block
+ *
+ * The recursion runs in integers: int16 samples, 2cos(ω) in Q14 and int32
+ * state (the product is widened to 64 bits).  audio_goertzel_init() rejects
+ * tone/block combinations whose state could overflow.  Results are
+ * normalised to the block energy, so detection thresholds do not depend on
+ * the input level:
+ *
+ *   ratio = 2·|X|² / (block_size · Σx²)    1.0 = all energy in this tone
+ *
+ * A clean dual tone reads about 0.5 on each of its two filters.
+ *
+ * Pure C with no ESP-IDF dependencies (shared with the host DTMF check,
+ * `make audio_dtmf_check`).  One bank per task.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define AUDIO_GOERTZEL_MAX_TONES    16
+#define AUDIO_GOERTZEL_RATIO_ONE    65536   /* ratio_q16 of 1.0 */
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t block_size;                            /* Samples per result */
+    uint8_t  count;
+    uint16_t freq_hz[AUDIO_GOERTZEL_MAX_TONES];
+} audio_goertzel_config_t;
+
+typedef struct {
+    uint16_t block_size;
+    uint8_t  count;
+    uint16_t pos;                                   /* Samples into the block */
+    int32_t  coeff[AUDIO_GOERTZEL_MAX_TONES];       /* 2cos(ω), Q14 */
+    int32_t  s1[AUDIO_GOERTZEL_MAX_TONES];
+    int32_t  s2[AUDIO_GOERTZEL_MAX_TONES];
+    uint64_t energy;                                /* Σx² so far */
+    /* Last completed block */
+    uint32_t ratio_q16[AUDIO_GOERTZEL_MAX_TONES];   /* Tone share of the block energy */
+    uint64_t power[AUDIO_GOERTZEL_MAX_TONES];       /* |X|² */
+    uint64_t block_energy;
+    uint32_t blocks;
+} audio_goertzel_t;
+
+/**
+ * @brief  Set up a bank for @p cfg.
+ * @return false if the tone count, a frequency (must be below Nyquist) or
+ *         the block size is out of range for the fixed-point state.
+ */
+bool audio_goertzel_init(audio_goertzel_t *g, const audio_goertzel_config_t *cfg);
+
+/**
+ * @brief  Clear the running block (results of the last block are kept).
+ */
+void audio_goertzel_reset(audio_goertzel_t *g);
+
+/**
+ * @brief  Run up to @p count samples through the bank, stopping at the end
+ *         of a block so every block's results can be read.
+ * @param  block_done  Set to true if a block completed (results updated).
+ * @return Number of samples consumed.
+ */
+size_t audio_goertzel_feed(audio_goertzel_t *g, const int16_t *samples, size_t count,
+                           bool *block_done);
+
+/**
+ * @brief  Level of tone @p i in the last block, dB relative to a
+ *         full-scale sine at that frequency.
+ */
+float audio_goertzel_dbfs(const audio_goertzel_t *g, uint8_t i);
+
+/**
+ * @brief  RMS level of the last block, dB relative to a full-scale sine.
+ */
+float audio_goertzel_block_dbfs(const audio_goertzel_t *g);
@@ -0,0 +1,71 @@
+/*
+ * Audio modem – badge-to-badge messages over sound (audio_fsk.h).
+ *
+ * The receiver task subscribes to the audio stream, runs every block
+ * through the FSK demodulator and queues each frame that passes its CRC;
+ * read them with audio_modem_receive().  Frames that fail the CRC are only
+ * counted.  The receiver costs 32 Goertzel filters (~1.5 M multiplies/s).
+ *
+ * The badge has no speaker, so the transmit side renders frames into a WAV
+ * file (audio_modem_write_wav) to be played from a phone or a laptop – or,
+ * with an amplifier on the I2S data-out pin, to be sent from another badge
+ * through audio_fsk_tx_render().
+ *
+ * Start and stop from one task (the Python runner stops the receiver when
+ * an app ends).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "audio_fsk.h"
+
+#define AUDIO_MODEM_QUEUE_LEN   4
+#define AUDIO_MODEM_AMPLITUDE   16384   /* −6 dBFS peak in generated files */
+
+typedef struct {
+    uint8_t  data[AUDIO_FSK_MAX_PAYLOAD];
+    uint16_t len;
+    float    score;         /* Preamble match, 0..1 */
+    int64_t  timestamp_us;  /* Capture time of the frame's last block */
+} audio_modem_frame_t;
+
+typedef struct {
+    audio_fsk_stats_t fsk;  /* Syncs, good frames, CRC and header failures */
+    uint32_t blocks;        /* Stream blocks demodulated */
+    uint32_t dropped;       /* Frames lost to a full queue */
+    uint32_t overruns;      /* Stream blocks lost by the receiver task */
+} audio_modem_stats_t;
+
+/**
+ * @brief  Start the receiver task (no-op if running).  Starts the audio
+ *         stream if needed.
+ * @return false if no stream slot is free.
+ */
+bool audio_modem_start(void);
+
+/**
+ * @brief  Stop the receiver task (no-op if stopped).  Queued frames are
+ *         discarded.
+ */
+void audio_modem_stop(void);
+
+bool audio_modem_running(void);
+
+/**
+ * @brief  Take the next received frame, waiting up to @p timeout_ms
+ *         (0 = poll).
+ */
+bool audio_modem_receive(audio_modem_frame_t *frame, uint32_t timeout_ms);
+
+void audio_modem_get_stats(audio_modem_stats_t *out);
+
+/**
+ * @brief  Write @p len bytes (at most AUDIO_FSK_MAX_PAYLOAD) as a 16-bit
+ *         mono WAV transmission at AUDIO_SAMPLE_RATE, with a short silence
+ *         either side.
+ * @return false if the payload is too long or the file cannot be written.
+ */
+bool audio_modem_write_wav(const char *path, const uint8_t *data, size_t len);
@@ -0,0 +1,109 @@
+/*
+ * Audio onset – spectral-flux onsets, tempo and beat tracking.
+ *
+ * Fed one stream block (AUDIO_ONSET_HOP samples) at a time, the engine
+ * works entirely on the newest block, so every decision is made before
+ * the next block arrives:
+ *
+ *   1. Onsets.  The last AUDIO_ONSET_FFT samples are transformed and
+ *      folded into mel bands; spectral flux is the mean rise in band level
+ *      (dB) since the previous hop.  An onset fires when the flux exceeds
+ *      a running mean by AUDIO_ONSET_THRESH_K running deviations (and an
+ *      absolute floor), at most once per refractory period.
+ *   2. Tempo.  The flux above its mean is kept as an onset envelope of
+ *      AUDIO_ONSET_HISTORY hops (~5.5 s).  Every AUDIO_ONSET_TEMPO_EVERY
+ *      hops its autocorrelation over the 60–200 BPM lags, weighted towards
+ *      120 BPM to settle octave ambiguity, gives a period and a confidence
+ *      (how far the peak stands out of the lag range, 0..1).
+ *   3. Beats.  At each tempo update the beat phase is the offset whose
+ *      comb (one tooth per period over the last few beats) collects the
+ *      most envelope, so the grid sits on the strong hits (kick, snare)
+ *      rather than off-beat hi-hats.  Once the tempo is locked, a beat is
+ *      emitted when an onset
+ *      lands near the next grid point and the grid is nudged towards
+ *      onsets just after it; when no
+ *      onset comes, the grid still emits a "predicted" beat on time.
+ *      Without a tempo every onset at least one 200 BPM period after the
+ *      last beat counts as a beat.
+ *
+ * Results are per hop; times are hop indices (AUDIO_ONSET_HOP_US each).
+ * Pure C with no ESP-IDF dependencies (shared with the host check,
+ * `make audio_beat_check`).  One engine per task.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio.h"
+#include "audio_fft.h"
+#include "audio_bands.h"
+
+#define AUDIO_ONSET_HOP         AUDIO_FFT_SIZE          /* One stream block */
+#define AUDIO_ONSET_FFT         (2 * AUDIO_ONSET_HOP)   /* 93.75 Hz bins */
+#define AUDIO_ONSET_BANDS       20
+#define AUDIO_ONSET_HISTORY     1024                    /* Power of two */
+#define AUDIO_ONSET_TEMPO_EVERY 32
+#define AUDIO_ONSET_MIN_BPM     60
+#define AUDIO_ONSET_MAX_BPM     200
+#define AUDIO_ONSET_THRESH_K    2.0f
+#define AUDIO_ONSET_HOP_US      (AUDIO_ONSET_HOP * 1000000LL / AUDIO_SAMPLE_RATE)
+
+/* Hops per second and the lag range of the tempo search */
+#define AUDIO_ONSET_RATE        ((float)AUDIO_SAMPLE_RATE / AUDIO_ONSET_HOP)
+#define AUDIO_ONSET_LAG_MIN     (60 * AUDIO_SAMPLE_RATE / (AUDIO_ONSET_HOP * AUDIO_ONSET_MAX_BPM))
+#define AUDIO_ONSET_LAG_MAX     (60 * AUDIO_SAMPLE_RATE / (AUDIO_ONSET_HOP * AUDIO_ONSET_MIN_BPM) + 1)
+
+typedef struct {
+    bool  onset;            /* Onset in this hop */
+    bool  beat;             /* Beat in this hop */
+    bool  predicted;        /* The beat came from the tempo grid, not an onset */
+    float flux;             /* Mean band rise, dB */
+    float strength;         /* (flux − mean) / deviation of the onset */
+    float bpm;              /* Tempo estimate, 0 = none */
+    float confidence;       /* Tempo confidence, 0..1 */
+} audio_onset_result_t;
+
+typedef struct {
+    audio_fft_plan_t plan;
+    audio_band_map_t bands;
+    int16_t  frame[AUDIO_ONSET_FFT];
+    float    work[AUDIO_ONSET_FFT];
+    float    power[AUDIO_ONSET_FFT / 2];
+    float    band_db[AUDIO_ONSET_BANDS];    /* Previous hop */
+
+    /* Onset detection */
+    uint32_t hops;
+    float    mean, dev;                     /* Running flux statistics */
+    uint32_t last_onset;
+
+    /* Tempo */
+    float    env[AUDIO_ONSET_HISTORY];      /* Onset envelope ring */
+    float    acf[AUDIO_ONSET_LAG_MAX + 2];  /* Autocorrelation scratch */
+    float    period;                        /* Hops per beat, 0 = unknown */
+    float    confidence;
+    float    pending;                       /* Tempo change awaiting confirmation */
+
+    /* Beat grid */
+    float    last_beat;                     /* Hop of the last beat (fractional) */
+    bool     have_beat;
+} audio_onset_t;
+
+/**
+ * @brief  Allocate the FFT plan and reset all state.
+ * @return false on allocation failure.
+ */
+bool audio_onset_init(audio_onset_t *o);
+
+void audio_onset_free(audio_onset_t *o);
+
+/**
+ * @brief  Process the next AUDIO_ONSET_HOP samples.
+ */
+void audio_onset_process(audio_onset_t *o, const int16_t *hop, audio_onset_result_t *out);
+
+/**
+ * @brief  True once the tempo estimate is confident enough to drive the
+ *         beat grid.
+ */
+bool audio_onset_locked(const audio_onset_t *o);
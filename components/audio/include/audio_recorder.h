@@ -0,0 +1,88 @@
+/*
+ * Audio recorder – streaming WAV capture to a FAT file.
+ *
+ * Two tasks share AUDIO_REC_BUFFERS chunk buffers:
+ *
+ *   - the capture task (priority 5) subscribes to the audio stream and
+ *     appends each block to the current chunk, as 16-bit PCM or IMA ADPCM;
+ *   - the writer task (priority 2, below the UI tasks) writes full chunks
+ *     to the file and hands the buffers back.
+ *
+ * A slow flash write (wear-levelling erase, FAT update) therefore only
+ * delays the writer; capture carries on into the other buffer.  If the
+ * writer falls more than a whole chunk behind, incoming stream blocks are
+ * dropped and counted instead of stalling anything upstream.
+ *
+ * The file is laid out for the flash:
+ *   - the WAV header is padded with a JUNK chunk to exactly one 4 KB
+ *     cluster, so every chunk write covers whole, aligned clusters;
+ *   - the full size is allocated up front (lseek past the end) so FAT
+ *     cluster allocation does not happen mid-recording;
+ *   - the header is written and synced first with the pre-allocated size
+ *     (a file cut short by a reset still plays) and patched, and the
+ *     file truncated, when recording ends;
+ *   - the writer syncs the file every AUDIO_REC_SYNC_MS, so a reset
+ *     loses at most that much audio.
+ *
+ * Recording ends on audio_recorder_stop() or when the pre-allocated space
+ * is full.  Stopping does not wait: the writer closes the file in the
+ * background and audio_recorder_active() stays true until it has.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AUDIO_REC_HEADER        4096                    /* Header bytes: one FAT cluster */
+#define AUDIO_REC_CHUNK         (4 * 4096)              /* Bytes per flash write */
+#define AUDIO_REC_BUFFERS       2
+#define AUDIO_REC_SYNC_MS       5000                    /* Longest span between fsyncs */
+
+typedef enum {
+    AUDIO_REC_PCM16 = 0,        /* 96 KB/s at 48 kHz */
+    AUDIO_REC_IMA_ADPCM,        /* ~24 KB/s, format 0x11 */
+} audio_rec_format_t;
+
+typedef struct {
+    const char        *path;
+    audio_rec_format_t format;
+    uint32_t           max_bytes;   /* File size to pre-allocate, header included */
+} audio_rec_config_t;
+
+typedef struct {
+    bool               active;          /* File open (capturing or flushing) */
+    audio_rec_format_t format;
+    uint32_t           capacity;        /* Data bytes pre-allocated */
+    uint32_t           samples;         /* Samples captured */
+    uint32_t           bytes;           /* Data bytes written to the file */
+    uint32_t           chunks;          /* Chunk writes */
+    uint32_t           max_write_us;    /* Slowest chunk write */
+    uint32_t           dropped_blocks;  /* Stream blocks lost: no free buffer */
+    uint32_t           overruns;        /* Stream blocks lost: capture task late */
+    bool               write_error;
+} audio_rec_stats_t;
+
+/**
+ * @brief  Data bytes per second of audio for @p format.
+ */
+uint32_t audio_recorder_bytes_per_second(audio_rec_format_t format);
+
+/**
+ * @brief  Create cfg->path, pre-allocate it and start recording.  Starts
+ *         the audio stream if needed.
+ * @return false if a recording is active, the file cannot be created or
+ *         max_bytes does not leave room for one chunk.
+ */
+bool audio_recorder_start(const audio_rec_config_t *cfg);
+
+/**
+ * @brief  Ask the recording to stop (no-op if idle) and return at once.
+ *         The last chunks are written and the file finalised by the
+ *         writer task.
+ */
+void audio_recorder_stop(void);
+
+bool audio_recorder_active(void);
+
+void audio_recorder_get_stats(audio_rec_stats_t *out);
@@ -6,15 +6,18 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "audio_analyzer.h"
 
 /* Screen for displaying real-time audio spectrum */
 typedef struct {
-    uint8_t spectrum[128];      /* Current FFT magnitude (0-255) */
-    uint8_t peak_hold[128];     /* Peak hold for each frequency bin */
-    uint8_t max_hold[128];      /* Max hold for each frequency bin (manual hold) */
-    bool max_hold_enabled;      /* Whether max hold is active */
+    uint8_t spectrum[AUDIO_SPECTRUM_BARS];  /* Current bar magnitude (0-255) */
+    uint8_t peak_hold[AUDIO_SPECTRUM_BARS]; /* Peak hold for each bar */
+    uint8_t max_hold[AUDIO_SPECTRUM_BARS];  /* Max hold for each bar (manual hold) */
+    bool max_hold_enabled;      /* Whether max hold is active (freezes the waterfall) */
+    bool waterfall;             /* Scrolling spectrogram instead of bars */
     uint32_t frame_count;       /* Frames rendered */
     bool updating;              /* Audio reader thread is active */
+    audio_analyzer_stats_t stats;   /* Analyzer settings and cost, for the status line */
 } audio_spectrum_screen_t;
 
 /**
@@ -32,6 +35,21 @@ void audio_spectrum_screen_update(audio_spectrum_screen_t *screen, uint8_t *new_
  */
 void audio_spectrum_screen_draw(audio_spectrum_screen_t *screen);
 
+/**
+ * @brief  Switch between the bar view and the waterfall.  The waterfall
+ *         draws each new spectrum as one 1-px column (frequency up the
+ *         screen, colour from a 256-entry RGB565 LUT) and lets the ST7789
+ *         hardware scroll move the history, so a frame costs one column
+ *         of SPI traffic.
+ */
+void audio_spectrum_toggle_view(audio_spectrum_screen_t *screen);
+
+/**
+ * @brief  Restore display state the screen changed (hardware scroll).
+ *         Call from the display task when leaving the screen.
+ */
+void audio_spectrum_screen_leave(void);
+
 /**
  * @brief  Start background audio capture task.
  *         Returns immediately; updates 'screen' in real time.
@@ -43,6 +61,24 @@ void audio_spectrum_task_start(audio_spectrum_screen_t *screen);
  */
 void audio_spectrum_task_stop(void);
 
+/**
+ * @brief  Step the FFT size (±1 = ×2 / ÷2, 256–4096) and the overlap
+ *         (±1 through 0/50/75 %).  Applied by the capture task before its
+ *         next block; the setting persists across visits.
+ */
+void audio_spectrum_adjust(int size_step, int overlap_step);
+
+/**
+ * @brief  Switch the bar axis: linear → 1/3-octave → mel → linear.
+ */
+void audio_spectrum_cycle_scale(void);
+
+/**
+ * @brief  Switch the analyzer between the float and Q15 FFT (the status
+ *         line shows which is running and its CPU cost).
+ */
+void audio_spectrum_toggle_fft_kind(void);
+
 /**
  * @brief  Toggle max hold mode on/off.
  */
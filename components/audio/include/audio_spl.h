@@ -0,0 +1,56 @@
+/*
+ * Audio SPL – always-on sound level meter on the microphone.
+ *
+ * Runs as the audio stream's full-resolution tap, inside the capture task:
+ * every block goes through the A / C weighting cascade (audio_weighting.h)
+ * and three integrators per weighting –
+ *
+ *   fast   exponential, τ = 125 ms
+ *   slow   exponential, τ = 1 s
+ *   Leq    energy average since the last audio_spl_reset()
+ *
+ * – plus the highest fast level since the reset.  Levels are reported in
+ * dB SPL from the ICS-43434 sensitivity (AUDIO_SPL_SENSITIVITY_DBFS).  The
+ * cost per block is tracked in audio_spl_stats_t; with 24-bit capture it
+ * is a few percent of one core.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_weighting.h"
+
+#define AUDIO_SPL_FAST_MS   125
+#define AUDIO_SPL_SLOW_MS   1000
+
+typedef struct {
+    float    fast[AUDIO_WEIGHT_COUNT];      /* dB SPL, indexed by audio_weight_t */
+    float    slow[AUDIO_WEIGHT_COUNT];
+    float    leq[AUDIO_WEIGHT_COUNT];
+    float    max[AUDIO_WEIGHT_COUNT];       /* Highest fast level since reset */
+    uint32_t leq_ms;                        /* Leq / max integration time */
+} audio_spl_level_t;
+
+typedef struct {
+    uint32_t blocks;            /* Blocks metered */
+    uint32_t max_block_us;      /* Slowest block */
+    float    load;              /* Share of real time spent metering, 0..1 */
+} audio_spl_stats_t;
+
+/**
+ * @brief  Start metering (starts the audio stream if needed).  Idempotent.
+ */
+void audio_spl_start(void);
+
+/**
+ * @brief  Current levels (all AUDIO_SPL_MIN_DB before the first block).
+ */
+void audio_spl_get(audio_spl_level_t *out);
+
+/**
+ * @brief  Restart the Leq and max integration.
+ */
+void audio_spl_reset(void);
+
+void audio_spl_get_stats(audio_spl_stats_t *out);
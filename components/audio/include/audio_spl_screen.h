@@ -0,0 +1,28 @@
+/*
+ * Sound Level screen – A / C / Z weighted SPL from the always-on meter.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief  Reset the draw state; the next draw repaints the whole screen.
+ */
+void audio_spl_screen_init(void);
+
+/**
+ * @brief  Redraw whatever changed.
+ * @return true if a level changed since the last call.
+ */
+bool audio_spl_screen_draw(void);
+
+/**
+ * @brief  Show the next weighting: A → C → Z → A.
+ */
+void audio_spl_screen_cycle_weighting(void);
+
+/**
+ * @brief  Switch the main reading between fast and slow time weighting.
+ */
+void audio_spl_screen_toggle_speed(void);
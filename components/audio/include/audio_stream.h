@@ -0,0 +1,111 @@
+/*
+ * Audio stream – one always-on microphone capture shared by all consumers.
+ *
+ * A single capture task is the only reader of the I2S channel.  It keeps
+ * the DMA drained into a ring of AUDIO_STREAM_BLOCKS blocks, each tagged
+ * with a sequence number and a capture timestamp, and wakes every
+ * subscriber after each block.  Consumers (spectrum FFT, VU meter,
+ * recorder, ...) read from the ring at their own pace and never block the
+ * I2S channel or each other.
+ *
+ *   - The ring is single-producer and lock-free: each slot carries its
+ *     sequence number, written after the samples, so a reader can detect a
+ *     slot that was overwritten while it copied.
+ *   - A subscriber that falls more than AUDIO_STREAM_BLOCKS - 2 blocks
+ *     behind skips ahead; lost blocks are counted in its overruns.
+ *   - DMA overflows (capture task starved) and I2S read errors are
+ *     counted in audio_stream_stats_t.
+ *
+ * A single tap can also see every block at full capture resolution
+ * (AUDIO_CAPTURE_BITS) inside the capture task, for always-on meters that
+ * need more than 16 bits; see audio_stream_set_tap().
+ *
+ * Usage:
+ *   static audio_sub_t sub;
+ *   audio_stream_subscribe(&sub);
+ *   while (...) {
+ *       if (audio_stream_read(&sub, &blk, 100)) process(blk.samples);
+ *   }
+ *   audio_stream_unsubscribe(&sub);
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define AUDIO_STREAM_BLOCK      AUDIO_FFT_SIZE  /* Samples per block (5.3 ms) */
+#define AUDIO_STREAM_BLOCKS     16              /* Ring depth (~85 ms) */
+#define AUDIO_STREAM_MAX_SUBS   6
+#define AUDIO_STREAM_STACK      3072            /* Capture task stack, bytes */
+
+typedef struct {
+    uint32_t       seq;                         /* 1, 2, 3, ... (0 = empty) */
+    int64_t        timestamp_us;                /* esp_timer time of sample 0 */
+    audio_sample_t samples[AUDIO_STREAM_BLOCK];
+} audio_block_t;
+
+typedef struct {
+    uint32_t          next_seq;                 /* Next block this reader wants */
+    uint32_t          blocks;                   /* Blocks delivered */
+    uint32_t          overruns;                 /* Blocks lost by falling behind */
+    SemaphoreHandle_t wake;                     /* Given by the capture task */
+    bool              active;
+} audio_sub_t;
+
+/* Full-resolution block callback: samples MSB aligned in 32 bits */
+typedef void (*audio_stream_tap_t)(const int32_t *raw, size_t count, int64_t timestamp_us);
+
+typedef struct {
+    uint32_t blocks;            /* Blocks captured since start */
+    uint32_t dma_overflows;     /* I2S DMA queue overflows (capture too slow) */
+    uint32_t read_errors;       /* Failed or short I2S reads */
+    uint8_t  subscribers;
+} audio_stream_stats_t;
+
+/**
+ * @brief  Initialise the microphone (if needed) and start the capture
+ *         task.  Idempotent.
+ */
+void audio_stream_start(void);
+
+/**
+ * @brief  Register @p sub; it will receive blocks captured from now on.
+ * @return false if all AUDIO_STREAM_MAX_SUBS slots are taken.
+ */
+bool audio_stream_subscribe(audio_sub_t *sub);
+
+/**
+ * @brief  Remove @p sub; safe to call on an inactive subscriber.
+ */
+void audio_stream_unsubscribe(audio_sub_t *sub);
+
+/**
+ * @brief  Copy the next block for @p sub into @p out, waiting up to
+ *         @p timeout_ms for one to arrive (0 = poll).
+ * @return true if @p out holds a block.
+ */
+bool audio_stream_read(audio_sub_t *sub, audio_block_t *out, uint32_t timeout_ms);
+
+/**
+ * @brief  Copy the newest block and move @p sub past it.  Blocks skipped
+ *         this way are not counted as overruns (for meters that only care
+ *         about "now").  Never waits.
+ * @return false if no block newer than the last one read exists.
+ */
+bool audio_stream_read_latest(audio_sub_t *sub, audio_block_t *out);
+
+/**
+ * @brief  Install @p tap (NULL removes it).  It runs in the capture task
+ *         with every block before subscribers are woken, so it delays them
+ *         all: keep it to a few percent of a block (5.3 ms).
+ */
+void audio_stream_set_tap(audio_stream_tap_t tap);
+
+/**
+ * @brief  Copy the capture statistics.
+ */
+void audio_stream_get_stats(audio_stream_stats_t *out);
@@ -0,0 +1,86 @@
+/*
+ * Audio tones – Goertzel tone and DTMF detection on the shared stream.
+ *
+ * A background task subscribes to the audio stream and runs a configured
+ * tone bank (up to AUDIO_GOERTZEL_MAX_TONES target frequencies, e.g. a
+ * whistle command or a beacon) and, optionally, the DTMF decoder.  A tone
+ * is "present" in a block when it carries at least min_share of the block
+ * energy and is louder than min_dbfs; it must hold (or stay gone) for
+ * `debounce` consecutive blocks before an event is posted.  Events go to
+ * one queue, read with audio_tones_receive(); when the reader falls behind
+ * new events are dropped and counted.
+ *
+ * The block length sets the frequency resolution (1000 / block_ms Hz) and
+ * the detection latency (debounce × block_ms).  The cost is one multiply
+ * per sample per tone, ~0.4 M/s for the eight DTMF tones.
+ *
+ * Start and stop from one task (the Python runner stops the detector when
+ * an app ends).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_goertzel.h"
+
+#define AUDIO_TONES_QUEUE_LEN   16
+
+typedef enum {
+    AUDIO_TONE_ON = 0,      /* Target tone appeared */
+    AUDIO_TONE_OFF,         /* Target tone ended (duration_ms set) */
+    AUDIO_TONE_DTMF_DOWN,   /* DTMF key pressed */
+    AUDIO_TONE_DTMF_UP,     /* DTMF key released (duration_ms set) */
+} audio_tone_event_type_t;
+
+typedef struct {
+    audio_tone_event_type_t type;
+    uint8_t  tone;          /* Index into freq_hz (ON / OFF) */
+    uint16_t freq_hz;       /* Tone frequency (ON / OFF) */
+    char     key;           /* DTMF key (DTMF_DOWN / DTMF_UP) */
+    uint32_t duration_ms;
+    int64_t  timestamp_us;  /* Capture time of the deciding block's end */
+} audio_tone_event_t;
+
+typedef struct {
+    uint16_t block_ms;                          /* Goertzel block length */
+    uint8_t  count;                             /* Target tones (0 = DTMF only) */
+    uint16_t freq_hz[AUDIO_GOERTZEL_MAX_TONES];
+    float    min_share;                         /* Fraction of block energy, 0..1 */
+    float    min_dbfs;                          /* Tone level, dB re full-scale sine */
+    uint8_t  debounce;                          /* Blocks to confirm on / off */
+    bool     dtmf;                              /* Also run the DTMF decoder */
+} audio_tones_config_t;
+
+#define AUDIO_TONES_DEFAULT_CONFIG() \
+    { .block_ms = 20, .count = 0, .min_share = 0.4f, .min_dbfs = -50.0f, \
+      .debounce = 2, .dtmf = true }
+
+typedef struct {
+    uint32_t blocks;        /* Tone-bank blocks processed */
+    uint32_t events;        /* Events queued */
+    uint32_t dropped;       /* Events lost to a full queue */
+    uint32_t overruns;      /* Stream blocks lost by the detector task */
+} audio_tones_stats_t;
+
+/**
+ * @brief  Start (or restart with a new configuration) the detector task.
+ *         Starts the audio stream if needed.
+ * @return false if the configuration is invalid or no stream slot is free.
+ */
+bool audio_tones_start(const audio_tones_config_t *cfg);
+
+/**
+ * @brief  Stop the detector task (no-op if stopped).  Queued events are
+ *         discarded.
+ */
+void audio_tones_stop(void);
+
+bool audio_tones_running(void);
+
+/**
+ * @brief  Take the next event, waiting up to @p timeout_ms (0 = poll).
+ */
+bool audio_tones_receive(audio_tone_event_t *ev, uint32_t timeout_ms);
+
+void audio_tones_get_stats(audio_tones_stats_t *out);
@@ -0,0 +1,88 @@
+/*
+ * Audio weighting – IEC 61672 A / C frequency weighting as fixed-point
+ * biquad cascades, and the ICS-43434 sound-pressure calibration.
+ *
+ *   C(s) = s² / (s + ω1)²  ·  1 / (s + ω4)²
+ *   A(s) = C(s)  ·  s² / ((s + ω2)(s + ω3))
+ *
+ * with the standard pole frequencies 20.6, 107.7, 737.9 and 12194 Hz.  A
+ * contains C, so one cascade serves both: two biquads give C and a third
+ * on the C output gives A – three biquads per sample for A, C and Z
+ * (unweighted) together.  Each section is designed in float by the
+ * bilinear transform (ω4 pre-warped) when the filter is initialised, then
+ * run in Q29 with 64-bit accumulation and error feedback, so the
+ * near-DC poles of the 20.6 Hz high-pass add no audible rumble.
+ *
+ * Input is the full-resolution capture (audio_stream_set_tap(), MSB
+ * aligned in 32 bits); the output is the mean square of each weighting
+ * over the block, normalised so a full-scale sine gives 0.5 and each
+ * weighting is 0 dB at 1 kHz.
+ *
+ * Pure C with no ESP-IDF dependencies; the same sources build on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+/* ── Calibration ────────────────────────────────────────────────────────── */
+/* ICS-43434: a 94 dB SPL 1 kHz sine reads -26 dBFS (sine peak = full scale) */
+#define AUDIO_SPL_REF_DB            94.0f
+#define AUDIO_SPL_SENSITIVITY_DBFS  (-26.0f)
+#define AUDIO_SPL_MIN_DB            0.0f    /* Reported for digital silence */
+
+typedef enum {
+    AUDIO_WEIGHT_A = 0,
+    AUDIO_WEIGHT_C,
+    AUDIO_WEIGHT_Z,             /* Unweighted */
+    AUDIO_WEIGHT_COUNT
+} audio_weight_t;
+
+/* Direct form I section, Q29 coefficients (a0 = 1) */
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;
+    int32_t x1, x2, y1, y2;
+    int32_t err;                /* Rounding remainder fed back */
+} audio_biquad_t;
+
+typedef struct {
+    audio_biquad_t hp;          /* s² / (s + ω1)² */
+    audio_biquad_t lp;          /* ω4² / (s + ω4)² → C */
+    audio_biquad_t ac;          /* s² / ((s + ω2)(s + ω3)) → A */
+    float gain2[AUDIO_WEIGHT_COUNT];    /* Power normalisation: 0 dB at 1 kHz */
+    uint32_t sample_rate;
+} audio_weighting_t;
+
+/**
+ * @brief  Design the cascade for @p sample_rate and clear its state.
+ */
+void audio_weighting_init(audio_weighting_t *w, uint32_t sample_rate);
+
+/**
+ * @brief  Clear the filter state (e.g. after a gap in the input).
+ */
+void audio_weighting_reset(audio_weighting_t *w);
+
+/**
+ * @brief  Filter @p count samples and return the mean square per weighting
+ *         in @p ms.  @p work holds @p count intermediate samples.
+ */
+void audio_weighting_process(audio_weighting_t *w, const int32_t *in, int32_t *work,
+                             size_t count, float ms[AUDIO_WEIGHT_COUNT]);
+
+/**
+ * @brief  Gain of weighting @p kind at @p hz in dB, from the quantised
+ *         coefficients and normalisation actually in use.
+ */
+float audio_weighting_response_db(const audio_weighting_t *w, audio_weight_t kind, float hz);
+
+/**
+ * @brief  Sound pressure level in dB SPL for a mean square from
+ *         audio_weighting_process().
+ */
+static inline float audio_spl_db(float ms) {
+    float db = AUDIO_SPL_REF_DB - AUDIO_SPL_SENSITIVITY_DBFS + 10.0f * log10f(2.0f * ms + 1e-30f);
+    return db < AUDIO_SPL_MIN_DB ? AUDIO_SPL_MIN_DB : db;
+}
@@ -0,0 +1,105 @@
+/*
+ * Button gesture implementation – per-button timers driven by edges and
+ * the scan clock.
+ */
+
+#include "btn_gesture.h"
+#include <string.h>
+
+#define MS(x)   ((int64_t)(x) * 1000)
+
+void btn_gesture_init(btn_gesture_t *g, const btn_gesture_config_t *cfg, uint16_t state) {
+    memset(g, 0, sizeof(*g));
+    g->cfg   = *cfg;
+    g->state = state;
+    /* Buttons held at start are not timed: no hold, repeat or chord */
+    g->hold_done = state;
+}
+
+void btn_gesture_set_config(btn_gesture_t *g, const btn_gesture_config_t *cfg) {
+    g->cfg = *cfg;
+}
+
+static size_t emit(btn_gesture_event_t *out, size_t n, uint8_t button, btn_gesture_kind_t kind,
+                   uint16_t state, int64_t t_us) {
+    if (n >= BTN_GESTURE_MAX_EVENTS) return n;
+    out[n].button       = button;
+    out[n].kind         = kind;
+    out[n].state        = state;
+    out[n].timestamp_us = t_us;
+    return n + 1;
+}
+
+/* ── Edges ──────────────────────────────────────────────────────────────── */
+size_t btn_gesture_edge(btn_gesture_t *g, uint8_t button, bool pressed, int64_t t_us,
+                        btn_gesture_event_t *out) {
+    const btn_gesture_config_t *c = &g->cfg;
+    uint16_t bit = (uint16_t)(1u << button);
+    size_t   n   = 0;
+
+    if (button >= BTN_GESTURE_MAX_BUTTONS) return 0;
+
+    if (!pressed) {
+        g->state &= ~bit;
+        g->up_us[button] = t_us;
+        /* A short press that was not itself the second tap can start one */
+        bool short_press = !c->hold_ms || t_us - g->down_us[button] < MS(c->hold_ms);
+        if (short_press && !(g->double_done & bit)) g->tap_armed |= bit;
+        else                                        g->tap_armed &= ~bit;
+        g->double_done &= ~bit;
+        return 0;
+    }
+
+    g->state |= bit;
+    g->down_us[button] = t_us;
+    g->hold_done &= ~bit;
+    g->double_done &= ~bit;
+
+    if (c->double_ms && (g->tap_armed & bit) && t_us - g->up_us[button] <= MS(c->double_ms)) {
+        g->double_done |= bit;
+        n = emit(out, n, button, BTN_GESTURE_DOUBLE_TAP, g->state, t_us);
+    }
+    g->tap_armed &= ~bit;
+
+    if (c->chord_ms && (g->state & ~bit)) {
+        bool together = true;
+        for (uint8_t b = 0; b < BTN_GESTURE_MAX_BUTTONS && together; b++) {
+            if ((g->state & ~bit) >> b & 1) together = t_us - g->down_us[b] <= MS(c->chord_ms);
+        }
+        if (together) n = emit(out, n, button, BTN_GESTURE_CHORD, g->state, t_us);
+    }
+
+    if (c->repeat_ms && (c->repeat_mask & bit)) {
+        g->next_repeat_us[button] = t_us + MS(c->repeat_delay_ms);
+        g->interval_us[button]    = (uint32_t)MS(c->repeat_ms);
+    }
+    return n;
+}
+
+/* ── Time ───────────────────────────────────────────────────────────────── */
+size_t btn_gesture_tick(btn_gesture_t *g, int64_t now_us, btn_gesture_event_t *out) {
+    const btn_gesture_config_t *c = &g->cfg;
+    size_t n = 0;
+
+    for (uint8_t b = 0; b < BTN_GESTURE_MAX_BUTTONS; b++) {
+        uint16_t bit = (uint16_t)(1u << b);
+        if (!(g->state & bit)) continue;
+
+        if (c->hold_ms && !(g->hold_done & bit) && now_us - g->down_us[b] >= MS(c->hold_ms)) {
+            g->hold_done |= bit;
+            n = emit(out, n, b, BTN_GESTURE_HOLD, g->state, g->down_us[b] + MS(c->hold_ms));
+        }
+
+        if (c->repeat_ms && (c->repeat_mask & bit) && g->interval_us[b] &&
+            now_us >= g->next_repeat_us[b]) {
+            n = emit(out, n, b, BTN_GESTURE_REPEAT, g->state, g->next_repeat_us[b]);
+            /* One repeat per tick: if the caller fell behind, restart the
+             * schedule from now rather than bursting */
+            g->next_repeat_us[b] += g->interval_us[b];
+            if (g->next_repeat_us[b] <= now_us) g->next_repeat_us[b] = now_us + g->interval_us[b];
+            uint32_t next = g->interval_us[b] * c->repeat_accel_pct / 100;
+            g->interval_us[b] = next > MS(c->repeat_min_ms) ? next : (uint32_t)MS(c->repeat_min_ms);
+        }
+    }
+    return n;
+}
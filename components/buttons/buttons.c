@@ -1,10 +1,14 @@
 /*
  * Button driver for Disobey Badge 2025.
  *
- * All buttons use GPIO interrupts (edge-triggered) with a 20 ms debounce
- * timer to filter bounce.  Debounce is implemented by re-reading the pin
- * 20 ms after the initial edge and only posting an event if the level is
- * stable.
+ * One periodic esp_timer reads the GPIO input registers every
+ * BUTTONS_SCAN_US, turns them into a bitmask of pressed buttons and runs it
+ * through the vertical-counter debouncer (btn_debounce.h).  Every debounced
+ * change becomes one btn_event_t carrying the full button state and the
+ * time of the first stable sample, so all buttons see the same latency
+ * whatever else the timer daemon is doing.  The same scan drives the
+ * gesture recogniser (btn_gesture.h), whose events follow the plain ones.
+ * Presses are also traced for input-to-photon latency (latency_trace.h).
  *
  * Pin mapping (HARDWARE.md):
  *   UP=11  DOWN=1  LEFT=21  RIGHT=2  STICK=14
@@ -16,14 +20,15 @@
  */
 
 #include "buttons.h"
+#include "btn_debounce.h"
+#include "latency_trace.h"
 #include "driver/gpio.h"
+#include "soc/gpio_reg.h"
+#include "esp_timer.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "freertos/timers.h"
 
 #define TAG "buttons"
-#define DEBOUNCE_MS  20
 
 /* ── Pin / polarity table ───────────────────────────────────────────────── */
 typedef struct {
@@ -44,74 +49,139 @@ static const btn_hw_t s_hw[BTN_COUNT] = {
 };
 
 /* ── Module state ───────────────────────────────────────────────────────── */
-static QueueHandle_t s_queue;
-static TimerHandle_t s_timer[BTN_COUNT];
-static bool          s_last_state[BTN_COUNT];
-
-/* ── Helpers ────────────────────────────────────────────────────────────── */
-static bool read_pressed(btn_id_t id) {
-    int level = gpio_get_level(s_hw[id].pin);
-    return s_hw[id].active_low ? (level == 0) : (level == 1);
-}
+static QueueHandle_t      s_queue;
+static esp_timer_handle_t s_timer;
+static btn_debounce_t     s_deb;
+static volatile uint16_t  s_state;      /* Copy of s_deb.state for readers */
+static buttons_stats_t    s_stats;
+static btn_gesture_t      s_gesture;
+static portMUX_TYPE       s_gesture_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const btn_event_type_t s_gesture_type[] = {
+    [BTN_GESTURE_HOLD]       = BTN_HOLD,
+    [BTN_GESTURE_REPEAT]     = BTN_REPEAT,
+    [BTN_GESTURE_DOUBLE_TAP] = BTN_DOUBLE_TAP,
+    [BTN_GESTURE_CHORD]      = BTN_CHORD,
+};
 
-/* ── Debounce timer callback ─────────────────────────────────────────────── */
-static void debounce_cb(TimerHandle_t t) {
-    btn_id_t id = (btn_id_t)(uintptr_t)pvTimerGetTimerID(t);
-    bool pressed = read_pressed(id);
+/* ── Sampling ───────────────────────────────────────────────────────────── */
+/* All pins from one read of each input register */
+static uint16_t read_pressed_mask(void) {
+    uint64_t in = REG_READ(GPIO_IN_REG) | (uint64_t)REG_READ(GPIO_IN1_REG) << 32;
+    uint16_t mask = 0;
+    for (int i = 0; i < BTN_COUNT; i++) {
+        bool high = (in >> s_hw[i].pin) & 1;
+        if (high != s_hw[i].active_low) mask |= BTN_MASK(i);
+    }
+    return mask;
+}
 
-    if (pressed == s_last_state[id]) return;  /* unchanged, ignore */
-    s_last_state[id] = pressed;
+/* ── Scan timer callback (esp_timer task) ───────────────────────────────── */
+static void post(const btn_event_t *ev) {
+    if (xQueueSend(s_queue, ev, 0) == pdTRUE) s_stats.events++;
+    else s_stats.dropped++;
+}
 
-    btn_event_t ev = {
-        .id   = id,
-        .type = pressed ? BTN_PRESSED : BTN_RELEASED,
-    };
-    xQueueSendFromISR(s_queue, &ev, NULL);
+static void post_gestures(const btn_gesture_event_t *g, size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        btn_event_t ev = {
+            .id           = (btn_id_t)g[k].button,
+            .type         = s_gesture_type[g[k].kind],
+            .state        = g[k].state,
+            .timestamp_us = g[k].timestamp_us,
+        };
+        post(&ev);
+    }
 }
 
-/* ── ISR handler ─────────────────────────────────────────────────────────── */
-static void IRAM_ATTR gpio_isr(void *arg) {
-    btn_id_t id = (btn_id_t)(uintptr_t)arg;
-    /* Reset the one-shot debounce timer */
-    BaseType_t woken = pdFALSE;
-    xTimerResetFromISR(s_timer[id], &woken);
-    portYIELD_FROM_ISR(woken);
+static void scan_cb(void *arg) {
+    (void)arg;
+    int64_t  now     = esp_timer_get_time();
+    uint16_t changed = btn_debounce_update(&s_deb, read_pressed_mask());
+    btn_gesture_event_t g[BTN_GESTURE_MAX_EVENTS];
+    size_t   n;
+    s_stats.scans++;
+
+    /* One event per changed button, each carrying the state with that
+     * change applied, so a reader can rebuild the state from events alone */
+    uint16_t state = s_state;
+    for (int i = 0; changed && i < BTN_COUNT; i++) {
+        if (!(changed & BTN_MASK(i))) continue;
+        state ^= BTN_MASK(i);
+        btn_event_t ev = {
+            .id           = (btn_id_t)i,
+            .type         = (state & BTN_MASK(i)) ? BTN_PRESSED : BTN_RELEASED,
+            .state        = state,
+            .timestamp_us = now - (int64_t)(BTN_DEBOUNCE_SAMPLES - 1) * BUTTONS_SCAN_US,
+        };
+        if (ev.type == BTN_PRESSED) latency_trace_press((uint8_t)i, ev.timestamp_us, now);
+        post(&ev);
+
+        portENTER_CRITICAL(&s_gesture_lock);
+        n = btn_gesture_edge(&s_gesture, (uint8_t)i, ev.type == BTN_PRESSED, ev.timestamp_us, g);
+        portEXIT_CRITICAL(&s_gesture_lock);
+        post_gestures(g, n);
+    }
+    s_state = state;
+
+    portENTER_CRITICAL(&s_gesture_lock);
+    n = btn_gesture_tick(&s_gesture, now, g);
+    portEXIT_CRITICAL(&s_gesture_lock);
+    post_gestures(g, n);
 }
 
 /* ── Public init ─────────────────────────────────────────────────────────── */
 void buttons_init(QueueHandle_t event_queue) {
     s_queue = event_queue;
 
-    gpio_install_isr_service(0);
-
     for (int i = 0; i < BTN_COUNT; i++) {
         gpio_config_t cfg = {
             .pin_bit_mask = 1ULL << s_hw[i].pin,
             .mode         = GPIO_MODE_INPUT,
             .pull_up_en   = s_hw[i].active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
             .pull_down_en = s_hw[i].active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
-            .intr_type    = GPIO_INTR_ANYEDGE,
+            .intr_type    = GPIO_INTR_DISABLE,
         };
         gpio_config(&cfg);
+    }
 
-        s_last_state[i] = read_pressed((btn_id_t)i);
-
-        /* One-shot debounce timer (20 ms) */
-        s_timer[i] = xTimerCreate(
-            "btn_debounce",
-            pdMS_TO_TICKS(DEBOUNCE_MS),
-            pdFALSE,                          /* one-shot */
-            (void *)(uintptr_t)i,             /* ID = button index */
-            debounce_cb
-        );
-        configASSERT(s_timer[i]);
+    /* Buttons held at boot count as pressed without an event */
+    btn_debounce_init(&s_deb, read_pressed_mask());
+    s_state = s_deb.state;
+    btn_gesture_config_t gcfg = BTN_GESTURE_DEFAULT_CONFIG();
+    btn_gesture_init(&s_gesture, &gcfg, s_state);
 
-        gpio_isr_handler_add(s_hw[i].pin, gpio_isr, (void *)(uintptr_t)i);
-    }
+    const esp_timer_create_args_t args = {
+        .callback = scan_cb,
+        .name     = "btn_scan",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &s_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(s_timer, BUTTONS_SCAN_US));
 
-    ESP_LOGI(TAG, "Buttons ready (%d inputs)", BTN_COUNT);
+    ESP_LOGI(TAG, "Buttons ready (%d inputs, %d us scan, %d-sample debounce)",
+             BTN_COUNT, BUTTONS_SCAN_US, BTN_DEBOUNCE_SAMPLES);
 }
 
 bool buttons_is_pressed(btn_id_t id) {
-    return read_pressed(id);
+    return (s_state & BTN_MASK(id)) != 0;
+}
+
+uint16_t buttons_get_state(void) {
+    return s_state;
+}
+
+void buttons_get_stats(buttons_stats_t *out) {
+    *out = s_stats;
+}
+
+void buttons_set_gestures(const btn_gesture_config_t *cfg) {
+    portENTER_CRITICAL(&s_gesture_lock);
+    btn_gesture_set_config(&s_gesture, cfg);
+    portEXIT_CRITICAL(&s_gesture_lock);
+}
+
+void buttons_get_gestures(btn_gesture_config_t *out) {
+    portENTER_CRITICAL(&s_gesture_lock);
+    *out = s_gesture.cfg;
+    portEXIT_CRITICAL(&s_gesture_lock);
 }
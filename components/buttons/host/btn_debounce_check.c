@@ -0,0 +1,277 @@
+/*
+ * Host-side button debouncer check against synthetic bounce traces.
+ *
+ * Simulates the contacts of all nine buttons at 10 µs resolution: random
+ * presses and releases (alone and as chords), each followed by contact
+ * bounce – a burst of random toggles lasting up to bounce_ms – and, on
+ * some fixtures, short EMI-like glitches on idle lines.  The traces are
+ * sampled every BUTTONS_SCAN_US and run through btn_debounce exactly as
+ * the driver's scan timer does.  Checked per fixture:
+ *
+ *   - exactly one event per real transition, in order, with the state
+ *     mask matching the contacts,
+ *   - no event from a glitch shorter than BTN_DEBOUNCE_SAMPLES - 1 scans,
+ *   - latency from the contact settling to the event at most
+ *     BTN_DEBOUNCE_SAMPLES scans, and the event's timestamp (the first
+ *     stable sample) within one scan after the settle time.
+ *
+ * The latency of the old driver (a 20 ms one-shot timer restarted by every
+ * edge) is printed alongside for comparison.  The exit status is non-zero
+ * if any fixture fails.
+ *
+ * Build and run (from the repo root): `make btn_debounce_check`
+ */
+
+#include "btn_debounce.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCAN_US         2000    /* BUTTONS_SCAN_US */
+#define STEP_US         10
+#define BUTTONS         9
+#define MAX_TRANSITIONS 4096
+#define OLD_DEBOUNCE_US 20000
+
+/* ── Random numbers (fixed seed, so runs are repeatable) ────────────────── */
+static uint32_t s_rng = 0x9E3779B9;
+
+static uint32_t rnd(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static int64_t rnd_range(int64_t lo, int64_t hi) {
+    return lo + (int64_t)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+/* ── Fixtures ───────────────────────────────────────────────────────────── */
+typedef struct {
+    const char *name;
+    uint32_t    seconds;
+    uint16_t    bounce_ms;      /* Longest bounce burst */
+    uint16_t    min_hold_ms;    /* Shortest press / gap */
+    uint16_t    glitches;       /* Glitches per button per second */
+    bool        chords;         /* Press groups of buttons together */
+} fixture_t;
+
+static const fixture_t s_fixtures[] = {
+    { "clean",           20,  0,  30, 0, false },
+    { "bounce_1ms",      20,  1,  30, 0, false },
+    { "bounce_5ms",      20,  5,  30, 0, false },
+    { "bounce_10ms",     20, 10,  40, 0, false },
+    { "fast_taps",       20,  2,  12, 0, false },
+    { "chords",          20,  5,  30, 0, true  },
+    { "glitches",        20,  3,  30, 4, false },
+    { "chords_glitches", 20,  5,  30, 2, true  },
+};
+
+/* A real contact change; its bounce edges are in the trace's edge list */
+typedef struct {
+    int64_t t_us;           /* First edge */
+    int64_t settle_us;      /* Last edge of the bounce */
+    uint8_t button;
+    bool    pressed;
+} transition_t;
+
+typedef struct {
+    transition_t tr[MAX_TRANSITIONS];
+    int          count;
+    /* Per button edge list: times at which the contact toggles */
+    int64_t     *edges[BUTTONS];
+    int          n_edges[BUTTONS];
+    int          glitches;
+} trace_t;
+
+static void add_edge(trace_t *tc, int b, int64_t t) {
+    tc->edges[b] = realloc(tc->edges[b], (tc->n_edges[b] + 1) * sizeof(int64_t));
+    tc->edges[b][tc->n_edges[b]++] = t;
+}
+
+static int cmp_tr(const void *a, const void *b) {
+    const transition_t *x = a, *y = b;
+    if (x->settle_us != y->settle_us) return x->settle_us < y->settle_us ? -1 : 1;
+    return x->button - y->button;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Bounce burst from @p t: the first edge plus pairs of toggles, so the
+ * contact ends at the new level; returns the settle (last edge) time */
+static int64_t bounce(trace_t *tc, int b, int64_t t, const fixture_t *fx) {
+    int64_t settle = t;
+    add_edge(tc, b, t);
+    if (!fx->bounce_ms) return t;
+    int64_t end = t + rnd_range(fx->bounce_ms * 200, fx->bounce_ms * 1000);
+    for (int64_t e = t + rnd_range(20, 800); e < end; e += rnd_range(20, 800)) {
+        int64_t back = e + rnd_range(10, 300);
+        add_edge(tc, b, e);
+        add_edge(tc, b, back);
+        if (back > settle) settle = back;
+    }
+    return settle;
+}
+
+static void add_transition(trace_t *tc, int b, int64_t t, bool pressed, const fixture_t *fx) {
+    transition_t *tr = &tc->tr[tc->count++];
+    tr->t_us      = t;
+    tr->button    = (uint8_t)b;
+    tr->pressed   = pressed;
+    tr->settle_us = bounce(tc, b, t, fx);
+}
+
+static void build_trace(trace_t *tc, const fixture_t *fx) {
+    memset(tc, 0, sizeof(*tc));
+    const int64_t end_us = (int64_t)fx->seconds * 1000000;
+    const int64_t min_us = (fx->min_hold_ms + fx->bounce_ms) * 1000;
+
+    for (int b = 0; b < BUTTONS; b++) {
+        /* Chords: buttons 5..8 follow button 4, each a few ms late */
+        if (fx->chords && b > 4) continue;
+        int  group   = fx->chords && b == 4 ? BUTTONS - 4 : 1;
+        bool pressed = false;
+        for (int64_t t = rnd_range(50000, 300000); t < end_us - 600000 && tc->count < MAX_TRANSITIONS - BUTTONS; ) {
+            pressed = !pressed;
+            for (int g = 0; g < group; g++) {
+                add_transition(tc, b + g, t + (g ? rnd_range(0, 8000) : 0), pressed, fx);
+            }
+            t += min_us + 8000 + rnd_range(0, 400000);
+        }
+        for (int g = 0; pressed && g < group; g++) {
+            add_transition(tc, b + g, end_us - 300000 + g * 1000, false, fx);
+        }
+    }
+
+    /* Glitches on idle contacts, shorter than BTN_DEBOUNCE_SAMPLES - 1
+     * scans.  At least one sample must separate a glitch from a real edge
+     * or another glitch, or the debouncer rightly sees one longer pulse;
+     * one inside a debounce window rightly delays the edge */
+    const int64_t gap  = 2 * SCAN_US;
+    const int64_t hold = (BTN_DEBOUNCE_SAMPLES + 1) * SCAN_US;
+    for (int b = 0; b < BUTTONS; b++) {
+        int first = tc->n_edges[b];
+        for (uint32_t k = 0; k < fx->glitches * fx->seconds; k++) {
+            int64_t t   = rnd_range(0, end_us - 100000);
+            int64_t len = rnd_range(10, (BTN_DEBOUNCE_SAMPLES - 1) * SCAN_US - STEP_US);
+            bool clear  = true;
+            for (int i = 0; i < tc->count && clear; i++) {
+                const transition_t *tr = &tc->tr[i];
+                if (tr->button == b && t + len > tr->t_us - gap && t < tr->settle_us + hold) clear = false;
+            }
+            for (int i = first; i < tc->n_edges[b] && clear; i += 2) {
+                if (t + len > tc->edges[b][i] - gap && t < tc->edges[b][i + 1] + gap) clear = false;
+            }
+            if (!clear) continue;
+            add_edge(tc, b, t);
+            add_edge(tc, b, t + len);
+            tc->glitches++;
+        }
+    }
+
+    qsort(tc->tr, tc->count, sizeof(transition_t), cmp_tr);
+    for (int b = 0; b < BUTTONS; b++) qsort(tc->edges[b], tc->n_edges[b], sizeof(int64_t), cmp_i64);
+}
+
+static void free_trace(trace_t *tc) {
+    for (int b = 0; b < BUTTONS; b++) free(tc->edges[b]);
+}
+
+/* ── Run ────────────────────────────────────────────────────────────────── */
+/* Next transition of button @p b at or after index @p from, or -1 */
+static int next_of(const trace_t *tc, int b, int from) {
+    for (int i = from; i < tc->count; i++) if (tc->tr[i].button == b) return i;
+    return -1;
+}
+
+static bool run_fixture(const fixture_t *fx) {
+    static trace_t tc;
+    build_trace(&tc, fx);
+
+    const int64_t end_us = (int64_t)fx->seconds * 1000000;
+    int      pos[BUTTONS] = { 0 };      /* Next edge per button */
+    int      next[BUTTONS];             /* Next expected transition per button */
+    uint16_t level = 0, state = 0;
+    btn_debounce_t deb;
+    int      events = 0, errors = 0;
+    double   sum_settle = 0, sum_edge = 0, sum_old = 0;
+    int64_t  max_settle = 0, max_stamp = 0;
+
+    for (int b = 0; b < BUTTONS; b++) next[b] = next_of(&tc, b, 0);
+    btn_debounce_init(&deb, 0);
+
+    for (int64_t ts = SCAN_US; ts < end_us; ts += SCAN_US) {
+        /* Contact levels at the sample instant (STEP_US resolution) */
+        int64_t at = ts / STEP_US * STEP_US;
+        for (int b = 0; b < BUTTONS; b++) {
+            while (pos[b] < tc.n_edges[b] && tc.edges[b][pos[b]] <= at) {
+                level ^= 1u << b;
+                pos[b]++;
+            }
+        }
+
+        /* Same expansion into events as the driver's scan callback */
+        uint16_t changed = btn_debounce_update(&deb, level);
+        for (int b = 0; b < BUTTONS; b++) {
+            if (!(changed & (1u << b))) continue;
+            state ^= 1u << b;
+            bool    pressed = state & (1u << b);
+            int64_t stamp   = ts - (int64_t)(BTN_DEBOUNCE_SAMPLES - 1) * SCAN_US;
+            events++;
+
+            int k = next[b];
+            if (k < 0 || tc.tr[k].pressed != pressed) {
+                if (errors++ < 5) printf("    unexpected %s of button %d at %.3f s\n",
+                                         pressed ? "press" : "release", b, ts / 1e6);
+                continue;
+            }
+            const transition_t *tr = &tc.tr[k];
+            int64_t lat = ts - tr->settle_us;
+            if (ts < tr->t_us || lat > (int64_t)BTN_DEBOUNCE_SAMPLES * SCAN_US ||
+                stamp < tr->t_us || stamp >= tr->settle_us + SCAN_US) {
+                if (errors++ < 5) printf("    button %d at %.3f s: edge %.3f, settle %.3f, stamp %.3f\n",
+                                         b, ts / 1e6, tr->t_us / 1e6, tr->settle_us / 1e6, stamp / 1e6);
+            }
+            if (lat > max_settle) max_settle = lat;
+            if (stamp - tr->settle_us > max_stamp) max_stamp = stamp - tr->settle_us;
+            sum_settle += lat > 0 ? lat : 0;
+            sum_edge   += ts - tr->t_us;
+            sum_old    += tr->settle_us - tr->t_us + OLD_DEBOUNCE_US;
+            next[b] = next_of(&tc, b, k + 1);
+        }
+        if (deb.state != state) {
+            if (errors++ < 5) printf("    state mismatch at %.3f s\n", ts / 1e6);
+            state = deb.state;
+        }
+    }
+
+    int missed = 0;
+    for (int b = 0; b < BUTTONS; b++) {
+        for (int k = next[b]; k >= 0; k = next_of(&tc, b, k + 1)) missed++;
+    }
+    errors += missed;
+    int matched = events > 0 ? events : 1;
+    printf("  %-16s %4d transitions %3d glitches %4d events  latency after settle %4.1f / %4.1f ms,"
+           " after edge %5.1f ms (old %5.1f)  %s\n",
+           fx->name, tc.count, tc.glitches, events, sum_settle / matched / 1000.0, max_settle / 1000.0,
+           sum_edge / matched / 1000.0, sum_old / matched / 1000.0, errors ? "FAIL" : "ok");
+    if (missed) printf("    %d transitions missed\n", missed);
+    free_trace(&tc);
+    return errors == 0;
+}
+
+int main(void) {
+    printf("Vertical-counter debounce: %d us scan, %d samples; latencies mean / max\n",
+           SCAN_US, BTN_DEBOUNCE_SAMPLES);
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(s_fixtures) / sizeof(s_fixtures[0]); i++) {
+        ok &= run_fixture(&s_fixtures[i]);
+    }
+    printf(ok ? "All fixtures passed\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
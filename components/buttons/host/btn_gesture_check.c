@@ -0,0 +1,196 @@
+/*
+ * Host-side button gesture check against scripted press sequences.
+ *
+ * Each scenario is a list of debounced edges fed to btn_gesture exactly as
+ * the driver does: edges as they are confirmed, and btn_gesture_tick() on
+ * every BUTTONS_SCAN_US scan.  The gestures that come out are compared, in
+ * order, with the expected list (kind, button, state and due time) under
+ * the default configuration.  Covered:
+ *
+ *   - HOLD once per press at hold_ms, none for a button held at start,
+ *   - REPEAT after repeat_delay_ms, each interval 85 % of the last down to
+ *     repeat_min_ms, and none for buttons outside repeat_mask,
+ *   - DOUBLE_TAP inside double_ms only, not after a long press, and a
+ *     third tap starting over (the fourth tap is a double again),
+ *   - CHORD only while every held button went down within chord_ms.
+ *
+ * Scan-driven gestures must also be reported within one scan of their due
+ * time.  The exit status is non-zero if any scenario fails.
+ *
+ * Build and run (from the repo root): `make btn_gesture_check`
+ */
+
+#include "btn_gesture.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+#define SCAN_US     2000    /* BUTTONS_SCAN_US */
+#define MAX_EVENTS  64
+#define COUNT(a)    (sizeof(a) / sizeof((a)[0]))
+
+/* Button ids (btn_id_t in buttons.h): UP repeats, STICK and A do not */
+#define UP          0
+#define STICK       4
+#define A           5
+#define B           6
+
+#define HOLD        BTN_GESTURE_HOLD
+#define REPEAT      BTN_GESTURE_REPEAT
+#define DOUBLE      BTN_GESTURE_DOUBLE_TAP
+#define CHORD       BTN_GESTURE_CHORD
+
+typedef struct {
+    uint32_t t_ms;
+    uint8_t  button;
+    bool     pressed;
+} edge_t;
+
+typedef struct {
+    uint32_t           t_us;        /* Due time */
+    uint8_t            button;
+    btn_gesture_kind_t kind;
+    uint16_t           state;
+} expect_t;
+
+typedef struct {
+    const char     *name;
+    uint16_t        held_at_start;
+    uint32_t        end_ms;
+    const edge_t   *edges;
+    size_t          n_edges;
+    const expect_t *expect;
+    size_t          n_expect;
+} scenario_t;
+
+/* ── Scenarios ──────────────────────────────────────────────────────────── */
+static const edge_t e_tap[] = { { 100, A, true }, { 200, A, false } };
+
+static const edge_t   e_hold[] = { { 100, A, true }, { 1500, A, false } };
+static const expect_t x_hold[] = { { 700000, A, HOLD, 1 << A } };
+
+/* 120 ms, then 85 % of the last interval each time, never under 40 ms */
+static const edge_t   e_repeat[] = { { 100, UP, true }, { 1000, UP, false } };
+static const expect_t x_repeat[] = {
+    { 400000, UP, REPEAT, 1 << UP }, { 520000, UP, REPEAT, 1 << UP },
+    { 622000, UP, REPEAT, 1 << UP }, { 700000, UP, HOLD,   1 << UP },
+    { 708700, UP, REPEAT, 1 << UP }, { 782395, UP, REPEAT, 1 << UP },
+    { 845035, UP, REPEAT, 1 << UP }, { 898279, UP, REPEAT, 1 << UP },
+    { 943536, UP, REPEAT, 1 << UP }, { 983536, UP, REPEAT, 1 << UP },
+};
+
+static const edge_t   e_double[] = {
+    { 100, A, true }, { 180, A, false }, { 400, A, true }, { 480, A, false },
+};
+static const expect_t x_double[] = { { 400000, A, DOUBLE, 1 << A } };
+
+static const edge_t e_double_slow[] = {
+    { 100, A, true }, { 180, A, false }, { 500, A, true }, { 580, A, false },
+};
+
+static const edge_t e_long_then_tap[] = {
+    { 100, A, true }, { 800, A, false }, { 900, A, true }, { 980, A, false },
+};
+static const expect_t x_long_then_tap[] = { { 700000, A, HOLD, 1 << A } };
+
+static const edge_t e_taps[] = {
+    { 100, A, true }, { 160, A, false }, { 300, A, true }, { 360, A, false },
+    { 500, A, true }, { 560, A, false }, { 700, A, true }, { 760, A, false },
+};
+static const expect_t x_taps[] = {
+    { 300000, A, DOUBLE, 1 << A }, { 700000, A, DOUBLE, 1 << A },
+};
+
+static const edge_t e_chord[] = {
+    { 100, STICK, true }, { 300, A, true }, { 500, B, true },
+    { 550, STICK, false }, { 560, A, false }, { 570, B, false },
+};
+static const expect_t x_chord[] = {
+    { 300000, A, CHORD, 1 << STICK | 1 << A },
+    { 500000, B, CHORD, 1 << STICK | 1 << A | 1 << B },
+};
+
+/* B joins 450 ms after STICK: outside the window even though A is recent */
+static const edge_t e_chord_slow[] = {
+    { 100, STICK, true }, { 400, A, true }, { 550, B, true },
+    { 600, STICK, false }, { 610, A, false }, { 620, B, false },
+};
+static const expect_t x_chord_slow[] = { { 400000, A, CHORD, 1 << STICK | 1 << A } };
+
+static const edge_t e_held_at_start[] = { { 1200, STICK, false } };
+
+static const scenario_t s_scenarios[] = {
+    { "single_tap",      0,          1000, e_tap,           COUNT(e_tap),           NULL, 0 },
+    { "hold",            0,          1600, e_hold,          COUNT(e_hold),
+      x_hold,            COUNT(x_hold) },
+    { "repeat_accel",    0,          1200, e_repeat,        COUNT(e_repeat),
+      x_repeat,          COUNT(x_repeat) },
+    { "double_tap",      0,          1000, e_double,        COUNT(e_double),
+      x_double,          COUNT(x_double) },
+    { "double_too_slow", 0,          1000, e_double_slow,   COUNT(e_double_slow),   NULL, 0 },
+    { "long_then_tap",   0,          1200, e_long_then_tap, COUNT(e_long_then_tap),
+      x_long_then_tap,   COUNT(x_long_then_tap) },
+    { "four_taps",       0,          1000, e_taps,          COUNT(e_taps),
+      x_taps,            COUNT(x_taps) },
+    { "chord",           0,          1000, e_chord,         COUNT(e_chord),
+      x_chord,           COUNT(x_chord) },
+    { "chord_window",    0,          1000, e_chord_slow,    COUNT(e_chord_slow),
+      x_chord_slow,      COUNT(x_chord_slow) },
+    { "held_at_start",   1 << STICK, 1500, e_held_at_start, COUNT(e_held_at_start), NULL, 0 },
+};
+
+/* ── Runner ─────────────────────────────────────────────────────────────── */
+typedef struct {
+    btn_gesture_event_t ev;
+    int64_t             seen_us;    /* Scan or edge that reported it */
+} seen_t;
+
+static const char *kind_name(btn_gesture_kind_t k) {
+    static const char *names[] = { "HOLD", "REPEAT", "DOUBLE_TAP", "CHORD" };
+    return (unsigned)k < COUNT(names) ? names[k] : "?";
+}
+
+static bool run_scenario(const scenario_t *sc) {
+    static seen_t seen[MAX_EVENTS];
+    btn_gesture_event_t out[BTN_GESTURE_MAX_EVENTS];
+    btn_gesture_config_t cfg = BTN_GESTURE_DEFAULT_CONFIG();
+    btn_gesture_t g;
+    size_t n = 0, next = 0;
+
+    btn_gesture_init(&g, &cfg, sc->held_at_start);
+    for (int64_t t = 0; t <= (int64_t)sc->end_ms * 1000; t += SCAN_US) {
+        while (next < sc->n_edges && (int64_t)sc->edges[next].t_ms * 1000 <= t) {
+            const edge_t *e = &sc->edges[next++];
+            size_t k = btn_gesture_edge(&g, e->button, e->pressed, (int64_t)e->t_ms * 1000, out);
+            for (size_t i = 0; i < k && n < MAX_EVENTS; i++) seen[n++] = (seen_t){ out[i], t };
+        }
+        size_t k = btn_gesture_tick(&g, t, out);
+        for (size_t i = 0; i < k && n < MAX_EVENTS; i++) seen[n++] = (seen_t){ out[i], t };
+    }
+
+    int errors = 0;
+    for (size_t i = 0; i < n || i < sc->n_expect; i++) {
+        const expect_t *x = i < sc->n_expect ? &sc->expect[i] : NULL;
+        const seen_t   *s = i < n ? &seen[i] : NULL;
+        bool ok = x && s && s->ev.kind == x->kind && s->ev.button == x->button &&
+                  s->ev.state == x->state && s->ev.timestamp_us == x->t_us &&
+                  s->seen_us - s->ev.timestamp_us < SCAN_US;
+        if (ok) continue;
+        if (errors++ >= 5) continue;
+        if (x) printf("    expected %-10s button %u state %03x at %8.3f ms\n",
+                      kind_name(x->kind), x->button, x->state, x->t_us / 1000.0);
+        if (s) printf("    got      %-10s button %u state %03x at %8.3f ms (seen %.3f ms)\n",
+                      kind_name(s->ev.kind), s->ev.button, s->ev.state,
+                      s->ev.timestamp_us / 1000.0, s->seen_us / 1000.0);
+        else   printf("    got      nothing\n");
+    }
+    printf("  %-16s %2zu gestures  %s\n", sc->name, n, errors ? "FAIL" : "ok");
+    return errors == 0;
+}
+
+int main(void) {
+    printf("Button gestures: %d us scan, default timings\n", SCAN_US);
+    bool ok = true;
+    for (size_t i = 0; i < COUNT(s_scenarios); i++) ok &= run_scenario(&s_scenarios[i]);
+    printf(ok ? "All scenarios passed\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+/*
+ * Button debouncer – vertical counters over a bitmask of inputs.
+ *
+ * Every scan feeds one sample of all buttons (bit n = button n pressed).
+ * Each bit has a 2-bit counter, stored "vertically": bit n of cnt0 and
+ * cnt1 together form button n's counter, so all buttons are debounced with
+ * a handful of bitwise operations and no per-button loop.  A counter
+ * counts samples that disagree with the debounced state and is cleared by
+ * any sample that agrees; the state flips on the BTN_DEBOUNCE_SAMPLES-th
+ * disagreeing sample in a row.  Bounce therefore delays an edge but never
+ * doubles it, and glitches shorter than BTN_DEBOUNCE_SAMPLES - 1 scan
+ * periods are ignored.
+ *
+ * Pure C with no ESP-IDF dependencies (shared with the host check,
+ * `make btn_debounce_check`).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define BTN_DEBOUNCE_SAMPLES    4   /* Fixed by the 2-bit counters */
+
+typedef struct {
+    uint16_t state;         /* Debounced state, bit n = button n pressed */
+    uint16_t cnt0, cnt1;    /* Vertical counter, low and high bits */
+} btn_debounce_t;
+
+/**
+ * @brief  Start from a known state (e.g. the first sample) with no
+ *         pending changes.
+ */
+static inline void btn_debounce_init(btn_debounce_t *d, uint16_t state) {
+    d->state = state;
+    d->cnt0  = 0;
+    d->cnt1  = 0;
+}
+
+/**
+ * @brief  Feed one sample of all buttons.
+ * @return Bits whose debounced state changed on this sample.
+ */
+static inline uint16_t btn_debounce_update(btn_debounce_t *d, uint16_t sample) {
+    uint16_t delta  = sample ^ d->state;
+    uint16_t toggle = delta & d->cnt0 & d->cnt1;     /* Counter was 3: fourth sample */
+    d->cnt1   = (d->cnt1 ^ d->cnt0) & delta;
+    d->cnt0   = ~d->cnt0 & delta;
+    d->state ^= toggle;
+    return toggle;
+}
@@ -0,0 +1,95 @@
+/*
+ * Button gestures – hold, auto-repeat, double-tap and chord recognition.
+ *
+ * One state machine for all buttons, fed with the debounced edges and with
+ * the passing time (the driver calls it on every scan).  Gestures are
+ * reported in addition to the plain press / release events, so screens
+ * that only care about presses are unaffected:
+ *
+ *   HOLD        once per press, hold_ms after it went down
+ *   REPEAT      while a button in repeat_mask is held: first after
+ *               repeat_delay_ms, then every repeat_ms, each interval
+ *               shrinking by repeat_accel_pct down to repeat_min_ms
+ *   DOUBLE_TAP  on a press less than double_ms after a short press of the
+ *               same button was released (a third tap starts over)
+ *   CHORD       on a press while other buttons are held, if all of them
+ *               went down within chord_ms; state has the whole set
+ *
+ * A timing of 0 disables that gesture.  Pure C with no ESP-IDF
+ * dependencies; button n is bit n as in btn_debounce.h.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BTN_GESTURE_MAX_BUTTONS 16
+#define BTN_GESTURE_MAX_EVENTS  BTN_GESTURE_MAX_BUTTONS  /* Per call */
+
+typedef enum {
+    BTN_GESTURE_HOLD = 0,
+    BTN_GESTURE_REPEAT,
+    BTN_GESTURE_DOUBLE_TAP,
+    BTN_GESTURE_CHORD,
+} btn_gesture_kind_t;
+
+typedef struct {
+    uint16_t hold_ms;
+    uint16_t repeat_delay_ms;
+    uint16_t repeat_ms;
+    uint16_t repeat_min_ms;
+    uint8_t  repeat_accel_pct;      /* Next interval = this % of the last one */
+    uint16_t repeat_mask;           /* Buttons that auto-repeat */
+    uint16_t double_ms;
+    uint16_t chord_ms;
+} btn_gesture_config_t;
+
+/* Repeat on the four directions: 300 ms, then 120 ms speeding up to 40 ms */
+#define BTN_GESTURE_DEFAULT_CONFIG() \
+    { .hold_ms = 600, .repeat_delay_ms = 300, .repeat_ms = 120, .repeat_min_ms = 40, \
+      .repeat_accel_pct = 85, .repeat_mask = 0x000F, .double_ms = 300, .chord_ms = 400 }
+
+typedef struct {
+    uint8_t            button;
+    btn_gesture_kind_t kind;
+    uint16_t           state;           /* Buttons held */
+    int64_t            timestamp_us;    /* When the gesture was due */
+} btn_gesture_event_t;
+
+typedef struct {
+    btn_gesture_config_t cfg;
+    uint16_t state;
+    uint16_t hold_done;                 /* HOLD already reported for this press */
+    uint16_t tap_armed;                 /* Last press was a short tap */
+    uint16_t double_done;               /* This press was a DOUBLE_TAP */
+    int64_t  down_us[BTN_GESTURE_MAX_BUTTONS];
+    int64_t  up_us[BTN_GESTURE_MAX_BUTTONS];
+    int64_t  next_repeat_us[BTN_GESTURE_MAX_BUTTONS];
+    uint32_t interval_us[BTN_GESTURE_MAX_BUTTONS];
+} btn_gesture_t;
+
+/**
+ * @brief  Start with @p state held (no gestures for those buttons until
+ *         they are pressed again).
+ */
+void btn_gesture_init(btn_gesture_t *g, const btn_gesture_config_t *cfg, uint16_t state);
+
+/**
+ * @brief  Change the timings; presses in progress keep their schedule.
+ */
+void btn_gesture_set_config(btn_gesture_t *g, const btn_gesture_config_t *cfg);
+
+/**
+ * @brief  Report a debounced edge of @p button at @p t_us.
+ * @return Gestures written to @p out (DOUBLE_TAP, CHORD).
+ */
+size_t btn_gesture_edge(btn_gesture_t *g, uint8_t button, bool pressed, int64_t t_us,
+                        btn_gesture_event_t *out);
+
+/**
+ * @brief  Advance time to @p now_us (call at least every few ms).
+ * @return Gestures written to @p out (HOLD, REPEAT).
+ */
+size_t btn_gesture_tick(btn_gesture_t *g, int64_t now_us, btn_gesture_event_t *out);
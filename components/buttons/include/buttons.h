@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "btn_gesture.h"
 
 /* ── Button identifiers ─────────────────────────────────────────────────── */
 typedef enum {
@@ -23,23 +24,59 @@ typedef enum {
 typedef enum {
     BTN_PRESSED,
     BTN_RELEASED,
+    /* Gestures (btn_gesture.h), sent after the plain events */
+    BTN_HOLD,           /* Held for hold_ms */
+    BTN_REPEAT,         /* Auto-repeat while held (repeat_mask buttons) */
+    BTN_DOUBLE_TAP,     /* Second short press of the same button */
+    BTN_CHORD,          /* Pressed while others are held; state = the set */
 } btn_event_type_t;
 
 typedef struct {
     btn_id_t        id;
     btn_event_type_t type;
+    uint16_t        state;          /* All buttons after this event, bit = 1 << btn_id_t */
+    int64_t         timestamp_us;   /* esp_timer time of the first stable sample */
 } btn_event_t;
 
+#define BTN_MASK(id)    (1u << (id))
+
+/* ── Scanning ───────────────────────────────────────────────────────────── */
+/* One periodic esp_timer samples all buttons at once; an edge is reported
+ * after BTN_DEBOUNCE_SAMPLES stable samples, i.e. 6–8 ms after it settles */
+#ifndef BUTTONS_SCAN_US
+#define BUTTONS_SCAN_US     2000
+#endif
+
+typedef struct {
+    uint32_t scans;
+    uint32_t events;
+    uint32_t dropped;       /* Events lost to a full queue */
+} buttons_stats_t;
+
 /* ── Public API ──────────────────────────────────────────────────────────── */
 
 /**
- * @brief  Initialise all GPIO pins and install ISR service.
+ * @brief  Initialise all GPIO pins and start the scan timer.
  *         @p event_queue must be a FreeRTOS queue for btn_event_t items
  *         already created by the caller.
  */
 void buttons_init(QueueHandle_t event_queue);
 
 /**
- * @brief  Return true if button @p id is currently pressed (active-low).
+ * @brief  Return true if button @p id is pressed (debounced).
  */
 bool buttons_is_pressed(btn_id_t id);
+
+/**
+ * @brief  Debounced state of all buttons, bit BTN_MASK(id) set = pressed.
+ */
+uint16_t buttons_get_state(void);
+
+void buttons_get_stats(buttons_stats_t *out);
+
+/**
+ * @brief  Change gesture timings (BTN_GESTURE_DEFAULT_CONFIG() at boot).
+ */
+void buttons_set_gestures(const btn_gesture_config_t *cfg);
+
+void buttons_get_gestures(btn_gesture_config_t *out);
@@ -0,0 +1,247 @@
+/*
+ * Fixed-point maths – lookup tables and table-driven functions.
+ *
+ * Every table has 256 interpolation segments (plus the end point) and was
+ * generated offline:
+ *   SIN_Q15[k]   = round(32767 * sin(pi/2 * k / 256))       k = 0..256
+ *   EXP2_Q16[k]  = round(65536 * 2^(k / 256))               k = 0..256
+ *   SQRT_Q16[k]  = round(65536 * sqrt((k + 64) / 256))      k = 0..192
+ *   RECIP_Q16[k] = round(65536 * 256 / (256 + k))           k = 0..256
+ */
+
+#include "fixpt.h"
+
+#define LOG2E_Q16   94548       /* log2(e) in Q16.16 */
+
+static const uint16_t SIN_Q15[257] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,
+     1608,  1809,  2009,  2210,  2410,  2611,  2811,  3012,
+     3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+     6393,  6590,  6786,  6983,  7179,  7375,  7571,  7767,
+     7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849,
+    11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+    12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+    15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673,
+    16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357,
+    19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+    20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+    23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143,
+    24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+    26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+    27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+    28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534,
+    29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+    30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+    31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+    32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+    32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717,
+    32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+    32767,
+};
+
+static const uint32_t EXP2_Q16[257] = {
+     65536,  65714,  65892,  66071,  66250,  66429,  66609,  66790,
+     66971,  67153,  67335,  67517,  67700,  67884,  68068,  68252,
+     68438,  68623,  68809,  68996,  69183,  69370,  69558,  69747,
+     69936,  70126,  70316,  70507,  70698,  70889,  71082,  71274,
+     71468,  71661,  71856,  72050,  72246,  72442,  72638,  72835,
+     73032,  73230,  73429,  73628,  73828,  74028,  74229,  74430,
+     74632,  74834,  75037,  75240,  75444,  75649,  75854,  76060,
+     76266,  76473,  76680,  76888,  77096,  77305,  77515,  77725,
+     77936,  78147,  78359,  78572,  78785,  78998,  79212,  79427,
+     79642,  79858,  80075,  80292,  80510,  80728,  80947,  81166,
+     81386,  81607,  81828,  82050,  82273,  82496,  82719,  82944,
+     83169,  83394,  83620,  83847,  84074,  84302,  84531,  84760,
+     84990,  85220,  85451,  85683,  85915,  86148,  86382,  86616,
+     86851,  87086,  87322,  87559,  87796,  88034,  88273,  88513,
+     88752,  88993,  89234,  89476,  89719,  89962,  90206,  90451,
+     90696,  90942,  91188,  91436,  91684,  91932,  92181,  92431,
+     92682,  92933,  93185,  93438,  93691,  93945,  94200,  94455,
+     94711,  94968,  95226,  95484,  95743,  96002,  96263,  96524,
+     96785,  97048,  97311,  97575,  97839,  98104,  98370,  98637,
+     98905,  99173,  99442,  99711,  99982, 100253, 100524, 100797,
+    101070, 101344, 101619, 101895, 102171, 102448, 102726, 103004,
+    103283, 103564, 103844, 104126, 104408, 104691, 104975, 105260,
+    105545, 105831, 106118, 106406, 106694, 106984, 107274, 107565,
+    107856, 108149, 108442, 108736, 109031, 109326, 109623, 109920,
+    110218, 110517, 110816, 111117, 111418, 111720, 112023, 112327,
+    112631, 112937, 113243, 113550, 113858, 114167, 114476, 114787,
+    115098, 115410, 115723, 116036, 116351, 116667, 116983, 117300,
+    117618, 117937, 118257, 118577, 118899, 119221, 119544, 119869,
+    120194, 120519, 120846, 121174, 121502, 121832, 122162, 122493,
+    122825, 123158, 123492, 123827, 124163, 124500, 124837, 125176,
+    125515, 125855, 126197, 126539, 126882, 127226, 127571, 127917,
+    128263, 128611, 128960, 129310, 129660, 130012, 130364, 130718,
+    131072,
+};
+
+static const uint32_t SQRT_Q16[193] = {
+    32768, 33023, 33276, 33527, 33776, 34024, 34270, 34514,
+    34756, 34996, 35235, 35472, 35708, 35942, 36175, 36406,
+    36636, 36864, 37091, 37316, 37540, 37763, 37985, 38205,
+    38424, 38642, 38858, 39073, 39287, 39500, 39712, 39923,
+    40132, 40341, 40548, 40755, 40960, 41164, 41368, 41570,
+    41771, 41972, 42171, 42369, 42567, 42763, 42959, 43154,
+    43348, 43541, 43733, 43925, 44115, 44305, 44494, 44682,
+    44869, 45056, 45242, 45427, 45611, 45795, 45977, 46160,
+    46341, 46522, 46702, 46881, 47059, 47237, 47415, 47591,
+    47767, 47942, 48117, 48291, 48465, 48637, 48809, 48981,
+    49152, 49322, 49492, 49661, 49830, 49998, 50166, 50332,
+    50499, 50665, 50830, 50995, 51159, 51323, 51486, 51649,
+    51811, 51972, 52134, 52294, 52454, 52614, 52773, 52932,
+    53090, 53248, 53405, 53562, 53719, 53874, 54030, 54185,
+    54340, 54494, 54647, 54801, 54954, 55106, 55258, 55410,
+    55561, 55712, 55862, 56012, 56162, 56311, 56459, 56608,
+    56756, 56903, 57051, 57198, 57344, 57490, 57636, 57781,
+    57926, 58071, 58215, 58359, 58503, 58646, 58789, 58931,
+    59073, 59215, 59357, 59498, 59639, 59779, 59919, 60059,
+    60199, 60338, 60477, 60615, 60753, 60891, 61029, 61166,
+    61303, 61440, 61576, 61712, 61848, 61984, 62119, 62254,
+    62388, 62523, 62657, 62790, 62924, 63057, 63190, 63323,
+    63455, 63587, 63719, 63850, 63982, 64113, 64243, 64374,
+    64504, 64634, 64763, 64893, 65022, 65151, 65279, 65408,
+    65536,
+};
+
+static const uint32_t RECIP_Q16[257] = {
+    65536, 65281, 65028, 64777, 64528, 64281, 64035, 63792,
+    63550, 63310, 63072, 62836, 62602, 62369, 62138, 61909,
+    61681, 61455, 61231, 61008, 60787, 60568, 60350, 60133,
+    59919, 59705, 59494, 59283, 59075, 58867, 58662, 58457,
+    58254, 58053, 57852, 57654, 57456, 57260, 57065, 56872,
+    56680, 56489, 56299, 56111, 55924, 55738, 55554, 55370,
+    55188, 55007, 54828, 54649, 54471, 54295, 54120, 53946,
+    53773, 53601, 53431, 53261, 53092, 52925, 52759, 52593,
+    52429, 52265, 52103, 51942, 51782, 51622, 51464, 51306,
+    51150, 50995, 50840, 50686, 50534, 50382, 50231, 50081,
+    49932, 49784, 49637, 49490, 49345, 49200, 49056, 48913,
+    48771, 48630, 48489, 48349, 48210, 48072, 47935, 47798,
+    47663, 47528, 47393, 47260, 47127, 46995, 46864, 46733,
+    46603, 46474, 46346, 46218, 46091, 45965, 45839, 45714,
+    45590, 45467, 45344, 45222, 45100, 44979, 44859, 44739,
+    44620, 44502, 44384, 44267, 44151, 44035, 43919, 43805,
+    43691, 43577, 43464, 43352, 43240, 43129, 43019, 42908,
+    42799, 42690, 42582, 42474, 42367, 42260, 42154, 42048,
+    41943, 41838, 41734, 41631, 41528, 41425, 41323, 41222,
+    41121, 41020, 40920, 40820, 40721, 40623, 40525, 40427,
+    40330, 40233, 40137, 40041, 39946, 39851, 39756, 39662,
+    39569, 39476, 39383, 39291, 39199, 39108, 39017, 38926,
+    38836, 38746, 38657, 38568, 38480, 38392, 38304, 38217,
+    38130, 38044, 37958, 37872, 37787, 37702, 37617, 37533,
+    37449, 37366, 37283, 37200, 37118, 37036, 36954, 36873,
+    36792, 36712, 36631, 36552, 36472, 36393, 36314, 36236,
+    36158, 36080, 36003, 35926, 35849, 35772, 35696, 35620,
+    35545, 35470, 35395, 35320, 35246, 35172, 35099, 35026,
+    34953, 34880, 34808, 34735, 34664, 34592, 34521, 34450,
+    34380, 34309, 34239, 34169, 34100, 34031, 33962, 33893,
+    33825, 33757, 33689, 33622, 33554, 33487, 33421, 33354,
+    33288, 33222, 33157, 33091, 33026, 32961, 32897, 32832,
+    32768,
+};
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static inline uint32_t lerp_u32(const uint32_t *t, uint32_t i, uint32_t frac8) {
+    return t[i] + (uint32_t)(((int32_t)(t[i + 1] - t[i]) * (int32_t)frac8) >> 8);
+}
+
+static inline int clz32(uint32_t x) {
+    return __builtin_clz(x);
+}
+
+/* sqrt of the normalised mantissa: x << s lands in [2^30, 2^32), s even.
+ * Returns sqrt(m / 2^32) in Q16 (32768..65536) and the shift. */
+static uint32_t sqrt_mantissa(uint32_t x, int *shift) {
+    int s = clz32(x) & ~1;
+    uint32_t m = x << s;
+    uint32_t idx = (m >> 24) - 64;            /* 0..191 */
+    uint32_t frac = (m >> 16) & 0xFF;
+    *shift = s;
+    return lerp_u32(SQRT_Q16, idx, frac);
+}
+
+/* ── Trigonometry ───────────────────────────────────────────────────────── */
+q15_t fixpt_sin(uint16_t angle) {
+    uint32_t quadrant = angle >> 14;
+    uint32_t pos = angle & 0x3FFF;            /* 14-bit position in quadrant */
+    if (quadrant & 1) pos = 0x4000 - pos;     /* mirror: 0x4000 → table end */
+
+    uint32_t i = pos >> 6, frac = pos & 0x3F;
+    int32_t v = SIN_Q15[i];
+    if (frac) v += ((int32_t)(SIN_Q15[i + 1] - SIN_Q15[i]) * (int32_t)frac + 32) >> 6;
+
+    return (q15_t)((quadrant & 2) ? -v : v);
+}
+
+/* ── Exponential ────────────────────────────────────────────────────────── */
+q16_t fixpt_exp2_q16(q16_t x) {
+    int32_t  n = x >> 16;                     /* floor */
+    uint32_t f = (uint32_t)x & 0xFFFF;
+    uint32_t m = lerp_u32(EXP2_Q16, f >> 8, f & 0xFF);   /* 2^f in Q16 */
+
+    if (n >= 15) return Q16_MAX;
+    if (n >= 0)  return (q16_t)(m << n);
+    if (n < -32) return 0;
+    return (q16_t)((m + (1u << (-n - 1))) >> -n);
+}
+
+q16_t fixpt_exp_q16(q16_t x) {
+    return fixpt_exp2_q16(fixpt_sat16(((int64_t)x * LOG2E_Q16 + (1 << 15)) >> 16));
+}
+
+/* ── Square root ────────────────────────────────────────────────────────── */
+uint16_t fixpt_isqrt(uint32_t x) {
+    if (x == 0) return 0;
+    int s;
+    uint32_t r = sqrt_mantissa(x, &s);        /* sqrt(x) = r / 2^(s/2) */
+    int sh = s / 2;
+    r = (r + (1u << sh >> 1)) >> sh;
+    return (uint16_t)(r > 65535 ? 65535 : r);
+}
+
+q16_t fixpt_sqrt_q16(q16_t x) {
+    if (x <= 0) return 0;
+    int s;
+    uint32_t r = sqrt_mantissa((uint32_t)x, &s);
+    /* sqrt(x / 2^16) * 2^16 = sqrt(x) * 2^8 = r * 2^(8 - s/2) */
+    int sh = s / 2 - 8;
+    if (sh <= 0) return (q16_t)(r << -sh);
+    return (q16_t)((r + (1u << (sh - 1))) >> sh);
+}
+
+/* ── Reciprocal ─────────────────────────────────────────────────────────── */
+q16_t fixpt_recip_q16(q16_t x) {
+    if (x == 0) return Q16_MAX;
+    bool neg = x < 0;
+    uint32_t u = neg ? (uint32_t)(-(int64_t)x) : (uint32_t)x;
+
+    /* u << z in [2^31, 2^32): mantissa m in [1, 2) */
+    int z = clz32(u);
+    uint32_t m = u << z;
+    uint32_t y = lerp_u32(RECIP_Q16, (m >> 23) & 0xFF, (m >> 15) & 0xFF);
+
+    /* One Newton step: y = y * (2 - m * y) */
+    int64_t mq = m >> 15;                     /* m in Q16 */
+    int64_t e  = (mq * y) >> 16;
+    y = (uint32_t)((y * (2 * (int64_t)Q16_ONE - e)) >> 16);
+
+    /* 2^32 / u = y * 2^(z - 15) */
+    int sh = z - 15;
+    int64_t r;
+    if (sh >= 0) {
+        r = (int64_t)y << sh;
+    } else {
+        r = ((int64_t)y + ((int64_t)1 << (-sh - 1))) >> -sh;
+    }
+    if (r > Q16_MAX) r = Q16_MAX;
+    return (q16_t)(neg ? -r : r);
+}
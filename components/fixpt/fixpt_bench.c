@@ -0,0 +1,153 @@
+/*
+ * Fixed-point vs float microbenchmark and accuracy report.
+ *
+ * On target the cost is CPU cycles per call (esp_cpu_get_cycle_count);
+ * on the host it is nanoseconds per call.  Accuracy is the worst-case
+ * error against libm over a sweep of the input range, checked against the
+ * bounds quoted in fixpt.h so table changes cannot loosen them unnoticed.
+ *
+ * Host build: `make fixpt_bench` from the repo root (exits non-zero if a
+ * function exceeds its bound).
+ */
+
+#include "fixpt.h"
+#include <math.h>
+#include <stdio.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "esp_log.h"
+#define TAG "fixpt"
+#define UNIT "cyc"
+#define REPORT(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+static inline uint32_t bench_now(void) { return esp_cpu_get_cycle_count(); }
+#else
+#include <time.h>
+#define UNIT "ns"
+#define REPORT(fmt, ...) printf(fmt "\n", ##__VA_ARGS__)
+static inline uint32_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#endif
+
+#define ITERATIONS  4096
+#define TWO_PI      6.28318530717958647692f
+
+/* Worst-case error bounds, as documented in fixpt.h */
+#define BOUND_SIN_LSB       1.1
+#define BOUND_EXP_REL       6e-5
+#define BOUND_ISQRT_LSB     2.5
+#define BOUND_SQRT_REL      8e-5
+#define BOUND_RECIP_REL     2e-5
+
+static volatile int32_t s_sink_i;
+static volatile float   s_sink_f;
+static bool             s_pass;
+
+/* ── Timing ─────────────────────────────────────────────────────────────── */
+#define TIME_LOOP(result, body)                                          \
+    do {                                                                 \
+        uint32_t t0_ = bench_now();                                      \
+        for (uint32_t i = 0; i < ITERATIONS; i++) { body; }              \
+        (result) = (float)(bench_now() - t0_) / ITERATIONS;              \
+    } while (0)
+
+static void report(const char *name, float t_float, float t_fix, double max_err,
+                   double bound, const char *err_unit) {
+    bool ok = max_err <= bound;
+    REPORT("%-8s float %6.1f " UNIT "  fixpt %6.1f " UNIT "  (x%.1f)  max err %.3g %s"
+           "  (bound %.3g) %s",
+           name, t_float, t_fix, t_fix > 0 ? t_float / t_fix : 0.0f, max_err, err_unit,
+           bound, ok ? "ok" : "FAIL");
+    if (!ok) s_pass = false;
+}
+
+/* ── Individual benchmarks ──────────────────────────────────────────────── */
+static void bench_sin(void) {
+    float tf, tq;
+    TIME_LOOP(tf, s_sink_f = sinf((float)i * (TWO_PI / ITERATIONS)));
+    TIME_LOOP(tq, s_sink_i = fixpt_sin((uint16_t)(i * (65536 / ITERATIONS))));
+
+    double err = 0;
+    for (uint32_t a = 0; a < 65536; a++) {
+        double ref = sin(a * (2.0 * M_PI / 65536.0)) * 32767.0;
+        double e = fabs(fixpt_sin((uint16_t)a) - ref);
+        if (e > err) err = e;
+    }
+    report("sin", tf, tq, err, BOUND_SIN_LSB, "LSB");
+}
+
+static void bench_exp(void) {
+    float tf, tq;
+    /* x in [-8, 8) */
+    TIME_LOOP(tf, s_sink_f = expf((float)i * (16.0f / ITERATIONS) - 8.0f));
+    TIME_LOOP(tq, s_sink_i = fixpt_exp_q16((q16_t)(i * (16 * Q16_ONE / ITERATIONS)) - 8 * Q16_ONE));
+
+    double err = 0;
+    for (int32_t x = -8 * Q16_ONE; x < 8 * Q16_ONE; x += 97) {
+        double ref = exp(x / 65536.0);
+        double got = fixpt_exp_q16(x) / 65536.0;
+        /* Relative error where Q16 output rounding is not dominant */
+        if (ref >= 1.0) {
+            double e = fabs(got - ref) / ref;
+            if (e > err) err = e;
+        }
+    }
+    report("exp", tf, tq, err, BOUND_EXP_REL, "rel");
+}
+
+static void bench_sqrt(void) {
+    float tf, tq;
+    TIME_LOOP(tf, s_sink_f = sqrtf((float)(i * 1048573u + 1)));
+    TIME_LOOP(tq, s_sink_i = fixpt_isqrt(i * 1048573u + 1));
+
+    double err = 0;
+    for (uint64_t x = 1; x < 0xFFFFFFFFull; x = x * 1.0007 + 1) {
+        double e = fabs(fixpt_isqrt((uint32_t)x) - sqrt((double)x));
+        if (e > err) err = e;
+    }
+    report("isqrt", tf, tq, err, BOUND_ISQRT_LSB, "LSB");
+
+    TIME_LOOP(tq, s_sink_i = fixpt_sqrt_q16((q16_t)(i * 4099u + Q16_ONE)));
+    err = 0;
+    for (int32_t x = Q16_ONE; x < Q16_MAX - 4096; x += x / 1024 + 1) {
+        double ref = sqrt(x / 65536.0);
+        double e = fabs(fixpt_sqrt_q16(x) / 65536.0 - ref) / ref;
+        if (e > err) err = e;
+    }
+    report("sqrt16", tf, tq, err, BOUND_SQRT_REL, "rel");
+}
+
+static void bench_recip(void) {
+    float tf, tq;
+    TIME_LOOP(tf, s_sink_f = 1.0f / ((float)i + 1.5f));
+    TIME_LOOP(tq, s_sink_i = fixpt_recip_q16((q16_t)(i * Q16_ONE + Q16_ONE + Q16_ONE / 2)));
+
+    double err = 0;
+    /* Relative error where the result is >= 1.0 (x <= 1.0) */
+    for (int32_t x = Q16_ONE / 256; x <= Q16_ONE; x += x / 512 + 1) {
+        double ref = 65536.0 / x;
+        double e = fabs(fixpt_recip_q16(x) / 65536.0 - ref) / ref;
+        if (e > err) err = e;
+    }
+    report("recip", tf, tq, err, BOUND_RECIP_REL, "rel");
+}
+
+bool fixpt_bench_run(void) {
+    s_pass = true;
+    REPORT("fixpt benchmark: %d calls each, cost per call", ITERATIONS);
+    bench_sin();
+    bench_exp();
+    bench_sqrt();
+    bench_recip();
+    REPORT("fixpt accuracy: %s", s_pass ? "all within bounds" : "BOUND EXCEEDED");
+    return s_pass;
+}
+
+#ifndef ESP_PLATFORM
+int main(void) {
+    return fixpt_bench_run() ? 0 : 1;
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Fixed-point maths – Q15 / Q16.16 arithmetic and lookup-table functions.
+ *
+ *   q15_t   signed 1.15  (-1.0 .. 0.99997), audio samples, sin/cos
+ *   q16_t   signed 16.16 (-32768.0 .. 32767.99998), general purpose
+ *
+ * Angles are 16-bit binary angles: 0..65535 is one full turn, so phase
+ * accumulators wrap for free.  Table functions interpolate linearly
+ * between 256 segments; the worst-case errors are listed per function
+ * (measured against libm, see fixpt_bench_run()).
+ *
+ * Pure C with no ESP-IDF dependencies; the same sources build on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int16_t q15_t;
+typedef int32_t q16_t;
+
+#define Q15_ONE        32767
+#define Q15_MIN        (-32768)
+#define Q16_ONE        65536
+#define Q16_MAX        INT32_MAX
+#define Q16_MIN        INT32_MIN
+
+/* Compile-time conversions (for constants and tables only) */
+#define Q15(x)         ((q15_t)((x) >= 0.99997 ? Q15_ONE : (x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q16(x)         ((q16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q16_FROM_INT(i) ((q16_t)((i) * Q16_ONE))
+#define Q16_TO_INT(q)  ((int32_t)(q) >> 16)
+
+/* Binary angle for a fraction of a turn */
+#define FIXPT_ANGLE(turns)  ((uint16_t)((turns) * 65536.0))
+#define FIXPT_ANGLE_HALF    0x8000u
+#define FIXPT_ANGLE_QUARTER 0x4000u
+
+/* ── Saturating arithmetic ───────────────────────────────────────────────── */
+static inline q15_t fixpt_sat15(int32_t v) {
+    return (q15_t)(v > Q15_ONE ? Q15_ONE : (v < Q15_MIN ? Q15_MIN : v));
+}
+
+static inline q16_t fixpt_sat16(int64_t v) {
+    return (q16_t)(v > Q16_MAX ? Q16_MAX : (v < Q16_MIN ? Q16_MIN : v));
+}
+
+static inline q15_t fixpt_add15(q15_t a, q15_t b) { return fixpt_sat15((int32_t)a + b); }
+static inline q15_t fixpt_sub15(q15_t a, q15_t b) { return fixpt_sat15((int32_t)a - b); }
+static inline q16_t fixpt_add16(q16_t a, q16_t b) { return fixpt_sat16((int64_t)a + b); }
+static inline q16_t fixpt_sub16(q16_t a, q16_t b) { return fixpt_sat16((int64_t)a - b); }
+
+/* Rounded Q15 product; -1 * -1 saturates to Q15_ONE */
+static inline q15_t fixpt_mul15(q15_t a, q15_t b) {
+    return fixpt_sat15(((int32_t)a * b + (1 << 14)) >> 15);
+}
+
+/* Rounded Q16.16 product, saturating */
+static inline q16_t fixpt_mul16(q16_t a, q16_t b) {
+    return fixpt_sat16(((int64_t)a * b + (1 << 15)) >> 16);
+}
+
+/* Q16.16 quotient, saturating (b == 0 gives ±max) */
+static inline q16_t fixpt_div16(q16_t a, q16_t b) {
+    if (b == 0) return a >= 0 ? Q16_MAX : Q16_MIN;
+    return fixpt_sat16(((int64_t)a << 16) / b);
+}
+
+/* ── Trigonometry (max error 1.1 LSB Q15) ───────────────────────────────── */
+q15_t fixpt_sin(uint16_t angle);
+
+static inline q15_t fixpt_cos(uint16_t angle) {
+    return fixpt_sin((uint16_t)(angle + FIXPT_ANGLE_QUARTER));
+}
+
+/* ── Exponential (relative error < 6e-5 for results >= 1.0) ─────────────── */
+
+/**
+ * @brief  2^x for Q16.16 x; saturates above 2^15, flushes to 0 below 2^-16.
+ */
+q16_t fixpt_exp2_q16(q16_t x);
+
+/**
+ * @brief  e^x for Q16.16 x (via exp2).
+ */
+q16_t fixpt_exp_q16(q16_t x);
+
+/* ── Square root (relative error < 8e-5) ────────────────────────────────── */
+
+/**
+ * @brief  Integer square root, rounded; within 2.5 LSB at the top of the
+ *         range (16-bit mantissa), saturated to 65535.
+ */
+uint16_t fixpt_isqrt(uint32_t x);
+
+/**
+ * @brief  Square root of a non-negative Q16.16 value (negative → 0).
+ */
+q16_t fixpt_sqrt_q16(q16_t x);
+
+/* ── Reciprocal (relative error < 2e-5 for results >= 1.0) ──────────────── */
+
+/**
+ * @brief  1 / x in Q16.16, saturating (x == 0 gives ±max).
+ */
+q16_t fixpt_recip_q16(q16_t x);
+
+/* ── Benchmark ──────────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Time every table function against its float/libm counterpart and
+ *         report per-call cost and worst-case error (log on target, stdout
+ *         on host).
+ * @return false if a function exceeds the error bound quoted above.
+ */
+bool fixpt_bench_run(void);
@@ -0,0 +1,180 @@
+/*
+ * Frame pacer implementation.
+ *
+ * All timing is done in esp_timer microseconds.  The FreeRTOS tick is
+ * 1 ms, so the remaining time to a deadline is rounded to the nearest tick
+ * and the residual error shows up in the jitter histogram.
+ */
+
+#include "frame_pacer.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+#define TAG "frame_pacer"
+
+#define DEFAULT_FPS        30
+#define FPS_WINDOW_US      1000000LL
+
+typedef struct {
+    frame_pacer_cfg_t   cfg;
+    frame_pacer_stats_t stats;
+    int64_t  deadline_us;      /* Absolute time the current frame period ends */
+    int64_t  window_start_us;  /* Start of the achieved-FPS window */
+    uint32_t window_frames;
+    uint16_t unchanged;        /* Consecutive frames reported as unchanged */
+    bool     anchored;
+} pacer_slot_t;
+
+static pacer_slot_t s_slot[FRAME_PACER_MAX_SCREENS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint32_t JITTER_LIMIT_US[FRAME_PACER_JITTER_BUCKETS - 1] = {
+    250, 500, 1000, 2000, 4000
+};
+static const uint16_t FPS_LIMIT[FRAME_PACER_FPS_BUCKETS - 1] = {
+    5, 10, 15, 20, 30, 45, 55
+};
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static uint16_t target_fps(const pacer_slot_t *s) {
+    return s->cfg.target_fps ? s->cfg.target_fps : DEFAULT_FPS;
+}
+
+static void record_jitter(pacer_slot_t *s, int64_t err_us) {
+    uint32_t j = (uint32_t)(err_us < 0 ? -err_us : err_us);
+    int b = 0;
+    while (b < FRAME_PACER_JITTER_BUCKETS - 1 && j >= JITTER_LIMIT_US[b]) b++;
+    s->stats.jitter_hist[b]++;
+    if (j > s->stats.jitter_max_us) s->stats.jitter_max_us = j;
+}
+
+static void record_frame(pacer_slot_t *s, int64_t now) {
+    s->stats.frames++;
+    s->window_frames++;
+
+    int64_t elapsed = now - s->window_start_us;
+    if (elapsed >= FPS_WINDOW_US) {
+        uint16_t fps = (uint16_t)((s->window_frames * 1000000LL + elapsed / 2) / elapsed);
+        int b = 0;
+        while (b < FRAME_PACER_FPS_BUCKETS - 1 && fps >= FPS_LIMIT[b]) b++;
+        s->stats.fps_hist[b]++;
+        s->stats.achieved_fps = fps;
+        s->window_start_us = now;
+        s->window_frames = 0;
+    }
+}
+
+/* Adaptive rate: halve after half a second of unchanged frames */
+static void adapt(pacer_slot_t *s, bool changed) {
+    uint16_t target = target_fps(s);
+
+    if (changed || s->cfg.idle_fps == 0) {
+        s->unchanged = 0;
+        s->stats.current_fps = target;
+        return;
+    }
+
+    if (++s->unchanged >= s->stats.current_fps / 2 + 1 &&
+        s->stats.current_fps > s->cfg.idle_fps) {
+        uint16_t next = s->stats.current_fps / 2;
+        s->stats.current_fps = (next < s->cfg.idle_fps) ? s->cfg.idle_fps : next;
+        s->unchanged = 0;
+    }
+}
+
+/* ── Public API ──────────────────────────────────────────────────────────── */
+void frame_pacer_configure(uint8_t screen, const frame_pacer_cfg_t *cfg) {
+    if (screen >= FRAME_PACER_MAX_SCREENS || !cfg) return;
+    pacer_slot_t *s = &s_slot[screen];
+    s->cfg = *cfg;
+    s->stats.current_fps = target_fps(s);
+    s->anchored = false;
+}
+
+void frame_pacer_begin(uint8_t screen) {
+    if (screen >= FRAME_PACER_MAX_SCREENS) return;
+    pacer_slot_t *s = &s_slot[screen];
+    int64_t now = esp_timer_get_time();
+
+    s->stats.current_fps = target_fps(s);
+    s->unchanged = 0;
+    s->deadline_us = now;
+    s->window_start_us = now;
+    s->window_frames = 0;
+    s->anchored = true;
+}
+
+void frame_pacer_wait(uint8_t screen, bool changed) {
+    if (screen >= FRAME_PACER_MAX_SCREENS) {
+        vTaskDelay(pdMS_TO_TICKS(1000 / DEFAULT_FPS));
+        return;
+    }
+    pacer_slot_t *s = &s_slot[screen];
+
+    if (!s->anchored) frame_pacer_begin(screen);
+
+    portENTER_CRITICAL(&s_lock);
+    adapt(s, changed);
+    int64_t period = 1000000LL / s->stats.current_fps;
+    int64_t now = esp_timer_get_time();
+
+    s->deadline_us += period;
+    if (now > s->deadline_us) {
+        /* Overran: drop whole periods instead of bursting to catch up.
+         * The schedule is re-anchored after the minimum sleep below. */
+        s->stats.late++;
+        s->stats.skipped += (uint32_t)((now - s->deadline_us) / period);
+    }
+    record_frame(s, now);
+    int64_t deadline = s->deadline_us;
+    portEXIT_CRITICAL(&s_lock);
+
+    /* Always block for at least one tick so lower-priority tasks
+     * (LED animation, idle) are never starved by an overrunning screen. */
+    int64_t remaining = deadline - now;
+    int64_t tick_us = 1000LL * portTICK_PERIOD_MS;
+    TickType_t ticks = remaining > 0 ? (TickType_t)((remaining + tick_us / 2) / tick_us) : 0;
+    vTaskDelay(ticks > 0 ? ticks : 1);
+
+    int64_t woke = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    if (remaining > 0) {
+        record_jitter(s, woke - deadline);
+    } else {
+        /* Late frame: the deadline moved to the wake-up time */
+        s->deadline_us = woke;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool frame_pacer_get_stats(uint8_t screen, frame_pacer_stats_t *out) {
+    if (screen >= FRAME_PACER_MAX_SCREENS || !out) return false;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_slot[screen].stats;
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+void frame_pacer_reset_stats(uint8_t screen) {
+    if (screen >= FRAME_PACER_MAX_SCREENS) return;
+    pacer_slot_t *s = &s_slot[screen];
+    portENTER_CRITICAL(&s_lock);
+    uint16_t fps = s->stats.current_fps;
+    memset(&s->stats, 0, sizeof(s->stats));
+    s->stats.current_fps = fps;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void frame_pacer_log_stats(uint8_t screen) {
+    frame_pacer_stats_t st;
+    if (!frame_pacer_get_stats(screen, &st) || st.frames == 0) return;
+
+    ESP_LOGI(TAG, "screen %u: %lu frames, target %u fps, achieved %u fps, "
+                  "%lu late, %lu skipped, jitter max %lu us",
+             screen, (unsigned long)st.frames, target_fps(&s_slot[screen]),
+             st.achieved_fps, (unsigned long)st.late, (unsigned long)st.skipped,
+             (unsigned long)st.jitter_max_us);
+}
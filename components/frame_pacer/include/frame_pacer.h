@@ -0,0 +1,84 @@
+/*
+ * Frame pacer – deadline-based frame timing for the display task.
+ *
+ * Each screen is identified by a small integer slot (main.c uses the
+ * app_state_t value).  Instead of "draw, then vTaskDelay(n)", the display
+ * task calls frame_pacer_wait() after drawing a frame; the pacer sleeps
+ * until the next absolute deadline, so the frame period no longer drifts
+ * with draw time.
+ *
+ *   - Deadlines are kept in esp_timer microseconds; frames that overrun by
+ *     one or more whole periods are counted as skipped and the schedule is
+ *     re-anchored instead of trying to catch up.
+ *   - Adaptive mode: when a screen reports "nothing changed" for half a
+ *     second, its rate is halved step by step down to idle_fps.  The first
+ *     changed frame restores target_fps.
+ *   - Per-screen statistics (jitter and achieved-FPS histograms, skipped
+ *     frames) can be queried at any time with frame_pacer_get_stats().
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of screen slots tracked by the pacer */
+#define FRAME_PACER_MAX_SCREENS    32
+
+/* Wake-up jitter histogram: <250 µs, <500 µs, <1 ms, <2 ms, <4 ms, ≥4 ms */
+#define FRAME_PACER_JITTER_BUCKETS 6
+
+/* Achieved-FPS histogram (per 1 s window): <5, <10, <15, <20, <30, <45, <55, ≥55 */
+#define FRAME_PACER_FPS_BUCKETS    8
+
+typedef struct {
+    uint16_t target_fps;   /* Nominal frame rate (0 = slot unused, 30 FPS fallback) */
+    uint16_t idle_fps;     /* Adaptive floor when nothing changes (0 = never adapt) */
+} frame_pacer_cfg_t;
+
+typedef struct {
+    uint32_t frames;                                  /* Frames paced */
+    uint32_t skipped;                                 /* Whole periods lost to overruns */
+    uint32_t late;                                    /* Frames that finished past their deadline */
+    uint32_t jitter_max_us;                           /* Worst wake-up error */
+    uint32_t jitter_hist[FRAME_PACER_JITTER_BUCKETS];
+    uint32_t fps_hist[FRAME_PACER_FPS_BUCKETS];
+    uint16_t current_fps;                             /* Effective rate after adaptation */
+    uint16_t achieved_fps;                            /* Measured over the last full second */
+} frame_pacer_stats_t;
+
+/**
+ * @brief  Set the frame rate policy for a screen slot.
+ */
+void frame_pacer_configure(uint8_t screen, const frame_pacer_cfg_t *cfg);
+
+/**
+ * @brief  Re-anchor the schedule for @p screen (call when the screen is
+ *         entered so time spent elsewhere is not counted as skipped frames).
+ */
+void frame_pacer_begin(uint8_t screen);
+
+/**
+ * @brief  Sleep until the next frame deadline of @p screen.
+ *
+ * @param  screen   Screen slot
+ * @param  changed  false if the frame just drawn was identical to the
+ *                  previous one (drives adaptive rate reduction)
+ */
+void frame_pacer_wait(uint8_t screen, bool changed);
+
+/**
+ * @brief  Copy the statistics for @p screen.
+ * @return false if @p screen is out of range.
+ */
+bool frame_pacer_get_stats(uint8_t screen, frame_pacer_stats_t *out);
+
+/**
+ * @brief  Clear the statistics for @p screen.
+ */
+void frame_pacer_reset_stats(uint8_t screen);
+
+/**
+ * @brief  Print a one-line summary of @p screen's statistics to the log.
+ */
+void frame_pacer_log_stats(uint8_t screen);
@@ -1,5 +1,6 @@
 #include "archanoid.h"
 #include "st7789.h"
+#include "game_rng.h"
 #include "badge_settings.h"
 #include <stdlib.h>
 #include <string.h>
@@ -180,7 +181,7 @@ void archanoid_update(bool move_left, bool move_right, bool launch) {
         /* Angle based on hit position */
         int16_t hit = (g_arc.ball_x + BALL_SIZE / 2) - (g_arc.paddle_x + PADDLE_WIDTH / 2);
         g_arc.ball_dx = hit / 4;
-        if (g_arc.ball_dx == 0) g_arc.ball_dx = (rand() & 1) ? 1 : -1;
+        if (g_arc.ball_dx == 0) g_arc.ball_dx = (game_rand() & 1) ? 1 : -1;
         /* Keep speed bounded */
         if (g_arc.ball_dx >  BALL_SPEED) g_arc.ball_dx =  BALL_SPEED;
         if (g_arc.ball_dx < -BALL_SPEED) g_arc.ball_dx = -BALL_SPEED;
@@ -296,7 +297,7 @@ void archanoid_draw(void) {
         char buf[32];
         /* Score */
         st7789_fill_rect(0, 2, 120, 16, bg);
-        snprintf(buf, sizeof(buf), "SCORE %lu", g_arc.score);
+        snprintf(buf, sizeof(buf), "SCORE %lu", (unsigned long)g_arc.score);
         st7789_draw_string(4, 2, buf, COLOR_TEXT, bg, 1);
 
         /* Lives */
@@ -318,7 +319,7 @@ void archanoid_draw(void) {
                                "GAME OVER", COLOR_TEXT, bg, 2);
         }
         char buf[32];
-        snprintf(buf, sizeof(buf), "Score: %lu", g_arc.score);
+        snprintf(buf, sizeof(buf), "Score: %lu", (unsigned long)g_arc.score);
         st7789_draw_string(SCREEN_WIDTH / 2 - 40, SCREEN_HEIGHT / 2 + 10,
                            buf, COLOR_TEXT, bg, 1);
         st7789_draw_string(SCREEN_WIDTH / 2 - 48, SCREEN_HEIGHT / 2 + 30,
@@ -0,0 +1,110 @@
+#include "game_replay.h"
+#include <inttypes.h>
+#include <string.h>
+
+#define LINE_LEN  96
+
+static void begin(game_replay_t *r, FILE *f, bool writing, const char *game,
+                  uint32_t seed, uint16_t fps) {
+    memset(r, 0, sizeof(*r));
+    r->f = f;
+    r->writing = writing;
+    snprintf(r->game, sizeof(r->game), "%s", game);
+    r->seed = seed;
+    r->fps = fps ? fps : 60;
+}
+
+void game_replay_live(game_replay_t *r, const char *game, uint32_t seed, uint16_t fps) {
+    begin(r, NULL, false, game, seed, fps);
+}
+
+void game_replay_record(game_replay_t *r, FILE *f, const char *game, uint32_t seed, uint16_t fps) {
+    begin(r, f, true, game, seed, fps);
+    fprintf(f, "# badge replay v1\n");
+    fprintf(f, "game,%s,seed,0x%08" PRIx32 ",fps,%u\n", r->game, seed, r->fps);
+    fprintf(f, "frame,t_ms,button,event,state\n");
+}
+
+/* Read up to the next event or end line; false at end of file */
+static bool read_next(game_replay_t *r) {
+    char line[LINE_LEN];
+    r->have_next = false;
+
+    while (fgets(line, sizeof(line), r->f)) {
+        uint32_t frame, t_ms, score;
+        unsigned button, state;
+
+        if (sscanf(line, "end,%" SCNu32 ",score,%" SCNu32, &frame, &score) == 2) {
+            r->has_end = true;
+            r->end_frames = frame;
+            r->end_score = score;
+            return false;
+        }
+        if (sscanf(line, "%" SCNu32 ",%" SCNu32 ",%u,%*[a-z],0x%x",
+                   &frame, &t_ms, &button, &state) == 4) {
+            r->have_next = true;
+            r->next_frame = frame;
+            r->next_state = (uint16_t)state;
+            return true;
+        }
+        /* Anything else is log output around the trace */
+    }
+    return false;
+}
+
+bool game_replay_open(game_replay_t *r, FILE *f) {
+    char line[LINE_LEN];
+
+    while (fgets(line, sizeof(line), f)) {
+        char     game[GAME_REPLAY_NAME_LEN];
+        uint32_t seed;
+        unsigned fps;
+        if (sscanf(line, "game,%15[^,],seed,0x%" SCNx32 ",fps,%u", game, &seed, &fps) == 3) {
+            begin(r, f, false, game, seed, (uint16_t)fps);
+            read_next(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t game_replay_step(game_replay_t *r, uint16_t live) {
+    if (r->f && !r->writing) {
+        /* Several buttons may change on the same frame: keep the last state */
+        while (r->have_next && r->next_frame <= r->frame) {
+            r->state = r->next_state;
+            read_next(r);
+        }
+    } else {
+        uint16_t changed = r->state ^ live;
+        if (r->f && changed) {
+            uint32_t t_ms = game_replay_time_ms(r);
+            uint16_t state = r->state;
+            for (unsigned b = 0; b < 16; b++) {
+                uint16_t bit = (uint16_t)(1u << b);
+                if (!(changed & bit)) continue;
+                state ^= bit;
+                fprintf(r->f, "%" PRIu32 ",%" PRIu32 ",%u,%s,0x%04x\n", r->frame, t_ms, b,
+                        (state & bit) ? "pressed" : "released", state);
+            }
+        }
+        r->state = live;
+    }
+    r->frame++;
+    return r->state;
+}
+
+bool game_replay_done(const game_replay_t *r) {
+    if (!r->f || r->writing || r->have_next) return false;
+    return !r->has_end || r->frame >= r->end_frames;
+}
+
+void game_replay_finish(game_replay_t *r, uint32_t score) {
+    if (!r->f || !r->writing) return;
+    fprintf(r->f, "end,%" PRIu32 ",score,%" PRIu32 "\n", r->frame, score);
+    fflush(r->f);
+}
+
+uint32_t game_replay_time_ms(const game_replay_t *r) {
+    return (uint32_t)((uint64_t)r->frame * 1000u / r->fps);
+}
@@ -0,0 +1,17 @@
+#include "game_rng.h"
+
+static uint32_t s_state = 0x2545F491u;
+
+void game_rng_seed(uint32_t seed) {
+    s_state = seed ? seed : 0x2545F491u;
+}
+
+int game_rand(void) {
+    /* xorshift32 (Marsaglia) */
+    uint32_t x = s_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_state = x;
+    return (int)(x >> 1);
+}
@@ -1,14 +1,12 @@
 #include "hacky_bird.h"
 #include "st7789.h"
-#include "buttons.h"
+#include "game_rng.h"
 #include "badge_settings.h"
 #include "sk6812.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "led_comp.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 
 // Display dimensions
 #define SCREEN_WIDTH 320
@@ -57,7 +55,7 @@ static void game_init(void) {
     // Initialize pipes
     for (int i = 0; i < 3; i++) {
         g_game.pipes[i][0] = SCREEN_WIDTH + i * PIPE_SPACING;
-        g_game.pipes[i][1] = 40 + (rand() % 60);  // Random gap position
+        g_game.pipes[i][1] = 40 + (game_rand() % 60);  // Random gap position
     }
 }
 
@@ -140,17 +138,16 @@ void hacky_bird_update(bool flap_pressed) {
                 g_game.score++;
                 g_game.last_scored_pipe = i;
                 
-                // LED bar effect on gate pass - flash green
+                // LED bar effect on gate pass - flash green (perceptual level)
                 sk6812_color_t green = {0, 255, 0};
-                sk6812_fill(sk6812_scale(green, 60));
-                sk6812_show();
+                led_comp_flash(sk6812_scale(green, 132), 150);
             }
         }
 
         // Respawn pipe when it goes off screen
         if (g_game.pipes[i][0] + PIPE_WIDTH < 0) {
             g_game.pipes[i][0] = SCREEN_WIDTH;
-            g_game.pipes[i][1] = 40 + (rand() % 60);
+            g_game.pipes[i][1] = 40 + (game_rand() % 60);
             // Reset last scored when pipe respawns
             if (i == g_game.last_scored_pipe) {
                 g_game.last_scored_pipe = 999;
@@ -162,10 +159,10 @@ void hacky_bird_update(bool flap_pressed) {
     if (check_collision()) {
         g_game.active = false;
         
-        // Flash red LEDs on death
+        // Red LEDs on death (app layer, released when the game exits)
         sk6812_color_t red = {255, 0, 0};
-        sk6812_fill(sk6812_scale(red, 60));
-        sk6812_show();
+        led_comp_fill(LED_LAYER_APP, LED_COMP_ALL, sk6812_scale(red, 132),
+                      LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
     }
 
     g_game.frame_count++;
@@ -0,0 +1,669 @@
+/*
+ * Headless host build of the games: deterministic replay and frame cost.
+ *
+ * The six games are compiled unchanged against an in-memory framebuffer
+ * that stands in for the ST7789, and stepped exactly as display_task does
+ * (same button mapping, same game-over handling, snake on the session
+ * clock).  Each fixture plays a game from a fixed seed while recording the
+ * session with game_replay; the trace is then replayed from the file.
+ * Hacky Bird, Space Shooter, Snake and Pong are played by bots that watch
+ * the last frame drawn, as a person would, so the sessions score and cover
+ * real gameplay; Archanoid and Race Condition get random presses.  Checked
+ * per fixture:
+ *
+ *   - the replay ends on the same frame, with the same score and the same
+ *     framebuffer hash as the recorded run,
+ *   - frames, score and hash match the golden values below, so a change
+ *     that alters gameplay is caught ("the game still plays the same").
+ *
+ * Update + draw time per frame is reported as a repeatable benchmark (host
+ * CPU, so only useful relative to earlier runs).  After an intended
+ * gameplay change, `-u` prints a fresh golden table.
+ *
+ * Traces recorded on the badge (file or serial capture) can be given on
+ * the command line: each is replayed and its end line (frames, score)
+ * compared with the headless run.
+ *
+ * Build and run (from the repo root): `make game_replay_check`
+ *   game_replay_check [-o dir] [-u] [trace.csv ...]
+ */
+
+#include "game_replay.h"
+#include "game_rng.h"
+#include "st7789.h"
+#include "font8x16.h"
+#include "led_comp.h"
+#include "badge_settings.h"
+#include "hacky_bird.h"
+#include "space_shooter.h"
+#include "snake.h"
+#include "pong.h"
+#include "archanoid.h"
+#include "race_condition.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIXTURE_FRAMES  3600    /* One minute at 60 FPS */
+#define HASH_EVERY      30      /* Frames between framebuffer hashes */
+#define FPS             60      /* s_frame_policy for the game screens */
+
+/* Button bits (btn_id_t in buttons.h) */
+#define UP      (1u << 0)
+#define DOWN    (1u << 1)
+#define LEFT    (1u << 2)
+#define RIGHT   (1u << 3)
+#define STICK   (1u << 4)
+#define BTN_A   (1u << 5)
+
+/* ── Display and LED stand-ins ──────────────────────────────────────────── */
+static uint16_t s_fb[ST7789_WIDTH * ST7789_HEIGHT];
+
+void st7789_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t colour) {
+    for (uint32_t yy = y; yy < (uint32_t)y + h && yy < ST7789_HEIGHT; yy++) {
+        for (uint32_t xx = x; xx < (uint32_t)x + w && xx < ST7789_WIDTH; xx++) {
+            s_fb[yy * ST7789_WIDTH + xx] = colour;
+        }
+    }
+}
+
+void st7789_fill(uint16_t colour) {
+    st7789_fill_rect(0, 0, ST7789_WIDTH, ST7789_HEIGHT, colour);
+}
+
+void st7789_draw_string(uint16_t x, uint16_t y, const char *s, uint16_t fg, uint16_t bg, uint8_t scale) {
+    if (scale < 1) scale = 1;
+    for (; *s; s++, x += 8 * scale) {
+        uint8_t c = (uint8_t)*s;
+        const uint8_t *glyph = font8x16_data[(c >= 0x20 && c < 0x7F ? c : '?') - 0x20];
+        for (int row = 0; row < 16; row++) {
+            for (int col = 0; col < 8; col++) {
+                uint16_t colour = (glyph[row] & (0x80 >> col)) ? fg : bg;
+                st7789_fill_rect(x + col * scale, y + row * scale, scale, scale, colour);
+            }
+        }
+    }
+}
+
+void st7789_draw_buffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *buf) {
+    for (uint32_t row = 0; row < h && y + row < ST7789_HEIGHT; row++) {
+        for (uint32_t col = 0; col < w && x + col < ST7789_WIDTH; col++) {
+            s_fb[(y + row) * ST7789_WIDTH + x + col] = buf[row * w + col];
+        }
+    }
+}
+
+void led_comp_flash(sk6812_color_t color, uint32_t ms) { (void)color; (void)ms; }
+
+void led_comp_fill(led_layer_t layer, uint16_t mask, sk6812_color_t color,
+                   led_blend_t blend, uint8_t alpha, uint32_t ttl_ms) {
+    (void)layer; (void)mask; (void)color; (void)blend; (void)alpha; (void)ttl_ms;
+}
+
+sk6812_color_t sk6812_scale(sk6812_color_t c, uint8_t brightness) {
+    return (sk6812_color_t){ (uint8_t)(c.r * brightness / 255),
+                             (uint8_t)(c.g * brightness / 255),
+                             (uint8_t)(c.b * brightness / 255) };
+}
+
+uint16_t settings_get_accent_color(void) { return 0x07FF; }
+uint16_t settings_get_text_color(void)   { return 0xFFFF; }
+
+static uint64_t fb_hash(uint64_t h) {
+    /* FNV-1a over the framebuffer */
+    for (size_t i = 0; i < sizeof(s_fb) / sizeof(s_fb[0]); i++) {
+        h = (h ^ s_fb[i]) * 0x100000001B3ULL;
+    }
+    return h;
+}
+
+/* ── Games, stepped as display_task steps them ──────────────────────────── */
+static uint32_t s_snake_last_ms;
+
+static void init_hacky(void) { hacky_bird_init(); }
+static bool step_hacky(uint16_t in, uint32_t t_ms) {
+    (void)t_ms;
+    hacky_bird_update(in & (BTN_A | STICK));
+    if (!hacky_bird_is_active()) return false;
+    hacky_bird_draw();
+    return true;
+}
+static uint32_t score_hacky(void) { return hacky_bird_get_score(); }
+
+static void init_shooter(void) { space_shooter_init(); }
+static bool step_shooter(uint16_t in, uint32_t t_ms) {
+    (void)t_ms;
+    space_shooter_update(in & (LEFT | STICK), in & RIGHT, in & BTN_A);
+    space_shooter_draw();
+    return true;
+}
+
+static void init_snake(void) { s_snake_last_ms = 0; snake_init(); }
+static bool step_snake(uint16_t in, uint32_t t_ms) {
+    if (t_ms - s_snake_last_ms < snake_get_speed_delay()) return true;
+    if (in & UP)         snake_set_direction(SNAKE_DIR_UP);
+    else if (in & DOWN)  snake_set_direction(SNAKE_DIR_DOWN);
+    else if (in & LEFT)  snake_set_direction(SNAKE_DIR_LEFT);
+    else if (in & RIGHT) snake_set_direction(SNAKE_DIR_RIGHT);
+    snake_update();
+    snake_draw();
+    s_snake_last_ms = t_ms;
+    return true;
+}
+
+static void init_pong(void) { pong_init(); }
+static bool step_pong(uint16_t in, uint32_t t_ms) {
+    (void)t_ms;
+    pong_update(in & UP, in & DOWN);
+    bool active = pong_is_active();
+    pong_draw();
+    return active;
+}
+
+static void init_arc(void) { archanoid_init(); }
+static bool step_arc(uint16_t in, uint32_t t_ms) {
+    (void)t_ms;
+    archanoid_update(in & LEFT, in & RIGHT, in & (BTN_A | STICK));
+    bool active = archanoid_is_active();
+    archanoid_draw();
+    return active;
+}
+
+static void init_race(void) { race_condition_init(); }
+static bool step_race(uint16_t in, uint32_t t_ms) {
+    (void)t_ms;
+    race_condition_update(in & LEFT, in & RIGHT, in & (BTN_A | STICK));
+    bool active = race_condition_is_active();
+    race_condition_draw();
+    return active;
+}
+
+typedef struct bot bot_t;
+typedef struct game game_t;
+
+/* Watching players, defined below */
+static uint16_t play_hacky(bot_t *b, uint32_t frame);
+static uint16_t play_shooter(bot_t *b, uint32_t frame);
+static uint16_t play_snake(bot_t *b, uint32_t frame);
+static uint16_t play_pong(bot_t *b, uint32_t frame);
+
+struct game {
+    const char *name;           /* Name in the trace (main.c uses the same) */
+    void      (*init)(void);
+    bool      (*step)(uint16_t in, uint32_t t_ms);  /* false: game over */
+    uint32_t  (*score)(void);
+    uint16_t    bot_buttons;    /* Buttons the scripted player uses */
+    uint8_t     bot_hold;       /* Longest press, frames */
+    uint8_t     bot_gap;        /* Shortest gap between presses, frames */
+    uint16_t  (*player)(bot_t *b, uint32_t frame);  /* NULL: random presses */
+};
+
+static const game_t s_games[] = {
+    { "hacky_bird",     init_hacky,   step_hacky,   score_hacky,              0,                        0,  0,
+      play_hacky },
+    { "space_shooter",  init_shooter, step_shooter, space_shooter_get_score,  0,                        0,  0,
+      play_shooter },
+    { "snake",          init_snake,   step_snake,   snake_get_score,          0,                        0,  0,
+      play_snake },
+    { "pong",           init_pong,    step_pong,    pong_get_score,           0,                        0,  0,
+      play_pong },
+    { "archanoid",      init_arc,     step_arc,     archanoid_get_score,      LEFT | RIGHT | BTN_A,     30,  3 },
+    { "race_condition", init_race,    step_race,    race_condition_get_score, LEFT | RIGHT | BTN_A,     30,  3 },
+};
+#define NUM_GAMES (sizeof(s_games) / sizeof(s_games[0]))
+
+/* Golden results: frames, score and framebuffer hash per fixture */
+typedef struct {
+    const char *name;
+    uint32_t    seed;
+    uint32_t    frames;
+    uint32_t    score;
+    uint64_t    hash;
+} golden_t;
+
+static const golden_t s_golden[] = {
+    { "hacky_bird",     0x00C0FFEE,   697,   28, 0x03BC66DE67E050E8ULL },
+    { "space_shooter",  0x00C0FFEE,  3600,  650, 0xB3A6F4458064BE50ULL },
+    { "snake",          0x00C0FFEE,  3600,  450, 0x110127F4537BD09DULL },
+    { "pong",           0x00C0FFEE,  2871,    7, 0xC7D63764E2670039ULL },
+    { "archanoid",      0x00C0FFEE,   766, 1410, 0x27E467A05DC5D9DCULL },
+    { "race_condition", 0x00C0FFEE,   553, 1527, 0xF5649FE09D00ADBAULL },
+};
+
+/* ── Scripted players ───────────────────────────────────────────────────── */
+struct bot {
+    uint32_t rng;
+    uint16_t mask;
+    uint32_t until;             /* Frame the current mask is held to */
+    int      last_x, last_y;    /* Bird (Hacky) or ball (Pong) last frame */
+};
+
+static uint16_t px(int x, int y) {
+    return s_fb[y * ST7789_WIDTH + x];
+}
+
+/* Hacky Bird: flap when the bird falls past a point a little below the
+ * next gap's centre (a flap lifts it well above where it was) */
+#define HB_BIRD_X       60
+#define HB_BIRD         0xFFE0
+#define HB_PIPE         0x07E0
+#define HB_PIPE_W       30
+
+static uint16_t play_hacky(bot_t *b, uint32_t frame) {
+    (void)frame;
+    int y = -1;
+    for (int r = 0; r < ST7789_HEIGHT; r++) {
+        if (px(HB_BIRD_X, r) == HB_BIRD) { y = r + 4; break; }
+    }
+    if (y < 0) return 0;
+
+    /* Nearest pipe not yet passed: first green column from the bird's tail */
+    int target = ST7789_HEIGHT / 2;
+    for (int x = HB_BIRD_X - 4 - HB_PIPE_W + 1; x < ST7789_WIDTH; x++) {
+        if (x < 0 || px(x, ST7789_HEIGHT - 1) != HB_PIPE) continue;
+        int top = 0, bottom = ST7789_HEIGHT - 1;
+        while (top < ST7789_HEIGHT && px(x, top) == HB_PIPE) top++;
+        while (bottom > top && px(x, bottom) == HB_PIPE) bottom--;
+        target = (top + bottom) / 2 + 24;
+        break;
+    }
+
+    bool falling = y >= b->last_y;
+    b->last_y = y;
+    return (y > target && falling) ? BTN_A : 0;
+}
+
+/* Space Shooter: get out from under a rock too low to shoot, else stand
+ * under the lowest rock that can still be reached and fire on every other
+ * frame (the game fires on the press) */
+#define SS_SHIP_Y       145
+#define SS_SHIP         0x07FF
+#define SS_ROCK         0xF800
+#define SS_SPEED        6       /* Ship, px per frame */
+#define SS_FALL         3       /* Rocks, px per frame */
+#define SS_MAX_ROCKS    8
+
+typedef struct {
+    int lo, hi;                 /* Columns */
+    int bottom;                 /* Lowest row */
+} rock_t;
+
+static int find_rocks(rock_t *rocks) {
+    int n = 0;
+    for (int y = SS_SHIP_Y + 20; y >= 16; y--) {
+        for (int x = 0; x < ST7789_WIDTH; x++) {
+            if (px(x, y) != SS_ROCK) continue;
+            int end = x;
+            while (end + 1 < ST7789_WIDTH && px(end + 1, y) == SS_ROCK) end++;
+            bool known = false;
+            for (int i = 0; i < n; i++) known |= x <= rocks[i].hi && end >= rocks[i].lo;
+            if (!known && n < SS_MAX_ROCKS) rocks[n++] = (rock_t){ x, end, y };
+            x = end;
+        }
+    }
+    return n;
+}
+
+static uint16_t play_shooter(bot_t *b, uint32_t frame) {
+    (void)b;
+    int lo = -1, hi = -1;
+    for (int x = 0; x < ST7789_WIDTH; x++) {
+        if (px(x, SS_SHIP_Y) != SS_SHIP) continue;
+        if (lo < 0) lo = x;
+        hi = x;
+    }
+    if (lo < 0) return 0;
+    int ship = (lo + hi) / 2;
+
+    rock_t rocks[SS_MAX_ROCKS];
+    int n = find_rocks(rocks);          /* Lowest first */
+    uint16_t fire = (frame & 1) ? BTN_A : 0;
+
+    /* A low rock over the hull that the gun (centre column) misses */
+    for (int i = 0; i < n; i++) {
+        const rock_t *r = &rocks[i];
+        bool over_hull = r->lo <= hi + SS_SPEED && r->hi >= lo - SS_SPEED;
+        bool in_line   = r->lo <= ship && r->hi >= ship;
+        if (r->bottom < SS_SHIP_Y - 50 || !over_hull || in_line) continue;
+        bool go_left = (r->lo + r->hi) / 2 > ship;
+        if (go_left && lo - SS_SPEED < 0) go_left = false;
+        if (!go_left && hi + SS_SPEED >= ST7789_WIDTH) go_left = true;
+        return fire | (go_left ? LEFT : RIGHT);
+    }
+
+    /* Lowest rock the gun can get under before it lands */
+    for (int i = 0; i < n; i++) {
+        const rock_t *r = &rocks[i];
+        int target = (r->lo + r->hi) / 2;
+        if (target < SS_SPEED) target = SS_SPEED;
+        if (target > ST7789_WIDTH - SS_SPEED) target = ST7789_WIDTH - SS_SPEED;
+        int frames = abs(target - ship) / SS_SPEED + 2;
+        if (r->bottom + frames * SS_FALL >= SS_SHIP_Y - 12) continue;
+        if (target < ship - 2) return fire | LEFT;
+        if (target > ship + 2) return fire | RIGHT;
+        return fire;
+    }
+    return fire;
+}
+
+/* Snake: head for the food by the shortest move that leaves room to turn
+ * (the neck is body, so reversing is never picked) */
+#define SN_CELL         10
+#define SN_W            (ST7789_WIDTH / SN_CELL)
+#define SN_H            (ST7789_HEIGHT / SN_CELL)
+#define SN_BODY         0x07E0
+#define SN_HEAD         0x07FF
+#define SN_FOOD         0xF800
+
+static bool s_sn_blocked[SN_H][SN_W];
+
+static int sn_room(int x, int y) {
+    static bool seen[SN_H][SN_W];
+    static int  stack[SN_H * SN_W][2];
+    memset(seen, 0, sizeof(seen));
+    int n = 0, area = 0;
+    stack[n][0] = x; stack[n][1] = y; n++;
+    seen[y][x] = true;
+    while (n) {
+        n--;
+        int cx = stack[n][0], cy = stack[n][1];
+        area++;
+        static const int d[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+        for (int i = 0; i < 4; i++) {
+            int nx = cx + d[i][0], ny = cy + d[i][1];
+            if (nx < 0 || ny < 0 || nx >= SN_W || ny >= SN_H) continue;
+            if (seen[ny][nx] || s_sn_blocked[ny][nx]) continue;
+            seen[ny][nx] = true;
+            stack[n][0] = nx; stack[n][1] = ny; n++;
+        }
+    }
+    return area;
+}
+
+static uint16_t play_snake(bot_t *b, uint32_t frame) {
+    (void)frame;
+    int hx = -1, hy = -1, fx = -1, fy = -1, len = 0;
+    for (int y = 0; y < SN_H; y++) {
+        for (int x = 0; x < SN_W; x++) {
+            uint16_t c = px(x * SN_CELL + 4, y * SN_CELL + 4);
+            s_sn_blocked[y][x] = c == SN_BODY || c == SN_HEAD;
+            if (c == SN_BODY || c == SN_HEAD) len++;
+            if (c == SN_HEAD) { hx = x; hy = y; }
+            if (c == SN_FOOD) { fx = x; fy = y; }
+        }
+    }
+    if (hx < 0) return b->mask;
+    if (fx < 0) { fx = SN_W / 2; fy = SN_H / 2; }
+
+    static const struct { int dx, dy; uint16_t btn; } moves[4] = {
+        { 0, -1, UP }, { 0, 1, DOWN }, { -1, 0, LEFT }, { 1, 0, RIGHT },
+    };
+    int best = -1, best_room = 0, best_dist = 0;
+    for (int i = 0; i < 4; i++) {
+        int nx = hx + moves[i].dx, ny = hy + moves[i].dy;
+        if (nx < 0 || ny < 0 || nx >= SN_W || ny >= SN_H || s_sn_blocked[ny][nx]) continue;
+        int room = sn_room(nx, ny);
+        if (room > len + 4) room = len + 4;                   /* Enough is enough */
+        int dist = abs(nx - fx) + abs(ny - fy);
+        if (best < 0 || room > best_room || (room == best_room && dist < best_dist)) {
+            best = i; best_room = room; best_dist = dist;
+        }
+    }
+    if (best >= 0) b->mask = moves[best].btn;
+    return b->mask;
+}
+
+/* Pong: predict where the ball reaches the paddle and meet it with the
+ * paddle's outermost rows, so it leaves at 4 px/frame and outruns the
+ * 3 px/frame AI paddle; centre the paddle while the ball is away */
+#define PG_PADDLE_X     10
+#define PG_PADDLE_W     4
+#define PG_PADDLE_H     30
+#define PG_PADDLE       0x07FF
+#define PG_BALL         0xFFFF
+#define PG_BALL_SIZE    4
+#define PG_BALL_DX      3
+#define PG_SPEED        4
+#define PG_MAX_Y        (ST7789_HEIGHT - PG_PADDLE_H)
+
+static bool pg_reachable(int top, int want, int steps) {
+    if (want < 0 || want > PG_MAX_Y) return false;
+    int d = want - top;
+    if (want == 0 && top - PG_SPEED * steps <= 0) return true;
+    if (want == PG_MAX_Y && top + PG_SPEED * steps >= PG_MAX_Y) return true;
+    return d % PG_SPEED == 0 && abs(d) <= PG_SPEED * steps;
+}
+
+/* The score digits share the ball's colour; the ball is the only solid
+ * 4x4 block of it with nothing of that colour directly around it */
+static bool pg_is_ball(int x, int y) {
+    for (int i = -1; i <= PG_BALL_SIZE; i++) {
+        for (int j = -1; j <= PG_BALL_SIZE; j++) {
+            int cx = x + i, cy = y + j;
+            if (cx < 0 || cy < 0 || cx >= ST7789_WIDTH || cy >= ST7789_HEIGHT) continue;
+            bool inside = i >= 0 && j >= 0 && i < PG_BALL_SIZE && j < PG_BALL_SIZE;
+            if ((px(cx, cy) == PG_BALL) != inside) return false;
+        }
+    }
+    return true;
+}
+
+static uint16_t play_pong(bot_t *b, uint32_t frame) {
+    (void)frame;
+    int top = -1;
+    for (int y = 0; y < ST7789_HEIGHT; y++) {
+        if (px(PG_PADDLE_X, y) == PG_PADDLE) { top = y; break; }
+    }
+    int bx = -1, by = -1;
+    for (int y = 0; y < ST7789_HEIGHT && bx < 0; y++) {
+        for (int x = 0; x < ST7789_WIDTH; x++) {
+            if (pg_is_ball(x, y)) { bx = x; by = y; break; }
+        }
+    }
+    if (top < 0 || bx < 0) return 0;
+
+    int dx = bx - b->last_x, dy = by - b->last_y;
+    b->last_x = bx;
+    b->last_y = by;
+
+    int want = PG_MAX_Y / 2;
+    if (dx < 0) {
+        /* Same wall bounce as step_pong, up to the frame the ball enters
+         * the paddle's columns */
+        int x = bx, y = by, steps = 0;
+        while (x > PG_PADDLE_X + PG_PADDLE_W) {
+            x -= PG_BALL_DX;
+            y += dy;
+            if (y <= 0) { y = 0; dy = -dy; }
+            if (y >= ST7789_HEIGHT - PG_BALL_SIZE) {
+                y = ST7789_HEIGHT - PG_BALL_SIZE;
+                dy = -dy;
+            }
+            steps++;
+        }
+        /* hit_pos / 4 reaches +-4 only on the two outermost rows and +-3
+         * on the four next to them; the paddle only stops every 4 px */
+        const int edges[] = { y + 3, y + 4, y - 29, y - 30,
+                              y + 2, y + 1, y,     y - 1,
+                              y - 28, y - 27, y - 26, y - 25 };
+        want = y - PG_PADDLE_H / 2 + PG_BALL_SIZE / 2;
+        for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+            if (pg_reachable(top, edges[i], steps)) { want = edges[i]; break; }
+        }
+    }
+    if (want < top && (top - want >= PG_SPEED || want == 0)) return UP;
+    if (want > top && (want - top >= PG_SPEED || want == PG_MAX_Y)) return DOWN;
+    return 0;
+}
+
+/* Random button sets held 1..bot_hold frames, bot_gap..bot_gap+7 frames apart */
+static uint16_t bot_input(bot_t *b, const game_t *g, uint32_t frame) {
+    if (g->player) return g->player(b, frame);
+    if (frame >= b->until) {
+        b->rng ^= b->rng << 13;
+        b->rng ^= b->rng >> 17;
+        b->rng ^= b->rng << 5;
+        if (b->mask) {
+            b->mask  = 0;
+            b->until = frame + g->bot_gap + (b->rng >> 16) % 8;
+        } else {
+            b->mask  = (uint16_t)(b->rng & g->bot_buttons);
+            if (!b->mask) b->mask = g->bot_buttons & -g->bot_buttons;
+            b->until = frame + 1 + (b->rng >> 16) % g->bot_hold;
+        }
+    }
+    return b->mask;
+}
+
+/* ── Sessions ───────────────────────────────────────────────────────────── */
+typedef struct {
+    uint32_t frames;
+    uint32_t score;
+    uint64_t hash;
+    double   avg_us;
+    double   max_us;
+} result_t;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Play until game over, the end of a replay or @p max_frames (0 = none) */
+static result_t play(const game_t *g, game_replay_t *rp, bot_t *bot, uint32_t max_frames) {
+    result_t res = { .hash = 0xCBF29CE484222325ULL };
+    double total = 0;
+
+    memset(s_fb, 0, sizeof(s_fb));
+    game_rng_seed(rp->seed);
+    g->init();
+
+    while (!game_replay_done(rp) && (max_frames == 0 || rp->frame < max_frames)) {
+        uint16_t live = bot ? bot_input(bot, g, rp->frame) : 0;
+        double t0 = now_us();
+        uint16_t in = game_replay_step(rp, live);
+        bool running = g->step(in, game_replay_time_ms(rp));
+        double dt = now_us() - t0;
+
+        total += dt;
+        if (dt > res.max_us) res.max_us = dt;
+        if (rp->frame % HASH_EVERY == 0) res.hash = fb_hash(res.hash);
+        if (!running) break;
+    }
+    res.frames = rp->frame;
+    res.score  = g->score();
+    res.hash   = fb_hash(res.hash);
+    res.avg_us = res.frames ? total / res.frames : 0;
+    return res;
+}
+
+static const game_t *find_game(const char *name) {
+    for (size_t i = 0; i < NUM_GAMES; i++) {
+        if (strcmp(s_games[i].name, name) == 0) return &s_games[i];
+    }
+    return NULL;
+}
+
+static bool run_fixture(const golden_t *gold, const char *dir, bool update) {
+    const game_t *g = find_game(gold->name);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.csv", dir, g->name);
+
+    /* Recorded run, driven by the bot */
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return false; }
+    game_replay_t rp;
+    game_replay_record(&rp, f, g->name, gold->seed, FPS);
+    bot_t bot = { .rng = gold->seed ^ 0x9E3779B9u };
+    result_t rec = play(g, &rp, &bot, FIXTURE_FRAMES);
+    game_replay_finish(&rp, rec.score);
+    fclose(f);
+
+    /* Replay of the trace file */
+    f = fopen(path, "r");
+    if (!f || !game_replay_open(&rp, f)) {
+        printf("  %-15s cannot read back %s\n", g->name, path);
+        if (f) fclose(f);
+        return false;
+    }
+    result_t rep = play(g, &rp, NULL, 0);
+    fclose(f);
+
+    if (update) {
+        char name[24];
+        snprintf(name, sizeof(name), "\"%s\",", g->name);
+        printf("    { %-17s 0x%08X, %5u, %4u, 0x%016llXULL },\n",
+               name, gold->seed, rec.frames, rec.score, (unsigned long long)rec.hash);
+    }
+
+    bool same   = rep.frames == rec.frames && rep.score == rec.score && rep.hash == rec.hash;
+    bool golden = rec.frames == gold->frames && rec.score == gold->score && rec.hash == gold->hash;
+    printf("  %-15s %5u frames  score %4u  %7.1f us/frame (max %7.1f)  replay %s  golden %s\n",
+           g->name, rec.frames, rec.score, rec.avg_us, rec.max_us,
+           same ? "ok" : "DIVERGED", golden ? "ok" : "CHANGED");
+    return same && (golden || update);
+}
+
+/* Replay a trace recorded on the badge and compare with its end line */
+static bool run_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return false; }
+    game_replay_t rp;
+    if (!game_replay_open(&rp, f)) {
+        printf("  %s: no replay header\n", path);
+        fclose(f);
+        return false;
+    }
+    const game_t *g = find_game(rp.game);
+    if (!g) {
+        printf("  %s: unknown game '%s'\n", path, rp.game);
+        fclose(f);
+        return false;
+    }
+    result_t res = play(g, &rp, NULL, 0);
+    bool has_end = rp.has_end;
+    bool ok = has_end && res.frames == rp.end_frames && res.score == rp.end_score;
+    printf("  %s (%s, seed 0x%08X): %u frames, score %u", path, g->name, rp.seed,
+           res.frames, res.score);
+    if (has_end) {
+        printf("; badge %u frames, score %u: %s\n", rp.end_frames, rp.end_score,
+               ok ? "same" : "DIVERGED");
+    } else {
+        printf("; trace has no end line\n");
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = ".";
+    bool update = false;
+    int  first_trace = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0) {
+            update = true;
+        } else {
+            first_trace = i;
+            break;
+        }
+    }
+
+    bool ok = true;
+    if (first_trace < argc) {
+        printf("Replaying badge traces:\n");
+        for (int i = first_trace; i < argc; i++) ok &= run_trace(argv[i]);
+    } else {
+        printf("Headless games, %d frames max, traces in %s:\n", FIXTURE_FRAMES, dir);
+        for (size_t i = 0; i < sizeof(s_golden) / sizeof(s_golden[0]); i++) {
+            ok &= run_fixture(&s_golden[i], dir, update);
+        }
+    }
+    printf(ok ? "All fixtures passed\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,4 @@
+/* Host shim: st7789.h only needs the host name (headless game build only) */
+#pragma once
+
+#define SPI2_HOST 1
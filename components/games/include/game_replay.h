@@ -0,0 +1,93 @@
+#ifndef GAME_REPLAY_H
+#define GAME_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * Game input record / replay.
+ *
+ * Games are stepped once per frame and take their randomness from
+ * game_rng, so a session is reproduced exactly by its seed and the button
+ * mask the game saw on every frame.  Only changes are stored, one line per
+ * press or release, tagged with the frame it was first seen on and the
+ * session time:
+ *
+ *   # badge replay v1
+ *   game,snake,seed,0x1a2b3c4d,fps,60
+ *   frame,t_ms,button,event,state
+ *   42,700,2,pressed,0x0004
+ *   ...
+ *   end,1834,score,12
+ *
+ * The text goes to a file on the FAT partition or to the serial console.
+ * The reader skips any line that is not part of the trace, so a serial log
+ * with other output around the trace replays as is.
+ *
+ * A session without a file (live play) still counts frames, which is the
+ * game clock: game_replay_time_ms() advances by one frame period per step.
+ *
+ * Pure C and stdio; shared by the firmware and the headless host build of
+ * the games (`make game_replay_check`).
+ */
+
+#define GAME_REPLAY_NAME_LEN  16
+
+typedef struct {
+    FILE    *f;                 /* NULL = live, nothing stored */
+    bool     writing;
+    char     game[GAME_REPLAY_NAME_LEN];
+    uint32_t seed;
+    uint16_t fps;
+    uint32_t frame;             /* Frames stepped */
+    uint16_t state;             /* Button mask of the last frame */
+    /* Reader look-ahead */
+    bool     have_next;
+    uint32_t next_frame;
+    uint16_t next_state;
+    bool     has_end;           /* The end line has been read */
+    uint32_t end_frames;
+    uint32_t end_score;
+} game_replay_t;
+
+/**
+ * @brief Start a live session that stores nothing
+ */
+void game_replay_live(game_replay_t *r, const char *game, uint32_t seed, uint16_t fps);
+
+/**
+ * @brief Start recording to @p f (header written immediately)
+ */
+void game_replay_record(game_replay_t *r, FILE *f, const char *game, uint32_t seed, uint16_t fps);
+
+/**
+ * @brief Read the header of a trace from @p f
+ * @return false if no trace header was found
+ */
+bool game_replay_open(game_replay_t *r, FILE *f);
+
+/**
+ * @brief Advance one frame
+ * @param live  Buttons currently pressed (ignored while replaying)
+ * @return The mask the game must see on this frame
+ */
+uint16_t game_replay_step(game_replay_t *r, uint16_t live);
+
+/**
+ * @brief True once a replay has reached the end of its trace
+ */
+bool game_replay_done(const game_replay_t *r);
+
+/**
+ * @brief Write the end line of a recording (frames and @p score) and flush.
+ *        The caller closes the file.
+ */
+void game_replay_finish(game_replay_t *r, uint32_t score);
+
+/**
+ * @brief Session time of the current frame (frames × frame period)
+ */
+uint32_t game_replay_time_ms(const game_replay_t *r);
+
+#endif // GAME_REPLAY_H
@@ -0,0 +1,27 @@
+#ifndef GAME_RNG_H
+#define GAME_RNG_H
+
+#include <stdint.h>
+
+/*
+ * Deterministic random numbers for the games.
+ *
+ * One xorshift32 generator replaces rand(): it is private to the games
+ * (nothing else in the firmware advances it) and is seeded when a game
+ * starts, so the seed and the per-frame input reproduce a session exactly
+ * on the badge and in the host build.
+ */
+
+#define GAME_RAND_MAX  0x7FFFFFFF
+
+/**
+ * @brief Seed the generator (0 is replaced by a fixed non-zero seed)
+ */
+void game_rng_seed(uint32_t seed);
+
+/**
+ * @brief Next number in 0 .. GAME_RAND_MAX (drop-in for rand())
+ */
+int game_rand(void);
+
+#endif // GAME_RNG_H
@@ -4,7 +4,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Off-screen frame buffer, allocated by init and freed by deinit */
+#define RACE_CONDITION_FB_BYTES  (320 * 170 * 2)
+
 void race_condition_init(void);
+void race_condition_deinit(void);
 void race_condition_update(bool steer_left, bool steer_right, bool accelerate);
 void race_condition_draw(void);
 bool race_condition_is_active(void);
@@ -1,5 +1,6 @@
 #include "pong.h"
 #include "st7789.h"
+#include "game_rng.h"
 #include "badge_settings.h"
 #include <stdlib.h>
 #include <string.h>
@@ -51,9 +52,9 @@ static pong_state_t g_pong;
 static void reset_ball(void) {
     g_pong.ball_x  = SCREEN_WIDTH / 2;
     g_pong.ball_y  = SCREEN_HEIGHT / 2;
-    g_pong.ball_dx = (rand() & 1) ? BALL_INIT_DX : -BALL_INIT_DX;
-    g_pong.ball_dy = (rand() % 3) - 1;  /* -1, 0, or 1 */
-    if (g_pong.ball_dy == 0) g_pong.ball_dy = (rand() & 1) ? 1 : -1;
+    g_pong.ball_dx = (game_rand() & 1) ? BALL_INIT_DX : -BALL_INIT_DX;
+    g_pong.ball_dy = (game_rand() % 3) - 1;  /* -1, 0, or 1 */
+    if (g_pong.ball_dy == 0) g_pong.ball_dy = (game_rand() & 1) ? 1 : -1;
 }
 
 void pong_init(void) {
@@ -122,7 +123,7 @@ void pong_update(bool player_up, bool player_down) {
         /* Add spin based on paddle hit position */
         int16_t hit_pos = (g_pong.ball_y + BALL_SIZE / 2) - (g_pong.player_y + PADDLE_HEIGHT / 2);
         g_pong.ball_dy  = hit_pos / 4;
-        if (g_pong.ball_dy == 0) g_pong.ball_dy = (rand() & 1) ? 1 : -1;
+        if (g_pong.ball_dy == 0) g_pong.ball_dy = (game_rand() & 1) ? 1 : -1;
         g_pong.ball_x = PADDLE_MARGIN + PADDLE_WIDTH + 1;
     }
 
@@ -135,7 +136,7 @@ void pong_update(bool player_up, bool player_down) {
         g_pong.ball_dx = -g_pong.ball_dx;
         int16_t hit_pos = (g_pong.ball_y + BALL_SIZE / 2) - (g_pong.ai_y + PADDLE_HEIGHT / 2);
         g_pong.ball_dy  = hit_pos / 4;
-        if (g_pong.ball_dy == 0) g_pong.ball_dy = (rand() & 1) ? 1 : -1;
+        if (g_pong.ball_dy == 0) g_pong.ball_dy = (game_rand() & 1) ? 1 : -1;
         g_pong.ball_x = SCREEN_WIDTH - PADDLE_MARGIN - PADDLE_WIDTH - BALL_SIZE - 1;
     }
 
@@ -228,12 +229,12 @@ void pong_draw(void) {
         g_pong.ai_score != g_pong.prev_ai_score) {
         char buf[16];
         /* Player score (left of centre) */
-        snprintf(buf, sizeof(buf), "%lu", g_pong.player_score);
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)g_pong.player_score);
         st7789_fill_rect(SCREEN_WIDTH / 2 - 40, 4, 24, 16, bg);
         st7789_draw_string(SCREEN_WIDTH / 2 - 40, 4, buf, txt, bg, 2);
 
         /* AI score (right of centre) */
-        snprintf(buf, sizeof(buf), "%lu", g_pong.ai_score);
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)g_pong.ai_score);
         st7789_fill_rect(SCREEN_WIDTH / 2 + 20, 4, 24, 16, bg);
         st7789_draw_string(SCREEN_WIDTH / 2 + 20, 4, buf, txt, bg, 2);
 
@@ -19,13 +19,12 @@
 
 #include "race_condition.h"
 #include "st7789.h"
+#include "game_rng.h"
 #include "font8x16.h"
 #include "sk6812.h"
-#include "buttons.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include "esp_random.h"
 #include "esp_log.h"
 
 static const char *TAG = "race";
@@ -142,7 +141,7 @@ typedef struct {
 static game_state_t g_game;
 
 /* ── Double-buffer frame buffer ─────────────────────────────────────── */
-/* 320 × 170 × 2 bytes ≈ 106 KB – allocated once on first init.        */
+/* 320 × 170 × 2 bytes ≈ 106 KB – allocated on init, freed on deinit. */
 /* Pixels are stored in big-endian (wire) byte order so that the buffer */
 /* can be blitted directly via SPI without per-pixel conversion.        */
 
@@ -216,7 +215,6 @@ static void fb_flush(void) {
 
 /* ── Helpers ─────────────────────────────────────────────────────────── */
 
-/* Simple pseudo-random using stdlib rand() seeded by distance */
 static uint16_t car_colors[] = {
     C64_RED, C64_YELLOW, C64_CYAN, C64_WHITE,
     C64_LIGHT_GREEN, C64_ORANGE, C64_LIGHT_RED, C64_PURPLE
@@ -234,7 +232,7 @@ static uint32_t compute_lap_length(void) {
 
 /* ── Initialise ──────────────────────────────────────────────────────── */
 void race_condition_init(void) {
-    /* Allocate frame buffer once (persists across replays) */
+    /* Allocate frame buffer (kept across restarts until deinit) */
     if (!fb) {
         fb = malloc(FB_PIXELS * sizeof(uint16_t));
         if (!fb) {
@@ -244,7 +242,6 @@ void race_condition_init(void) {
     }
 
     memset(&g_game, 0, sizeof(g_game));
-    srand((unsigned)esp_random());
     g_game.lap          = 1;
     g_game.seg_index    = 0;
     g_game.seg_remain   = RACE_CONDITION_TRACK[0].length;
@@ -257,6 +254,12 @@ void race_condition_init(void) {
     }
 }
 
+/* Free the frame buffer; the next init allocates it again */
+void race_condition_deinit(void) {
+    free(fb);
+    fb = NULL;
+}
+
 /* ── Update ──────────────────────────────────────────────────────────── */
 void race_condition_update(bool steer_left, bool steer_right, bool accelerate) {
     if (g_game.game_over) return;
@@ -320,8 +323,8 @@ void race_condition_update(bool steer_left, bool steer_right, bool accelerate) {
             if (!g_game.cars[i].active) {
                 g_game.cars[i].active = true;
                 g_game.cars[i].dist   = 500;  /* ahead of player */
-                g_game.cars[i].lane   = (rand() % 120) - 60;
-                g_game.cars[i].color  = car_colors[rand() % NUM_CAR_COLORS];
+                g_game.cars[i].lane   = (game_rand() % 120) - 60;
+                g_game.cars[i].color  = car_colors[game_rand() % NUM_CAR_COLORS];
                 break;
             }
         }
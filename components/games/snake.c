@@ -1,6 +1,6 @@
 #include "snake.h"
 #include "st7789.h"
-#include "buttons.h"
+#include "game_rng.h"
 #include "sk6812.h"
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +43,11 @@ typedef struct {
     uint32_t speed_delay;
     bool game_over;
     bool ate_food_this_frame;  // Flag for LED effect
+    // Incremental drawing (reset with the game, so every game starts the same)
+    bool drawn;
+    bool has_old_tail;
+    point_t old_tail;
+    point_t old_food;
 } game_state_t;
 
 static game_state_t g_game;
@@ -56,8 +61,8 @@ static void draw_cell(int16_t x, int16_t y, uint16_t color) {
 static void spawn_food(void) {
     bool valid = false;
     while (!valid) {
-        g_game.food.x = rand() % GRID_WIDTH;
-        g_game.food.y = rand() % GRID_HEIGHT;
+        g_game.food.x = game_rand() % GRID_WIDTH;
+        g_game.food.y = game_rand() % GRID_HEIGHT;
         
         // Check if food is on snake
         valid = true;
@@ -177,27 +182,21 @@ void snake_update(void) {
 
 // Draw game (optimized to reduce flickering)
 void snake_draw(void) {
-    static bool first_draw = true;
-    
     // On first draw, clear entire screen
-    if (first_draw) {
+    if (!g_game.drawn) {
         st7789_fill(COLOR_BG);
-        first_draw = false;
+        g_game.drawn = true;
     }
     
     // Only redraw changed cells to avoid flickering
-    static point_t old_tail;
-    static point_t old_food;
-    static bool has_old_tail = false;
-    
     // Erase old tail position (only if snake didn't grow)
-    if (has_old_tail && !g_game.ate_food_this_frame) {
-        draw_cell(old_tail.x, old_tail.y, COLOR_BG);
+    if (g_game.has_old_tail && !g_game.ate_food_this_frame) {
+        draw_cell(g_game.old_tail.x, g_game.old_tail.y, COLOR_BG);
     }
     
     // Erase old food position if it was eaten
     if (g_game.ate_food_this_frame) {
-        draw_cell(old_food.x, old_food.y, COLOR_BG);
+        draw_cell(g_game.old_food.x, g_game.old_food.y, COLOR_BG);
     }
     
     // Draw snake body (second-to-last segment in green)
@@ -212,9 +211,9 @@ void snake_draw(void) {
     draw_cell(g_game.food.x, g_game.food.y, COLOR_FOOD);
     
     // Save positions for next frame
-    old_tail = g_game.snake[g_game.length - 1];
-    old_food = g_game.food;
-    has_old_tail = true;
+    g_game.old_tail = g_game.snake[g_game.length - 1];
+    g_game.old_food = g_game.food;
+    g_game.has_old_tail = true;
     
     // Only redraw score when it changes
     if (g_game.score != g_game.last_score) {
@@ -223,7 +222,7 @@ void snake_draw(void) {
         
         // Draw new score
         char score_str[32];
-        snprintf(score_str, sizeof(score_str), "Score: %lu", g_game.score);
+        snprintf(score_str, sizeof(score_str), "Score: %lu", (unsigned long)g_game.score);
         st7789_draw_string(5, 5, score_str, COLOR_TEXT, COLOR_BG, 1);
         
         g_game.last_score = g_game.score;
@@ -241,15 +240,13 @@ void snake_draw(void) {
         
         // Draw score
         char score_str[32];
-        snprintf(score_str, sizeof(score_str), "Score: %lu", g_game.score);
+        snprintf(score_str, sizeof(score_str), "Score: %lu", (unsigned long)g_game.score);
         st7789_draw_string(5, 5, score_str, COLOR_TEXT, COLOR_BG, 1);
         
         st7789_draw_string(SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT/2 - 20, 
                           "GAME OVER", COLOR_TEXT, COLOR_BG, 2);
         st7789_draw_string(SCREEN_WIDTH/2 - 48, SCREEN_HEIGHT/2 + 10,
                           "Press B to exit", COLOR_TEXT, COLOR_BG, 1);
-        
-        first_draw = true;  // Reset for next game
     }
 }
 
@@ -1,6 +1,6 @@
 #include "space_shooter.h"
 #include "st7789.h"
-#include "buttons.h"
+#include "game_rng.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -48,6 +48,8 @@ typedef struct {
     asteroid_t asteroids[MAX_ASTEROIDS];
     bool game_over;
     uint32_t last_spawn_time;
+    bool last_shoot;        // Fire on the press, not while held
+    uint32_t frame_count;   // Drives asteroid spawning
 } game_state_t;
 
 static game_state_t g_game;
@@ -114,8 +116,7 @@ void space_shooter_update(bool move_left, bool move_right, bool shoot) {
     }
     
     // Shoot bullet
-    static bool last_shoot = false;
-    if (shoot && !last_shoot) {
+    if (shoot && !g_game.last_shoot) {
         // Find inactive bullet slot
         for (int i = 0; i < MAX_BULLETS; i++) {
             if (!g_game.bullets[i].active) {
@@ -126,7 +127,7 @@ void space_shooter_update(bool move_left, bool move_right, bool shoot) {
             }
         }
     }
-    last_shoot = shoot;
+    g_game.last_shoot = shoot;
     
     // Update bullets
     for (int i = 0; i < MAX_BULLETS; i++) {
@@ -139,14 +140,13 @@ void space_shooter_update(bool move_left, bool move_right, bool shoot) {
     }
     
     // Spawn new asteroids
-    static uint32_t frame_count = 0;
-    frame_count++;
-    if (frame_count % 40 == 0) {  // Spawn every ~0.67 seconds at 60 FPS
+    g_game.frame_count++;
+    if (g_game.frame_count % 40 == 0) {  // Spawn every ~0.67 seconds at 60 FPS
         for (int i = 0; i < MAX_ASTEROIDS; i++) {
             if (!g_game.asteroids[i].active) {
-                g_game.asteroids[i].x = rand() % (SCREEN_WIDTH - ASTEROID_SIZE) + ASTEROID_SIZE/2;
+                g_game.asteroids[i].x = game_rand() % (SCREEN_WIDTH - ASTEROID_SIZE) + ASTEROID_SIZE/2;
                 g_game.asteroids[i].y = -ASTEROID_SIZE;
-                g_game.asteroids[i].size = ASTEROID_SIZE + (rand() % 8) - 4;  // Size variation
+                g_game.asteroids[i].size = ASTEROID_SIZE + (game_rand() % 8) - 4;  // Size variation
                 g_game.asteroids[i].active = true;
                 break;
             }
@@ -223,7 +223,7 @@ void space_shooter_draw(void) {
     
     // Draw score
     char score_str[32];
-    snprintf(score_str, sizeof(score_str), "Score: %lu", g_game.score);
+    snprintf(score_str, sizeof(score_str), "Score: %lu", (unsigned long)g_game.score);
     st7789_draw_string(5, 5, score_str, COLOR_TEXT, COLOR_SPACE, 1);
     
     // Draw game over
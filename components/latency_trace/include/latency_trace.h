@@ -0,0 +1,138 @@
+/*
+ * Latency trace – input-to-photon latency per app.
+ *
+ * Tracepoints along the path of a button press go into a lock-free ring:
+ *
+ *   EDGE      first sample at the new level (button scan timer)
+ *   DEBOUNCE  press confirmed and queued (button scan timer)
+ *   DISPATCH  input_task takes the event off the queue
+ *   UPDATE    the first frame that can see the press begins (display task)
+ *   FLUSH     that frame's last SPI transfer has completed (display task)
+ *
+ * Writers claim a slot with one atomic increment and publish it by storing
+ * its sequence number last, so the scan timer, input_task and the display
+ * task never wait on each other.  The display task is the only consumer:
+ * at each frame boundary it follows the new entries, keeps one open sample
+ * per button and closes it when a frame that began after the press has
+ * been sent to the panel.  st7789 transfers are blocking (polling SPI), so
+ * the end of the draw is the end of the last transfer.
+ *
+ * Closed samples go into per-app statistics (main.c uses the app_state_t
+ * value as the slot, as with frame_pacer): a histogram of edge-to-flush
+ * latency and the average / worst time spent in each stage.  A press that
+ * no frame shows within LATENCY_TRACE_TIMEOUT_US is counted as expired.
+ * Only presses are traced.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LATENCY_TRACE_MAX_APPS    32
+#define LATENCY_TRACE_RING        512       /* Tracepoints kept (power of two) */
+#define LATENCY_TRACE_BUTTONS     16        /* Open samples, one per button id */
+#define LATENCY_TRACE_TIMEOUT_US  1000000   /* Unshown presses expire after this */
+
+/* Edge-to-flush histogram: <10, <17, <25, <33, <50, <67, <100, ≥100 ms */
+#define LATENCY_TRACE_BUCKETS     8
+
+typedef enum {
+    LATENCY_TRACE_EDGE = 0,
+    LATENCY_TRACE_DEBOUNCE,
+    LATENCY_TRACE_DISPATCH,
+    LATENCY_TRACE_UPDATE,
+    LATENCY_TRACE_FLUSH,
+    LATENCY_TRACE_STAGES
+} latency_trace_stage_t;
+
+/* Time spent between consecutive stages, indexed by the later stage - 1 */
+#define LATENCY_TRACE_SPANS       (LATENCY_TRACE_STAGES - 1)
+
+#define LATENCY_TRACE_NO_APP      0xFF      /* App not known at the tracepoint */
+
+typedef struct {
+    uint32_t samples;                               /* Presses shown */
+    uint32_t hist[LATENCY_TRACE_BUCKETS];
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t last_us;
+    uint64_t sum_us;
+    uint64_t span_sum_us[LATENCY_TRACE_SPANS];      /* Per stage, when traced */
+    uint32_t span_max_us[LATENCY_TRACE_SPANS];
+    uint32_t span_n[LATENCY_TRACE_SPANS];
+} latency_trace_stats_t;
+
+/* ── Tracepoints (any task) ─────────────────────────────────────────────── */
+
+/**
+ * @brief  A press of @p button was confirmed at @p debounced_us; its first
+ *         stable sample was at @p edge_us (esp_timer microseconds).
+ */
+void latency_trace_press(uint8_t button, int64_t edge_us, int64_t debounced_us);
+
+/**
+ * @brief  input_task has taken the press of @p button off its queue while
+ *         @p app was running.
+ */
+void latency_trace_dispatch(uint8_t button, uint8_t app);
+
+/* ── Frame boundaries (display task only) ───────────────────────────────── */
+
+/**
+ * @brief  A frame of @p app begins: every press seen so far will be in it.
+ *
+ * Call before the app reads its input, and again when an event-driven
+ * screen wakes up to redraw.
+ */
+void latency_trace_frame_begin(uint8_t app);
+
+/**
+ * @brief  The frame of @p app has been sent to the panel: close the
+ *         samples it showed.
+ */
+void latency_trace_frame_end(uint8_t app);
+
+/* ── Reports ────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Copy the statistics for @p app.
+ * @return false if @p app is out of range.
+ */
+bool latency_trace_get_stats(uint8_t app, latency_trace_stats_t *out);
+
+/**
+ * @brief  Latency below which @p pct percent of @p st's samples fall,
+ *         rounded up to a histogram bucket edge (0 if there are none,
+ *         UINT32_MAX in the open top bucket).
+ */
+uint32_t latency_trace_percentile_us(const latency_trace_stats_t *st, unsigned pct);
+
+/**
+ * @brief  Clear the statistics of every app and the expired count.
+ */
+void latency_trace_reset(void);
+
+/**
+ * @brief  Presses no frame showed, and tracepoints overwritten before the
+ *         display task read them.
+ */
+void latency_trace_get_losses(uint32_t *expired, uint32_t *lost);
+
+/**
+ * @brief  Short text for an on-screen overlay: the last and 95th
+ *         percentile latency of @p app, e.g. "23ms p95 33".
+ */
+void latency_trace_format_overlay(uint8_t app, char *buf, size_t len);
+
+/**
+ * @brief  Log a one-line summary of @p app's statistics.
+ */
+void latency_trace_log_stats(uint8_t app);
+
+/**
+ * @brief  Print the per-app statistics and every tracepoint still in the
+ *         ring to stdout as CSV, for analysis on a host.
+ */
+void latency_trace_dump_csv(void);
@@ -0,0 +1,363 @@
+/*
+ * Latency trace implementation.
+ *
+ * Ring slots are seqlocks: a writer zeroes the slot's sequence number,
+ * fills it in and then stores index + 1; a reader copies the slot and
+ * accepts it only if the sequence number was index + 1 both before and
+ * after the copy.  Times are the low 32 bits of esp_timer, so every
+ * difference below is taken in unsigned arithmetic and survives the wrap.
+ *
+ * The open samples belong to the display task (the only caller of the
+ * frame functions) and need no lock; s_lock only guards the statistics
+ * that other tasks read.
+ */
+
+#include "latency_trace.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "latency"
+
+_Static_assert((LATENCY_TRACE_RING & (LATENCY_TRACE_RING - 1)) == 0,
+               "ring size must be a power of two");
+
+typedef struct {
+    atomic_uint seq;            /* Index + 1 once published, 0 while written */
+    uint32_t    t_us;
+    uint8_t     stage;
+    uint8_t     button;
+    uint8_t     app;
+} trace_slot_t;
+
+typedef struct {
+    uint32_t t_us;
+    uint8_t  stage;
+    uint8_t  button;
+    uint8_t  app;
+} trace_entry_t;
+
+/* A press waiting for the frame that shows it */
+typedef struct {
+    bool     open;
+    uint8_t  have;                          /* Bit per stage traced */
+    uint32_t t[LATENCY_TRACE_STAGES];
+} pending_t;
+
+static trace_slot_t s_ring[LATENCY_TRACE_RING];
+static atomic_uint  s_head;                 /* Next index to claim */
+static uint32_t     s_tail;                 /* Next index the display task reads */
+static pending_t    s_pending[LATENCY_TRACE_BUTTONS];
+
+static latency_trace_stats_t s_stats[LATENCY_TRACE_MAX_APPS];
+static uint32_t     s_expired;
+static uint32_t     s_lost;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint16_t LIMIT_MS[LATENCY_TRACE_BUCKETS - 1] = {
+    10, 17, 25, 33, 50, 67, 100
+};
+
+static const char *const STAGE_NAME[LATENCY_TRACE_STAGES] = {
+    "edge", "debounce", "dispatch", "update", "flush"
+};
+
+/* Span names, by the stage that ends the span */
+static const char *const SPAN_NAME[LATENCY_TRACE_SPANS] = {
+    "debounce", "queue", "wait", "render"
+};
+
+#define BIT(stage)  (1u << (stage))
+
+/* ── Ring ───────────────────────────────────────────────────────────────── */
+static void trace(uint8_t stage, uint8_t button, uint8_t app, uint32_t t_us) {
+    uint32_t i = atomic_fetch_add_explicit(&s_head, 1, memory_order_relaxed);
+    trace_slot_t *s = &s_ring[i & (LATENCY_TRACE_RING - 1)];
+
+    atomic_store_explicit(&s->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s->t_us   = t_us;
+    s->stage  = stage;
+    s->button = button;
+    s->app    = app;
+    atomic_store_explicit(&s->seq, i + 1, memory_order_release);
+}
+
+/*
+ * Copy entry @p i.  Returns 0 on success, < 0 if it is not published yet
+ * and > 0 if a later entry has already overwritten it.
+ */
+static int32_t read_entry(uint32_t i, trace_entry_t *out) {
+    const trace_slot_t *s = &s_ring[i & (LATENCY_TRACE_RING - 1)];
+    uint32_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (seq != i + 1) return seq ? (int32_t)(seq - (i + 1)) : -1;
+
+    out->t_us   = s->t_us;
+    out->stage  = s->stage;
+    out->button = s->button;
+    out->app    = s->app;
+
+    atomic_thread_fence(memory_order_acquire);
+    seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+    return (seq == i + 1) ? 0 : 1;
+}
+
+/* ── Consumer (display task) ────────────────────────────────────────────── */
+static void ingest(const trace_entry_t *e) {
+    if (e->button >= LATENCY_TRACE_BUTTONS) return;
+    pending_t *p = &s_pending[e->button];
+
+    switch (e->stage) {
+    case LATENCY_TRACE_EDGE:
+        if (p->open) {
+            /* Pressed again before any frame showed the last press */
+            portENTER_CRITICAL(&s_lock);
+            s_expired++;
+            portEXIT_CRITICAL(&s_lock);
+        }
+        memset(p, 0, sizeof(*p));
+        p->open = true;
+        p->have = BIT(LATENCY_TRACE_EDGE);
+        p->t[LATENCY_TRACE_EDGE] = e->t_us;
+        break;
+    case LATENCY_TRACE_DEBOUNCE:
+    case LATENCY_TRACE_DISPATCH:
+        /* A dispatch after the frame began (polled games) is off the path */
+        if (!p->open || (p->have & (BIT(e->stage) | BIT(LATENCY_TRACE_UPDATE)))) break;
+        p->have |= BIT(e->stage);
+        p->t[e->stage] = e->t_us;
+        break;
+    default:
+        break;      /* Our own UPDATE / FLUSH entries */
+    }
+}
+
+/* Follow the ring up to the first entry that is still being written */
+static void drain(void) {
+    for (;;) {
+        uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+        if (s_tail == head) return;
+        if (head - s_tail > LATENCY_TRACE_RING) {
+            portENTER_CRITICAL(&s_lock);
+            s_lost += head - LATENCY_TRACE_RING - s_tail;
+            portEXIT_CRITICAL(&s_lock);
+            s_tail = head - LATENCY_TRACE_RING;
+        }
+
+        trace_entry_t e;
+        int32_t r = read_entry(s_tail, &e);
+        if (r < 0) return;          /* Writer mid-entry: next frame boundary */
+        if (r == 0) {
+            ingest(&e);
+        } else {
+            portENTER_CRITICAL(&s_lock);
+            s_lost++;
+            portEXIT_CRITICAL(&s_lock);
+        }
+        s_tail++;
+    }
+}
+
+static void record(uint8_t app, const pending_t *p) {
+    if (app >= LATENCY_TRACE_MAX_APPS) return;
+    latency_trace_stats_t *st = &s_stats[app];
+    uint32_t total = p->t[LATENCY_TRACE_FLUSH] - p->t[LATENCY_TRACE_EDGE];
+
+    int b = 0;
+    while (b < LATENCY_TRACE_BUCKETS - 1 && total >= LIMIT_MS[b] * 1000u) b++;
+
+    portENTER_CRITICAL(&s_lock);
+    if (st->samples == 0 || total < st->min_us) st->min_us = total;
+    if (total > st->max_us) st->max_us = total;
+    st->samples++;
+    st->hist[b]++;
+    st->last_us = total;
+    st->sum_us += total;
+
+    /* Each traced stage closes the span from the previous traced one */
+    int prev = LATENCY_TRACE_EDGE;
+    for (int s = LATENCY_TRACE_EDGE + 1; s < LATENCY_TRACE_STAGES; s++) {
+        if (!(p->have & BIT(s))) continue;
+        uint32_t d = p->t[s] - p->t[prev];
+        st->span_sum_us[s - 1] += d;
+        st->span_n[s - 1]++;
+        if (d > st->span_max_us[s - 1]) st->span_max_us[s - 1] = d;
+        prev = s;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/* ── Tracepoints ────────────────────────────────────────────────────────── */
+void latency_trace_press(uint8_t button, int64_t edge_us, int64_t debounced_us) {
+    trace(LATENCY_TRACE_EDGE, button, LATENCY_TRACE_NO_APP, (uint32_t)edge_us);
+    trace(LATENCY_TRACE_DEBOUNCE, button, LATENCY_TRACE_NO_APP, (uint32_t)debounced_us);
+}
+
+void latency_trace_dispatch(uint8_t button, uint8_t app) {
+    trace(LATENCY_TRACE_DISPATCH, button, app, (uint32_t)esp_timer_get_time());
+}
+
+/* ── Frame boundaries ───────────────────────────────────────────────────── */
+void latency_trace_frame_begin(uint8_t app) {
+    drain();
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    for (int b = 0; b < LATENCY_TRACE_BUTTONS; b++) {
+        pending_t *p = &s_pending[b];
+        if (!p->open) continue;
+        if (now - p->t[LATENCY_TRACE_EDGE] > LATENCY_TRACE_TIMEOUT_US) {
+            p->open = false;
+            portENTER_CRITICAL(&s_lock);
+            s_expired++;
+            portEXIT_CRITICAL(&s_lock);
+            continue;
+        }
+        /* Not visible to the app until it has been debounced */
+        if ((p->have & BIT(LATENCY_TRACE_DEBOUNCE)) && !(p->have & BIT(LATENCY_TRACE_UPDATE))) {
+            p->have |= BIT(LATENCY_TRACE_UPDATE);
+            p->t[LATENCY_TRACE_UPDATE] = now;
+            trace(LATENCY_TRACE_UPDATE, (uint8_t)b, app, now);
+        }
+    }
+}
+
+void latency_trace_frame_end(uint8_t app) {
+    drain();
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    for (int b = 0; b < LATENCY_TRACE_BUTTONS; b++) {
+        pending_t *p = &s_pending[b];
+        if (!p->open || !(p->have & BIT(LATENCY_TRACE_UPDATE))) continue;
+        p->have |= BIT(LATENCY_TRACE_FLUSH);
+        p->t[LATENCY_TRACE_FLUSH] = now;
+        trace(LATENCY_TRACE_FLUSH, (uint8_t)b, app, now);
+        record(app, p);
+        p->open = false;
+    }
+}
+
+/* ── Reports ────────────────────────────────────────────────────────────── */
+bool latency_trace_get_stats(uint8_t app, latency_trace_stats_t *out) {
+    if (app >= LATENCY_TRACE_MAX_APPS || !out) return false;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats[app];
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+uint32_t latency_trace_percentile_us(const latency_trace_stats_t *st, unsigned pct) {
+    if (st->samples == 0) return 0;
+    uint64_t want = ((uint64_t)st->samples * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (int b = 0; b < LATENCY_TRACE_BUCKETS - 1; b++) {
+        seen += st->hist[b];
+        if (seen >= want) return LIMIT_MS[b] * 1000u;
+    }
+    return UINT32_MAX;
+}
+
+void latency_trace_reset(void) {
+    portENTER_CRITICAL(&s_lock);
+    memset(s_stats, 0, sizeof(s_stats));
+    s_expired = 0;
+    s_lost = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void latency_trace_get_losses(uint32_t *expired, uint32_t *lost) {
+    portENTER_CRITICAL(&s_lock);
+    if (expired) *expired = s_expired;
+    if (lost) *lost = s_lost;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void latency_trace_format_overlay(uint8_t app, char *buf, size_t len) {
+    latency_trace_stats_t st;
+    if (!latency_trace_get_stats(app, &st) || st.samples == 0) {
+        snprintf(buf, len, "--ms");
+        return;
+    }
+    uint32_t p95 = latency_trace_percentile_us(&st, 95);
+    if (p95 == UINT32_MAX) {
+        snprintf(buf, len, "%lums p95 >%u", (unsigned long)(st.last_us / 1000),
+                 LIMIT_MS[LATENCY_TRACE_BUCKETS - 2]);
+    } else {
+        snprintf(buf, len, "%lums p95 %lu", (unsigned long)(st.last_us / 1000),
+                 (unsigned long)(p95 / 1000));
+    }
+}
+
+static uint32_t span_avg(const latency_trace_stats_t *st, int s) {
+    return st->span_n[s] ? (uint32_t)(st->span_sum_us[s] / st->span_n[s]) : 0;
+}
+
+void latency_trace_log_stats(uint8_t app) {
+    latency_trace_stats_t st;
+    if (!latency_trace_get_stats(app, &st) || st.samples == 0) return;
+
+    ESP_LOGI(TAG, "app %u: %lu presses, avg %lu us (%lu..%lu), p50 %lu ms, p95 %lu ms; "
+                  "%s %lu / %s %lu / %s %lu / %s %lu us",
+             app, (unsigned long)st.samples,
+             (unsigned long)(st.sum_us / st.samples),
+             (unsigned long)st.min_us, (unsigned long)st.max_us,
+             (unsigned long)(latency_trace_percentile_us(&st, 50) / 1000),
+             (unsigned long)(latency_trace_percentile_us(&st, 95) / 1000),
+             SPAN_NAME[0], (unsigned long)span_avg(&st, 0),
+             SPAN_NAME[1], (unsigned long)span_avg(&st, 1),
+             SPAN_NAME[2], (unsigned long)span_avg(&st, 2),
+             SPAN_NAME[3], (unsigned long)span_avg(&st, 3));
+}
+
+void latency_trace_dump_csv(void) {
+    uint32_t expired, lost;
+    latency_trace_get_losses(&expired, &lost);
+
+    /* Per-app summary; the p50/p95 columns are histogram bucket edges */
+    printf("# latency_trace stats (expired=%lu lost=%lu)\n",
+           (unsigned long)expired, (unsigned long)lost);
+    printf("app,samples,min_us,avg_us,max_us,p50_us,p95_us");
+    for (int s = 0; s < LATENCY_TRACE_SPANS; s++) {
+        printf(",%s_avg_us,%s_max_us", SPAN_NAME[s], SPAN_NAME[s]);
+    }
+    for (int b = 0; b < LATENCY_TRACE_BUCKETS - 1; b++) printf(",lt_%ums", LIMIT_MS[b]);
+    printf(",ge_%ums\n", LIMIT_MS[LATENCY_TRACE_BUCKETS - 2]);
+
+    for (uint8_t app = 0; app < LATENCY_TRACE_MAX_APPS; app++) {
+        latency_trace_stats_t st;
+        latency_trace_get_stats(app, &st);
+        if (st.samples == 0) continue;
+        printf("%u,%lu,%lu,%lu,%lu", app, (unsigned long)st.samples,
+               (unsigned long)st.min_us, (unsigned long)(st.sum_us / st.samples),
+               (unsigned long)st.max_us);
+        for (int k = 0; k < 2; k++) {
+            uint32_t p = latency_trace_percentile_us(&st, k ? 95 : 50);
+            if (p == UINT32_MAX) printf(",inf");
+            else printf(",%lu", (unsigned long)p);
+        }
+        for (int s = 0; s < LATENCY_TRACE_SPANS; s++) {
+            printf(",%lu,%lu", (unsigned long)span_avg(&st, s),
+                   (unsigned long)st.span_max_us[s]);
+        }
+        for (int b = 0; b < LATENCY_TRACE_BUCKETS; b++) {
+            printf(",%lu", (unsigned long)st.hist[b]);
+        }
+        printf("\n");
+    }
+
+    /* Raw tracepoints, oldest first; app 255 = not known at the tracepoint */
+    printf("# latency_trace tracepoints\n");
+    printf("index,t_us,stage,button,app\n");
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+    uint32_t i = (head > LATENCY_TRACE_RING) ? head - LATENCY_TRACE_RING : 0;
+    for (; i != head; i++) {
+        trace_entry_t e;
+        if (read_entry(i, &e) != 0) continue;
+        printf("%lu,%lu,%s,%u,%u\n", (unsigned long)i, (unsigned long)e.t_us,
+               e.stage < LATENCY_TRACE_STAGES ? STAGE_NAME[e.stage] : "?",
+               e.button, e.app);
+    }
+    printf("# end\n");
+}
@@ -0,0 +1,100 @@
+/*
+ * LED compositor – prioritised layers blended into one frame.
+ *
+ * Every producer of LED output writes into its own layer instead of the
+ * driver buffer; led_task is the single owner of the chain and, once per
+ * tick, blends the layers bottom to top and calls sk6812_show() only when
+ * the result differs from the last frame.
+ *
+ *   LED_LAYER_BASE    the user's LED mode (led_fx effect or VU meter)
+ *   LED_LAYER_APP     the foreground app (game indicators, Python, UI test)
+ *   LED_LAYER_NOTIFY  short flashes (score, hit, game over)
+ *
+ * Each layer has a blend mode, an opacity, a pixel mask (LEDs the layer
+ * does not cover show what is below) and an optional time-to-live after
+ * which it disappears by itself, so "flash for 80 ms" no longer needs a
+ * vTaskDelay() and a clear that wipes the user's animation.
+ *
+ * Setters may be called from any task; they take a short critical section.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sk6812.h"
+
+typedef enum {
+    LED_LAYER_BASE = 0,
+    LED_LAYER_APP,
+    LED_LAYER_NOTIFY,
+    LED_LAYER_COUNT
+} led_layer_t;
+
+typedef enum {
+    LED_BLEND_REPLACE = 0,  /* out = src                              */
+    LED_BLEND_ADD,          /* out = below + src (saturating)         */
+    LED_BLEND_MULTIPLY,     /* out = below × src                      */
+    LED_BLEND_ALPHA,        /* out = below + (src - below) × alpha    */
+} led_blend_t;
+
+#define LED_COMP_OPAQUE    255
+#define LED_COMP_FOREVER   0     /* ttl_ms: layer stays until released */
+#define LED_COMP_ALL       ((uint16_t)((1u << SK6812_LED_COUNT) - 1))
+
+/**
+ * @brief  Replace the whole content of @p layer with @p frame.
+ *
+ * @param  frame   SK6812_LED_COUNT 16-bit perceptual colours
+ * @param  blend   How the layer combines with the layers below
+ * @param  alpha   Opacity 0–255 (applied after @p blend)
+ * @param  ttl_ms  Lifetime from now, or LED_COMP_FOREVER
+ */
+void led_comp_set(led_layer_t layer, const sk6812_color16_t *frame,
+                  led_blend_t blend, uint8_t alpha, uint32_t ttl_ms);
+
+/**
+ * @brief  Fill the LEDs in @p mask with one colour; LEDs outside the mask
+ *         become transparent.
+ */
+void led_comp_fill(led_layer_t layer, uint16_t mask, sk6812_color_t color,
+                   led_blend_t blend, uint8_t alpha, uint32_t ttl_ms);
+
+/**
+ * @brief  Set a single LED of @p layer and make it opaque in the mask.
+ *         Enables the layer (replace, opaque, no TTL) if it was released.
+ */
+void led_comp_set_pixel(led_layer_t layer, uint8_t index, sk6812_color_t color);
+
+/**
+ * @brief  Convenience for notifications: opaque flash of all LEDs on
+ *         LED_LAYER_NOTIFY for @p ms milliseconds.
+ */
+void led_comp_flash(sk6812_color_t color, uint32_t ms);
+
+/**
+ * @brief  Remove @p layer so the layers below show through again.
+ */
+void led_comp_release(led_layer_t layer);
+
+/**
+ * @brief  True while @p layer is set and has not expired.
+ */
+bool led_comp_active(led_layer_t layer);
+
+/**
+ * @brief  Blend all live layers into @p out (expired layers are dropped).
+ *
+ * @return true if @p out differs from the previous composed frame, i.e. a
+ *         show() is needed.
+ */
+bool led_comp_compose(sk6812_color16_t *out);
+
+/* ── Statistics ─────────────────────────────────────────────────────────── */
+typedef struct {
+    uint32_t composed;      /* led_comp_compose() calls */
+    uint32_t changed;       /* Frames that differed and were shown */
+    uint32_t expired;       /* Layers removed by their TTL */
+} led_comp_stats_t;
+
+void led_comp_get_stats(led_comp_stats_t *out);
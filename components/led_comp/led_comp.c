@@ -0,0 +1,181 @@
+/*
+ * LED compositor implementation.
+ *
+ * Layer state is a few hundred bytes guarded by one portMUX.  compose()
+ * snapshots the layers inside the critical section and blends outside it,
+ * so producers never wait for the blend.
+ */
+
+#include "led_comp.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include <string.h>
+
+typedef struct {
+    bool             on;
+    led_blend_t      blend;
+    uint8_t          alpha;
+    uint16_t         mask;                       /* Bit i: LED i covered */
+    int64_t          expire_us;                  /* 0 = never */
+    sk6812_color16_t px[SK6812_LED_COUNT];
+} layer_t;
+
+static layer_t          s_layers[LED_LAYER_COUNT];
+static sk6812_color16_t s_last[SK6812_LED_COUNT];
+static bool             s_last_valid;
+static led_comp_stats_t s_stats;
+static portMUX_TYPE     s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static inline sk6812_color16_t widen(sk6812_color_t c) {
+    return (sk6812_color16_t){ c.r * 257u, c.g * 257u, c.b * 257u };
+}
+
+static inline int64_t expiry(uint32_t ttl_ms) {
+    return ttl_ms ? esp_timer_get_time() + (int64_t)ttl_ms * 1000 : 0;
+}
+
+static inline uint16_t blend_ch(led_blend_t mode, uint8_t alpha, uint32_t dst, uint32_t src) {
+    uint32_t v;
+    switch (mode) {
+    case LED_BLEND_ADD:
+        v = dst + src;
+        if (v > 65535) v = 65535;
+        break;
+    case LED_BLEND_MULTIPLY:
+        v = (dst * src + 32767) / 65535;
+        break;
+    case LED_BLEND_ALPHA:
+    case LED_BLEND_REPLACE:
+    default:
+        v = src;
+        break;
+    }
+    if (alpha != LED_COMP_OPAQUE) {
+        /* dst + (v - dst) × alpha / 255 */
+        int32_t d = (int32_t)v - (int32_t)dst;
+        v = (uint32_t)((int32_t)dst + d * alpha / 255);
+    }
+    return (uint16_t)v;
+}
+
+/* ── Layer setters ──────────────────────────────────────────────────────── */
+void led_comp_set(led_layer_t layer, const sk6812_color16_t *frame,
+                  led_blend_t blend, uint8_t alpha, uint32_t ttl_ms) {
+    if (layer >= LED_LAYER_COUNT) return;
+    int64_t exp = expiry(ttl_ms);
+
+    portENTER_CRITICAL(&s_lock);
+    layer_t *l = &s_layers[layer];
+    memcpy(l->px, frame, sizeof(l->px));
+    l->blend     = blend;
+    l->alpha     = alpha;
+    l->mask      = LED_COMP_ALL;
+    l->expire_us = exp;
+    l->on        = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void led_comp_fill(led_layer_t layer, uint16_t mask, sk6812_color_t color,
+                   led_blend_t blend, uint8_t alpha, uint32_t ttl_ms) {
+    if (layer >= LED_LAYER_COUNT) return;
+    sk6812_color16_t c = widen(color);
+    int64_t exp = expiry(ttl_ms);
+
+    portENTER_CRITICAL(&s_lock);
+    layer_t *l = &s_layers[layer];
+    for (int i = 0; i < SK6812_LED_COUNT; i++) l->px[i] = c;
+    l->blend     = blend;
+    l->alpha     = alpha;
+    l->mask      = mask & LED_COMP_ALL;
+    l->expire_us = exp;
+    l->on        = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void led_comp_set_pixel(led_layer_t layer, uint8_t index, sk6812_color_t color) {
+    if (layer >= LED_LAYER_COUNT || index >= SK6812_LED_COUNT) return;
+
+    portENTER_CRITICAL(&s_lock);
+    layer_t *l = &s_layers[layer];
+    if (!l->on) {
+        l->blend     = LED_BLEND_REPLACE;
+        l->alpha     = LED_COMP_OPAQUE;
+        l->mask      = 0;
+        l->expire_us = 0;
+        l->on        = true;
+    }
+    l->px[index] = widen(color);
+    l->mask |= (uint16_t)(1u << index);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void led_comp_flash(sk6812_color_t color, uint32_t ms) {
+    led_comp_fill(LED_LAYER_NOTIFY, LED_COMP_ALL, color, LED_BLEND_REPLACE,
+                  LED_COMP_OPAQUE, ms ? ms : 1);
+}
+
+void led_comp_release(led_layer_t layer) {
+    if (layer >= LED_LAYER_COUNT) return;
+    portENTER_CRITICAL(&s_lock);
+    s_layers[layer].on = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool led_comp_active(led_layer_t layer) {
+    if (layer >= LED_LAYER_COUNT) return false;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    const layer_t *l = &s_layers[layer];
+    bool on = l->on && (l->expire_us == 0 || now < l->expire_us);
+    portEXIT_CRITICAL(&s_lock);
+    return on;
+}
+
+/* ── Composition ────────────────────────────────────────────────────────── */
+bool led_comp_compose(sk6812_color16_t *out) {
+    layer_t snap[LED_LAYER_COUNT];
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    for (int k = 0; k < LED_LAYER_COUNT; k++) {
+        layer_t *l = &s_layers[k];
+        if (l->on && l->expire_us && now >= l->expire_us) {
+            l->on = false;
+            s_stats.expired++;
+        }
+    }
+    memcpy(snap, s_layers, sizeof(snap));
+    portEXIT_CRITICAL(&s_lock);
+
+    memset(out, 0, sizeof(sk6812_color16_t) * SK6812_LED_COUNT);
+    for (int k = 0; k < LED_LAYER_COUNT; k++) {
+        const layer_t *l = &snap[k];
+        if (!l->on) continue;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) {
+            if (!(l->mask & (1u << i))) continue;
+            out[i].r = blend_ch(l->blend, l->alpha, out[i].r, l->px[i].r);
+            out[i].g = blend_ch(l->blend, l->alpha, out[i].g, l->px[i].g);
+            out[i].b = blend_ch(l->blend, l->alpha, out[i].b, l->px[i].b);
+        }
+    }
+
+    bool changed = !s_last_valid ||
+                   memcmp(out, s_last, sizeof(s_last)) != 0;
+    if (changed) {
+        memcpy(s_last, out, sizeof(s_last));
+        s_last_valid = true;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.composed++;
+    if (changed) s_stats.changed++;
+    portEXIT_CRITICAL(&s_lock);
+    return changed;
+}
+
+void led_comp_get_stats(led_comp_stats_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,122 @@
+/*
+ * Host-side LED effect simulator.
+ *
+ * Renders an effect timeline to a binary PPM image for review: one column
+ * block per LED (left to right = LED 0..11), one row per engine tick
+ * (top to bottom = time).  Effect output is perceptual (the LED driver
+ * applies gamma), which is what a monitor expects, so values are written
+ * as-is.
+ *
+ * Build (from the repo root, or `make fx_sim`):
+ *   cc -O2 -Icomponents/led_fx/include -Icomponents/sk6812/include \
+ *      components/led_fx/host/led_fx_sim.c components/led_fx/led_fx.c \
+ *      components/led_fx/led_fx_builtin.c components/led_fx/led_fx_parse.c \
+ *      components/fixpt/fixpt.c -Icomponents/fixpt/include -o led_fx_sim
+ *
+ * Usage:
+ *   led_fx_sim -l                                  list built-in effects
+ *   led_fx_sim <name|file.fx> [ms] [out.ppm] [-a RRGGBB]
+ */
+
+#include "led_fx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CELL_W    16     /* Pixels per LED horizontally */
+#define GAP_W      2     /* Dark separator between LEDs */
+#define ROW_H      2     /* Pixels per tick vertically */
+#define FILE_MAX  4096
+
+static const led_fx_t *load_effect(const char *arg, led_fx_t *storage) {
+    const led_fx_t *fx = led_fx_find(arg);
+    if (fx) return fx;
+
+    FILE *f = fopen(arg, "r");
+    if (!f) return NULL;
+    static char text[FILE_MAX + 1];
+    size_t n = fread(text, 1, FILE_MAX, f);
+    fclose(f);
+    text[n] = '\0';
+
+    int line = 0;
+    if (!led_fx_parse(text, storage, &line)) {
+        fprintf(stderr, "%s: parse error on line %d\n", arg, line);
+        exit(1);
+    }
+    return storage;
+}
+
+int main(int argc, char **argv) {
+    const char *src = NULL, *out_path = "led_fx.ppm";
+    long duration = 10000;
+    int pos = 0;
+    sk6812_color_t accent = { 255, 0, 200 };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0) {
+            for (size_t k = 0; k < led_fx_builtin_count(); k++) {
+                printf("%s\n", led_fx_builtin(k)->name);
+            }
+            return 0;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            unsigned long rgb = strtoul(argv[++i], NULL, 16);
+            accent = (sk6812_color_t){ (uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb };
+        } else if (pos == 0) {
+            src = argv[i]; pos++;
+        } else if (pos == 1) {
+            duration = strtol(argv[i], NULL, 0); pos++;
+        } else {
+            out_path = argv[i];
+        }
+    }
+    if (!src || duration <= 0) {
+        fprintf(stderr, "usage: %s <name|file.fx> [ms] [out.ppm] [-a RRGGBB]\n"
+                        "       %s -l\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    static led_fx_t parsed;
+    const led_fx_t *fx = load_effect(src, &parsed);
+    if (!fx) {
+        fprintf(stderr, "%s: not a built-in effect or readable file\n", src);
+        return 1;
+    }
+
+    FILE *out = fopen(out_path, "wb");
+    if (!out) {
+        perror(out_path);
+        return 1;
+    }
+
+    int ticks  = (int)(duration / LED_FX_TICK_MS);
+    int width  = SK6812_LED_COUNT * (CELL_W + GAP_W);
+    int height = ticks * ROW_H;
+    fprintf(out, "P6\n%d %d\n255\n", width, height);
+
+    led_fx_player_t player = { 0 };
+    led_fx_player_start(&player, fx, 0);
+    sk6812_color16_t leds[SK6812_LED_COUNT];
+    uint8_t *row = malloc((size_t)width * 3);
+
+    for (int t = 0; t < ticks; t++) {
+        led_fx_player_render(&player, (uint32_t)(t * LED_FX_TICK_MS), accent, leds);
+        uint8_t *p = row;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) {
+            for (int x = 0; x < CELL_W; x++) {
+                *p++ = (uint8_t)(leds[i].r >> 8);
+                *p++ = (uint8_t)(leds[i].g >> 8);
+                *p++ = (uint8_t)(leds[i].b >> 8);
+            }
+            for (int x = 0; x < GAP_W; x++) {
+                *p++ = 24; *p++ = 24; *p++ = 24;
+            }
+        }
+        for (int y = 0; y < ROW_H; y++) fwrite(row, 3, (size_t)width, out);
+    }
+
+    free(row);
+    fclose(out);
+    printf("%s: %d ticks (%ld ms) -> %s\n", fx->name, ticks, duration, out_path);
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * LED effect engine – data-driven animations for the SK6812 chain.
+ *
+ * An effect is a compact descriptor evaluated in integer/fixed-point maths
+ * at a fixed tick rate.  It has two independent keyframe tracks:
+ *
+ *   colour track – keys select palette entries; the engine blends between
+ *                  consecutive entries with the key's easing curve
+ *   level track  – keys hold a brightness 0-255, eased the same way
+ *
+ * Each track loops with its own period.  Per-LED tables shift the time
+ * (phase_ms), rotate the palette (color_shift) and attenuate the level
+ * (atten), which is how chases, rainbows and split-colour effects are
+ * expressed without code.  An optional flicker adds a random level drop
+ * that grows with the LED's attenuation (flame tips).
+ *
+ * Effects come from three places:
+ *   - flash tables (led_fx_builtin.c)
+ *   - text files in /pyapps/fx/ (led_fx_parse() / led_fx_load_dir())
+ *   - Python: badge.leds.effect("<same text format>")
+ *
+ * Text format (one directive per line, '#' starts a comment):
+ *
+ *   name Sunset
+ *   colors ff4000 8000ff        # palette, RRGGBB hex
+ *   color_period 4000           # ms
+ *   color 0 0 sine              # <at_ms> <palette index> <ease>
+ *   color 2000 1 sine
+ *   level_period 3000
+ *   level 0 10 in_out           # <at_ms> <level 0-255> <ease>
+ *   level 1500 90 in_out
+ *   spread 250                  # phase_ms[i] = i * 250 (or: phase a b c ...)
+ *   shift 0 1 0 1 0 1 0 1 0 1 0 1
+ *   atten 0 40 80 120 160 200 0 40 80 120 160 200
+ *   flicker 60
+ *   accent                      # palette[0] follows the accent colour
+ *
+ * Eases: step, linear, in, out, in_out, sine.  A track without keys is
+ * constant (palette[0] / full level).
+ *
+ * The evaluator has no ESP-IDF dependencies so it can run on the host
+ * (see host/led_fx_sim.c).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sk6812.h"
+
+#define LED_FX_MAX_KEYS     8
+#define LED_FX_MAX_COLORS   8
+#define LED_FX_NAME_LEN     16
+#define LED_FX_MAX_CUSTOM   8      /* RAM slots for file / Python effects */
+#define LED_FX_TICK_MS      20     /* Evaluation rate (50 Hz) */
+#define LED_FX_DIR          "/pyapps/fx"
+
+/* led_fx_register() failures */
+#define LED_FX_REG_FULL     (-1)   /* All custom slots in use */
+#define LED_FX_REG_BUSY     (-2)   /* LED owner still plays the copy to rewrite */
+
+/* ── Descriptor ──────────────────────────────────────────────────────────── */
+typedef enum {
+    LED_FX_EASE_STEP = 0,   /* hold until the next key */
+    LED_FX_EASE_LINEAR,
+    LED_FX_EASE_IN,         /* quadratic ease-in */
+    LED_FX_EASE_OUT,        /* quadratic ease-out */
+    LED_FX_EASE_IN_OUT,     /* smoothstep */
+    LED_FX_EASE_SINE,       /* half-cosine */
+    LED_FX_EASE_COUNT
+} led_fx_ease_t;
+
+typedef struct {
+    uint16_t at_ms;         /* Position within the track period */
+    uint8_t  value;         /* Palette index (colour) or level (level track) */
+    uint8_t  ease;          /* led_fx_ease_t towards the next key */
+} led_fx_key_t;
+
+typedef struct {
+    uint16_t     period_ms;
+    uint8_t      num_keys;  /* 0 = constant */
+    led_fx_key_t keys[LED_FX_MAX_KEYS];   /* sorted by at_ms */
+} led_fx_track_t;
+
+/* Effect flags */
+#define LED_FX_F_ACCENT   0x01   /* palette[0] is replaced by the accent colour */
+
+typedef struct led_fx {
+    char            name[LED_FX_NAME_LEN];
+    uint8_t         num_colors;
+    sk6812_color_t  palette[LED_FX_MAX_COLORS];
+    led_fx_track_t  color;
+    led_fx_track_t  level;
+    int16_t         phase_ms[SK6812_LED_COUNT];    /* per-LED time offset */
+    uint8_t         color_shift[SK6812_LED_COUNT]; /* per-LED palette rotation */
+    uint8_t         atten[SK6812_LED_COUNT];       /* per-LED level cut (0 = none) */
+    uint8_t         flicker;                       /* max random level drop */
+    uint8_t         flags;
+    uint16_t        duration_ms;   /* >0 and next set: hand over after this long */
+    const struct led_fx *next;
+} led_fx_t;
+
+/* ── Player ──────────────────────────────────────────────────────────────── */
+typedef struct {
+    const led_fx_t *fx;
+    uint32_t        start_ms;      /* Timebase value when fx started */
+    uint32_t        rng;           /* Flicker PRNG state */
+} led_fx_player_t;
+
+/**
+ * @brief  Start playing @p fx at absolute time @p now_ms.
+ */
+void led_fx_player_start(led_fx_player_t *p, const led_fx_t *fx, uint32_t now_ms);
+
+/**
+ * @brief  Evaluate the current effect at absolute time @p now_ms.
+ *         Follows fx->next chains.  Writes SK6812_LED_COUNT 16-bit
+ *         colours (feed them to sk6812_set16() to keep the fade detail).
+ */
+void led_fx_player_render(led_fx_player_t *p, uint32_t now_ms,
+                          sk6812_color_t accent, sk6812_color16_t *out);
+
+/**
+ * @brief  Evaluate @p fx at effect-relative time @p t_ms (stateless
+ *         except for the flicker PRNG in @p rng, which may be NULL).
+ */
+void led_fx_render(const led_fx_t *fx, uint32_t t_ms, sk6812_color_t accent,
+                   uint32_t *rng, sk6812_color16_t *out);
+
+/* ── Registry ────────────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Look up an effect by name (built-ins first, then custom slots).
+ */
+const led_fx_t *led_fx_find(const char *name);
+
+/**
+ * @brief  Built-in effect table (flash).
+ */
+const led_fx_t *led_fx_builtin(size_t index);
+size_t led_fx_builtin_count(void);
+
+/**
+ * @brief  Copy @p fx into a custom slot (replacing one with the same name).
+ *         A replaced effect is published as a new copy; the old one is
+ *         only rewritten once the LED owner no longer holds it.
+ * @return Slot index, LED_FX_REG_FULL if all slots are in use, or
+ *         LED_FX_REG_BUSY if the slot was re-registered since the LED
+ *         owner last called led_fx_custom_hold() (retry after a tick).
+ */
+int led_fx_register(const led_fx_t *fx);
+
+/**
+ * @brief  Custom (file / Python) effects.
+ */
+const led_fx_t *led_fx_custom(size_t index);
+size_t led_fx_custom_count(void);
+
+/**
+ * @brief  LED owner only: the current copy of custom slot @p index, held
+ *         (never rewritten) until the next hold or release.  Call every
+ *         tick while playing it.
+ * @return NULL (and nothing held) if there is no such slot.
+ */
+const led_fx_t *led_fx_custom_hold(size_t index);
+
+/**
+ * @brief  LED owner only: drop the hold when not playing a custom effect.
+ */
+void led_fx_custom_release(void);
+
+/**
+ * @brief  Ask the LED owner to switch to custom slot @p index
+ *         (used by Python, which cannot touch the LED mode directly).
+ */
+void led_fx_request_custom(int index);
+
+/**
+ * @brief  Fetch and clear a pending led_fx_request_custom() call.
+ * @return Requested slot, or -1 if none is pending.
+ */
+int led_fx_take_request(void);
+
+/* ── Text format ─────────────────────────────────────────────────────────── */
+
+/**
+ * @brief  Parse the text format into @p out.
+ * @param  err_line  Set to the offending line number on failure (may be NULL)
+ * @return true on success.
+ */
+bool led_fx_parse(const char *text, led_fx_t *out, int *err_line);
+
+/**
+ * @brief  Parse and register every *.fx file in @p dir.
+ * @return Number of effects registered.
+ */
+int led_fx_load_dir(const char *dir);
@@ -0,0 +1,269 @@
+/*
+ * LED effect engine – evaluator, player and effect registry.
+ *
+ * Everything here is integer maths: track positions are Q16 fractions
+ * (0..65535), easing curves are polynomials or the fixpt cosine table,
+ * and colours are blended and scaled per channel.  No ESP-IDF
+ * headers are used so the same file builds into the host simulator.
+ */
+
+#include "led_fx.h"
+#include "fixpt.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#define FX_ONE    65536u     /* Q16 track position 1.0 */
+#define FX_MAX    65535u
+
+/*
+ * Custom effects are double-buffered: registering fills the slot's idle
+ * copy and then publishes it (and a new slot count).  The LED owner takes
+ * the copy it plays with led_fx_custom_hold(), which also publishes which
+ * one it holds (slot * 2 + copy); a register that would rewrite the held
+ * copy returns busy instead, so led_task never renders an effect that is
+ * being rewritten, however quickly Python re-registers.  Both sides use
+ * sequentially consistent atomics: the holder re-checks the current copy
+ * after publishing its hold.  One task registers at a time (the loader at
+ * boot, then Python).
+ */
+static led_fx_t      s_custom[LED_FX_MAX_CUSTOM][2];
+static atomic_uchar  s_custom_cur[LED_FX_MAX_CUSTOM];
+static atomic_size_t s_custom_count;
+static atomic_int    s_held = -1;
+static atomic_int    s_request = -1;
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static uint32_t ease(uint8_t kind, uint32_t f) {
+    switch (kind) {
+    case LED_FX_EASE_STEP:
+        return 0;
+    case LED_FX_EASE_IN:
+        return (f * f) >> 16;
+    case LED_FX_EASE_OUT: {
+        uint32_t g = FX_MAX - f;
+        return FX_MAX - ((g * g) >> 16);
+    }
+    case LED_FX_EASE_IN_OUT: {
+        /* smoothstep: f² (3 - 2f) */
+        uint32_t f2 = (f * f) >> 16;
+        uint32_t v  = (uint32_t)(((uint64_t)f2 * (3 * FX_ONE - 2 * f)) >> 16);
+        return v > FX_MAX ? FX_MAX : v;
+    }
+    case LED_FX_EASE_SINE: {
+        /* (1 - cos(pi f)) / 2; f is half a turn of binary angle */
+        return (uint32_t)(Q15_ONE - fixpt_cos((uint16_t)(f >> 1)));
+    }
+    case LED_FX_EASE_LINEAR:
+    default:
+        return f;
+    }
+}
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s ? *s : 0x2545F491u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/*
+ * Locate the key segment covering time @p t (+ @p phase) on @p tr.
+ * Returns the start/end values and the eased Q16 position between them.
+ */
+static void eval_track(const led_fx_track_t *tr, uint32_t t, int32_t phase,
+                       uint8_t *a, uint8_t *b, uint32_t *f) {
+    const led_fx_key_t *k = tr->keys;
+    uint8_t n = tr->num_keys;
+
+    if (n == 1 || tr->period_ms == 0) {
+        *a = *b = k[0].value;
+        *f = 0;
+        return;
+    }
+
+    uint32_t period = tr->period_ms;
+    int32_t  p = phase % (int32_t)period;
+    if (p < 0) p += (int32_t)period;
+    uint32_t tt = (t % period + (uint32_t)p) % period;
+
+    /* Last key at or before tt; before the first key we are still in the
+     * segment that wraps from the last key */
+    int cur = n - 1;
+    for (int i = 0; i < n; i++) {
+        if (k[i].at_ms > tt) break;
+        cur = i;
+    }
+    if (tt < k[0].at_ms) tt += period;
+
+    int      nxt     = (cur + 1 < n) ? cur + 1 : 0;
+    uint32_t start   = k[cur].at_ms;
+    uint32_t end     = (cur + 1 < n) ? k[nxt].at_ms : k[0].at_ms + period;
+    uint32_t span    = end - start;
+    uint32_t pos     = 0;
+
+    if (span > 0) {
+        pos = ((tt - start) << 16) / span;
+        if (pos > FX_MAX) pos = FX_MAX;
+    }
+
+    *a = k[cur].value;
+    *b = k[nxt].value;
+    *f = ease(k[cur].ease, pos);
+}
+
+/* Blend two 8-bit values; result in 16 bits (a * 257 .. b * 257) */
+static uint16_t lerp16(uint8_t a, uint8_t b, uint32_t f) {
+    int32_t d = ((int32_t)b - (int32_t)a) * 257;
+    return (uint16_t)((int32_t)a * 257 + ((d * (int32_t)(f >> 1)) >> 15));
+}
+
+static sk6812_color_t palette_at(const led_fx_t *fx, uint8_t idx, uint8_t shift,
+                                 sk6812_color_t accent) {
+    uint8_t n = fx->num_colors ? fx->num_colors : 1;
+    idx = (uint8_t)((idx + shift) % n);
+    if (idx == 0 && (fx->flags & LED_FX_F_ACCENT)) return accent;
+    return fx->palette[idx];
+}
+
+/* ── Evaluation ─────────────────────────────────────────────────────────── */
+void led_fx_render(const led_fx_t *fx, uint32_t t_ms, sk6812_color_t accent,
+                   uint32_t *rng, sk6812_color16_t *out) {
+    for (int i = 0; i < SK6812_LED_COUNT; i++) {
+        int32_t phase = fx->phase_ms[i];
+        uint8_t shift = fx->color_shift[i];
+        uint8_t a, b;
+        uint32_t f;
+
+        /* Colour (16-bit per channel) */
+        sk6812_color16_t c;
+        if (fx->color.num_keys == 0) {
+            sk6812_color_t p = palette_at(fx, 0, shift, accent);
+            c = (sk6812_color16_t){ p.r * 257u, p.g * 257u, p.b * 257u };
+        } else {
+            eval_track(&fx->color, t_ms, phase, &a, &b, &f);
+            sk6812_color_t ca = palette_at(fx, a, shift, accent);
+            sk6812_color_t cb = palette_at(fx, b, shift, accent);
+            c.r = lerp16(ca.r, cb.r, f);
+            c.g = lerp16(ca.g, cb.g, f);
+            c.b = lerp16(ca.b, cb.b, f);
+        }
+
+        /* Level (16-bit) */
+        uint32_t level = 65535;
+        if (fx->level.num_keys) {
+            eval_track(&fx->level, t_ms, phase, &a, &b, &f);
+            level = lerp16(a, b, f);
+        }
+        level = level * (255u - fx->atten[i]) / 255u;
+
+        /* Flicker: up to fx->flicker at full attenuation, a fifth of it
+         * on unattenuated LEDs */
+        if (fx->flicker && rng) {
+            uint32_t drop = xorshift32(rng) % (fx->flicker + 1u);
+            drop = drop * (64u + fx->atten[i]) * 257u / 319u;
+            level = (level > drop) ? level - drop : 0;
+        }
+
+        out[i].r = (uint16_t)((c.r * level) >> 16);
+        out[i].g = (uint16_t)((c.g * level) >> 16);
+        out[i].b = (uint16_t)((c.b * level) >> 16);
+    }
+}
+
+void led_fx_player_start(led_fx_player_t *p, const led_fx_t *fx, uint32_t now_ms) {
+    p->fx = fx;
+    p->start_ms = now_ms;
+    if (p->rng == 0) p->rng = 0x9E3779B9u ^ now_ms;
+}
+
+void led_fx_player_render(led_fx_player_t *p, uint32_t now_ms,
+                          sk6812_color_t accent, sk6812_color16_t *out) {
+    if (!p->fx) {
+        memset(out, 0, sizeof(sk6812_color16_t) * SK6812_LED_COUNT);
+        return;
+    }
+
+    /* Follow the chain; each link keeps its own time origin */
+    while (p->fx->next && p->fx->duration_ms &&
+           now_ms - p->start_ms >= p->fx->duration_ms) {
+        p->start_ms += p->fx->duration_ms;
+        p->fx = p->fx->next;
+    }
+
+    led_fx_render(p->fx, now_ms - p->start_ms, accent, &p->rng, out);
+}
+
+/* ── Registry ───────────────────────────────────────────────────────────── */
+const led_fx_t *led_fx_find(const char *name) {
+    for (size_t i = 0; i < led_fx_builtin_count(); i++) {
+        const led_fx_t *fx = led_fx_builtin(i);
+        if (strncmp(fx->name, name, LED_FX_NAME_LEN) == 0) return fx;
+    }
+    size_t n = led_fx_custom_count();
+    for (size_t i = 0; i < n; i++) {
+        const led_fx_t *fx = led_fx_custom(i);
+        if (strncmp(fx->name, name, LED_FX_NAME_LEN) == 0) return fx;
+    }
+    return NULL;
+}
+
+int led_fx_register(const led_fx_t *fx) {
+    size_t n = led_fx_custom_count();
+    size_t slot = n;
+    for (size_t i = 0; i < n; i++) {
+        if (strncmp(led_fx_custom(i)->name, fx->name, LED_FX_NAME_LEN) == 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot >= LED_FX_MAX_CUSTOM) return LED_FX_REG_FULL;
+
+    /* Fill the copy led_task is not using.  Loaded effects never chain:
+     * the pointer would not survive a reload */
+    unsigned idle = atomic_load(&s_custom_cur[slot]) ^ 1u;
+    if (atomic_load(&s_held) == (int)(slot * 2 + idle)) return LED_FX_REG_BUSY;
+    led_fx_t *dst = &s_custom[slot][idle];
+    *dst = *fx;
+    dst->next = NULL;
+    dst->name[LED_FX_NAME_LEN - 1] = '\0';
+
+    atomic_store(&s_custom_cur[slot], (unsigned char)idle);
+    if (slot == n) atomic_store_explicit(&s_custom_count, n + 1, memory_order_release);
+    return (int)slot;
+}
+
+const led_fx_t *led_fx_custom(size_t index) {
+    if (index >= led_fx_custom_count()) return NULL;
+    return &s_custom[index][atomic_load_explicit(&s_custom_cur[index], memory_order_acquire)];
+}
+
+const led_fx_t *led_fx_custom_hold(size_t index) {
+    if (index >= led_fx_custom_count()) {
+        led_fx_custom_release();
+        return NULL;
+    }
+    unsigned cur;
+    do {
+        cur = atomic_load(&s_custom_cur[index]);
+        atomic_store(&s_held, (int)(index * 2 + cur));
+    } while (atomic_load(&s_custom_cur[index]) != cur);
+    return &s_custom[index][cur];
+}
+
+void led_fx_custom_release(void) {
+    atomic_store(&s_held, -1);
+}
+
+size_t led_fx_custom_count(void) {
+    return atomic_load_explicit(&s_custom_count, memory_order_acquire);
+}
+
+void led_fx_request_custom(int index) {
+    atomic_store(&s_request, index);
+}
+
+int led_fx_take_request(void) {
+    return atomic_exchange(&s_request, -1);
+}
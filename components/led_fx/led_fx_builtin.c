@@ -0,0 +1,208 @@
+/*
+ * Built-in LED effects (flash tables).
+ *
+ * These reproduce the animations that used to be hand-coded in led_task.
+ * Timings are derived from the old frame counters, e.g. "phase++ every
+ * 30 ms, hue += 1" becomes a 256 × 30 ms = 7680 ms colour period.
+ *
+ * Levels are perceptual (the driver applies gamma 2.2), so the old linear
+ * brightness factors were converted with 255 * (v / 255)^(1 / 2.2).
+ *
+ * Per-LED tables assume the badge layout of two six-LED bars
+ * (0-5 and 6-11, bottom to top).
+ */
+
+#include "led_fx.h"
+
+_Static_assert(SK6812_LED_COUNT == 12, "per-LED tables below assume 12 LEDs");
+
+#define KEY(at, v, e)   { (at), (v), LED_FX_EASE_##e }
+#define TRACK(period, ...)                                                   \
+    { .period_ms = (period),                                                 \
+      .num_keys  = sizeof((led_fx_key_t[]){ __VA_ARGS__ }) / sizeof(led_fx_key_t), \
+      .keys      = { __VA_ARGS__ } }
+#define CONSTANT(v)     { .num_keys = 1, .keys = { KEY(0, (v), STEP) } }
+#define SPREAD(d)       { 0, (d), 2*(d), 3*(d), 4*(d), 5*(d), \
+                          6*(d), 7*(d), 8*(d), 9*(d), 10*(d), 11*(d) }
+#define HALVES(a, b)    { a, a, a, a, a, a, b, b, b, b, b, b }
+
+/* Hue wheel: red → green → blue → red, linear (matches the old wheel()) */
+#define WHEEL_PALETTE   { SK6812_RED, SK6812_GREEN, SK6812_BLUE }
+#define WHEEL(period)   TRACK(period, KEY(0, 0, LINEAR),                   \
+                                      KEY((period) / 3, 1, LINEAR),        \
+                                      KEY((period) * 2 / 3, 2, LINEAR))
+
+#define DISOBEY_A       { 255,   0, 200 }   /* hot magenta */
+#define DISOBEY_B       { 255, 255, 255 }   /* white       */
+
+/* ── Solid colours ──────────────────────────────────────────────────────── */
+static const led_fx_t FX_RED = {
+    .name = "red",   .num_colors = 1, .palette = { SK6812_RED },   .level = CONSTANT(110),
+};
+static const led_fx_t FX_GREEN = {
+    .name = "green", .num_colors = 1, .palette = { SK6812_GREEN }, .level = CONSTANT(110),
+};
+static const led_fx_t FX_BLUE = {
+    .name = "blue",  .num_colors = 1, .palette = { SK6812_BLUE },  .level = CONSTANT(110),
+};
+
+/* ── Hue based ──────────────────────────────────────────────────────────── */
+static const led_fx_t FX_RAINBOW = {
+    .name       = "rainbow",
+    .num_colors = 3,
+    .palette    = WHEEL_PALETTE,
+    .color      = WHEEL(7680),
+    .level      = CONSTANT(186),
+    .phase_ms   = SPREAD(960),          /* 32 hue steps per LED */
+};
+
+static const led_fx_t FX_MORPH = {
+    .name       = "morph",
+    .num_colors = 3,
+    .palette    = WHEEL_PALETTE,
+    .color      = WHEEL(60000),
+    .level      = CONSTANT(110),
+};
+
+static const led_fx_t FX_BREATH_CYCLE = {
+    .name       = "breath_cycle",
+    .num_colors = 3,
+    .palette    = WHEEL_PALETTE,
+    .color      = WHEEL(3840),
+    .level      = TRACK(3770, KEY(0, 43, SINE), KEY(1885, 155, SINE)),
+};
+
+static const led_fx_t FX_ROTATE = {
+    .name       = "rotate",
+    .num_colors = 3,
+    .palette    = WHEEL_PALETTE,
+    .color      = WHEEL(2560),
+    /* Three-LED block moving one LED per 160 ms: dim, mid, bright, then dark */
+    .level      = TRACK(1920, KEY(0, 96, STEP), KEY(160, 132, STEP),
+                              KEY(320, 159, STEP), KEY(480, 0, STEP)),
+    .phase_ms   = { 320, 160, 0, -160, -320, -480,
+                    -640, -800, -960, -1120, -1280, -1440 },
+};
+
+static const led_fx_t FX_DISCO = {
+    .name       = "disco",
+    .num_colors = 6,
+    .palette    = { SK6812_RED, SK6812_YELLOW, SK6812_GREEN,
+                    SK6812_CYAN, SK6812_BLUE, SK6812_MAGENTA },
+    .color      = TRACK(2160, KEY(0, 0, STEP), KEY(360, 1, STEP), KEY(720, 2, STEP),
+                              KEY(1080, 3, STEP), KEY(1440, 4, STEP), KEY(1800, 5, STEP)),
+    /* Every third LED lit, pattern marches one LED per 120 ms */
+    .level      = TRACK(360, KEY(0, 186, STEP), KEY(120, 0, STEP)),
+    .phase_ms   = SPREAD(120),
+};
+
+/* ── Two-colour ─────────────────────────────────────────────────────────── */
+static const led_fx_t FX_POLICE = {
+    .name        = "police",
+    .num_colors  = 2,
+    .palette     = { SK6812_RED, SK6812_BLUE },
+    .level       = TRACK(800, KEY(0, 186, STEP), KEY(400, 0, STEP)),
+    .phase_ms    = HALVES(0, 400),
+    .color_shift = HALVES(0, 1),
+};
+
+static const led_fx_t FX_RELAX = {
+    .name       = "relax",
+    .num_colors = 2,
+    .palette    = { { 100, 0, 150 }, { 0, 150, 120 } },  /* mauve, teal */
+    .color      = TRACK(15700, KEY(0, 0, SINE), KEY(7850, 1, SINE)),
+    .level      = CONSTANT(89),
+};
+
+static const led_fx_t FX_CHASE = {
+    .name       = "chase",
+    .num_colors = 2,
+    .palette    = { SK6812_WHITE, SK6812_BLUE },
+    .color      = TRACK(720, KEY(0, 0, STEP), KEY(60, 1, STEP)),
+    .level      = TRACK(720, KEY(0, 167, STEP), KEY(60, 122, STEP),
+                             KEY(120, 80, STEP), KEY(180, 0, STEP)),
+    .phase_ms   = SPREAD(-60),
+};
+
+static const led_fx_t FX_ACCENT = {
+    .name       = "accent",
+    .num_colors = 1,
+    .flags      = LED_FX_F_ACCENT,
+    .level      = TRACK(3770, KEY(0, 21, SINE), KEY(1885, 159, SINE)),
+};
+
+static const led_fx_t FX_FLAME = {
+    .name       = "flame",
+    .num_colors = 2,
+    .palette    = { { 255, 160, 40 }, { 255, 50, 0 } },   /* hot, ember */
+    .color      = TRACK(7850, KEY(0, 0, SINE), KEY(3925, 1, SINE)),
+    .level      = TRACK(7850, KEY(0, 76, SINE), KEY(3925, 87, SINE)),
+    .phase_ms   = { 0, 375, 750, 1125, 1500, 1875,
+                    1000, 1375, 1750, 2125, 2500, 2875 },
+    .atten      = { 0, 38, 77, 115, 153, 191, 0, 38, 77, 115, 153, 191 },
+    .flicker    = 60,
+};
+
+/* ── DISOBEY identity: four 5.12 s sub-animations in a loop ─────────────── */
+static const led_fx_t FX_ID_ROTATE;
+static const led_fx_t FX_ID_SCAN;
+static const led_fx_t FX_ID_STROBE;
+
+static const led_fx_t FX_IDENTITY = {
+    .name        = "identity",
+    .num_colors  = 2,
+    .palette     = { DISOBEY_A, DISOBEY_B },
+    .level       = TRACK(2513, KEY(0, 59, SINE), KEY(1257, 132, SINE)),
+    .color_shift = { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1 },
+    .duration_ms = 5120,
+    .next        = &FX_ID_ROTATE,
+};
+
+static const led_fx_t FX_ID_ROTATE = {
+    .name        = "identity",
+    .num_colors  = 2,
+    .palette     = { DISOBEY_A, DISOBEY_B },
+    .color       = TRACK(3840, KEY(0, 0, STEP), KEY(320, 1, STEP)),
+    .level       = TRACK(3840, KEY(0, 132, STEP), KEY(320, 80, STEP)),
+    .phase_ms    = SPREAD(-320),
+    .duration_ms = 5120,
+    .next        = &FX_ID_SCAN,
+};
+
+static const led_fx_t FX_ID_SCAN = {
+    .name        = "identity",
+    .num_colors  = 2,
+    .palette     = { DISOBEY_A, DISOBEY_B },
+    .color       = TRACK(1200, KEY(0, 0, STEP), KEY(200, 1, STEP)),
+    .level       = TRACK(1200, KEY(0, 132, STEP), KEY(200, 59, STEP)),
+    .phase_ms    = { 0, -200, -400, -600, -800, -1000,
+                     0, -200, -400, -600, -800, -1000 },
+    .duration_ms = 5120,
+    .next        = &FX_ID_STROBE,
+};
+
+static const led_fx_t FX_ID_STROBE = {
+    .name        = "identity",
+    .num_colors  = 2,
+    .palette     = { DISOBEY_A, DISOBEY_B },
+    .color       = TRACK(400, KEY(0, 0, STEP), KEY(200, 1, STEP)),
+    .level       = CONSTANT(122),
+    .color_shift = HALVES(0, 1),
+    .duration_ms = 5120,
+    .next        = &FX_IDENTITY,
+};
+
+/* ── Table ──────────────────────────────────────────────────────────────── */
+static const led_fx_t *const s_builtin[] = {
+    &FX_RED, &FX_GREEN, &FX_BLUE, &FX_RAINBOW, &FX_IDENTITY, &FX_ACCENT,
+    &FX_DISCO, &FX_POLICE, &FX_RELAX, &FX_ROTATE, &FX_CHASE, &FX_MORPH,
+    &FX_BREATH_CYCLE, &FX_FLAME,
+};
+
+const led_fx_t *led_fx_builtin(size_t index) {
+    return (index < led_fx_builtin_count()) ? s_builtin[index] : NULL;
+}
+
+size_t led_fx_builtin_count(void) {
+    return sizeof(s_builtin) / sizeof(s_builtin[0]);
+}
@@ -0,0 +1,87 @@
+/*
+ * Load *.fx effect files from the pyapps FAT partition.
+ */
+
+#include "led_fx.h"
+#include "esp_log.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define TAG "led_fx"
+
+#define FX_FILE_MAX   2048   /* Effects are a few hundred bytes of text */
+
+static bool has_fx_suffix(const char *name) {
+    size_t len = strlen(name);
+    return len > 3 && strcasecmp(name + len - 3, ".fx") == 0;
+}
+
+static bool load_file(const char *path, const char *file_name) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        ESP_LOGW(TAG, "Cannot open %s", path);
+        return false;
+    }
+
+    char *text = malloc(FX_FILE_MAX + 1);
+    if (!text) {
+        fclose(f);
+        return false;
+    }
+    size_t n = fread(text, 1, FX_FILE_MAX, f);
+    bool truncated = !feof(f);
+    fclose(f);
+    text[n] = '\0';
+
+    if (truncated) {
+        ESP_LOGW(TAG, "%s: larger than %d bytes, skipped", file_name, FX_FILE_MAX);
+        free(text);
+        return false;
+    }
+
+    led_fx_t fx;
+    int line = 0;
+    bool ok = led_fx_parse(text, &fx, &line);
+    free(text);
+    if (!ok) {
+        ESP_LOGW(TAG, "%s: parse error on line %d", file_name, line);
+        return false;
+    }
+
+    /* Unnamed effects take the file name without the extension */
+    if (fx.name[0] == '\0') {
+        size_t len = strlen(file_name) - 3;
+        if (len >= LED_FX_NAME_LEN) len = LED_FX_NAME_LEN - 1;
+        memcpy(fx.name, file_name, len);
+        fx.name[len] = '\0';
+    }
+
+    if (led_fx_register(&fx) < 0) {
+        ESP_LOGW(TAG, "%s: no free effect slot", file_name);
+        return false;
+    }
+    ESP_LOGI(TAG, "Loaded effect '%s' from %s", fx.name, file_name);
+    return true;
+}
+
+int led_fx_load_dir(const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) {
+        ESP_LOGD(TAG, "No effect directory %s", dir);
+        return 0;
+    }
+
+    int loaded = 0;
+    char path[128];
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (!has_fx_suffix(e->d_name)) continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        if (load_file(path, e->d_name)) loaded++;
+    }
+    closedir(d);
+    return loaded;
+}
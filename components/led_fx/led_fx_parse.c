@@ -0,0 +1,175 @@
+/*
+ * LED effect text format parser (see led_fx.h for the syntax).
+ *
+ * Plain C library code only, so it is shared by the firmware (FAT loader,
+ * Python) and the host simulator.
+ */
+
+#include "led_fx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define LINE_MAX_LEN  160
+
+static const char *const EASE_NAMES[LED_FX_EASE_COUNT] = {
+    "step", "linear", "in", "out", "in_out", "sine"
+};
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+static bool parse_long(const char *tok, long min, long max, long *out) {
+    char *end;
+    if (!tok) return false;
+    long v = strtol(tok, &end, 0);
+    if (*end != '\0' || v < min || v > max) return false;
+    *out = v;
+    return true;
+}
+
+static bool parse_ease(const char *tok, uint8_t *out) {
+    if (!tok) {
+        *out = LED_FX_EASE_LINEAR;
+        return true;
+    }
+    for (int i = 0; i < LED_FX_EASE_COUNT; i++) {
+        if (strcasecmp(tok, EASE_NAMES[i]) == 0) {
+            *out = (uint8_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* "color <at_ms> <value> [ease]" / "level ..." */
+static bool parse_key(char **save, led_fx_track_t *tr, long max_value) {
+    long at, value;
+    if (tr->num_keys >= LED_FX_MAX_KEYS) return false;
+    if (!parse_long(strtok_r(NULL, " \t", save), 0, UINT16_MAX, &at)) return false;
+    if (!parse_long(strtok_r(NULL, " \t", save), 0, max_value, &value)) return false;
+
+    led_fx_key_t *k = &tr->keys[tr->num_keys];
+    if (!parse_ease(strtok_r(NULL, " \t", save), &k->ease)) return false;
+    if (tr->num_keys > 0 && at <= tr->keys[tr->num_keys - 1].at_ms) return false;
+
+    k->at_ms = (uint16_t)at;
+    k->value = (uint8_t)value;
+    tr->num_keys++;
+    return true;
+}
+
+/* Per-LED list; a short list repeats ("shift 0 1" alternates) */
+static bool parse_list(char **save, long min, long max, long *vals) {
+    int n = 0;
+    char *tok;
+    while (n < SK6812_LED_COUNT && (tok = strtok_r(NULL, " \t", save)) != NULL) {
+        if (!parse_long(tok, min, max, &vals[n])) return false;
+        n++;
+    }
+    if (n == 0) return false;
+    for (int i = n; i < SK6812_LED_COUNT; i++) vals[i] = vals[i % n];
+    return true;
+}
+
+static bool track_valid(const led_fx_track_t *tr) {
+    if (tr->num_keys > 1 && tr->period_ms == 0) return false;
+    if (tr->num_keys > 0 && tr->period_ms &&
+        tr->keys[tr->num_keys - 1].at_ms >= tr->period_ms) return false;
+    return true;
+}
+
+static bool parse_line(char *line, led_fx_t *fx) {
+    char *save;
+    char *cmd = strtok_r(line, " \t", &save);
+    long v, vals[SK6812_LED_COUNT];
+
+    if (!cmd) return true;   /* blank line */
+
+    if (strcmp(cmd, "name") == 0) {
+        char *name = strtok_r(NULL, " \t", &save);
+        if (!name) return false;
+        strncpy(fx->name, name, LED_FX_NAME_LEN - 1);
+        fx->name[LED_FX_NAME_LEN - 1] = '\0';
+    } else if (strcmp(cmd, "colors") == 0) {
+        char *tok;
+        while ((tok = strtok_r(NULL, " \t", &save)) != NULL) {
+            char *end;
+            unsigned long rgb = strtoul(tok, &end, 16);
+            if (*end != '\0' || strlen(tok) != 6 || fx->num_colors >= LED_FX_MAX_COLORS) {
+                return false;
+            }
+            fx->palette[fx->num_colors++] = (sk6812_color_t){
+                (uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb
+            };
+        }
+    } else if (strcmp(cmd, "color_period") == 0) {
+        if (!parse_long(strtok_r(NULL, " \t", &save), 1, UINT16_MAX, &v)) return false;
+        fx->color.period_ms = (uint16_t)v;
+    } else if (strcmp(cmd, "level_period") == 0) {
+        if (!parse_long(strtok_r(NULL, " \t", &save), 1, UINT16_MAX, &v)) return false;
+        fx->level.period_ms = (uint16_t)v;
+    } else if (strcmp(cmd, "color") == 0) {
+        return parse_key(&save, &fx->color, LED_FX_MAX_COLORS - 1);
+    } else if (strcmp(cmd, "level") == 0) {
+        return parse_key(&save, &fx->level, 255);
+    } else if (strcmp(cmd, "spread") == 0) {
+        if (!parse_long(strtok_r(NULL, " \t", &save), -2900, 2900, &v)) return false;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) fx->phase_ms[i] = (int16_t)(v * i);
+    } else if (strcmp(cmd, "phase") == 0) {
+        if (!parse_list(&save, INT16_MIN, INT16_MAX, vals)) return false;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) fx->phase_ms[i] = (int16_t)vals[i];
+    } else if (strcmp(cmd, "shift") == 0) {
+        if (!parse_list(&save, 0, LED_FX_MAX_COLORS - 1, vals)) return false;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) fx->color_shift[i] = (uint8_t)vals[i];
+    } else if (strcmp(cmd, "atten") == 0) {
+        if (!parse_list(&save, 0, 255, vals)) return false;
+        for (int i = 0; i < SK6812_LED_COUNT; i++) fx->atten[i] = (uint8_t)vals[i];
+    } else if (strcmp(cmd, "flicker") == 0) {
+        if (!parse_long(strtok_r(NULL, " \t", &save), 0, 255, &v)) return false;
+        fx->flicker = (uint8_t)v;
+    } else if (strcmp(cmd, "accent") == 0) {
+        fx->flags |= LED_FX_F_ACCENT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────────── */
+bool led_fx_parse(const char *text, led_fx_t *out, int *err_line) {
+    char line[LINE_MAX_LEN];
+    int  line_no = 0;
+
+    memset(out, 0, sizeof(*out));
+
+    while (*text) {
+        size_t len = strcspn(text, "\r\n");
+        line_no++;
+
+        if (len >= sizeof(line)) goto fail;
+        memcpy(line, text, len);
+        line[len] = '\0';
+        text += len;
+        if (*text == '\r') text++;
+        if (*text == '\n') text++;
+
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        if (!parse_line(line, out)) goto fail;
+    }
+
+    /* Whole-effect checks are reported against the last line */
+    if (out->num_colors == 0) {
+        if (!(out->flags & LED_FX_F_ACCENT)) goto fail;
+        out->num_colors = 1;
+    }
+    if (!track_valid(&out->color) || !track_valid(&out->level)) goto fail;
+    for (int i = 0; i < out->color.num_keys; i++) {
+        if (out->color.keys[i].value >= out->num_colors) goto fail;
+    }
+    return true;
+
+fail:
+    if (err_line) *err_line = line_no;
+    return false;
+}
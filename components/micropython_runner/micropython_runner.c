@@ -19,6 +19,9 @@
 
 #include "micropython_runner.h"
 #include "mp_bridge.h"
+#include "audio_tones.h"
+#include "audio_beat.h"
+#include "audio_modem.h"
 
 #include "py/cstack.h"
 #include "py/compile.h"
@@ -54,6 +57,9 @@ static void *mp_heap = NULL;
 /* Shared with modbadge.c: badge.exit() sets this */
 volatile bool mp_app_exit_requested = false;
 
+/* Shared with modbadge.c: badge.mic.beat() holds a beat tracker user */
+volatile bool mp_mic_beat_on = false;
+
 /* Path of app to launch (set by CPU0 before waking the task) */
 static char mp_app_path[128] = {0};
 static volatile bool mp_app_pending = false;
@@ -304,6 +310,12 @@ static void mp_task(void *pvParameters)
 
                 mp_running = false;
                 mp_app_exit_requested = false;
+                audio_tones_stop();     /* Started on demand by badge.mic.dtmf() */
+                if (mp_mic_beat_on) {   /* ... and badge.mic.beat() */
+                    audio_beat_stop();
+                    mp_mic_beat_on = false;
+                }
+                audio_modem_stop();     /* ... and badge.mic.recv() */
                 ESP_LOGI(TAG, "app finished, returning to idle");
             }
 
@@ -1,7 +1,7 @@
 /*
  * MicroPython native 'badge' module for D26 Badge
  *
- * Provides: badge.display, badge.leds, badge.buttons, badge.exit(), badge.delay_ms()
+ * Provides: badge.display, badge.leds, badge.buttons, badge.mic, badge.exit(), badge.delay_ms()
  * All display/LED commands go through mp_bridge queues to CPU0.
  * Button state is read from the button bridge queue.
  */
@@ -9,7 +9,17 @@
 #include "py/runtime.h"
 #include "py/obj.h"
 #include "py/mphal.h"
+#include "py/mperrno.h"
 #include "mp_bridge.h"
+#include "led_fx.h"
+#include "audio_stream.h"
+#include "audio_bands.h"
+#include "audio_tones.h"
+#include "audio_beat.h"
+#include "audio_spl.h"
+#include "audio_modem.h"
+#include "fixpt.h"
+#include "esp_timer.h"
 #include <string.h>
 
 /* ───────────────────── badge.display ───────────────────── */
@@ -120,9 +130,36 @@ static mp_obj_t badge_leds_fill(mp_obj_t r_obj, mp_obj_t g_obj, mp_obj_t b_obj)
 }
 static MP_DEFINE_CONST_FUN_OBJ_3(badge_leds_fill_obj, badge_leds_fill);
 
+/* badge.leds.effect(text) – define and play an effect (led_fx text format) */
+static mp_obj_t badge_leds_effect(mp_obj_t text_obj) {
+    led_fx_t fx;
+    int line = 0;
+    if (!led_fx_parse(mp_obj_str_get_str(text_obj), &fx, &line)) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("effect: error on line %d"), line);
+    }
+    if (fx.name[0] == '\0') strcpy(fx.name, "python");
+
+    /* Busy until led_task has moved on to the last copy: one tick */
+    int slot = led_fx_register(&fx);
+    for (int i = 0; i < 5 && slot == LED_FX_REG_BUSY; i++) {
+        mp_hal_delay_ms(LED_FX_TICK_MS);
+        slot = led_fx_register(&fx);
+    }
+    if (slot == LED_FX_REG_BUSY) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("effect: LEDs busy"));
+    }
+    if (slot < 0) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("effect: no free slot"));
+    }
+    led_fx_request_custom(slot);
+    return mp_obj_new_int(slot);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(badge_leds_effect_obj, badge_leds_effect);
+
 static const mp_rom_map_elem_t badge_leds_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_set),  MP_ROM_PTR(&badge_leds_set_obj) },
     { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&badge_leds_fill_obj) },
+    { MP_ROM_QSTR(MP_QSTR_effect), MP_ROM_PTR(&badge_leds_effect_obj) },
 };
 static MP_DEFINE_CONST_DICT(badge_leds_locals_dict, badge_leds_locals_dict_table);
 
@@ -188,6 +225,200 @@ static MP_DEFINE_CONST_OBJ_TYPE(
 
 static const mp_obj_base_t badge_buttons_obj = { &badge_buttons_type };
 
+/* ───────────────────── badge.mic ───────────────────── */
+
+static audio_sub_t   s_mic_sub;    /* Shared stream subscriber, kept across runs */
+static audio_block_t s_mic_block;  /* Newest block read, seq 0 = none yet */
+
+/* Move s_mic_block to the newest block if one arrived since the last call.
+ * Python polls faster than blocks arrive, so callers cache their results
+ * per block seq and return them again until the next block.
+ * false only if no block has been read yet. */
+static bool mic_latest_block(void) {
+    static audio_block_t next;      /* A torn read must not clobber s_mic_block */
+
+    if (!s_mic_sub.active && !audio_stream_subscribe(&s_mic_sub)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("mic: no free stream slot"));
+    }
+    if (audio_stream_read_latest(&s_mic_sub, &next)) s_mic_block = next;
+    return s_mic_block.seq != 0;
+}
+
+/* badge.mic.level() - RMS of the newest audio block (0-32767) */
+static mp_obj_t badge_mic_level(void) {
+    static uint32_t seq;
+    static int      level;
+
+    if (!mic_latest_block()) return mp_obj_new_int(0);
+    if (s_mic_block.seq != seq) {
+        int64_t sum_sq = 0;
+        for (int i = 0; i < AUDIO_STREAM_BLOCK; i++) {
+            sum_sq += (int32_t)s_mic_block.samples[i] * s_mic_block.samples[i];
+        }
+        level = fixpt_isqrt((uint32_t)(sum_sq / AUDIO_STREAM_BLOCK));
+        seq = s_mic_block.seq;
+    }
+    return mp_obj_new_int(level);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(badge_mic_level_obj, badge_mic_level);
+
+/* badge.mic.bands(count=8, scale=badge.mic.MEL) - band levels of the newest
+ * block in dB re full scale (ints, -100..0); 20 Hz - 20 kHz, 1/3-octave
+ * ignores count beyond the 30 standard bands */
+static mp_obj_t badge_mic_bands(size_t n_args, const mp_obj_t *args) {
+    static audio_band_map_t map;
+    static float work[AUDIO_FFT_SIZE];
+    static float power[AUDIO_FREQ_BINS];
+    static float band[AUDIO_BANDS_MAX];
+    static uint32_t seq;            /* Block band[] was computed from */
+
+    mp_int_t count = (n_args > 0) ? mp_obj_get_int(args[0]) : 8;
+    mp_int_t scale = (n_args > 1) ? mp_obj_get_int(args[1]) : AUDIO_SCALE_MEL;
+    if (count < 1 || count > AUDIO_BANDS_MAX || scale < 0 || scale >= AUDIO_SCALE_CUSTOM) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bands: bad count or scale"));
+    }
+    if (map.scale != (audio_band_scale_t)scale || map.fft_size == 0 ||
+        (scale != AUDIO_SCALE_THIRD_OCTAVE && map.count != count)) {
+        audio_bands_build(&map, (audio_band_scale_t)scale, (uint8_t)count,
+                          AUDIO_FFT_SIZE, 20, 20000);
+        seq = 0;
+    }
+
+    const audio_fft_plan_t *plan = audio_block_plan();
+    bool have = plan && mic_latest_block();
+    if (have && s_mic_block.seq != seq) {
+        audio_fft_power(plan, s_mic_block.samples, work, power);
+        audio_bands_aggregate(&map, power, band);
+        seq = s_mic_block.seq;
+    }
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (int b = 0; b < map.count; b++) {
+        int db = have ? (int)audio_bands_dbfs(&map, band[b]) : -100;
+        if (db < -100) db = -100;
+        mp_obj_list_append(list, mp_obj_new_int(db));
+    }
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(badge_mic_bands_obj, 0, 2, badge_mic_bands);
+
+/* badge.mic.dtmf() - DTMF keys pressed since the last call, as a string.
+ * The first call starts the Goertzel detector; it stops when the app ends */
+static mp_obj_t badge_mic_dtmf(void) {
+    if (!audio_tones_running()) {
+        audio_tones_config_t cfg = AUDIO_TONES_DEFAULT_CONFIG();
+        if (!audio_tones_start(&cfg)) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("mic: no free stream slot"));
+        }
+    }
+    char keys[AUDIO_TONES_QUEUE_LEN];
+    size_t n = 0;
+    audio_tone_event_t ev;
+    while (n < sizeof(keys) && audio_tones_receive(&ev, 0)) {
+        if (ev.type == AUDIO_TONE_DTMF_DOWN) keys[n++] = ev.key;
+    }
+    return mp_obj_new_str(keys, n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(badge_mic_dtmf_obj, badge_mic_dtmf);
+
+/* badge.mic.beat() - (bpm, confidence, beats, ms_since_beat) from the shared
+ * beat tracker; bpm is 0 until a tempo is locked, beats counts up on every
+ * beat.  The first call starts the tracker; it stops when the app ends */
+static mp_obj_t badge_mic_beat(void) {
+    extern volatile bool mp_mic_beat_on;
+    if (!mp_mic_beat_on) {
+        if (!audio_beat_start()) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("mic: no free stream slot"));
+        }
+        mp_mic_beat_on = true;
+    }
+    audio_beat_state_t st;
+    audio_beat_get(&st);
+    mp_int_t since = st.beats ? (mp_int_t)((esp_timer_get_time() - st.last_beat_us) / 1000) : -1;
+    mp_obj_t items[4] = {
+        mp_obj_new_int((mp_int_t)(st.bpm + 0.5f)),
+        mp_obj_new_float(st.confidence),
+        mp_obj_new_int_from_uint(st.beats),
+        mp_obj_new_int(since),
+    };
+    return mp_obj_new_tuple(4, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(badge_mic_beat_obj, badge_mic_beat);
+
+/* badge.mic.spl(weight=badge.mic.A) - (fast, slow, leq, max) in dB SPL from
+ * the always-on sound level meter; weight is A, C or Z (unweighted) */
+static mp_obj_t badge_mic_spl(size_t n_args, const mp_obj_t *args) {
+    mp_int_t weight = (n_args > 0) ? mp_obj_get_int(args[0]) : AUDIO_WEIGHT_A;
+    if (weight < 0 || weight >= AUDIO_WEIGHT_COUNT) {
+        mp_raise_ValueError(MP_ERROR_TEXT("spl: bad weighting"));
+    }
+    audio_spl_level_t lv;
+    audio_spl_get(&lv);
+    mp_obj_t items[4] = {
+        mp_obj_new_float(lv.fast[weight]),
+        mp_obj_new_float(lv.slow[weight]),
+        mp_obj_new_float(lv.leq[weight]),
+        mp_obj_new_float(lv.max[weight]),
+    };
+    return mp_obj_new_tuple(4, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(badge_mic_spl_obj, 0, 1, badge_mic_spl);
+
+/* badge.mic.recv(timeout_ms=0) - next message heard by the acoustic modem as
+ * bytes, or None.  The first call starts the receiver; it stops when the app
+ * ends */
+static mp_obj_t badge_mic_recv(size_t n_args, const mp_obj_t *args) {
+    mp_int_t timeout = (n_args > 0) ? mp_obj_get_int(args[0]) : 0;
+    if (!audio_modem_running() && !audio_modem_start()) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("mic: no free stream slot"));
+    }
+    static audio_modem_frame_t frame;
+    if (!audio_modem_receive(&frame, timeout > 0 ? (uint32_t)timeout : 0)) return mp_const_none;
+    return mp_obj_new_bytes(frame.data, frame.len);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(badge_mic_recv_obj, 0, 1, badge_mic_recv);
+
+/* badge.mic.modem_wav(path, data) - write data (up to 255 bytes) as a modem
+ * transmission WAV, to be played to another badge */
+static mp_obj_t badge_mic_modem_wav(mp_obj_t path_obj, mp_obj_t data_obj) {
+    mp_buffer_info_t buf;
+    mp_get_buffer_raise(data_obj, &buf, MP_BUFFER_READ);
+    if (buf.len > AUDIO_FSK_MAX_PAYLOAD) {
+        mp_raise_ValueError(MP_ERROR_TEXT("modem_wav: data too long"));
+    }
+    if (!audio_modem_write_wav(mp_obj_str_get_str(path_obj), buf.buf, buf.len)) {
+        mp_raise_OSError(MP_EIO);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(badge_mic_modem_wav_obj, badge_mic_modem_wav);
+
+static const mp_rom_map_elem_t badge_mic_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_level), MP_ROM_PTR(&badge_mic_level_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bands), MP_ROM_PTR(&badge_mic_bands_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dtmf),  MP_ROM_PTR(&badge_mic_dtmf_obj) },
+    { MP_ROM_QSTR(MP_QSTR_beat),  MP_ROM_PTR(&badge_mic_beat_obj) },
+    { MP_ROM_QSTR(MP_QSTR_spl),   MP_ROM_PTR(&badge_mic_spl_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recv),  MP_ROM_PTR(&badge_mic_recv_obj) },
+    { MP_ROM_QSTR(MP_QSTR_modem_wav), MP_ROM_PTR(&badge_mic_modem_wav_obj) },
+    { MP_ROM_QSTR(MP_QSTR_LINEAR), MP_ROM_INT(AUDIO_SCALE_LINEAR) },
+    { MP_ROM_QSTR(MP_QSTR_THIRD_OCTAVE), MP_ROM_INT(AUDIO_SCALE_THIRD_OCTAVE) },
+    { MP_ROM_QSTR(MP_QSTR_MEL), MP_ROM_INT(AUDIO_SCALE_MEL) },
+    { MP_ROM_QSTR(MP_QSTR_A), MP_ROM_INT(AUDIO_WEIGHT_A) },
+    { MP_ROM_QSTR(MP_QSTR_C), MP_ROM_INT(AUDIO_WEIGHT_C) },
+    { MP_ROM_QSTR(MP_QSTR_Z), MP_ROM_INT(AUDIO_WEIGHT_Z) },
+};
+static MP_DEFINE_CONST_DICT(badge_mic_locals_dict, badge_mic_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    badge_mic_type,
+    MP_QSTR_mic,
+    MP_TYPE_FLAG_NONE,
+    locals_dict, &badge_mic_locals_dict
+);
+
+static const mp_obj_base_t badge_mic_obj = { &badge_mic_type };
+
 /* ───────────────────── badge module top-level ───────────────────── */
 
 /* badge.exit() */
@@ -217,6 +448,7 @@ static const mp_rom_map_elem_t badge_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_display),   MP_ROM_PTR(&badge_display_obj) },
     { MP_ROM_QSTR(MP_QSTR_leds),      MP_ROM_PTR(&badge_leds_obj) },
     { MP_ROM_QSTR(MP_QSTR_buttons),   MP_ROM_PTR(&badge_buttons_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mic),       MP_ROM_PTR(&badge_mic_obj) },
     { MP_ROM_QSTR(MP_QSTR_exit),      MP_ROM_PTR(&badge_exit_obj) },
     { MP_ROM_QSTR(MP_QSTR_delay_ms),  MP_ROM_PTR(&badge_delay_ms_obj) },
 };
@@ -8,11 +8,25 @@
 #define SK6812_DATA_PIN     18   /* GPIO18 – RMT TX */
 #define SK6812_ENABLE_PIN   17   /* GPIO17 – active-high power enable */
 
+/* Temporal dither refresh: while any channel sits between two 8-bit
+ * codes, the last frame is re-sent at this rate with the next dither step */
+#define SK6812_DITHER_HZ    400
+
 /* ── Colour type ─────────────────────────────────────────────────────────── */
+/*
+ * Colour values are perceptual (gamma-encoded, like sRGB): the driver maps
+ * them through a gamma 2.2 LUT to linear PWM duty in 16 bits and
+ * temporally dithers the result down to the LEDs' 8-bit codes.
+ */
 typedef struct {
     uint8_t r, g, b;
 } sk6812_color_t;
 
+/* 16-bit perceptual colour for smooth low-level fades (0-65535) */
+typedef struct {
+    uint16_t r, g, b;
+} sk6812_color16_t;
+
 /* Predefined colours */
 #define SK6812_BLACK   ((sk6812_color_t){0,   0,   0  })
 #define SK6812_RED     ((sk6812_color_t){255, 0,   0  })
@@ -25,6 +39,10 @@ typedef struct {
 #define SK6812_ORANGE  ((sk6812_color_t){255, 128, 0  })
 
 /* ── Public API ──────────────────────────────────────────────────────────── */
+/*
+ * In the firmware only led_task drives the chain; everything else draws
+ * through led_comp layers.
+ */
 
 /**
  * @brief  Initialise the RMT peripheral and enable the LED power rail.
@@ -37,6 +55,12 @@ void sk6812_init(void);
  */
 void sk6812_set(uint8_t index, sk6812_color_t color);
 
+/**
+ * @brief  Write a 16-bit perceptual colour; keeps the sub-8-bit detail
+ *         that dithering turns into visible brightness steps.
+ */
+void sk6812_set16(uint8_t index, sk6812_color16_t color);
+
 /**
  * @brief  Set all LEDs to the same colour.
  */
@@ -49,10 +73,47 @@ void sk6812_clear(void);
 
 /**
  * @brief  Transmit the current pixel buffer to the LED chain.
+ *
+ *         Non-blocking: the frame is encoded into a free GRB buffer and
+ *         queued behind any transfer still on the wire.  If show() is
+ *         called again before the queued frame starts, the newer frame
+ *         replaces it (counted as merged).
  */
 void sk6812_show(void);
 
 /**
- * @brief  Scale a colour by a brightness factor 0–255.
+ * @brief  Sync fence: wait until every shown frame has been latched.
+ * @return false on timeout.
+ */
+bool sk6812_wait_idle(uint32_t timeout_ms);
+
+/* ── Transfer statistics ─────────────────────────────────────────────────── */
+typedef struct {
+    uint32_t show_calls;        /* sk6812_show() invocations */
+    uint32_t show_us_max;       /* Longest time spent inside show() */
+    uint64_t show_us_total;
+    uint32_t frames_sent;       /* Frames fully clocked out */
+    uint32_t frames_merged;     /* Frames overwritten before reaching the wire */
+    uint32_t frames_dropped;    /* Frames lost to a full timer queue / RMT error */
+    uint32_t tx_errors;
+    uint32_t dither_frames;     /* Refresh frames sent only to advance dithering */
+    uint32_t latency_us_max;    /* show() call → last bit on the wire */
+    uint64_t latency_us_total;
+} sk6812_stats_t;
+
+/**
+ * @brief  Copy / clear the transfer statistics.
+ */
+void sk6812_get_stats(sk6812_stats_t *out);
+void sk6812_reset_stats(void);
+
+/**
+ * @brief  Log a one-line latency summary prefixed with @p label.
+ */
+void sk6812_log_stats(const char *label);
+
+/**
+ * @brief  Scale a colour by a brightness factor 0–255 (8-bit result;
+ *         use sk6812_set16() where low-level precision matters).
  */
 sk6812_color_t sk6812_scale(sk6812_color_t c, uint8_t brightness);
@@ -8,6 +8,24 @@
  *
  * We use the new ESP-IDF 5.x RMT encoder API (rmt_new_bytes_encoder).
  *
+ * Transmission is asynchronous and double-buffered: sk6812_show() encodes
+ * the pixel buffer into whichever GRB buffer the RMT is not reading and
+ * returns immediately.  If a frame is still on the wire, the new frame is
+ * parked in the back buffer (later show() calls overwrite it, i.e. frames
+ * are merged) and the RMT done-callback arms a one-shot esp_timer that
+ * starts the next transfer once the reset gap has passed, so nothing waits
+ * on the line and no FreeRTOS task sits in the frame path.
+ * sk6812_wait_idle() is the fence for the rare caller that must know the
+ * LEDs have latched.
+ *
+ * Output is gamma corrected: the 16-bit perceptual pixel buffer is mapped
+ * through a 257-entry gamma 2.2 LUT (interpolated) to 16-bit linear duty,
+ * then reduced to 8-bit codes with per-channel first-order temporal
+ * dithering (the low byte is carried to the next frame).  Because the app
+ * frame rate is too low for dithering to be invisible at the very bottom
+ * of the range, the last frame is re-sent at SK6812_DITHER_HZ while any
+ * channel has a fractional code; exact frames stop the refresh.
+ *
  * LED order on badge: pixels 0–7, data chain on GPIO18,
  * power enable on GPIO17 (active high).
  */
@@ -18,6 +36,7 @@
 #include "driver/rmt_tx.h"
 #include "driver/rmt_encoder.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -30,16 +49,198 @@
 #define T1H_TICKS   6    /* 600 ns */
 #define T1L_TICKS   6    /* 600 ns */
 #define RESET_TICKS 1000 /* 100 µs  */
+#define RESET_US    ((int64_t)(RESET_TICKS / (RMT_RESOLUTION_HZ / 1000000UL)))
+
+#define GRB_BYTES   (SK6812_LED_COUNT * 3)
 
 /* ── Module state ───────────────────────────────────────────────────────── */
 static rmt_channel_handle_t s_chan = NULL;
 static rmt_encoder_handle_t s_enc  = NULL;
-static sk6812_color_t s_buf[SK6812_LED_COUNT];
+static sk6812_color16_t s_buf[SK6812_LED_COUNT];   /* perceptual, written by set() */
 
 /* Byte encoder config (reused for every show()) */
 static rmt_bytes_encoder_config_t s_enc_cfg;
 static rmt_transmit_config_t s_tx_cfg = { .loop_count = 0 };
 
+/*
+ * Double buffer: s_grb[s_tx_idx] belongs to the RMT while s_busy is set,
+ * the other buffer is where show() writes.  All of the fields below are
+ * protected by s_lock (shared with the RMT ISR).
+ */
+static uint8_t  s_grb[2][GRB_BYTES];
+static uint8_t  s_tx_idx;
+static bool     s_busy;          /* a transfer is on the wire */
+static bool     s_pending;       /* back buffer holds a frame waiting for the wire */
+static int64_t  s_req_us[2];     /* show() time of the frame in each buffer */
+static int64_t  s_done_us;       /* end of the last transfer (for the reset gap) */
+static bool     s_refresh[2];    /* buffer holds a dither refresh, not a show() frame */
+static uint16_t s_lin[GRB_BYTES];/* linear duty of the last shown frame, GRB order */
+static uint8_t  s_err[GRB_BYTES];/* dither residual carried between frames */
+static bool     s_dither;        /* s_lin has codes between two 8-bit steps */
+static sk6812_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_timer_handle_t s_dither_timer;
+static bool               s_dither_timer_on;
+static esp_timer_handle_t s_latch_timer;    /* Starts a transfer after the reset gap */
+
+/* (k / 256)^2.2 in 16 bits, k = 0..256 */
+static const uint16_t GAMMA_LUT[257] = {
+        0,     0,     2,     4,     7,    11,    17,    24,
+       32,    41,    52,    64,    78,    93,   110,   128,
+      147,   168,   191,   215,   240,   267,   296,   327,
+      359,   392,   428,   465,   504,   544,   586,   630,
+      676,   723,   772,   823,   875,   930,   986,  1044,
+     1104,  1165,  1229,  1294,  1361,  1430,  1501,  1574,
+     1648,  1725,  1803,  1884,  1966,  2050,  2136,  2224,
+     2314,  2406,  2500,  2595,  2693,  2793,  2895,  2998,
+     3104,  3212,  3322,  3433,  3547,  3663,  3781,  3900,
+     4022,  4146,  4272,  4400,  4530,  4663,  4797,  4933,
+     5072,  5212,  5355,  5499,  5646,  5795,  5946,  6099,
+     6255,  6412,  6572,  6733,  6897,  7063,  7231,  7402,
+     7574,  7749,  7926,  8105,  8286,  8469,  8655,  8843,
+     9033,  9225,  9419,  9616,  9815, 10016, 10219, 10425,
+    10632, 10842, 11054, 11269, 11486, 11705, 11926, 12149,
+    12375, 12603, 12833, 13066, 13301, 13538, 13777, 14019,
+    14263, 14509, 14758, 15009, 15262, 15517, 15775, 16035,
+    16298, 16563, 16830, 17099, 17371, 17645, 17922, 18201,
+    18482, 18765, 19051, 19339, 19630, 19923, 20218, 20516,
+    20816, 21119, 21424, 21731, 22040, 22352, 22667, 22984,
+    23303, 23624, 23949, 24275, 24604, 24935, 25269, 25605,
+    25943, 26284, 26628, 26973, 27322, 27672, 28026, 28381,
+    28739, 29100, 29462, 29828, 30196, 30566, 30939, 31314,
+    31692, 32072, 32454, 32840, 33227, 33617, 34010, 34405,
+    34802, 35202, 35605, 36010, 36417, 36827, 37240, 37655,
+    38072, 38493, 38915, 39340, 39768, 40198, 40631, 41066,
+    41503, 41944, 42387, 42832, 43280, 43730, 44183, 44639,
+    45097, 45557, 46020, 46486, 46954, 47425, 47899, 48374,
+    48853, 49334, 49818, 50304, 50793, 51284, 51778, 52275,
+    52774, 53276, 53780, 54287, 54796, 55308, 55823, 56341,
+    56860, 57383, 57908, 58436, 58966, 59499, 60035, 60573,
+    61114, 61657, 62203, 62752, 63303, 63857, 64414, 64973,
+    65535,
+};
+
+/* ── Gamma + dither ─────────────────────────────────────────────────────── */
+static inline uint16_t gamma16(uint16_t v) {
+    uint32_t i = v >> 8, frac = v & 0xFF;
+    return (uint16_t)(GAMMA_LUT[i] + (((uint32_t)(GAMMA_LUT[i + 1] - GAMMA_LUT[i]) * frac) >> 8));
+}
+
+/* Reduce s_lin to 8-bit codes into @p dst, advancing the dither; s_lock held */
+static void encode_locked(uint8_t *dst) {
+    for (int i = 0; i < GRB_BYTES; i++) {
+        uint32_t acc = (uint32_t)s_lin[i] + s_err[i];
+        uint32_t out = acc >> 8;
+        s_err[i] = (uint8_t)acc;
+        dst[i] = (uint8_t)(out > 255 ? 255 : out);
+    }
+}
+
+/* ── Transfer scheduling ────────────────────────────────────────────────── */
+static void tx_failed(void) {
+    portENTER_CRITICAL(&s_lock);
+    s_busy = false;
+    s_stats.tx_errors++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void transmit(void) {
+    if (rmt_transmit(s_chan, s_enc, s_grb[s_tx_idx], GRB_BYTES, &s_tx_cfg) != ESP_OK) {
+        tx_failed();
+    }
+}
+
+/* Reset gap over (esp_timer task) */
+static void latch_done(void *arg) {
+    (void)arg;
+    transmit();
+}
+
+/*
+ * Start the transfer of s_grb[s_tx_idx]; caller has already set s_busy.
+ * The line must stay low for the latch period between back-to-back
+ * frames: if it has not yet, the one-shot latch timer starts the transfer
+ * when it has.  Only one transfer is in flight, so the timer is free.
+ */
+static void start_tx(void) {
+    int64_t gap = esp_timer_get_time() - s_done_us;
+    if (gap >= RESET_US) {
+        transmit();
+    } else if (esp_timer_start_once(s_latch_timer, (uint64_t)(RESET_US - gap)) != ESP_OK) {
+        tx_failed();
+    }
+}
+
+static bool IRAM_ATTR tx_done_cb(rmt_channel_handle_t chan,
+                                 const rmt_tx_done_event_data_t *edata, void *ctx) {
+    (void)chan; (void)edata; (void)ctx;
+    int64_t now = esp_timer_get_time();
+    bool kick = false;
+
+    portENTER_CRITICAL_ISR(&s_lock);
+    if (s_refresh[s_tx_idx]) {
+        s_stats.dither_frames++;
+    } else {
+        uint32_t lat = (uint32_t)(now - s_req_us[s_tx_idx]);
+        if (lat > s_stats.latency_us_max) s_stats.latency_us_max = lat;
+        s_stats.latency_us_total += lat;
+        s_stats.frames_sent++;
+    }
+    s_done_us = now;
+
+    if (s_pending) {
+        /* Back buffer becomes the wire buffer; show() now writes the other one */
+        s_pending = false;
+        s_tx_idx ^= 1;
+        kick = true;
+    } else {
+        s_busy = false;
+    }
+    portEXIT_CRITICAL_ISR(&s_lock);
+
+    /* The line went low just now: the latch timer starts the parked frame
+     * after a full reset gap */
+    if (kick && esp_timer_start_once(s_latch_timer, RESET_US) != ESP_OK) {
+        /* Timer still armed: drop the frame, the next show() retransmits */
+        portENTER_CRITICAL_ISR(&s_lock);
+        s_busy = false;
+        s_stats.frames_dropped++;
+        portEXIT_CRITICAL_ISR(&s_lock);
+    }
+    return false;
+}
+
+/* Dither refresh (esp_timer task): re-send the last frame with the next
+ * dither step, but only while the chain is idle so show() always wins */
+static void dither_refresh(void *arg) {
+    (void)arg;
+    bool start = false;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_dither && !s_busy && !s_pending) {
+        uint8_t back = s_tx_idx ^ 1;
+        encode_locked(s_grb[back]);
+        s_refresh[back] = true;
+        s_busy = true;
+        s_tx_idx = back;
+        start = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (start) start_tx();
+}
+
+static void update_dither_timer(bool needed) {
+    if (needed == s_dither_timer_on || !s_dither_timer) return;
+    s_dither_timer_on = needed;
+    if (needed) {
+        esp_timer_start_periodic(s_dither_timer, 1000000 / SK6812_DITHER_HZ);
+    } else {
+        esp_timer_stop(s_dither_timer);
+    }
+}
+
 /* ── Init ────────────────────────────────────────────────────────────────── */
 void sk6812_init(void) {
     /* Power enable pin */
@@ -70,20 +271,50 @@ void sk6812_init(void) {
         .flags.msb_first = 1,
     };
     ESP_ERROR_CHECK(rmt_new_bytes_encoder(&s_enc_cfg, &s_enc));
+
+    /* Done-callback must be registered before the channel is enabled */
+    rmt_tx_event_callbacks_t cbs = { .on_trans_done = tx_done_cb };
+    ESP_ERROR_CHECK(rmt_tx_register_event_callbacks(s_chan, &cbs, NULL));
     ESP_ERROR_CHECK(rmt_enable(s_chan));
 
+    /* Start each channel's dither at a different phase so LEDs at the same
+     * level do not pulse in step */
+    for (int i = 0; i < GRB_BYTES; i++) s_err[i] = (uint8_t)(i * 97);
+
+    const esp_timer_create_args_t dither_args = {
+        .callback = dither_refresh,
+        .name     = "sk6812_dither",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&dither_args, &s_dither_timer));
+
+    const esp_timer_create_args_t latch_args = {
+        .callback = latch_done,
+        .name     = "sk6812_latch",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&latch_args, &s_latch_timer));
+
     memset(s_buf, 0, sizeof(s_buf));
     sk6812_show();
+    sk6812_wait_idle(100);
     ESP_LOGI(TAG, "SK6812 ready (%d LEDs on GPIO%d)", SK6812_LED_COUNT, SK6812_DATA_PIN);
 }
 
 /* ── Pixel buffer operations ────────────────────────────────────────────── */
+static inline sk6812_color16_t widen(sk6812_color_t c) {
+    return (sk6812_color16_t){ c.r * 257u, c.g * 257u, c.b * 257u };
+}
+
 void sk6812_set(uint8_t index, sk6812_color_t c) {
+    if (index < SK6812_LED_COUNT) s_buf[index] = widen(c);
+}
+
+void sk6812_set16(uint8_t index, sk6812_color16_t c) {
     if (index < SK6812_LED_COUNT) s_buf[index] = c;
 }
 
 void sk6812_fill(sk6812_color_t c) {
-    for (int i = 0; i < SK6812_LED_COUNT; i++) s_buf[i] = c;
+    sk6812_color16_t w = widen(c);
+    for (int i = 0; i < SK6812_LED_COUNT; i++) s_buf[i] = w;
 }
 
 void sk6812_clear(void) {
@@ -93,19 +324,97 @@ void sk6812_clear(void) {
 
 /* ── Transmit ────────────────────────────────────────────────────────────── */
 void sk6812_show(void) {
+    int64_t t0 = esp_timer_get_time();
+
     /*
      * SK6812 byte order is GRB.
-     * Build a raw GRB buffer from our internal RGB buffer.
+     * Gamma-map our perceptual RGB buffer to a linear GRB frame.
      */
-    uint8_t grb[SK6812_LED_COUNT * 3];
+    uint16_t lin[GRB_BYTES];
+    uint16_t frac = 0;
     for (int i = 0; i < SK6812_LED_COUNT; i++) {
-        grb[i * 3 + 0] = s_buf[i].g;
-        grb[i * 3 + 1] = s_buf[i].r;
-        grb[i * 3 + 2] = s_buf[i].b;
+        lin[i * 3 + 0] = gamma16(s_buf[i].g);
+        lin[i * 3 + 1] = gamma16(s_buf[i].r);
+        lin[i * 3 + 2] = gamma16(s_buf[i].b);
+        frac |= (lin[i * 3 + 0] | lin[i * 3 + 1] | lin[i * 3 + 2]) & 0xFF;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(s_lin, lin, sizeof(s_lin));
+    s_dither = (frac != 0);
+    uint8_t back = s_tx_idx ^ 1;
+    encode_locked(s_grb[back]);
+    s_refresh[back] = false;
+    bool start = false;
+    if (s_busy) {
+        /* Previous frame still on the wire: park (or merge into) the back buffer */
+        if (s_pending) {
+            s_stats.frames_merged++;
+        } else {
+            s_pending = true;
+            s_req_us[back] = t0;
+        }
+    } else {
+        s_busy = true;
+        s_tx_idx = back;
+        s_req_us[back] = t0;
+        start = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (start) start_tx();
+    update_dither_timer(frac != 0);
+
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+    portENTER_CRITICAL(&s_lock);
+    s_stats.show_calls++;
+    s_stats.show_us_total += dt;
+    if (dt > s_stats.show_us_max) s_stats.show_us_max = dt;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool sk6812_wait_idle(uint32_t timeout_ms) {
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        portENTER_CRITICAL(&s_lock);
+        bool idle = !s_busy && !s_pending;
+        portEXIT_CRITICAL(&s_lock);
+        if (idle) return true;
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeout_ms)) return false;
+        vTaskDelay(1);
     }
+}
+
+/* ── Statistics ──────────────────────────────────────────────────────────── */
+void sk6812_get_stats(sk6812_stats_t *out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void sk6812_reset_stats(void) {
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void sk6812_log_stats(const char *label) {
+    sk6812_stats_t st;
+    sk6812_get_stats(&st);
+    if (st.show_calls == 0) return;
 
-    rmt_transmit(s_chan, s_enc, grb, sizeof(grb), &s_tx_cfg);
-    rmt_tx_wait_all_done(s_chan, pdMS_TO_TICKS(100));
+    ESP_LOGI(TAG, "%s: %lu show() calls, avg %lu us / max %lu us in call; "
+                  "%lu sent, %lu merged, %lu dropped, %lu dither; "
+                  "show->latched avg %lu us / max %lu us",
+             label ? label : "stats",
+             (unsigned long)st.show_calls,
+             (unsigned long)(st.show_us_total / st.show_calls),
+             (unsigned long)st.show_us_max,
+             (unsigned long)st.frames_sent, (unsigned long)st.frames_merged,
+             (unsigned long)st.frames_dropped, (unsigned long)st.dither_frames,
+             (unsigned long)(st.frames_sent ? st.latency_us_total / st.frames_sent : 0),
+             (unsigned long)st.latency_us_max);
 }
 
 /* ── Utility ─────────────────────────────────────────────────────────────── */
@@ -98,6 +98,26 @@ void st7789_draw_bitmap(uint16_t x, uint16_t y, const uint8_t *bitmap,
 void st7789_draw_buffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                         const uint16_t *buf);
 
+/**
+ * @brief  Set up hardware scrolling along the x axis: @p fixed_left and
+ *         @p fixed_right columns stay in place, the columns between them
+ *         wrap around as a ring.
+ */
+void st7789_scroll_area(uint16_t fixed_left, uint16_t fixed_right);
+
+/**
+ * @brief  Show frame-memory column @p x at the left edge of the scrolling
+ *         area (fixed_left ≤ x < ST7789_WIDTH − fixed_right).  Drawing keeps
+ *         addressing frame memory, so a new column written at the wrap
+ *         point appears without redrawing the rest.
+ */
+void st7789_scroll_to(uint16_t x);
+
+/**
+ * @brief  Return to normal, unscrolled display.
+ */
+void st7789_scroll_reset(void);
+
 /**
  * @brief  Control backlight (true = on).
  */
@@ -34,6 +34,8 @@
 #define ST7789_RAMWR   0x2C
 #define ST7789_COLMOD  0x3A
 #define ST7789_MADCTL  0x36
+#define ST7789_VSCRDEF 0x33
+#define ST7789_VSCSAD  0x37
 
 /* MADCTL bits */
 #define MADCTL_MX  0x40   /* column address order */
@@ -292,6 +294,39 @@ void st7789_draw_buffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
     spi_write_buf(buf, (size_t)w * h * 2);
 }
 
+/* ── Hardware scroll ────────────────────────────────────────────────────── */
+/*
+ * The controller scrolls along its 320-line frame-memory axis.  With the
+ * MV exchange used for landscape that axis is screen x, so the "vertical"
+ * scroll registers move columns: VSCRDEF splits the 320 lines into a fixed
+ * left area, a scrolling area and a fixed right area, and VSCSAD picks the
+ * frame-memory line shown at the left of the scrolling area.
+ */
+static void data16(uint16_t v) {
+    dc_set(true);
+    spi_write_byte(v >> 8);
+    spi_write_byte(v & 0xFF);
+}
+
+void st7789_scroll_area(uint16_t fixed_left, uint16_t fixed_right) {
+    if (fixed_left + fixed_right >= ST7789_WIDTH) return;
+    cmd(ST7789_VSCRDEF);
+    data16(fixed_left);
+    data16(ST7789_WIDTH - fixed_left - fixed_right);
+    data16(fixed_right);
+}
+
+void st7789_scroll_to(uint16_t x) {
+    cmd(ST7789_VSCSAD);
+    data16(x);
+}
+
+void st7789_scroll_reset(void) {
+    st7789_scroll_area(0, 0);
+    st7789_scroll_to(0);
+    cmd(ST7789_NORON);      /* Leave scroll mode */
+}
+
 void st7789_set_backlight(bool on) {
     gpio_set_level(ST7789_PIN_BL, on ? 1 : 0);
 }
@@ -0,0 +1,105 @@
+/*
+ * Task profiler – per-task CPU, per-core load, stack headroom and heap.
+ *
+ * While it runs, a low-priority task takes a snapshot every period from
+ * two sources:
+ *
+ *   run-time stats  FreeRTOS run-time counters (esp_timer, 1 µs), taken
+ *                   with uxTaskGetSystemState() and differenced between
+ *                   snapshots: exact CPU time per task.  Needs
+ *                   CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS.
+ *   tick samples    a tick hook on each core counts the task the tick
+ *                   interrupted (1000 samples/s per core, a table lookup
+ *                   per tick).  It splits each task's time between the
+ *                   cores and gives the CPU figures when run-time stats
+ *                   are compiled out.
+ *
+ * Each snapshot also has every task's stack high-water mark (the bytes it
+ * has never touched) and the 8-bit heap: free, lowest free since boot,
+ * largest free block and fragmentation (1 - largest / free).  FreeRTOS
+ * does not record a task's stack size, so the sizes given at creation are
+ * declared with task_prof_set_stack_size(); other tasks show headroom only.
+ *
+ * Snapshots can also be streamed to stdout as CSV for longer captures.
+ * Two kinds of row, each introduced by its own header line:
+ *
+ *   sys,t_ms,core0_pct,core1_pct,heap_free,heap_min,heap_largest,heap_frag_pct
+ *   task,t_ms,name,core,prio,cpu_pct,core0_pct,core1_pct,stack_free,stack_size
+ *
+ * so `grep ^task` or `grep ^sys` on the serial log gives a table with its
+ * header.  core is -1 for tasks that may run on either core.
+ *
+ * Start / stop calls nest like audio_beat: the task and the tick hooks run
+ * until every task_prof_start() has been matched by a task_prof_stop().
+ * The last stop does not block: the task finishes the snapshot (and CSV
+ * rows) in hand, removes the tick hooks and deletes itself.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TASK_PROF_MAX_TASKS     32
+#define TASK_PROF_CORES         2
+#define TASK_PROF_PERIOD_MS     1000
+#define TASK_PROF_NAME_LEN      16      /* CONFIG_FREERTOS_MAX_TASK_NAME_LEN */
+#define TASK_PROF_STACK         3072    /* Profiler task stack, bytes */
+#define TASK_PROF_ANY_CORE      (-1)
+
+typedef struct {
+    char     name[TASK_PROF_NAME_LEN];
+    int8_t   core;                          /* Pinned core or TASK_PROF_ANY_CORE */
+    uint8_t  prio;
+    uint16_t cpu_pm;                        /* Share of all cores, 0.1 % */
+    uint16_t core_pm[TASK_PROF_CORES];      /* Share of each core's ticks, 0.1 % */
+    uint32_t stack_free;                    /* Bytes never used */
+    uint32_t stack_size;                    /* Bytes, 0 = not declared */
+} task_prof_task_t;
+
+typedef struct {
+    uint32_t seq;                           /* Snapshot number, 1 = first */
+    uint32_t t_ms;                          /* Since the profiler started */
+    uint32_t period_ms;                     /* Time the CPU figures cover */
+    bool     exact;                         /* CPU from run-time stats, not ticks */
+    uint16_t core_load_pm[TASK_PROF_CORES]; /* Non-idle time, 0.1 % */
+    uint32_t heap_free;
+    uint32_t heap_min;
+    uint32_t heap_largest;
+    uint16_t heap_frag_pm;                  /* 0.1 % */
+    uint8_t  n_tasks;                       /* Sorted by cpu_pm, highest first */
+    task_prof_task_t task[TASK_PROF_MAX_TASKS];
+} task_prof_snapshot_t;
+
+/**
+ * @brief  Declare the stack size @p name was created with, in bytes.
+ */
+void task_prof_set_stack_size(const char *name, uint32_t bytes);
+
+/**
+ * @brief  Start the profiler (or add a user to it).  Waits up to 500 ms
+ *         for a stopped profiler task to finish exiting.
+ * @return false if its task could not be created, or the previous one
+ *         has not exited yet.
+ */
+bool task_prof_start(void);
+
+/**
+ * @brief  Drop one user; the profiler stops when the last one is gone.
+ *         Returns at once, so it is safe from input_task and app exit.
+ */
+void task_prof_stop(void);
+
+/**
+ * @brief  Copy the latest snapshot.
+ * @return false if there is none yet (out->seq is 0).
+ */
+bool task_prof_get(task_prof_snapshot_t *out);
+
+/**
+ * @brief  Stream every snapshot to stdout as CSV (adds a profiler user
+ *         while on, so the export runs without the screen).
+ */
+void task_prof_set_export(bool on);
+
+bool task_prof_exporting(void);
@@ -0,0 +1,24 @@
+/*
+ * Task Profiler screen – per-core load, heap and one row per task
+ * (CPU, core, priority, stack headroom), busiest first.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief  Reset the draw state; the next draw repaints the whole screen.
+ */
+void task_prof_screen_init(void);
+
+/**
+ * @brief  Redraw whatever changed.
+ * @return true if anything was drawn.
+ */
+bool task_prof_screen_draw(void);
+
+/**
+ * @brief  Scroll the task rows by @p rows (negative = up).
+ */
+void task_prof_screen_scroll(int rows);
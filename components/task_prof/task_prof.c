@@ -0,0 +1,437 @@
+/*
+ * Task profiler implementation.
+ *
+ * Each core's tick hook only writes its own table, so the hooks take no
+ * lock: a slot is claimed by storing its count before its handle, and the
+ * profiler task reads the counts as they are and differences them with
+ * the previous snapshot.  Counts only grow while the hooks are
+ * registered; the tables are cleared before they are.
+ *
+ * The previous run-time and tick counts belong to the profiler task.
+ * s_lock guards the published snapshot, the declared stack sizes, the
+ * user count and the task handle.
+ *
+ * Stopping never deletes the task from outside: task_prof_stop() clears
+ * s_running and wakes it, and the task removes the tick hooks and deletes
+ * itself between snapshots, so it is never cut off inside printf.
+ */
+
+#include "task_prof.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_freertos_hooks.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "task_prof"
+
+#if !CONFIG_FREERTOS_USE_TRACE_FACILITY
+#error "task_prof needs CONFIG_FREERTOS_USE_TRACE_FACILITY (uxTaskGetSystemState)"
+#endif
+
+/* Exact CPU time from the run-time counters, else from the tick samples */
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#define EXACT   1
+#else
+#define EXACT   0
+#endif
+
+_Static_assert(TASK_PROF_CORES >= portNUM_PROCESSORS, "one tick table per core");
+
+/* Ticks each core has spent in a task */
+typedef struct {
+    volatile TaskHandle_t task;
+    volatile uint32_t     ticks;
+} tick_slot_t;
+
+/* Counts at the previous snapshot */
+typedef struct {
+    TaskHandle_t task;
+    uint32_t     run;
+    uint32_t     ticks[TASK_PROF_CORES];
+} prev_t;
+
+typedef struct {
+    char     name[TASK_PROF_NAME_LEN];
+    uint32_t bytes;
+} stack_size_t;
+
+/* Task control */
+static TaskHandle_t  s_task = NULL;
+static volatile bool s_running = false;
+static uint32_t      s_users = 0;
+static bool          s_export = false;
+static volatile bool s_header_due = false;
+static int64_t       s_t0_us;
+static portMUX_TYPE  s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Tick hooks */
+static tick_slot_t       s_ticks[TASK_PROF_CORES][TASK_PROF_MAX_TASKS];
+static volatile uint32_t s_core_ticks[TASK_PROF_CORES];
+
+/* Profiler task */
+static TaskStatus_t s_status[TASK_PROF_MAX_TASKS];
+static prev_t       s_prev[TASK_PROF_MAX_TASKS];
+static uint8_t      s_n_prev;
+static uint32_t     s_prev_total;
+static uint32_t     s_prev_core_ticks[TASK_PROF_CORES];
+static int64_t      s_prev_us;
+static task_prof_snapshot_t s_work;
+
+/* Shared (s_lock) */
+static task_prof_snapshot_t s_latest;
+static stack_size_t s_sizes[TASK_PROF_MAX_TASKS];
+
+/* ── Tick hook ──────────────────────────────────────────────────────────── */
+static void IRAM_ATTR tick_hook(void) {
+    int core = xPortGetCoreID();
+    TaskHandle_t cur = xTaskGetCurrentTaskHandle();
+    tick_slot_t *tab = s_ticks[core];
+
+    s_core_ticks[core]++;
+    for (int i = 0; i < TASK_PROF_MAX_TASKS; i++) {
+        if (tab[i].task == cur) {
+            tab[i].ticks++;
+            return;
+        }
+        if (tab[i].task == NULL) {
+            tab[i].ticks = 1;
+            tab[i].task  = cur;
+            return;
+        }
+    }
+    /* Table full: the tick still counts towards the core total */
+}
+
+static uint32_t ticks_of(int core, TaskHandle_t task) {
+    for (int i = 0; i < TASK_PROF_MAX_TASKS; i++) {
+        TaskHandle_t t = s_ticks[core][i].task;
+        if (t == task) return s_ticks[core][i].ticks;
+        if (t == NULL) break;
+    }
+    return 0;
+}
+
+/* ── Snapshot (profiler task) ───────────────────────────────────────────── */
+static uint16_t per_mille(uint64_t part, uint64_t whole) {
+    if (whole == 0) return 0;
+    uint64_t pm = (part * 1000 + whole / 2) / whole;
+    return pm > 1000 ? 1000 : (uint16_t)pm;
+}
+
+static const prev_t *find_prev(TaskHandle_t task) {
+    for (uint8_t i = 0; i < s_n_prev; i++) {
+        if (s_prev[i].task == task) return &s_prev[i];
+    }
+    return NULL;
+}
+
+static uint32_t stack_size_of(const char *name) {
+    uint32_t bytes = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < TASK_PROF_MAX_TASKS && s_sizes[i].name[0]; i++) {
+        if (strncmp(s_sizes[i].name, name, TASK_PROF_NAME_LEN) == 0) {
+            bytes = s_sizes[i].bytes;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return bytes;
+}
+
+static void sort_by_cpu(task_prof_snapshot_t *s) {
+    for (int i = 1; i < s->n_tasks; i++) {
+        task_prof_task_t t = s->task[i];
+        int j = i;
+        while (j > 0 && s->task[j - 1].cpu_pm < t.cpu_pm) {
+            s->task[j] = s->task[j - 1];
+            j--;
+        }
+        s->task[j] = t;
+    }
+}
+
+/*
+ * Fill s_work with the figures since the previous call.
+ * Returns false on the first call, which only sets the baseline.
+ */
+static bool take_snapshot(void) {
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(s_status, TASK_PROF_MAX_TASKS, &total);
+    int64_t now_us = esp_timer_get_time();
+    if (n == 0) {
+        ESP_LOGW(TAG, "More than %d tasks, not profiled", TASK_PROF_MAX_TASKS);
+        return false;
+    }
+
+    uint32_t core_ticks[TASK_PROF_CORES];
+    uint32_t d_core[TASK_PROF_CORES];
+    for (int c = 0; c < TASK_PROF_CORES; c++) {
+        core_ticks[c] = s_core_ticks[c];
+        d_core[c] = core_ticks[c] - s_prev_core_ticks[c];
+    }
+#if EXACT
+    uint32_t d_total = total - s_prev_total;
+#endif
+    bool baseline = s_prev_us == 0;
+
+    task_prof_snapshot_t *s = &s_work;
+    s->t_ms      = (uint32_t)((now_us - s_t0_us) / 1000);
+    s->period_ms = (uint32_t)((now_us - s_prev_us) / 1000);
+    s->exact     = EXACT;
+    s->n_tasks   = 0;
+
+    uint32_t d_core_all = 0;
+    for (int c = 0; c < TASK_PROF_CORES; c++) {
+        d_core_all += d_core[c];
+        s->core_load_pm[c] = 0;
+    }
+
+    uint32_t busy[TASK_PROF_CORES] = { 0 };
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        const prev_t *p = find_prev(st->xHandle);
+        task_prof_task_t *t = &s->task[s->n_tasks++];
+        int idle_core = -1;
+
+        snprintf(t->name, sizeof(t->name), "%s", st->pcTaskName);
+        BaseType_t core = xTaskGetCoreID(st->xHandle);
+        t->core = (core == tskNO_AFFINITY) ? TASK_PROF_ANY_CORE : (int8_t)core;
+        t->prio = (uint8_t)st->uxCurrentPriority;
+        t->stack_free = st->usStackHighWaterMark * sizeof(StackType_t);
+        t->stack_size = stack_size_of(t->name);
+
+        uint32_t d_ticks_all = 0;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            uint32_t d = ticks_of(c, st->xHandle) - (p ? p->ticks[c] : 0);
+            t->core_pm[c] = per_mille(d, d_core[c]);
+            d_ticks_all += d;
+            if (st->xHandle == xTaskGetIdleTaskHandleForCore(c)) idle_core = c;
+            else busy[c] += d;
+        }
+
+        t->cpu_pm = per_mille(d_ticks_all, d_core_all);
+#if EXACT
+        /* A task created since the last snapshot has run only since then */
+        uint32_t d_run = st->ulRunTimeCounter - (p ? p->run : 0);
+        t->cpu_pm = per_mille(d_run, (uint64_t)d_total * portNUM_PROCESSORS);
+        if (idle_core >= 0) s->core_load_pm[idle_core] = 1000 - per_mille(d_run, d_total);
+#else
+        (void)idle_core;
+#endif
+    }
+#if !EXACT
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        s->core_load_pm[c] = per_mille(busy[c], d_core[c]);
+    }
+#endif
+
+    /* Counts for the next difference */
+    for (UBaseType_t i = 0; i < n; i++) {
+        s_prev[i].task = s_status[i].xHandle;
+#if EXACT
+        s_prev[i].run = s_status[i].ulRunTimeCounter;
+#endif
+        for (int c = 0; c < TASK_PROF_CORES; c++) {
+            s_prev[i].ticks[c] = ticks_of(c, s_status[i].xHandle);
+        }
+    }
+    s_n_prev = (uint8_t)n;
+    s_prev_total = total;
+    memcpy(s_prev_core_ticks, core_ticks, sizeof(core_ticks));
+    s_prev_us = now_us;
+
+    s->heap_free    = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s->heap_min     = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    s->heap_largest = (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    s->heap_frag_pm = 1000 - per_mille(s->heap_largest, s->heap_free);
+
+    sort_by_cpu(s);
+    return !baseline;
+}
+
+/* ── CSV export ─────────────────────────────────────────────────────────── */
+static void print_csv_header(void) {
+    printf("# task_prof csv v1, period %u ms, cpu from %s\n", TASK_PROF_PERIOD_MS,
+           EXACT ? "run-time stats" : "tick samples");
+    printf("sys,t_ms,core0_pct,core1_pct,heap_free,heap_min,heap_largest,heap_frag_pct\n");
+    printf("task,t_ms,name,core,prio,cpu_pct,core0_pct,core1_pct,stack_free,stack_size\n");
+}
+
+static void print_csv(const task_prof_snapshot_t *s) {
+    printf("sys,%lu,%u.%u,%u.%u,%lu,%lu,%lu,%u.%u\n", (unsigned long)s->t_ms,
+           s->core_load_pm[0] / 10, s->core_load_pm[0] % 10,
+           s->core_load_pm[1] / 10, s->core_load_pm[1] % 10,
+           (unsigned long)s->heap_free, (unsigned long)s->heap_min,
+           (unsigned long)s->heap_largest, s->heap_frag_pm / 10, s->heap_frag_pm % 10);
+    for (int i = 0; i < s->n_tasks; i++) {
+        const task_prof_task_t *t = &s->task[i];
+        printf("task,%lu,%s,%d,%u,%u.%u,%u.%u,%u.%u,%lu,%lu\n", (unsigned long)s->t_ms,
+               t->name, t->core, t->prio, t->cpu_pm / 10, t->cpu_pm % 10,
+               t->core_pm[0] / 10, t->core_pm[0] % 10, t->core_pm[1] / 10, t->core_pm[1] % 10,
+               (unsigned long)t->stack_free, (unsigned long)t->stack_size);
+    }
+}
+
+/* ── Task ───────────────────────────────────────────────────────────────── */
+static void prof_task(void *arg) {
+    (void)arg;
+    TickType_t wake = xTaskGetTickCount();
+
+    take_snapshot();
+    while (s_running) {
+        /* task_prof_stop() notifies to end the wait early */
+        wake += pdMS_TO_TICKS(TASK_PROF_PERIOD_MS);
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(wake - now) > 0) ulTaskNotifyTake(pdTRUE, wake - now);
+        else wake = now;
+        if (!s_running) break;
+
+        if (!take_snapshot()) continue;
+
+        portENTER_CRITICAL(&s_lock);
+        s_work.seq = s_latest.seq + 1;
+        s_latest = s_work;
+        bool exporting = s_export;
+        portEXIT_CRITICAL(&s_lock);
+
+        if (exporting) {
+            if (s_header_due) {
+                s_header_due = false;
+                print_csv_header();
+            }
+            print_csv(&s_work);
+        }
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        esp_deregister_freertos_tick_hook_for_cpu(tick_hook, c);
+    }
+    ESP_LOGI(TAG, "Profiler stopped");
+
+    portENTER_CRITICAL(&s_lock);
+    s_task = NULL;  /* Clear handle before self-deleting */
+    portEXIT_CRITICAL(&s_lock);
+    vTaskDelete(NULL);
+}
+
+static bool task_alive(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool alive = s_task != NULL;
+    portEXIT_CRITICAL(&s_lock);
+    return alive;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+void task_prof_set_stack_size(const char *name, uint32_t bytes) {
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < TASK_PROF_MAX_TASKS; i++) {
+        stack_size_t *e = &s_sizes[i];
+        if (e->name[0] && strncmp(e->name, name, TASK_PROF_NAME_LEN) != 0) continue;
+        strncpy(e->name, name, TASK_PROF_NAME_LEN - 1);
+        e->bytes = bytes;
+        break;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool task_prof_start(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool first = s_users++ == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (!first) return true;
+
+    /* A previous task may still be winding down; it exits on its own */
+    for (int i = 0; i < 50 && task_alive(); i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (task_alive()) {
+        ESP_LOGW(TAG, "Previous profiler task still stopping, not started");
+        portENTER_CRITICAL(&s_lock);
+        s_users--;
+        portEXIT_CRITICAL(&s_lock);
+        return false;
+    }
+
+    memset(s_ticks, 0, sizeof(s_ticks));
+    memset((void *)s_core_ticks, 0, sizeof(s_core_ticks));
+    memset(s_prev, 0, sizeof(s_prev));
+    memset(s_prev_core_ticks, 0, sizeof(s_prev_core_ticks));
+    s_n_prev = 0;
+    s_prev_total = 0;
+    s_prev_us = 0;
+    s_t0_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_latest, 0, sizeof(s_latest));
+    portEXIT_CRITICAL(&s_lock);
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        esp_register_freertos_tick_hook_for_cpu(tick_hook, c);
+    }
+
+    s_running = true;
+    if (xTaskCreatePinnedToCore(prof_task, "task_prof", TASK_PROF_STACK, NULL, 1,
+                                &s_task, PRO_CPU_NUM) != pdPASS) {
+        ESP_LOGE(TAG, "Could not create the profiler task");
+        s_running = false;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            esp_deregister_freertos_tick_hook_for_cpu(tick_hook, c);
+        }
+        s_users = 0;
+        return false;
+    }
+    ESP_LOGI(TAG, "Profiler started (cpu from %s)", EXACT ? "run-time stats" : "tick samples");
+    return true;
+}
+
+void task_prof_stop(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool last = s_users > 0 && --s_users == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (!last || !s_running) return;
+
+    /* The task removes the hooks and exits; no waiting here */
+    s_running = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_task) xTaskNotifyGive(s_task);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool task_prof_get(task_prof_snapshot_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_latest;
+    portEXIT_CRITICAL(&s_lock);
+    return out->seq != 0;
+}
+
+void task_prof_set_export(bool on) {
+    portENTER_CRITICAL(&s_lock);
+    bool was = s_export;
+    s_export = on;
+    if (on && !was) s_header_due = true;
+    portEXIT_CRITICAL(&s_lock);
+    if (on == was) return;
+
+    if (on) {
+        if (!task_prof_start()) {
+            portENTER_CRITICAL(&s_lock);
+            s_export = false;
+            portEXIT_CRITICAL(&s_lock);
+            return;
+        }
+    } else {
+        task_prof_stop();
+    }
+    ESP_LOGI(TAG, "CSV export %s", on ? "on" : "off");
+}
+
+bool task_prof_exporting(void) {
+    portENTER_CRITICAL(&s_lock);
+    bool on = s_export;
+    portEXIT_CRITICAL(&s_lock);
+    return on;
+}
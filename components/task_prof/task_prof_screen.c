@@ -0,0 +1,163 @@
+/*
+ * Task Profiler screen implementation
+ */
+
+#include "task_prof_screen.h"
+#include "task_prof.h"
+#include "st7789.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+#define TAG "task_prof_screen"
+
+/* Screen layout: 8x16 font, 40 columns */
+#define TEXT_X          4
+#define LINE_H          16
+#define TITLE_Y         2
+#define CORES_Y         20
+#define HEAP_Y          36
+#define HEADER_Y        54
+#define ROWS_Y          70
+#define ROWS            6
+#define STACK_COL       27      /* Column of the stack figures */
+
+/* Stack headroom warnings */
+#define STACK_LOW       1024
+#define STACK_CRITICAL  512
+
+/* Colors */
+#define COLOR_BG        0x0000  /* Black */
+#define COLOR_TEXT      0xFFFF  /* White */
+#define COLOR_GRID      0x4208  /* Dark gray */
+#define COLOR_TITLE     0x07FF  /* Cyan */
+#define COLOR_WARN      0xFFE0  /* Yellow */
+#define COLOR_ALERT     0xF800  /* Red */
+
+static task_prof_snapshot_t s_snap;     /* Too big for the display task stack */
+
+/* Draw state – reset on init */
+static bool     s_frame_drawn = false;
+static uint32_t s_seq_drawn = 0;
+static int      s_export_drawn = -1;
+static int      s_first = 0;            /* First task row shown */
+static int      s_first_drawn = -1;
+
+void task_prof_screen_init(void) {
+    s_frame_drawn  = false;
+    s_seq_drawn    = 0;
+    s_export_drawn = -1;
+    s_first        = 0;
+    s_first_drawn  = -1;
+    ESP_LOGI(TAG, "Task profiler screen initialized");
+}
+
+void task_prof_screen_scroll(int rows) {
+    s_first += rows;
+    if (s_first < 0) s_first = 0;
+    /* The upper bound depends on the task count, clamped when drawn */
+}
+
+/* ── Drawing helpers ────────────────────────────────────────────────────── */
+static void draw_frame(void) {
+    st7789_fill(COLOR_BG);
+    st7789_draw_string(TEXT_X, TITLE_Y, "Task Profiler", COLOR_TITLE, COLOR_BG, 1);
+    st7789_draw_string(TEXT_X, HEADER_Y, "Task          CPU%  C Pr    free/size",
+                       COLOR_GRID, COLOR_BG, 1);
+    s_frame_drawn = true;
+}
+
+/* Bytes as "123K" above 10 KB */
+static void fmt_bytes(char *buf, size_t len, uint32_t bytes) {
+    if (bytes >= 10 * 1024) snprintf(buf, len, "%luK", (unsigned long)(bytes / 1024));
+    else snprintf(buf, len, "%lu", (unsigned long)bytes);
+}
+
+static uint16_t stack_color(const task_prof_task_t *t) {
+    if (t->stack_free < STACK_CRITICAL) return COLOR_ALERT;
+    if (t->stack_free < STACK_LOW) return COLOR_WARN;
+    return COLOR_TEXT;
+}
+
+static void draw_summary(const task_prof_snapshot_t *s) {
+    char buf[48], f[8], m[8], b[8];
+
+    snprintf(buf, sizeof(buf), "CPU0 %3u.%u%%   CPU1 %3u.%u%%   %-5s",
+             s->core_load_pm[0] / 10, s->core_load_pm[0] % 10,
+             s->core_load_pm[1] / 10, s->core_load_pm[1] % 10,
+             s->exact ? "rt" : "ticks");
+    st7789_draw_string(TEXT_X, CORES_Y, buf, COLOR_TEXT, COLOR_BG, 1);
+
+    fmt_bytes(f, sizeof(f), s->heap_free);
+    fmt_bytes(m, sizeof(m), s->heap_min);
+    fmt_bytes(b, sizeof(b), s->heap_largest);
+    snprintf(buf, sizeof(buf), "Heap %s min %s blk %s frag %u%%  ",
+             f, m, b, (s->heap_frag_pm + 5) / 10);
+    st7789_draw_string(TEXT_X, HEAP_Y, buf, COLOR_TEXT, COLOR_BG, 1);
+}
+
+static void draw_rows(const task_prof_snapshot_t *s) {
+    char buf[48], stack[20];
+
+    for (int r = 0; r < ROWS; r++) {
+        int i = s_first + r;
+        uint16_t y = ROWS_Y + r * LINE_H;
+        if (i >= s->n_tasks) {
+            st7789_fill_rect(0, y, ST7789_WIDTH, LINE_H, COLOR_BG);
+            continue;
+        }
+
+        const task_prof_task_t *t = &s->task[i];
+        char core = t->core == TASK_PROF_ANY_CORE ? '*' : (char)('0' + t->core);
+        snprintf(buf, sizeof(buf), "%-12.12s %3u.%u  %c %2u ",
+                 t->name, t->cpu_pm / 10, t->cpu_pm % 10, core, t->prio);
+        st7789_draw_string(TEXT_X, y, buf, COLOR_TEXT, COLOR_BG, 1);
+
+        if (t->stack_size) {
+            snprintf(stack, sizeof(stack), "%5lu/%-6lu", (unsigned long)t->stack_free,
+                     (unsigned long)t->stack_size);
+        } else {
+            snprintf(stack, sizeof(stack), "%5lu       ", (unsigned long)t->stack_free);
+        }
+        st7789_draw_string(TEXT_X + STACK_COL * 8, y, stack, stack_color(t), COLOR_BG, 1);
+    }
+}
+
+/* ── Draw ───────────────────────────────────────────────────────────────── */
+bool task_prof_screen_draw(void) {
+    bool changed = false;
+
+    if (!s_frame_drawn) {
+        draw_frame();
+        changed = true;
+    }
+
+    int exporting = task_prof_exporting();
+    if (exporting != s_export_drawn) {
+        st7789_draw_string(ST7789_WIDTH - 3 * 8 - TEXT_X, TITLE_Y, exporting ? "CSV" : "   ",
+                           COLOR_ALERT, COLOR_BG, 1);
+        s_export_drawn = exporting;
+        changed = true;
+    }
+
+    bool fresh = task_prof_get(&s_snap) && s_snap.seq != s_seq_drawn;
+    if (s_snap.seq == 0) {
+        if (s_seq_drawn == 0 && changed) {
+            st7789_draw_string(TEXT_X, CORES_Y, "Sampling...", COLOR_GRID, COLOR_BG, 1);
+        }
+        return changed;
+    }
+
+    int last = s_snap.n_tasks > ROWS ? s_snap.n_tasks - ROWS : 0;
+    if (s_first > last) s_first = last;
+
+    if (fresh) {
+        draw_summary(&s_snap);
+        s_seq_drawn = s_snap.seq;
+    }
+    if (fresh || s_first != s_first_drawn) {
+        draw_rows(&s_snap);
+        s_first_drawn = s_first;
+        changed = true;
+    }
+    return changed;
+}
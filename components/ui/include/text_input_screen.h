@@ -35,6 +35,8 @@ void text_input_set_text(text_input_screen_t *screen, const char *text);
  *         LEFT/RIGHT: move cursor
  *         A: confirm input
  *         SELECT: cancel
+ *         Pass BTN_REPEAT events too: held directions repeat through the
+ *         button driver's gestures.
  */
 void text_input_handle_button(text_input_screen_t *screen, int button_id);
 
@@ -6,7 +6,8 @@
  *   • Buttons: all 9 buttons shown as boxes, highlighted when pressed
  *   • LEDs:    SK6812 chain driven with a cycling rainbow
  *
- * Exit: press B + START together (shown on screen).
+ * Exit: hold B and START (shown on screen), in either order and whatever
+ * else is held.
  */
 
 #pragma once
@@ -15,7 +16,6 @@
 #include <stdbool.h>
 
 typedef struct {
-    uint8_t  phase;          /* Animation phase counter */
     bool     needs_full_draw; /* Set on init to force first full draw */
     bool     wants_exit;     /* Set when exit combo detected */
     bool     btn_state[9];   /* Cached per-frame button state */
@@ -34,6 +34,12 @@ void ui_test_screen_init(ui_test_screen_t *screen);
  */
 void ui_test_screen_draw(ui_test_screen_t *screen);
 
+/**
+ * @brief  Feed a press event's button state; B and START both held
+ *         requests exit.
+ */
+void ui_test_screen_handle_press(ui_test_screen_t *screen, uint16_t buttons);
+
 /**
  * @brief  Returns true when the user has requested exit (B+START combo).
  */
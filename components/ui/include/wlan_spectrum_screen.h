@@ -12,6 +12,9 @@
 /* Maximum number of WiFi channels to display */
 #define MAX_WIFI_CHANNELS 14
 
+/* Stack of the "ws_scan" task, bytes */
+#define WLAN_SPECTRUM_SCAN_STACK 4096
+
 /* Screen state */
 typedef struct {
     int8_t   channel_rssi[MAX_WIFI_CHANNELS];  /* best RSSI per channel (dBm) */
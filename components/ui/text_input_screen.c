@@ -34,15 +34,8 @@ static const char charset[] = " abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUV
 #define CURSOR_Y          (INPUT_Y + CHAR_H + 2)   /* 58 */
 #define CURSOR_H          2
 
-/* Auto-repeat for held UP/DOWN: initial delay then fast repeat */
-#define REPEAT_INITIAL_MS  300
-#define REPEAT_FAST_MS     60
-
 /* Track state for dirty-region drawing */
 static bool s_needs_full_draw = true;
-static uint32_t s_repeat_start_tick = 0;
-static uint32_t s_last_repeat_tick = 0;
-static int s_repeat_btn = -1;  /* BTN_UP or BTN_DOWN when held, -1 otherwise */
 
 void text_input_init(text_input_screen_t *screen, const char *prompt, uint8_t max_len) {
     memset(screen, 0, sizeof(*screen));
@@ -52,7 +45,6 @@ void text_input_init(text_input_screen_t *screen, const char *prompt, uint8_t ma
     screen->cursor_pos = 0;
     screen->buffer[0] = 'a';  /* Start with 'a' */
     s_needs_full_draw = true;
-    s_repeat_btn = -1;
 }
 
 void text_input_set_text(text_input_screen_t *screen, const char *text) {
@@ -90,24 +82,16 @@ void text_input_handle_button(text_input_screen_t *screen, int button_id) {
     switch (button_id) {
     case BTN_UP:
         cycle_char(screen, +1);
-        /* Start auto-repeat tracking */
-        s_repeat_btn = BTN_UP;
-        s_repeat_start_tick = xTaskGetTickCount();
-        s_last_repeat_tick = s_repeat_start_tick;
         break;
 
     case BTN_DOWN:
         cycle_char(screen, -1);
-        s_repeat_btn = BTN_DOWN;
-        s_repeat_start_tick = xTaskGetTickCount();
-        s_last_repeat_tick = s_repeat_start_tick;
         break;
 
     case BTN_LEFT:
         if (screen->cursor_pos > 0) {
             screen->cursor_pos--;
         }
-        s_repeat_btn = -1;
         break;
 
     case BTN_RIGHT:
@@ -120,7 +104,6 @@ void text_input_handle_button(text_input_screen_t *screen, int button_id) {
         } else if (screen->cursor_pos < (uint8_t)strlen(screen->buffer) - 1) {
             screen->cursor_pos++;
         }
-        s_repeat_btn = -1;
         break;
 
     case BTN_B:
@@ -131,14 +114,12 @@ void text_input_handle_button(text_input_screen_t *screen, int button_id) {
             }
             screen->cursor_pos--;
         }
-        s_repeat_btn = -1;
         break;
 
     case BTN_A:
     case BTN_STICK:
     case BTN_SELECT:
         screen->editing = false;
-        s_repeat_btn = -1;
         break;
 
     default:
@@ -150,24 +131,6 @@ void text_input_draw(text_input_screen_t *screen) {
     uint16_t TEXT_COL = settings_get_text_color();
     uint16_t ACCENT   = settings_get_accent_color();
 
-    /* ── Auto-repeat for held UP/DOWN ── */
-    if (s_repeat_btn == BTN_UP || s_repeat_btn == BTN_DOWN) {
-        if (buttons_is_pressed((btn_id_t)s_repeat_btn)) {
-            uint32_t now = xTaskGetTickCount();
-            uint32_t elapsed = (now - s_repeat_start_tick) * portTICK_PERIOD_MS;
-            if (elapsed > REPEAT_INITIAL_MS) {
-                uint32_t since_last = (now - s_last_repeat_tick) * portTICK_PERIOD_MS;
-                if (since_last >= REPEAT_FAST_MS) {
-                    cycle_char(screen, (s_repeat_btn == BTN_UP) ? +1 : -1);
-                    s_last_repeat_tick = now;
-                }
-            }
-        } else {
-            /* Button released */
-            s_repeat_btn = -1;
-        }
-    }
-
     /* ── Full redraw (first time or after init) ── */
     if (s_needs_full_draw) {
         s_needs_full_draw = false;
@@ -25,6 +25,8 @@
 #include "ui_test_screen.h"
 #include "st7789.h"
 #include "sk6812.h"
+#include "led_comp.h"
+#include "anim_clock.h"
 #include "buttons.h"
 #include <string.h>
 
@@ -121,21 +123,15 @@ void ui_test_screen_draw(ui_test_screen_t *screen) {
         screen->btn_state[i] = buttons_is_pressed((btn_id_t)i);
     }
 
-    /* ── 2. Check exit combo: B + START held simultaneously ────────── */
-    if (screen->btn_state[BTN_B] && screen->btn_state[BTN_START]) {
-        screen->wants_exit = true;
-        return;
-    }
-
     bool full = screen->needs_full_draw;
 
-    /* ── 3. Full draw: static elements ───────────────────────────────── */
+    /* ── 2. Full draw: static elements ───────────────────────────────── */
     if (full) {
         st7789_fill(COL_BG);
 
         /* Title */
         st7789_draw_string(4, TITLE_Y, "HW TEST", COL_WHITE, COL_BG, 1);
-        st7789_draw_string(170, TITLE_Y, "Hold B+START = exit", COL_DK_GRAY, COL_BG, 1);
+        st7789_draw_string(170, TITLE_Y, "B+START = exit", COL_DK_GRAY, COL_BG, 1);
 
         /* Colour bars (static — drawn once) */
         uint16_t bar_total_h = NUM_BARS * BAR_H + (NUM_BARS - 1) * BAR_GAP;
@@ -151,7 +147,7 @@ void ui_test_screen_draw(ui_test_screen_t *screen) {
         screen->needs_full_draw = false;
     }
 
-    /* ── 4. Draw button boxes (incremental) ─────────────────────────── */
+    /* ── 3. Draw button boxes (incremental) ─────────────────────────── */
     for (uint8_t row = 0; row < BOX_ROWS; row++) {
         for (uint8_t col = 0; col < BOX_COLS; col++) {
             uint8_t btn_id = btn_grid[row][col];
@@ -167,9 +163,11 @@ void ui_test_screen_draw(ui_test_screen_t *screen) {
         }
     }
 
-    /* ── 5. Drive SK6812 LEDs with rainbow ──────────────────────────── */
+    /* ── 4. Drive SK6812 LEDs with rainbow ──────────────────────────── */
+    /* Hue from the shared clock: one turn every 4.2 s regardless of FPS */
+    uint8_t phase = (uint8_t)(anim_clock_phase(4200) >> 8);
     for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-        uint8_t hue = (uint8_t)(i * (256 / SK6812_LED_COUNT) + screen->phase);
+        uint8_t hue = (uint8_t)(i * (256 / SK6812_LED_COUNT) + phase);
         uint8_t region = hue / 43;
         uint8_t rem    = (hue % 43) * 6;
         uint8_t r = 0, g = 0, b = 0;
@@ -182,13 +180,16 @@ void ui_test_screen_draw(ui_test_screen_t *screen) {
             default: r = 255; b = 255 - rem;  break;
         }
         /* Dim to ~25% brightness so it's not blinding */
-        sk6812_set(i, (sk6812_color_t){ r / 4, g / 4, b / 4 });
+        led_comp_set_pixel(LED_LAYER_APP, i, (sk6812_color_t){ r / 4, g / 4, b / 4 });
     }
-    sk6812_show();
 
-    /* ── 6. Save state for next frame ────────────────────────────────── */
+    /* ── 5. Save state for next frame ────────────────────────────────── */
     memcpy(screen->btn_prev, screen->btn_state, sizeof(screen->btn_prev));
-    screen->phase += 2;
+}
+
+void ui_test_screen_handle_press(ui_test_screen_t *screen, uint16_t buttons) {
+    uint16_t combo = BTN_MASK(BTN_B) | BTN_MASK(BTN_START);
+    if ((buttons & combo) == combo) screen->wants_exit = true;
 }
 
 bool ui_test_screen_wants_exit(const ui_test_screen_t *screen) {
@@ -196,8 +197,7 @@ bool ui_test_screen_wants_exit(const ui_test_screen_t *screen) {
 }
 
 void ui_test_screen_clear(void) {
-    /* Turn off LEDs */
-    sk6812_clear();
-    sk6812_show();
+    /* Hand the LEDs back to the user's LED mode */
+    led_comp_release(LED_LAYER_APP);
     st7789_fill(0x0000);
 }
@@ -130,7 +130,7 @@ void wlan_spectrum_screen_init(wlan_spectrum_screen_t *screen) {
 void wlan_spectrum_screen_start_scan(wlan_spectrum_screen_t *screen) {
     if (s_scanning) return;
     s_scanning = true;
-    xTaskCreatePinnedToCore(wifi_spectrum_scan_task, "ws_scan", 4096,
+    xTaskCreatePinnedToCore(wifi_spectrum_scan_task, "ws_scan", WLAN_SPECTRUM_SCAN_STACK,
                             screen, 3, &s_scan_task, PRO_CPU_NUM);
 }
 
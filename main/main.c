@@ -6,14 +6,15 @@
  *
  *   app_main() (CPU0)
  *     ├── Initialise drivers: ST7789, SK6812, buttons
- *     ├── Spawn input_task  – reads button events from ISR queue
+ *     ├── Spawn input_task  – reads button events from the scan queue
  *     ├── Spawn display_task – owns the SPI bus; draws menu on request
  *     └── Spawn led_task    – drives SK6812 LEDs based on active mode
  *
  *  Shared state:
- *   - g_btn_queue   : ISR → input_task (btn_event_t)
+ *   - g_btn_queue   : button scan → input_task (btn_event_t)
  *   - g_disp_queue  : input_task → display_task (disp_cmd_t)
- *   - g_led_mode    : atomically updated int; led_task polls it
+ *   - g_led_mode    : atomically updated int; led_task polls it and plays
+ *                     the matching led_fx effect at a fixed tick
  *
  *  CPU affinity:
  *   - All tasks are pinned to CPU0 (PRO_CPU_NUM).
@@ -29,7 +30,6 @@
  *
  */
 
-#include <math.h>
 #include <stdlib.h>
 #include "st7789.h"
 #include "sk6812.h"
@@ -50,16 +50,35 @@
 #include "about_screen.h"
 #include "color_select_screen.h" /* New */
 #include "audio.h"              /* Added for VU meter mode */
+#include "audio_stream.h"       /* Shared microphone capture */
+#include "audio_fft.h"          /* FFT benchmark */
+#include "audio_bands.h"        /* VU band levels */
+#include "audio_recorder.h"     /* WAV recording to /pyapps */
+#include "audio_beat.h"         /* Beat pulse LED mode */
+#include "audio_spl.h"          /* Always-on sound level meter */
+#include "audio_spl_screen.h"
 #include "hacky_bird.h"         /* Hacky Bird game */
 #include "space_shooter.h"      /* Space Shooter game */
 #include "snake.h"              /* Snake game */
 #include "pong.h"               /* Pong game */
 #include "archanoid.h"          /* Archanoid game */
 #include "race_condition.h"      /* RaceCondition racing game */
+#include "game_rng.h"            /* Seeded game randomness */
+#include "game_replay.h"         /* Game input record / replay */
 #include "micropython_runner.h"  /* MicroPython integration */
 #include "pyapps_fs.h"          /* Python apps filesystem */
 #include "sao_eeprom_screen.h"  /* SAO EEPROM reader */
 #include "event_schedule_screen.h" /* Event schedule */
+#include "frame_pacer.h"          /* Deadline-based frame timing */
+#include "app_registry.h"         /* App lifecycle and budgets */
+#include "latency_trace.h"        /* Input-to-photon latency */
+#include "task_prof.h"            /* Per-task CPU / stack profiler */
+#include "task_prof_screen.h"
+#include "led_fx.h"               /* Data-driven LED effects */
+#include "fixpt.h"                /* Fixed-point maths */
+#include "led_comp.h"             /* LED layer compositor */
+#include "anim_clock.h"           /* Shared animation timebase */
+#include "mp_bridge.h"            /* Python → LED command queue */
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -69,11 +88,14 @@
 #include "esp_netif.h"
 #include "esp_event.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 #include "nvs_flash.h"
 #include <string.h>
 #include <stdatomic.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/stat.h>
 
 #define TAG "main"
 
@@ -85,6 +107,13 @@
 #define BTN_QUEUE_LEN  16
 #define DISP_QUEUE_LEN  4
 
+/* ── Task stacks (bytes; also declared to the task profiler) ─────────────── */
+#define DISPLAY_STACK   4096
+#define INPUT_STACK     3072
+#define LED_STACK       4096
+#define BEAT_CTL_STACK  3072
+#define BENCH_STACK     4096
+
 /* ── LED mode ─────────────────────────────────────────────────────────────── */
 typedef enum {
     LED_MODE_OFF = 0,
@@ -103,6 +132,8 @@ typedef enum {
     LED_MODE_BREATH_CYC,/* Breathing while color cycling */
     LED_MODE_FLAME,     /* Simulated flames on sides */
     LED_MODE_VU,        /* VU meter mode (MIC ON!) */
+    LED_MODE_BEAT,      /* Accent flash on each detected beat (MIC ON!) */
+    LED_MODE_CUSTOM,    /* Effect loaded from /pyapps/fx or Python */
     LED_MODE_COUNT
 } led_mode_t;
 
@@ -130,10 +161,11 @@ typedef enum {
     APP_STATE_SAO_EEPROM,
     APP_STATE_EVENT_SCHEDULE,
     APP_STATE_RACE_CONDITION,
+    APP_STATE_SOUND_LEVEL,
+    APP_STATE_TASK_PROFILER,
+    APP_STATE_COUNT
 } app_state_t;
 
-static atomic_int g_app_state = APP_STATE_IDLE;
-
 /* ── Display command / Redraw helper ────────────────────────────────────── */
 typedef enum {
     DISP_CMD_REDRAW_FULL,
@@ -153,9 +185,20 @@ static inline void request_redraw(disp_cmd_type_t type) {
     }
 }
 
+/* ── Game input traces (Development menu) ────────────────────────────────── */
+typedef enum {
+    GAME_TRACE_OFF = 0,
+    GAME_TRACE_RECORD,      /* Record each game to /pyapps/replay (or serial) */
+    GAME_TRACE_REPLAY,      /* Play each game from its recording */
+} game_trace_t;
+
 /* ── Shared globals ──────────────────────────────────────────────────────── */
 static QueueHandle_t  g_btn_queue;
+static QueueHandle_t  g_py_demo_btn_queue;  /* input_task → python_demo_task */
 static atomic_int     g_led_mode = LED_MODE_ACCENT;
+static atomic_int     g_led_custom = 0;    /* led_fx custom slot for LED_MODE_CUSTOM */
+static atomic_bool    g_latency_overlay;   /* Draw input latency in the corner */
+static atomic_int     g_game_trace = GAME_TRACE_OFF;  /* Record / replay game input */
 static menu_t         g_menu;           /* Main menu */
 static menu_t         g_tools_menu;     /* Tools submenu */
 static menu_t         g_diag_menu;      /* Diagnostics submenu */
@@ -174,10 +217,6 @@ static wlan_list_screen_t g_wlan_list_screen;
 static color_select_screen_t g_color_screen;  /* New color select screen */
 static sao_eeprom_screen_t g_sao_screen;      /* SAO EEPROM reader screen */
 static event_schedule_screen_t g_schedule_screen; /* Event schedule screen */
-static bool g_hacky_bird_game_over = false;   /* Flag for game over state */
-static bool g_pong_game_over = false;         /* Pong game over state */
-static bool g_archanoid_game_over = false;    /* Archanoid game over state */
-static bool g_race_condition_game_over = false; /* RaceCondition game over flag */
 
 /* ── Forward declarations ────────────────────────────────────────────────── */
 static void action_led_off(void);
@@ -203,6 +242,15 @@ static void action_python_demo(void);   /* Python demo */
 static void action_time_date_set(void); /* Time/date setting */
 static void action_sao_eeprom(void);   /* SAO EEPROM reader */
 static void action_event_schedule(void); /* Event schedule */
+static void action_fixpt_bench(void);   /* Fixed-point benchmark */
+static void action_fft_bench(void);     /* Audio FFT benchmark */
+static void action_latency_overlay(void); /* Toggle latency overlay */
+static void action_latency_report(void);  /* Latency report + CSV dump */
+static void action_game_record(void);   /* Toggle game input recording */
+static void action_game_replay(void);   /* Toggle game input replay */
+static void action_audio_record(void);  /* Start / stop WAV recording */
+static void action_sound_level(void);   /* SPL meter screen */
+static void action_task_profiler(void); /* Per-task CPU / stack screen */
 
 /* ── Menu action callbacks ───────────────────────────────────────────────── */
 static void action_led_off(void)      { atomic_store(&g_led_mode, LED_MODE_OFF);      }
@@ -218,128 +266,236 @@ static void action_led_morph(void)    { atomic_store(&g_led_mode, LED_MODE_MORPH
 static void action_led_breath_cyc(void) { atomic_store(&g_led_mode, LED_MODE_BREATH_CYC); }
 static void action_led_flame(void)     { atomic_store(&g_led_mode, LED_MODE_FLAME);     }
 static void action_led_vu(void)        { atomic_store(&g_led_mode, LED_MODE_VU);        }
+static void action_led_beat(void)      { atomic_store(&g_led_mode, LED_MODE_BEAT);      }
+
+/* Custom effects: each selection advances to the next loaded effect */
+static void action_led_custom(void) {
+    size_t n = led_fx_custom_count();
+    if (n == 0) {
+        ESP_LOGW(TAG, "No custom LED effects (add *.fx files to %s)", LED_FX_DIR);
+        return;
+    }
+    int next = 0;
+    if (atomic_load(&g_led_mode) == LED_MODE_CUSTOM) {
+        next = (atomic_load(&g_led_custom) + 1) % (int)n;
+    }
+    atomic_store(&g_led_custom, next);
+    atomic_store(&g_led_mode, LED_MODE_CUSTOM);
+    ESP_LOGI(TAG, "LED effect: %s", led_fx_custom((size_t)next)->name);
+}
 
 static void action_about(void) {
     ESP_LOGI(TAG, "Launching About Screen...");
-    atomic_store(&g_app_state, APP_STATE_ABOUT);
+    app_registry_start(APP_STATE_ABOUT);
 }
 
 static void action_audio_spectrum(void) {
     ESP_LOGI(TAG, "Launching Audio Spectrum Analyzer...");
-    atomic_store(&g_app_state, APP_STATE_AUDIO_SPECTRUM);
-    audio_spectrum_screen_init(&g_audio_screen);
-    audio_spectrum_task_start(&g_audio_screen);
+    app_registry_start(APP_STATE_AUDIO_SPECTRUM);
 }
 
 static void action_settings(void) {
     ESP_LOGI(TAG, "Launching Settings – Nickname Editor...");
-    atomic_store(&g_app_state, APP_STATE_SETTINGS);
-    text_input_init(&g_text_input_screen, "Nickname (Max 10):", 11);
-    text_input_set_text(&g_text_input_screen, settings_get_nickname());
+    app_registry_start(APP_STATE_SETTINGS);
 }
 
 static void action_ui_test(void) {
     ESP_LOGI(TAG, "Launching UI Test Screen...");
-    atomic_store(&g_app_state, APP_STATE_UI_TEST);
-    ui_test_screen_init(&g_ui_test_screen);
+    app_registry_start(APP_STATE_UI_TEST);
 }
 
 static void action_sensor_readout(void) {
     ESP_LOGI(TAG, "Launching Sensor Readout...");
-    atomic_store(&g_app_state, APP_STATE_SENSOR_READOUT);
-    sensor_readout_screen_init(&g_sensor_screen);
+    app_registry_start(APP_STATE_SENSOR_READOUT);
 }
 
 static void action_sao_eeprom(void) {
     ESP_LOGI(TAG, "Launching SAO EEPROM reader...");
-    atomic_store(&g_app_state, APP_STATE_SAO_EEPROM);
-    sao_eeprom_screen_init(&g_sao_screen);
+    app_registry_start(APP_STATE_SAO_EEPROM);
 }
 
 static void action_event_schedule(void) {
     ESP_LOGI(TAG, "Launching Event Schedule...");
-    atomic_store(&g_app_state, APP_STATE_EVENT_SCHEDULE);
-    event_schedule_screen_init(&g_schedule_screen);
+    app_registry_start(APP_STATE_EVENT_SCHEDULE);
+}
+
+/*
+ * The benchmarks take seconds, so they run in a one-shot task on the app
+ * core rather than in input_task.  One at a time; results go to the log.
+ */
+typedef struct {
+    const char *name;
+    bool (*run)(void);
+} bench_t;
+
+static const bench_t s_fixpt_bench = { "fixed-point", fixpt_bench_run };
+static const bench_t s_fft_bench   = { "audio FFT",   audio_fft_bench_run };
+static atomic_bool   s_bench_busy;
+
+static void bench_task(void *arg) {
+    const bench_t *b = arg;
+    if (b->run()) ESP_LOGI(TAG, "%s benchmark passed", b->name);
+    else          ESP_LOGW(TAG, "%s benchmark: accuracy limit missed", b->name);
+    atomic_store(&s_bench_busy, false);
+    vTaskDelete(NULL);
+}
+
+static void start_bench(const bench_t *b) {
+    if (atomic_exchange(&s_bench_busy, true)) {
+        ESP_LOGW(TAG, "A benchmark is already running");
+        return;
+    }
+    ESP_LOGI(TAG, "Running %s benchmark...", b->name);
+    if (xTaskCreatePinnedToCore(bench_task, "bench", BENCH_STACK, (void *)b, 1,
+                                NULL, APP_CPU_NUM) != pdPASS) {
+        ESP_LOGE(TAG, "Could not create the benchmark task");
+        atomic_store(&s_bench_busy, false);
+    }
+}
+
+static void action_fixpt_bench(void) {
+    start_bench(&s_fixpt_bench);
+}
+
+static void action_fft_bench(void) {
+    start_bench(&s_fft_bench);
+}
+
+static void action_task_profiler(void) {
+    ESP_LOGI(TAG, "Launching Task Profiler...");
+    app_registry_start(APP_STATE_TASK_PROFILER);
+}
+
+static void action_latency_overlay(void) {
+    bool on = !atomic_load(&g_latency_overlay);
+    atomic_store(&g_latency_overlay, on);
+    ESP_LOGI(TAG, "Latency overlay %s", on ? "on" : "off");
+}
+
+/* Per-app summary to the log, then everything as CSV for the host */
+static void action_latency_report(void) {
+    uint32_t expired, lost;
+    latency_trace_get_losses(&expired, &lost);
+    ESP_LOGI(TAG, "Input latency by app_state_t (%lu expired, %lu lost):",
+             (unsigned long)expired, (unsigned long)lost);
+    for (int i = 0; i < APP_STATE_COUNT; i++) {
+        latency_trace_log_stats((uint8_t)i);
+    }
+    latency_trace_dump_csv();
+}
+
+static void game_trace_toggle(game_trace_t mode) {
+    game_trace_t now = (atomic_load(&g_game_trace) == (int)mode) ? GAME_TRACE_OFF : mode;
+    atomic_store(&g_game_trace, now);
+    ESP_LOGI(TAG, "Game traces: %s", now == GAME_TRACE_RECORD ? "record" :
+                                     now == GAME_TRACE_REPLAY ? "replay" : "off");
+}
+
+static void action_game_record(void) { game_trace_toggle(GAME_TRACE_RECORD); }
+static void action_game_replay(void) { game_trace_toggle(GAME_TRACE_REPLAY); }
+
+/* Leave room for Python apps and FAT housekeeping when pre-allocating */
+#define REC_RESERVE_BYTES   (32 * 1024)
+#define REC_MAX_SECONDS     (5 * 60)    /* Longest recording pre-allocated */
+#define REC_MAX_FILES       1000        /* rec000.wav .. rec999.wav */
+
+static void action_audio_record(void) {
+    if (audio_recorder_active()) {
+        audio_recorder_stop();          /* Returns at once; the writer closes the file */
+        return;
+    }
+
+    uint64_t total, used, free_bytes;
+    if (!pyapps_fs_is_mounted() ||
+        pyapps_fs_get_stats(&total, &used, &free_bytes) != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot record: pyapps filesystem not mounted");
+        return;
+    }
+
+    /* Next free /pyapps/rec/recNNN.wav */
+    char path[40];
+    struct stat st;
+    int i;
+    mkdir(PYAPPS_MOUNT_POINT "/rec", 0755);
+    for (i = 0; i < REC_MAX_FILES; i++) {
+        snprintf(path, sizeof(path), PYAPPS_MOUNT_POINT "/rec/rec%03d.wav", i);
+        if (stat(path, &st) != 0) break;
+    }
+    if (i == REC_MAX_FILES) {
+        ESP_LOGE(TAG, "Cannot record: rec000.wav to rec999.wav all exist");
+        return;
+    }
+
+    uint64_t room = free_bytes > REC_RESERVE_BYTES ? free_bytes - REC_RESERVE_BYTES : 0;
+    uint64_t max  = AUDIO_REC_HEADER +
+                    (uint64_t)REC_MAX_SECONDS * audio_recorder_bytes_per_second(AUDIO_REC_IMA_ADPCM);
+    if (room > max) room = max;
+    audio_rec_config_t cfg = {
+        .path      = path,
+        .format    = AUDIO_REC_IMA_ADPCM,
+        .max_bytes = (uint32_t)room,
+    };
+    audio_recorder_start(&cfg);
+}
+
+static void action_sound_level(void) {
+    ESP_LOGI(TAG, "Launching Sound Level Meter...");
+    app_registry_start(APP_STATE_SOUND_LEVEL);
 }
 
 static void action_signal_strength(void) {
     ESP_LOGI(TAG, "Launching Signal Strength Display...");
-    atomic_store(&g_app_state, APP_STATE_SIGNAL_STRENGTH);
-    signal_strength_screen_init(&g_signal_screen);
+    app_registry_start(APP_STATE_SIGNAL_STRENGTH);
 }
 
 static void action_wlan_spectrum(void) {
     ESP_LOGI(TAG, "Launching WLAN Spectrum Analyzer...");
-    atomic_store(&g_app_state, APP_STATE_WLAN_SPECTRUM);
-    wlan_spectrum_screen_init(&g_wlan_spectrum_screen);
-    wlan_spectrum_screen_start_scan(&g_wlan_spectrum_screen);
+    app_registry_start(APP_STATE_WLAN_SPECTRUM);
 }
 
 static void action_wlan_list(void) {
     ESP_LOGI(TAG, "Launching WLAN Networks List...");
-    atomic_store(&g_app_state, APP_STATE_WLAN_LIST);
-    wlan_list_screen_init(&g_wlan_list_screen);
-    wlan_list_screen_start_scan(&g_wlan_list_screen);
+    app_registry_start(APP_STATE_WLAN_LIST);
 }
 
 static void action_color_select(void) {
     ESP_LOGI(TAG, "Launching Accent Color Selector...");
-    color_select_screen_init(&g_color_screen, settings_get_accent_color(), "Accent Color");
-    atomic_store(&g_app_state, APP_STATE_COLOR_SELECT);
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_COLOR_SELECT);
 }
 
 static void action_text_color_select(void) {
     ESP_LOGI(TAG, "Launching Text Color Selector...");
-    color_select_screen_init(&g_color_screen, settings_get_text_color(), "Text Color");
-    atomic_store(&g_app_state, APP_STATE_TEXT_COLOR_SELECT);
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_TEXT_COLOR_SELECT);
 }
 
 static void action_hacky_bird(void) {
     ESP_LOGI(TAG, "Launching Hacky Bird...");
-    atomic_store(&g_app_state, APP_STATE_HACKY_BIRD);
-    g_hacky_bird_game_over = false;
-    hacky_bird_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_HACKY_BIRD);
 }
 
 static void action_space_shooter(void) {
     ESP_LOGI(TAG, "Launching Space Shooter...");
-    atomic_store(&g_app_state, APP_STATE_SPACE_SHOOTER);
-    space_shooter_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_SPACE_SHOOTER);
 }
 
 static void action_snake(void) {
     ESP_LOGI(TAG, "Launching Snake...");
-    atomic_store(&g_app_state, APP_STATE_SNAKE);
-    snake_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_SNAKE);
 }
 
 static void action_pong(void) {
     ESP_LOGI(TAG, "Launching Pong...");
-    atomic_store(&g_app_state, APP_STATE_PONG);
-    g_pong_game_over = false;
-    pong_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_PONG);
 }
 
 static void action_archanoid(void) {
     ESP_LOGI(TAG, "Launching Archanoid...");
-    atomic_store(&g_app_state, APP_STATE_ARCHANOID);
-    g_archanoid_game_over = false;
-    archanoid_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_ARCHANOID);
 }
 
 static void action_race_condition(void) {
     ESP_LOGI(TAG, "Launching RaceCondition...");
-    atomic_store(&g_app_state, APP_STATE_RACE_CONDITION);
-    g_race_condition_game_over = false;
-    race_condition_init();
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_start(APP_STATE_RACE_CONDITION);
 }
 
 /* ── Python demo ─────────────────────────────────────────────────────────── */
@@ -352,6 +508,9 @@ static void action_race_condition(void) {
 
 #define PY_CAPTURE_SIZE  2048   /* stdout capture buffer size */
 #define PY_NUM_DEMOS     7
+#define PY_DEMO_STACK    32768
+/* Task stack, the VM's 32 KB heap and the capture buffer */
+#define PY_DEMO_HEAP     (PY_DEMO_STACK + 32 * 1024 + PY_CAPTURE_SIZE)
 
 static const char *PY_DEMO_TITLES[PY_NUM_DEMOS] = {
     "Hello Python",
@@ -578,7 +737,7 @@ static void python_demo_task(void *arg)
     char *capture_buf = heap_caps_malloc(PY_CAPTURE_SIZE, MALLOC_CAP_8BIT);
     if (!capture_buf) {
         ESP_LOGE(TAG, "Failed to allocate capture buffer");
-        atomic_store(&g_app_state, APP_STATE_MENU);
+        app_registry_exit();
         vTaskDelete(NULL);
         return;
     }
@@ -595,7 +754,7 @@ static void python_demo_task(void *arg)
     const int DISPLAY_LINES = 7;
     const int OUTPUT_Y_START = 36;
 
-    while (atomic_load(&g_app_state) == APP_STATE_PYTHON_DEMO) {
+    while (app_registry_current() == APP_STATE_PYTHON_DEMO) {
         /* Run the current demo if needed */
         if (needs_run) {
             needs_run = false;
@@ -612,13 +771,13 @@ static void python_demo_task(void *arg)
 
             st7789_draw_string(10, 40, "Running...", 0xFFE0, 0x0000, 1);
 
-            /* Set LED colour for this demo */
+            /* Set LED colour for this demo: a perceptual ramp 80..170
+             * (the old linear 20..105 through gamma 2.2) */
             sk6812_color_t col = PY_DEMO_COLORS[demo_idx];
             for (int i = 0; i < SK6812_LED_COUNT; i++) {
-                uint8_t bright = (i * 255) / SK6812_LED_COUNT;
-                sk6812_set(i, sk6812_scale(col, bright / 3 + 20));
+                uint8_t bright = 80 + (i * 90) / SK6812_LED_COUNT;
+                led_comp_set_pixel(LED_LAYER_APP, i, sk6812_scale(col, bright));
             }
-            sk6812_show();
 
             /* Run with capture */
             mp_hal_capture_start(capture_buf, PY_CAPTURE_SIZE);
@@ -693,50 +852,61 @@ static void python_demo_task(void *arg)
             st7789_draw_string(310, 156, ">", 0xFFE0, 0x0000, 1);
         }
 
-        /* Poll buttons */
-        if (buttons_is_pressed(BTN_LEFT)) {
+        /* Sleep until input_task forwards a button event (or the state
+         * changes); held UP/DOWN scroll through the driver's auto-repeat */
+        btn_event_t ev;
+        if (xQueueReceive(g_py_demo_btn_queue, &ev, pdMS_TO_TICKS(100)) != pdTRUE) continue;
+        bool press = (ev.type == BTN_PRESSED);
+        bool step  = press || ev.type == BTN_REPEAT;
+        if (press && ev.id == BTN_LEFT) {
             demo_idx = (demo_idx - 1 + PY_NUM_DEMOS) % PY_NUM_DEMOS;
             needs_run = true;
-            while (buttons_is_pressed(BTN_LEFT)) vTaskDelay(pdMS_TO_TICKS(30));
-        }
-        if (buttons_is_pressed(BTN_RIGHT)) {
+        } else if (press && ev.id == BTN_RIGHT) {
             demo_idx = (demo_idx + 1) % PY_NUM_DEMOS;
             needs_run = true;
-            while (buttons_is_pressed(BTN_RIGHT)) vTaskDelay(pdMS_TO_TICKS(30));
-        }
-        if (buttons_is_pressed(BTN_UP)) {
+        } else if (step && ev.id == BTN_UP) {
             if (scroll_offset > 0) { scroll_offset--; needs_draw = true; }
-            vTaskDelay(pdMS_TO_TICKS(120));
-        }
-        if (buttons_is_pressed(BTN_DOWN)) {
+        } else if (step && ev.id == BTN_DOWN) {
             if (scroll_offset < total_lines - DISPLAY_LINES) { scroll_offset++; needs_draw = true; }
-            vTaskDelay(pdMS_TO_TICKS(120));
-        }
-        if (buttons_is_pressed(BTN_B)) {
+        } else if (press && ev.id == BTN_B) {
             break;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
 
     /* Clean up */
     heap_caps_free(capture_buf);
-    sk6812_clear();
+    led_comp_release(LED_LAYER_APP);
 
     ESP_LOGI(TAG, "Python demo exiting");
-    atomic_store(&g_app_state, APP_STATE_MENU);
-    request_redraw(DISP_CMD_REDRAW_FULL);
+    app_registry_exit();
     vTaskDelete(NULL);
 }
 
 static void action_python_demo(void) {
     ESP_LOGI(TAG, "Launching Python Demo...");
-    atomic_store(&g_app_state, APP_STATE_PYTHON_DEMO);
+    app_registry_start(APP_STATE_PYTHON_DEMO);  /* Refused when the heap is too low */
+}
+
+static void python_demo_app_init(void) {
+    xQueueReset(g_py_demo_btn_queue);   /* Drop events left from a previous run */
 
     /* Spawn a task with 32KB stack (MicroPython needs ≥16KB + capture overhead).
      * ESP-IDF xTaskCreatePinnedToCore takes stack size in bytes directly. */
-    xTaskCreatePinnedToCore(python_demo_task, "py_demo", 32768,
-                            NULL, 5, NULL, PRO_CPU_NUM);
+    if (xTaskCreatePinnedToCore(python_demo_task, "py_demo", PY_DEMO_STACK,
+                                NULL, 5, NULL, PRO_CPU_NUM) != pdPASS) {
+        ESP_LOGE(TAG, "Could not create the Python demo task");
+        app_registry_exit();
+    }
+}
+
+/* Drawn by python_demo_task; its presses are not traced to the panel and expire */
+static bool python_demo_app_render(void) {
+    return false;
+}
+
+/* python_demo_task reads every event (releases and repeats too) */
+static void python_demo_app_input(const btn_event_t *ev) {
+    xQueueSend(g_py_demo_btn_queue, ev, 0);
 }
 
 /* ── Time/Date Setting ───────────────────────────────────────────────────── */
@@ -853,7 +1023,10 @@ static void td_draw(void) {
 
 static void action_time_date_set(void) {
     ESP_LOGI(TAG, "Launching Time/Date Setting...");
+    app_registry_start(APP_STATE_TIME_DATE_SET);
+}
 
+static void time_date_app_init(void) {
     /* Read current system time into fields */
     time_t now = time(NULL);
     struct tm *t = localtime(&now);
@@ -864,676 +1037,1323 @@ static void action_time_date_set(void) {
     s_td_fields[TD_FIELD_DAY]  = t->tm_mday;
     s_td_cursor = TD_FIELD_HOUR;
     s_td_needs_draw = true;
+}
 
-    atomic_store(&g_app_state, APP_STATE_TIME_DATE_SET);
-    request_redraw(DISP_CMD_REDRAW_FULL);
+/* Redraw on request */
+static bool time_date_app_render(void) {
+    if (!s_td_needs_draw) return false;
+    s_td_needs_draw = false;
+    td_draw();
+    return true;
 }
 
-/* ── Rainbow helper ──────────────────────────────────────────────────────── */
-static sk6812_color_t wheel(uint8_t pos) {
-    pos = 255 - pos;
-    if (pos < 85)  return (sk6812_color_t){ 255 - pos * 3,   0,           pos * 3   };
-    if (pos < 170) { pos -= 85;  return (sk6812_color_t){ 0,           pos * 3,   255 - pos * 3 }; }
-    pos -= 170;    return (sk6812_color_t){ pos * 3,         255 - pos * 3, 0           };
+/* UP/DOWN adjust field, LEFT/RIGHT move cursor, A confirm, B cancel */
+static void time_date_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_UP) {
+        s_td_fields[s_td_cursor]++;
+        td_clamp();
+        s_td_needs_draw = true;
+    } else if (ev->id == BTN_DOWN) {
+        s_td_fields[s_td_cursor]--;
+        td_clamp();
+        s_td_needs_draw = true;
+    } else if (ev->id == BTN_LEFT) {
+        s_td_cursor = (s_td_cursor - 1 + TD_NUM_FIELDS) % TD_NUM_FIELDS;
+        s_td_needs_draw = true;
+    } else if (ev->id == BTN_RIGHT) {
+        s_td_cursor = (s_td_cursor + 1) % TD_NUM_FIELDS;
+        s_td_needs_draw = true;
+    } else if (ev->id == BTN_A || ev->id == BTN_START) {
+        /* Apply the new time */
+        struct tm new_time = {0};
+        new_time.tm_hour = s_td_fields[TD_FIELD_HOUR];
+        new_time.tm_min  = s_td_fields[TD_FIELD_MIN];
+        new_time.tm_sec  = 0;
+        new_time.tm_year = s_td_fields[TD_FIELD_YEAR] - 1900;
+        new_time.tm_mon  = s_td_fields[TD_FIELD_MON] - 1;
+        new_time.tm_mday = s_td_fields[TD_FIELD_DAY];
+        new_time.tm_isdst = -1;
+        time_t t = mktime(&new_time);
+        struct timeval tv = { .tv_sec = t, .tv_usec = 0 };
+        settimeofday(&tv, NULL);
+        ESP_LOGI(TAG, "System time set to %04d-%02d-%02d %02d:%02d",
+                 s_td_fields[TD_FIELD_YEAR], s_td_fields[TD_FIELD_MON],
+                 s_td_fields[TD_FIELD_DAY], s_td_fields[TD_FIELD_HOUR],
+                 s_td_fields[TD_FIELD_MIN]);
+        /* Reset idle screen so it picks up the new time */
+        idle_screen_reset();
+        app_registry_exit();
+    } else if (ev->id == BTN_B) {
+        ESP_LOGI(TAG, "Time/date setting cancelled");
+        app_registry_exit();
+    }
 }
 
 /* ── LED task ────────────────────────────────────────────────────────────── */
 /*
- * DISOBEY identity palette: magenta/pink, white, black.
- * 8 LEDs: 4 magenta alternating with 4 white, fading in/out.
+ * Every mode except VU and beat is a led_fx effect (components/led_fx);
+ * the task evaluates the active one at a fixed LED_FX_TICK_MS rate.  VU
+ * and beat stay in code because they are driven by the microphone rather
+ * than by time.
  */
-#define IDENTITY_STEPS 64
-static const sk6812_color_t DISOBEY_A = {255,  0, 200};  /* hot magenta */
-static const sk6812_color_t DISOBEY_B = {255,255, 255};  /* white       */
+static const char *const LED_MODE_FX[LED_MODE_COUNT] = {
+    [LED_MODE_RED]        = "red",
+    [LED_MODE_GREEN]      = "green",
+    [LED_MODE_BLUE]       = "blue",
+    [LED_MODE_RAINBOW]    = "rainbow",
+    [LED_MODE_IDENTITY]   = "identity",
+    [LED_MODE_ACCENT]     = "accent",
+    [LED_MODE_DISCO]      = "disco",
+    [LED_MODE_POLICE]     = "police",
+    [LED_MODE_RELAX]      = "relax",
+    [LED_MODE_ROTATE]     = "rotate",
+    [LED_MODE_CHASE]      = "chase",
+    [LED_MODE_MORPH]      = "morph",
+    [LED_MODE_BREATH_CYC] = "breath_cycle",
+    [LED_MODE_FLAME]      = "flame",
+};
 
-static void led_task(void *arg) {
-    (void)arg;
-    uint32_t phase = 0;
+/* Accent colour setting (RGB565) expanded to RGB888 */
+static sk6812_color_t accent_rgb(void) {
+    uint16_t c16 = settings_get_accent_color();
+    uint8_t r5 = (c16 >> 11) & 0x1F;
+    uint8_t g6 = (c16 >> 5)  & 0x3F;
+    uint8_t b5 = c16 & 0x1F;
+    return (sk6812_color_t){
+        (uint8_t)((r5 << 3) | (r5 >> 2)),
+        (uint8_t)((g6 << 2) | (g6 >> 4)),
+        (uint8_t)((b5 << 3) | (b5 >> 2))
+    };
+}
 
-    while (1) {
-        led_mode_t mode = (led_mode_t)atomic_load(&g_led_mode);
+/* Simple VU meter visualizing mic level into two 6-LED bars (base layer):
+ * the left bar shows the bass band, the right bar mids and treble.
+ * Subscribes to the shared audio stream while the mode is active; never
+ * waits for audio, so the LED tick is unaffected. */
+#define VU_SPLIT_HZ     500
+#define VU_FLOOR_DB     (-50)   /* 0 LEDs at or below */
+#define VU_DB_PER_LED   3
+
+static audio_sub_t g_vu_sub;
+
+static void led_vu_update(uint32_t tick) {
+    static audio_block_t block; // Move off stack
+    static float work[AUDIO_FFT_SIZE];
+    static float power[AUDIO_FREQ_BINS];
+    static audio_band_map_t bands;
+    static uint32_t last_log = 0;
+    const audio_fft_plan_t *plan = audio_block_plan();
+
+    if (!plan) return;
+    if (!bands.count) {
+        static const uint16_t edges[] = { 20, VU_SPLIT_HZ, 20000 };
+        audio_bands_build_custom(&bands, edges, 2, AUDIO_FFT_SIZE);
+    }
+    if (!g_vu_sub.active) audio_stream_subscribe(&g_vu_sub);
 
-        switch (mode) {
-        case LED_MODE_OFF:
-            sk6812_clear();
-            vTaskDelay(pdMS_TO_TICKS(100));
-            break;
+    /* Average band power over every block since the last tick */
+    float sum[2] = { 0 }, band[2];
+    int n = 0;
+    while (audio_stream_read(&g_vu_sub, &block, 0)) {
+        audio_fft_power(plan, block.samples, work, power);
+        audio_bands_aggregate(&bands, power, band);
+        sum[0] += band[0];
+        sum[1] += band[1];
+        n++;
+    }
+    if (n == 0) return;
+
+    int level[2];
+    for (int b = 0; b < 2; b++) {
+        int db = (int)audio_bands_dbfs(&bands, sum[b] / n);
+        level[b] = (db - VU_FLOOR_DB) / VU_DB_PER_LED;
+        if (level[b] < 0) level[b] = 0;
+        if (level[b] > 6) level[b] = 6;
+    }
 
-        case LED_MODE_RED:
-            sk6812_fill(sk6812_scale(SK6812_RED, 40));
-            sk6812_show();
-            vTaskDelay(pdMS_TO_TICKS(100));
-            break;
+    if (tick - last_log > 50) {
+        ESP_LOGD("VU", "Bass %d / treble %d LEDs", level[0], level[1]);
+        last_log = tick;
+    }
 
-        case LED_MODE_GREEN:
-            sk6812_fill(sk6812_scale(SK6812_GREEN, 40));
-            sk6812_show();
-            vTaskDelay(pdMS_TO_TICKS(100));
-            break;
+    led_comp_fill(LED_LAYER_BASE, LED_COMP_ALL, SK6812_BLACK,
+                  LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
+    for (int i = 0; i < 6; i++) {
+        sk6812_color_t color;
+        if (i < 3)      color = SK6812_GREEN;
+        else if (i < 5) color = (sk6812_color_t){140, 100, 0}; // Orange
+        else            color = SK6812_RED;
 
-        case LED_MODE_BLUE:
-            sk6812_fill(sk6812_scale(SK6812_BLUE, 40));
-            sk6812_show();
-            vTaskDelay(pdMS_TO_TICKS(100));
-            break;
+        if (i < level[0]) led_comp_set_pixel(LED_LAYER_BASE, i, sk6812_scale(color, 151));
+        if (i < level[1]) led_comp_set_pixel(LED_LAYER_BASE, i + 6, sk6812_scale(color, 151));
+    }
+}
 
-        case LED_MODE_RAINBOW:
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                sk6812_set(i, sk6812_scale(wheel((i * 32 + phase) & 0xFF), 127));
-            }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(30));
-            break;
+/* Beat pulse: every LED flashes the accent colour on each beat from the
+ * shared beat tracker and fades out over the beat (over 500 ms until a
+ * tempo is locked), down to a dim glow.  The tracker runs while the mode
+ * is active.  Starting and stopping it can block (audio init, task
+ * creation, waiting for the old task to exit), so led_task only records
+ * what it wants and notifies beat_ctl, which does the blocking work and
+ * waits BEAT_RETRY_MS after a failed start before trying again. */
+#define BEAT_FLOOR      16      /* Brightness between beats */
+#define BEAT_RETRY_MS   5000
+
+static atomic_bool  g_beat_want;        /* Written by led_task */
+static TaskHandle_t g_beat_ctl_handle = NULL;
+
+/* Bring the tracker to the state led_task asked for */
+static void beat_ctl_task(void *arg) {
+    (void)arg;
+    bool on = false;
 
-        case LED_MODE_IDENTITY: {
-            /* 
-             * DISOBEY Dynamic Identity:
-             * Cycles through 4 sub-animations every ~5 seconds.
-             */
-            uint16_t sub_phase = (uint16_t)(phase & 1023);
-            uint8_t sub_mode   = (sub_phase >> 8);  /* 0, 1, 2, or 3 */
-            uint8_t t8         = (uint8_t)(sub_phase & 0xFF);
-
-            if (sub_mode == 0) {
-                /* Sub-mode 0: Breathing alternating colors (classic) */
-                float t = (sinf((float)t8 * 0.05f) + 1.0f) / 2.0f;
-                uint8_t bri = (uint8_t)(t * 50.0f + 10.0f);
-                for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                    sk6812_color_t c = (i % 2 == 0) ? DISOBEY_A : DISOBEY_B;
-                    sk6812_set(i, sk6812_scale(c, bri));
-                }
-            } else if (sub_mode == 1) {
-                /* Sub-mode 1: Rotating Magenta block on White background */
-                uint8_t p = (t8 / 16) % SK6812_LED_COUNT;
-                for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                    if (i == p) {
-                        sk6812_set(i, sk6812_scale(DISOBEY_A, 60));
-                    } else {
-                        sk6812_set(i, sk6812_scale(DISOBEY_B, 20));
-                    }
-                }
-            } else if (sub_mode == 2) {
-                /* Sub-mode 2: Disobey Scanner (Magenta scanner) */
-                int pos = (t8 / 10) % (SK6812_LED_COUNT * 2);
-                if (pos >= SK6812_LED_COUNT) pos = (SK6812_LED_COUNT * 2 - 1) - pos;
-                for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                    if (i == pos) {
-                        sk6812_set(i, sk6812_scale(DISOBEY_A, 60));
-                    } else {
-                        sk6812_set(i, sk6812_scale(DISOBEY_B, 10));
-                    }
-                }
-            } else {
-                /* Sub-mode 3: Stroboscopic Magenta/White swap (alternating sides) */
-                bool flip = (t8 % 20 < 10);
-                uint8_t half = SK6812_LED_COUNT / 2;
-                for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                    if (i < half) {
-                        sk6812_set(i, sk6812_scale(flip ? DISOBEY_A : DISOBEY_B, 50));
-                    } else {
-                        sk6812_set(i, sk6812_scale(flip ? DISOBEY_B : DISOBEY_A, 50));
-                    }
-                }
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bool want = atomic_load(&g_beat_want);
+        if (want && !on) {
+            on = audio_beat_start();
+            if (!on) {
+                ESP_LOGW(TAG, "Beat tracker did not start, retrying in %d s", BEAT_RETRY_MS / 1000);
+                vTaskDelay(pdMS_TO_TICKS(BEAT_RETRY_MS));
+                xTaskNotifyGive(xTaskGetCurrentTaskHandle());   /* Check again */
             }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(20));
-            break;
+        } else if (!want && on) {
+            audio_beat_stop();
+            on = false;
         }
+    }
+}
 
-        case LED_MODE_ACCENT: {
-            /* Breathing effect with the selected accent color (wide swing) */
-            uint16_t c16 = settings_get_accent_color();
-            /* Convert RGB565 to RGB888 base color */
-            uint8_t r5 = (c16 >> 11) & 0x1F;
-            uint8_t g6 = (c16 >> 5)  & 0x3F;
-            uint8_t b5 = c16 & 0x1F;
-            sk6812_color_t base = {
-                (uint8_t)((r5 << 3) | (r5 >> 2)),
-                (uint8_t)((g6 << 2) | (g6 >> 4)),
-                (uint8_t)((b5 << 3) | (b5 >> 2))
-            };
-
-            /* Sine breathing: (sin(t) + 1) / 2 */
-            float s = (sinf((float)phase * 0.05f) + 1.0f) / 2.0f;
-            /* Wide swing: 1 to 90 brightness (approx half of previous max) */
-            uint8_t bri = (uint8_t)(s * 89.0f + 1.0f);
-            
-            sk6812_fill(sk6812_scale(base, bri));
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(30));
-            break;
-        }
+static void led_beat_sync(bool want) {
+    if (atomic_exchange(&g_beat_want, want) != want && g_beat_ctl_handle) {
+        xTaskNotifyGive(g_beat_ctl_handle);
+    }
+}
 
-        case LED_MODE_DISCO: {
-            /* Rapid flashing and random colors / patterns (disco style) */
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                if (((phase >> 1) + i) % 3 == 0) {
-                    sk6812_set(i, sk6812_scale(wheel((phase * 16 + i * 16) & 0xFF), 127));
-                } else {
-                    sk6812_set(i, SK6812_BLACK);
-                }
-            }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(60));
-            break;
+static void led_beat_update(void) {
+    audio_beat_state_t beat;
+    audio_beat_get(&beat);
+    float fade  = 1.0f - audio_beat_phase(&beat, esp_timer_get_time());
+    uint8_t lvl = (uint8_t)(BEAT_FLOOR + (255 - BEAT_FLOOR) * fade * fade);
+
+    led_comp_fill(LED_LAYER_BASE, LED_COMP_ALL, sk6812_scale(accent_rgb(), lvl),
+                  LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
+}
+
+/* Apply LED commands queued by badge.leds.set()/fill() to the app layer */
+static void led_drain_python(void) {
+    mp_led_cmd_t cmd;
+    while (mp_bridge_recv_led_cmd(&cmd, 0) == ESP_OK) {
+        sk6812_color_t c = { cmd.r, cmd.g, cmd.b };
+        if (cmd.index == 0xFF) {
+            led_comp_fill(LED_LAYER_APP, LED_COMP_ALL, c,
+                          LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
+        } else {
+            led_comp_set_pixel(LED_LAYER_APP, cmd.index, c);
         }
+    }
+}
 
-        case LED_MODE_POLICE: {
-            /* Alternating red/blue strobes on sides (disco house look) */
-            uint8_t half = SK6812_LED_COUNT / 2;
-            bool left_on = (phase % 10 < 5);
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                if (i < half) {
-                    sk6812_set(i, left_on ? sk6812_scale(SK6812_RED, 127)   : SK6812_BLACK);
-                } else {
-                    sk6812_set(i, left_on ? SK6812_BLACK : sk6812_scale(SK6812_BLUE, 127));
-                }
-            }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(80));
-            break;
+/* ── LED tick ────────────────────────────────────────────────────────────── */
+/*
+ * A periodic esp_timer wakes led_task every LED_FX_TICK_MS.  The period is
+ * held by the hardware timer rather than by "delay after work", and effect
+ * phase comes from anim_clock_ms(), so a slow frame (busy CPU, long
+ * compose) is simply dropped without changing animation speed.
+ */
+static TaskHandle_t g_led_task_handle = NULL;
+static uint32_t     g_led_ticks_missed = 0;
+
+static void led_tick_cb(void *arg) {
+    (void)arg;
+    xTaskNotifyGive(g_led_task_handle);
+}
+
+static void led_task(void *arg) {
+    (void)arg;
+    static const led_fx_t *mode_fx[LED_MODE_COUNT];
+    led_fx_player_t player = { 0 };
+    const led_fx_t *playing = NULL;
+    sk6812_color16_t frame[SK6812_LED_COUNT];
+    uint32_t        tick = 0;
+    uint32_t        last_report = 0;
+
+    for (int m = 0; m < LED_MODE_COUNT; m++) {
+        if (LED_MODE_FX[m]) mode_fx[m] = led_fx_find(LED_MODE_FX[m]);
+    }
+
+    g_led_task_handle = xTaskGetCurrentTaskHandle();
+    const esp_timer_create_args_t tick_args = {
+        .callback = led_tick_cb,
+        .name     = "led_tick",
+    };
+    esp_timer_handle_t tick_timer;
+    ESP_ERROR_CHECK(esp_timer_create(&tick_args, &tick_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer, LED_FX_TICK_MS * 1000));
+
+    while (1) {
+        /* Notifications from ticks that fired while we were busy collapse
+         * into the count; those frames are skipped, not replayed */
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (ticks > 1) g_led_ticks_missed += ticks - 1;
+        uint32_t now_ms = anim_clock_ms();
+
+        /* Python asked for a custom effect */
+        int req = led_fx_take_request();
+        if (req >= 0) {
+            atomic_store(&g_led_custom, req);
+            atomic_store(&g_led_mode, LED_MODE_CUSTOM);
         }
 
-        case LED_MODE_RELAX: {
-            /* Slow, smooth smooth pulse transitions between relaxing colors */
-            float s = (sinf((float)phase * 0.02f) + 1.0f) / 2.0f;
-            sk6812_color_t color1 = {100, 0, 150}; // Mauve/Purple
-            sk6812_color_t color2 = {0, 150, 120}; // Teal/Green
-            sk6812_color_t blend = {
-                (uint8_t)(color1.r * (1.0f - s) + color2.r * s),
-                (uint8_t)(color1.g * (1.0f - s) + color2.g * s),
-                (uint8_t)(color1.b * (1.0f - s) + color2.b * s)
-            };
-            sk6812_fill(sk6812_scale(blend, 25)); // Even gentler (half of 50)
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(50));
-            break;
+        led_mode_t mode = (led_mode_t)atomic_load(&g_led_mode);
+        const led_fx_t *fx = mode_fx[mode];
+        if (mode == LED_MODE_CUSTOM) {
+            fx = led_fx_custom_hold((size_t)atomic_load(&g_led_custom));
+        } else {
+            led_fx_custom_release();
         }
 
-        case LED_MODE_ROTATE: {
-            /* Rotating block of color */
-            uint8_t p = (phase / 4) % SK6812_LED_COUNT;
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                uint8_t dist = (i >= p) ? (i - p) : (SK6812_LED_COUNT + i - p);
-                if (dist < 3) {
-                    sk6812_set(i, sk6812_scale(wheel((phase * 4) & 0xFF), (3 - dist) * 30));
-                } else {
-                    sk6812_set(i, SK6812_BLACK);
-                }
+        /* Base layer: the user's LED mode */
+        if (mode != LED_MODE_VU && g_vu_sub.active) audio_stream_unsubscribe(&g_vu_sub);
+        led_beat_sync(mode == LED_MODE_BEAT);
+
+        if (mode == LED_MODE_VU) {
+            playing = NULL;
+            led_vu_update(tick);
+        } else if (mode == LED_MODE_BEAT) {
+            playing = NULL;
+            led_beat_update();
+        } else if (fx) {
+            if (fx != playing) {
+                led_fx_player_start(&player, fx, now_ms);
+                playing = fx;
             }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(40));
-            break;
+            led_fx_player_render(&player, now_ms, accent_rgb(), frame);
+            led_comp_set(LED_LAYER_BASE, frame, LED_BLEND_REPLACE,
+                         LED_COMP_OPAQUE, LED_COMP_FOREVER);
+        } else {
+            /* Off (or a custom slot that is gone) */
+            playing = NULL;
+            led_comp_release(LED_LAYER_BASE);
         }
 
-        case LED_MODE_CHASE: {
-            /* Single bright LED chasing with a tail */
-            uint8_t pos = phase % SK6812_LED_COUNT;
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                if (i == pos) {
-                    sk6812_set(i, sk6812_scale(SK6812_WHITE, 100));
-                } else {
-                    /* dim tail */
-                    uint8_t prev = (pos + SK6812_LED_COUNT - 1) % SK6812_LED_COUNT;
-                    uint8_t pprev = (pos + SK6812_LED_COUNT - 2) % SK6812_LED_COUNT;
-                    if (i == prev) sk6812_set(i, sk6812_scale(SK6812_BLUE, 50));
-                    else if (i == pprev) sk6812_set(i, sk6812_scale(SK6812_BLUE, 20));
-                    else sk6812_set(i, SK6812_BLACK);
-                }
-            }
+        led_drain_python();
+
+        /* The only sk6812_show() in the firmware; skipped if nothing changed */
+        if (led_comp_compose(frame)) {
+            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) sk6812_set16(i, frame[i]);
             sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(60));
-            break;
         }
 
-        case LED_MODE_MORPH: {
-            /* Super slow hue morph of everything at once */
-            sk6812_color_t color = sk6812_scale(wheel(phase), 40);
-            sk6812_fill(color);
-            sk6812_show();
-            if ((phase % 4) == 0) phase++; /* Slower update */
-            vTaskDelay(pdMS_TO_TICKS(100));
-            break;
+        if (g_led_ticks_missed && now_ms - last_report > 10000) {
+            ESP_LOGW(TAG, "LED tick: %lu frame(s) skipped", (unsigned long)g_led_ticks_missed);
+            g_led_ticks_missed = 0;
+            last_report = now_ms;
         }
 
-        case LED_MODE_BREATH_CYC: {
-            /* Breathing with color cycling */
-            float s = (sinf((float)phase * 0.05f) + 1.0f) / 2.0f;
-            uint8_t bri = (uint8_t)(s * 80.0f + 5.0f);
-            sk6812_fill(sk6812_scale(wheel(phase * 2), bri));
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(30));
-            break;
+        tick += ticks;
+    }
+}
+
+/* ── Game sessions ───────────────────────────────────────────────────────── */
+/*
+ * Games run in the display task, one step per frame, and see the buttons
+ * through their session: live, recorded to a trace, or played back from
+ * one (game_replay.h).  The session seeds game_rng before the game's init,
+ * so a trace replays the same game on the badge and in the headless host
+ * build (`make game_replay_check`).  Display task only.
+ */
+typedef struct {
+    app_state_t   app;          /* APP_STATE_COUNT = no game running */
+    game_replay_t rp;
+    bool          replaying;    /* Trace not checked yet */
+    uint32_t      snake_last_ms;
+    bool          snake_stepped;  /* Snake moved this frame */
+    bool          over_drawn;     /* Game-over frame is on the panel */
+    int64_t       step_us;      /* Start of the frame being stepped, 0 = none */
+    uint64_t      cost_sum_us;  /* Update + draw time per stepped frame */
+    uint32_t      cost_max_us;
+    uint32_t      cost_n;
+} game_session_t;
+
+static game_session_t s_game = { .app = APP_STATE_COUNT };
+static atomic_bool    s_game_over;  /* Read by input_task */
+
+/* Per-game hooks, the app descriptor's ctx (see GAME_APP) */
+typedef struct {
+    void     (*init)(void);     /* Called once game_rng is seeded */
+    uint32_t (*score)(void);
+    bool       any_key_over;    /* Game-over screen says "Press any key" */
+} game_hooks_t;
+
+static const game_hooks_t *game_hooks(app_state_t state) {
+    const app_desc_t *app = app_registry_get(state);
+    return app ? app->ctx : NULL;
+}
+
+static uint32_t game_score(void) {
+    return game_hooks(s_game.app)->score();
+}
+
+/* Compare a finished replay with its recording, then continue live */
+static void game_session_check(void) {
+    game_replay_t *rp = &s_game.rp;
+    uint32_t score = game_score();
+    bool same = rp->has_end && rp->frame == rp->end_frames && score == rp->end_score;
+    if (rp->has_end) {
+        ESP_LOGI(TAG, "Replay %s: %lu frames, score %lu; recorded %lu frames, score %lu: %s",
+                 rp->game, (unsigned long)rp->frame, (unsigned long)score,
+                 (unsigned long)rp->end_frames, (unsigned long)rp->end_score,
+                 same ? "matched" : "DIVERGED");
+    } else {
+        ESP_LOGW(TAG, "Replay %s: trace has no end line (%lu frames, score %lu)",
+                 rp->game, (unsigned long)rp->frame, (unsigned long)score);
+    }
+    fclose(rp->f);
+    rp->f = NULL;               /* Live from here on */
+    s_game.replaying = false;
+}
+
+/* A game screen was entered: open its trace, seed, init */
+static void game_session_begin(app_state_t state) {
+    const app_desc_t *app = app_registry_get(state);
+    const char *name = app->name;       /* Trace name, as in the host build */
+    game_trace_t mode = atomic_load(&g_game_trace);
+    uint16_t fps = app->frame.target_fps;
+    uint32_t seed = esp_random();
+    char path[48];
+    snprintf(path, sizeof(path), PYAPPS_MOUNT_POINT "/replay/%s.csv", name);
+
+    memset(&s_game, 0, sizeof(s_game));
+    s_game.app = state;
+
+    FILE *f = NULL;
+    if (mode == GAME_TRACE_REPLAY) {
+        f = pyapps_fs_is_mounted() ? fopen(path, "r") : NULL;
+        if (f && game_replay_open(&s_game.rp, f)) {
+            seed = s_game.rp.seed;
+            s_game.replaying = true;
+            ESP_LOGI(TAG, "Replaying %s (seed 0x%08lx)", path, (unsigned long)seed);
+        } else {
+            ESP_LOGW(TAG, "No trace at %s, playing live", path);
+            if (f) fclose(f);
+            game_replay_live(&s_game.rp, name, seed, fps);
+        }
+    } else if (mode == GAME_TRACE_RECORD) {
+        /* Without the FAT partition the trace goes to the serial console */
+        if (pyapps_fs_is_mounted()) {
+            mkdir(PYAPPS_MOUNT_POINT "/replay", 0755);
+            f = fopen(path, "w");
         }
+        if (!f) f = stdout;
+        game_replay_record(&s_game.rp, f, name, seed, fps);
+        ESP_LOGI(TAG, "Recording %s to %s", name, f == stdout ? "serial" : path);
+    } else {
+        game_replay_live(&s_game.rp, name, seed, fps);
+    }
 
-        case LED_MODE_FLAME: {
-            /* Better flame: bright core at bottom, flickering dimming tops, relaxed movement */
-            for (uint8_t i = 0; i < SK6812_LED_COUNT; i++) {
-                uint8_t v_pos = i % 6; // Assume 0 is bottom, 5 is top for each bar
-                
-                /* 1. Base intensity: fades out as we go up */
-                float base = 1.0f - ((float)v_pos * 0.15f); // 1.0, 0.85, 0.7... 0.25
-                
-                /* 2. Slow 'draft' effect using sine for organic sway */
-                float draft = (sinf((float)phase * 0.04f + (float)v_pos * 0.3f) + 1.0f) * 0.12f;
-                
-                /* 3. High-frequency flicker: becomes dominant and 'unstable' at the tips */
-                float instability = (float)(rand() % 100) / 100.0f;
-                float flicker_amt = instability * (0.05f + (float)v_pos * 0.12f);
-                
-                float intensity = base + draft - flicker_amt;
-                if (intensity < 0.05f) intensity = 0.0f; // Allow tips to fully extinguish
-                if (intensity > 1.0f)  intensity = 1.0f;
-
-                uint8_t h = (uint8_t)(intensity * 100.0f);
-                
-                /* Color mapping: 
-                   - Hot (high intensity): Orange/Yellow
-                   - Cooling (mid/low): Deep Red
-                   - Coolest (bottom/random): Dim Red or Off */
-                sk6812_color_t fire;
-                fire.r = h;
-                fire.g = (h > 35) ? (h - 35) : 0; // Greener (more orange) when hotter
-                fire.b = (h > 85) ? (h - 85) : 0; // Touches of white at the very core
-                
-                sk6812_set(i, sk6812_scale(fire, 60));
-            }
-            sk6812_show();
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(50)); // Relaxed update rate (20 FPS)
-            break;
+    game_rng_seed(seed);
+    game_hooks(state)->init();
+}
+
+/* The game screen was left: close the trace, report the frame cost */
+static void game_session_end(void) {
+    game_replay_t *rp = &s_game.rp;
+    ESP_LOGI(TAG, "Exiting %s (final score: %lu)", rp->game,
+             (unsigned long)game_score());
+    if (s_game.replaying) {
+        game_session_check();           /* Game ended before the trace did */
+    } else if (rp->f) {
+        game_replay_finish(rp, game_score());
+        if (rp->f != stdout) fclose(rp->f);
+        rp->f = NULL;
+    }
+    if (s_game.cost_n) {
+        ESP_LOGI(TAG, "%s: %lu frames, update+draw avg %lu us, max %lu us", rp->game,
+                 (unsigned long)s_game.cost_n,
+                 (unsigned long)(s_game.cost_sum_us / s_game.cost_n),
+                 (unsigned long)s_game.cost_max_us);
+    }
+    s_game.app = APP_STATE_COUNT;
+}
+
+/* Buttons the game sees on this frame (call once per stepped frame) */
+static uint16_t game_session_input(void) {
+    if (s_game.replaying && game_replay_done(&s_game.rp)) {
+        game_session_check();           /* Previous frame was the last */
+    }
+    s_game.step_us = esp_timer_get_time();
+    return game_replay_step(&s_game.rp, buttons_get_state());
+}
+
+/* Frame of a game finished: account its update + draw time */
+static void game_session_frame_end(void) {
+    if (!s_game.step_us) return;
+    uint32_t us = (uint32_t)(esp_timer_get_time() - s_game.step_us);
+    s_game.step_us = 0;
+    s_game.cost_sum_us += us;
+    if (us > s_game.cost_max_us) s_game.cost_max_us = us;
+    s_game.cost_n++;
+}
+
+/* ── Game apps ───────────────────────────────────────────────────────────── */
+/* B quits; START pauses; a game that says "Press any key" exits on any */
+static void game_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    app_state_t state = (app_state_t)app_registry_current();
+    bool over = atomic_load(&s_game_over);
+    bool any_key = over && game_hooks(state)->any_key_over;
+    if (ev->id == BTN_B || any_key) {
+        app_registry_exit();
+    } else if (ev->id == BTN_START && !over) {
+        app_registry_pause(!app_registry_paused());
+    }
+}
+
+static void game_app_init(void) {
+    atomic_store(&s_game_over, false);
+    game_session_begin((app_state_t)app_registry_running());
+}
+
+static void game_app_exit(void) {
+    game_session_end();
+    led_comp_release(LED_LAYER_APP);
+}
+
+/* Paused: the last frame stays on the panel, the LEDs dim to the accent */
+static void game_app_suspend(void) {
+    led_comp_fill(LED_LAYER_APP, LED_COMP_ALL, sk6812_scale(accent_rgb(), 40),
+                  LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
+}
+
+static void game_app_resume(void) {
+    led_comp_release(LED_LAYER_APP);
+}
+
+/* Game-over frame: games that end draw once more, then stay still */
+static bool game_app_final_frame(void) {
+    if (!atomic_load(&s_game_over)) return true;
+    if (s_game.over_drawn) return false;
+    s_game.over_drawn = true;
+    return true;
+}
+
+static void hacky_bird_app_update(void) {
+    if (atomic_load(&s_game_over)) return;
+    /* Check if flap button is currently pressed */
+    uint16_t in = game_session_input();
+    hacky_bird_update(in & (BTN_MASK(BTN_A) | BTN_MASK(BTN_STICK)));
+    if (!hacky_bird_is_active()) atomic_store(&s_game_over, true);
+}
+
+static bool hacky_bird_app_render(void) {
+    if (!game_app_final_frame()) return false;
+    if (!atomic_load(&s_game_over)) {
+        hacky_bird_draw();
+        return true;
+    }
+
+    /* Draw game over screen */
+    uint16_t score = hacky_bird_get_score();
+    st7789_fill(0x5D1F);  // Sky blue
+    st7789_draw_string(SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT/2 - 30,
+                     "GAME OVER", 0xFFFF, 0x5D1F, 2);
+
+    char score_str[32];
+    snprintf(score_str, sizeof(score_str), "Score: %d", score);
+    st7789_draw_string(SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT/2,
+                     score_str, 0xFFFF, 0x5D1F, 2);
+
+    st7789_draw_string(SCREEN_WIDTH/2 - 70, SCREEN_HEIGHT/2 + 30,
+                     "Press any key", 0xFFFF, 0x5D1F, 1);
+    return true;
+}
+
+static void space_shooter_app_update(void) {
+    /* Get button states */
+    uint16_t in = game_session_input();
+    bool move_left = in & (BTN_MASK(BTN_LEFT) | BTN_MASK(BTN_STICK));
+    bool move_right = in & BTN_MASK(BTN_RIGHT);
+    bool shoot = in & BTN_MASK(BTN_A);
+    space_shooter_update(move_left, move_right, shoot);
+}
+
+static bool space_shooter_app_render(void) {
+    space_shooter_draw();
+    return true;
+}
+
+/* Snake: variable speed on the session clock (frames), so a replay moves
+ * on the same frames as its recording; input is checked at 60 FPS */
+static void snake_app_update(void) {
+    uint16_t in = game_session_input();
+    uint32_t now = game_replay_time_ms(&s_game.rp);
+    s_game.snake_stepped = (now - s_game.snake_last_ms >= snake_get_speed_delay());
+    if (!s_game.snake_stepped) return;
+
+    /* Handle direction input */
+    if (in & BTN_MASK(BTN_UP)) {
+        snake_set_direction(SNAKE_DIR_UP);
+    } else if (in & BTN_MASK(BTN_DOWN)) {
+        snake_set_direction(SNAKE_DIR_DOWN);
+    } else if (in & BTN_MASK(BTN_LEFT)) {
+        snake_set_direction(SNAKE_DIR_LEFT);
+    } else if (in & BTN_MASK(BTN_RIGHT)) {
+        snake_set_direction(SNAKE_DIR_RIGHT);
+    }
+
+    snake_update();
+
+    /* LED effect when food is eaten */
+    if (snake_ate_food_this_frame()) {
+        // Flash green on all LEDs briefly (expires by itself)
+        led_comp_flash((sk6812_color_t){0, 255, 0}, 50);
+    }
+    s_game.snake_last_ms = now;
+}
+
+static bool snake_app_render(void) {
+    if (!s_game.snake_stepped) return false;
+    snake_draw();
+    return true;
+}
+
+static void pong_app_update(void) {
+    if (atomic_load(&s_game_over)) return;
+    uint16_t in = game_session_input();
+    pong_update(in & BTN_MASK(BTN_UP), in & BTN_MASK(BTN_DOWN));
+
+    if (!pong_is_active()) {
+        atomic_store(&s_game_over, true);
+        /* Red/green flash on game end */
+        sk6812_color_t c = (pong_get_score() >= 7)
+            ? (sk6812_color_t){0, 255, 0}
+            : (sk6812_color_t){255, 0, 0};
+        led_comp_flash(c, 80);
+    } else if (pong_scored_this_frame()) {
+        /* Brief accent-colour flash on the side LEDs */
+        led_comp_flash(sk6812_scale(accent_rgb(), 167), 40);
+    }
+}
+
+static bool pong_app_render(void) {
+    if (!game_app_final_frame()) return false;
+    pong_draw();
+    return true;
+}
+
+static void archanoid_app_update(void) {
+    if (atomic_load(&s_game_over)) return;
+    uint16_t in = game_session_input();
+    bool left   = in & BTN_MASK(BTN_LEFT);
+    bool right  = in & BTN_MASK(BTN_RIGHT);
+    bool launch = in & (BTN_MASK(BTN_A) | BTN_MASK(BTN_STICK));
+
+    archanoid_update(left, right, launch);
+
+    if (!archanoid_is_active()) {
+        atomic_store(&s_game_over, true);
+        /* Flash LEDs on game end */
+        sk6812_color_t c = (archanoid_get_score() > 0)
+            ? (sk6812_color_t){0, 0, 255}
+            : (sk6812_color_t){255, 0, 0};
+        led_comp_flash(c, 80);
+    } else if (archanoid_hit_brick_this_frame()) {
+        /* Rainbow flash — cycle colour with score */
+        uint8_t hue = (uint8_t)(archanoid_get_score() * 3);
+        sk6812_color_t brick_c;
+        if (hue < 85) {
+            brick_c = (sk6812_color_t){ (uint8_t)(255 - hue * 3), (uint8_t)(hue * 3), 0 };
+        } else if (hue < 170) {
+            uint8_t h = hue - 85;
+            brick_c = (sk6812_color_t){ 0, (uint8_t)(255 - h * 3), (uint8_t)(h * 3) };
+        } else {
+            uint8_t h = hue - 170;
+            brick_c = (sk6812_color_t){ (uint8_t)(h * 3), 0, (uint8_t)(255 - h * 3) };
         }
+        led_comp_flash(sk6812_scale(brick_c, 180), 30);
+    }
+}
 
-        case LED_MODE_VU: {
-            /* Simple VU meter visualizing mic level into two 6-LED bars */
-            static audio_sample_t samples[AUDIO_FFT_SIZE]; // Move off stack
-            size_t n = audio_read_samples(samples);
-            if (n > 0) {
-                /* Calculate RMS level (root mean square) */
-                int64_t sum_sq = 0;
-                for (size_t i = 0; i < n; i++) {
-                    int32_t s = (int32_t)samples[i];
-                    sum_sq += (int64_t)s * s;
-                }
-                float rms = sqrtf((float)sum_sq / (float)n);
-                
-                /* DEBUG: Log the RMS value periodically (integer only to save stack) */
-                static uint32_t last_log = 0;
-                if (phase - last_log > 50) {
-                    ESP_LOGI("VU", "RMS level: %d", (int)rms);
-                    last_log = phase;
-                }
+static bool archanoid_app_render(void) {
+    if (!game_app_final_frame()) return false;
+    archanoid_draw();
+    return true;
+}
 
-                /* Map level to 0-6 LEDs. */
-                int level = (int)((rms - 10.0f) / 100.0f);
-                if (level < 0) level = 0;
-                if (level > 6) level = 6;
-
-                sk6812_clear();
-                for (int i = 0; i < level; i++) {
-                    sk6812_color_t color;
-                    if (i < 3)      color = SK6812_GREEN;
-                    else if (i < 5) color = (sk6812_color_t){140, 100, 0}; // Orange
-                    else            color = SK6812_RED;
-                    
-                    sk6812_set(i, sk6812_scale(color, 80));
-                    sk6812_set(i + 6, sk6812_scale(color, 80));
-                }
-                sk6812_show();
+static void race_condition_app_update(void) {
+    if (atomic_load(&s_game_over)) return;
+    /* Get button states */
+    uint16_t in = game_session_input();
+    bool steer_left  = in & BTN_MASK(BTN_LEFT);
+    bool steer_right = in & BTN_MASK(BTN_RIGHT);
+    bool accelerate  = in & (BTN_MASK(BTN_A) | BTN_MASK(BTN_STICK));
+
+    race_condition_update(steer_left, steer_right, accelerate);
+
+    if (!race_condition_is_active()) {
+        atomic_store(&s_game_over, true);
+
+        /* LEDs red on crash (held until the game exits) */
+        led_comp_fill(LED_LAYER_APP, LED_COMP_ALL, SK6812_RED,
+                      LED_BLEND_REPLACE, LED_COMP_OPAQUE, LED_COMP_FOREVER);
+    } else {
+        /* LED speed indicator: light LEDs proportional to speed */
+        int16_t spd = race_condition_get_speed();
+        int num_lit = spd * 12 / 200;  /* 0..12 LEDs based on speed */
+        if (num_lit > 12) num_lit = 12;
+        for (int i = 0; i < 12; i++) {
+            sk6812_color_t c;
+            if (i < num_lit) {
+                c = (sk6812_color_t){(uint8_t)(20 + i * 5), 0, 0};
+            } else {
+                c = (sk6812_color_t){0, 0, 0};
             }
-            phase++;
-            vTaskDelay(pdMS_TO_TICKS(20));
-            break;
+            led_comp_set_pixel(LED_LAYER_APP, i, c);
         }
+    }
+}
 
-        default:
-            vTaskDelay(pdMS_TO_TICKS(100));
+static bool race_condition_app_render(void) {
+    if (!game_app_final_frame()) return false;
+    race_condition_draw();
+    return true;
+}
+
+/* The framebuffer is only needed while the race runs */
+static void race_condition_app_exit(void) {
+    game_app_exit();
+    race_condition_deinit();
+}
+
+static uint32_t hacky_bird_score(void) {
+    return hacky_bird_get_score();
+}
+
+static const game_hooks_t s_hacky_bird_hooks     = { hacky_bird_init,     hacky_bird_score,          true  };
+static const game_hooks_t s_space_shooter_hooks  = { space_shooter_init,  space_shooter_get_score,   false };
+static const game_hooks_t s_snake_hooks          = { snake_init,          snake_get_score,           false };
+static const game_hooks_t s_pong_hooks           = { pong_init,           pong_get_score,            false };
+static const game_hooks_t s_archanoid_hooks      = { archanoid_init,      archanoid_get_score,       false };
+static const game_hooks_t s_race_condition_hooks = { race_condition_init, race_condition_get_score,  true  };
+
+/* ── Screen apps ─────────────────────────────────────────────────────────── */
+/* Any button except START exits; B too unless @p keep_b */
+static bool any_key_exits(const btn_event_t *ev, bool keep_b) {
+    if (ev->type != BTN_PRESSED || ev->id == BTN_START) return false;
+    return !(keep_b && ev->id == BTN_B);
+}
+
+static void sensor_readout_app_init(void) {
+    sensor_readout_screen_init(&g_sensor_screen);
+}
+
+static bool sensor_readout_app_render(void) {
+    sensor_readout_screen_draw(&g_sensor_screen);
+    return true;
+}
+
+static void sensor_readout_app_input(const btn_event_t *ev) {
+    if (any_key_exits(ev, true)) {
+        ESP_LOGI(TAG, "Exiting sensor readout");
+        app_registry_exit();
+    }
+}
+
+static void signal_strength_app_init(void) {
+    signal_strength_screen_init(&g_signal_screen);
+}
+
+static bool signal_strength_app_render(void) {
+    signal_strength_screen_draw(&g_signal_screen);
+    return true;
+}
+
+static void signal_strength_app_input(const btn_event_t *ev) {
+    if (any_key_exits(ev, true)) {
+        ESP_LOGI(TAG, "Exiting signal strength display");
+        app_registry_exit();
+    }
+}
+
+static void wlan_spectrum_app_init(void) {
+    wlan_spectrum_screen_init(&g_wlan_spectrum_screen);
+    wlan_spectrum_screen_start_scan(&g_wlan_spectrum_screen);
+}
+
+static bool wlan_spectrum_app_render(void) {
+    wlan_spectrum_screen_draw(&g_wlan_spectrum_screen);
+    return true;
+}
+
+/* B or LEFT exits */
+static void wlan_spectrum_app_input(const btn_event_t *ev) {
+    if (ev->type == BTN_PRESSED && (ev->id == BTN_B || ev->id == BTN_LEFT)) {
+        ESP_LOGI(TAG, "Exiting WLAN spectrum analyzer");
+        app_registry_exit();
+    }
+}
+
+static void wlan_list_app_init(void) {
+    wlan_list_screen_init(&g_wlan_list_screen);
+    wlan_list_screen_start_scan(&g_wlan_list_screen);
+}
+
+static bool wlan_list_app_render(void) {
+    wlan_list_screen_draw(&g_wlan_list_screen);
+    return true;
+}
+
+/* UP/DOWN scroll, B or LEFT exits */
+static void wlan_list_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_UP || ev->id == BTN_DOWN) {
+        wlan_list_screen_handle_button(&g_wlan_list_screen, ev->id);
+    } else if (ev->id == BTN_B || ev->id == BTN_LEFT) {
+        ESP_LOGI(TAG, "Exiting WLAN networks list");
+        app_registry_exit();
+    }
+}
+
+/* Sound level meter: the fast level settles in 125 ms */
+static bool sound_level_app_render(void) {
+    return audio_spl_screen_draw();
+}
+
+static void sound_level_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_SELECT || ev->id == BTN_STICK) {
+        /* SELECT / stick: A → C → Z weighting */
+        audio_spl_screen_cycle_weighting();
+    } else if (ev->id == BTN_LEFT || ev->id == BTN_RIGHT) {
+        /* LEFT/RIGHT: fast / slow reading */
+        audio_spl_screen_toggle_speed();
+    } else if (ev->id == BTN_START) {
+        /* START: restart Leq and max */
+        audio_spl_reset();
+    } else if (ev->id == BTN_A || ev->id == BTN_B) {
+        ESP_LOGI(TAG, "Exiting sound level meter");
+        app_registry_exit();
+    }
+}
+
+/* About screen: completely static, drawn once */
+static bool s_about_drawn;
+
+static void about_app_init(void) {
+    s_about_drawn = false;
+}
+
+static bool about_app_render(void) {
+    if (s_about_drawn) return false;    /* static: decays to idle rate */
+    about_screen_draw();
+    s_about_drawn = true;
+    return true;
+}
+
+static void about_app_input(const btn_event_t *ev) {
+    if (any_key_exits(ev, false)) {
+        ESP_LOGI(TAG, "Exiting about screen");
+        app_registry_exit();
+    }
+}
+
+/* Task profiler: snapshots once a second; the CSV export outlives the screen */
+static void task_profiler_app_init(void) {
+    task_prof_screen_init();
+    task_prof_start();
+}
+
+static void task_profiler_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_UP || ev->id == BTN_DOWN) {
+        task_prof_screen_scroll(ev->id == BTN_UP ? -1 : 1);
+    } else if (ev->id == BTN_START) {
+        /* START: CSV to the serial console on / off */
+        task_prof_set_export(!task_prof_exporting());
+    } else if (ev->id == BTN_B || ev->id == BTN_LEFT) {
+        ESP_LOGI(TAG, "Exiting task profiler");
+        app_registry_exit();
+    }
+}
+
+/* Idle: nickname and clock, redrawn only when the time changes */
+static void idle_app_init(void) {
+    idle_screen_reset();
+}
+
+static bool idle_app_render(void) {
+    idle_screen_draw(settings_get_nickname());
+    return false;       /* Not traced: presses here just open the menu */
+}
+
+/* Any button enters the menu */
+static void idle_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    ESP_LOGI(TAG, "Entering menu from idle");
+    app_registry_start(APP_STATE_MENU);
+}
+
+/*
+ * Queue-driven screens (menu, colour select, SAO, schedule) draw in full
+ * when entered, then block on g_disp_queue and redraw once per request
+ * from their on_input.  They are not paced (target_fps 0, see frame_done).
+ */
+static bool s_queue_entered;
+
+static void queue_app_enter(void) {
+    s_queue_entered = true;
+}
+
+/* Next redraw of a queue-driven screen; false if none came within @p ms */
+static bool queue_app_next(uint32_t ms, bool *full) {
+    disp_cmd_t cmd;
+    if (s_queue_entered) {
+        s_queue_entered = false;
+        *full = true;
+        return true;
+    }
+    if (xQueueReceive(g_disp_queue, &cmd, pdMS_TO_TICKS(ms)) != pdTRUE) return false;
+    latency_trace_frame_begin(app_registry_running());  /* Redraw for a new press */
+    *full = (cmd.type == DISP_CMD_REDRAW_FULL);
+    return true;
+}
+
+static bool menu_app_render(void) {
+    bool full;
+    if (!queue_app_next(30, &full)) return false;
+    menu_draw(g_current_menu, full);
+    return true;
+}
+
+/* B, or LEFT in a list, goes back to the parent menu or to idle */
+static void menu_back_or_idle(void) {
+    if (menu_back(&g_current_menu)) {
+        ESP_LOGI(TAG, "Navigated back to parent menu");
+        request_redraw(DISP_CMD_REDRAW_FULL);
+    } else {
+        ESP_LOGI(TAG, "Exiting menu to idle screen");
+        app_registry_start(APP_STATE_IDLE);
+    }
+}
+
+static void menu_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    switch (ev->id) {
+    case BTN_UP:
+        menu_navigate_up(g_current_menu);
+        request_redraw(DISP_CMD_REDRAW_ITEM);
+        break;
+
+    case BTN_DOWN:
+        menu_navigate_down(g_current_menu);
+        request_redraw(DISP_CMD_REDRAW_ITEM);
+        break;
+
+    case BTN_LEFT:
+        if (g_current_menu->grid_mode) {
+            /* Grid mode: navigate left within the grid */
+            menu_navigate_left(g_current_menu);
+            request_redraw(DISP_CMD_REDRAW_ITEM);
+        } else {
+            menu_back_or_idle();
+        }
+        break;
+
+    case BTN_RIGHT:
+        if (g_current_menu->grid_mode) {
+            /* Grid mode: navigate right within the grid */
+            menu_navigate_right(g_current_menu);
+            request_redraw(DISP_CMD_REDRAW_ITEM);
+        }
+        /* List mode: no action for RIGHT */
+        break;
+
+    case BTN_B:
+        menu_back_or_idle();
+        break;
+
+    case BTN_A:
+    case BTN_STICK:    /* joystick press also activates */
+    case BTN_SELECT:
+        /* Check for submenu first */
+        if (menu_enter_submenu(&g_current_menu)) {
+            ESP_LOGI(TAG, "Entered submenu");
+            request_redraw(DISP_CMD_REDRAW_FULL);
+        } else {
+            /* No submenu, activate action */
+            menu_select(g_current_menu);
+            request_redraw(DISP_CMD_REDRAW_ITEM);
         }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Colour select: accent and text colour share the screen */
+static void accent_color_app_init(void) {
+    color_select_screen_init(&g_color_screen, settings_get_accent_color(), "Accent Color");
+    queue_app_enter();
+}
+
+static void text_color_app_init(void) {
+    color_select_screen_init(&g_color_screen, settings_get_text_color(), "Text Color");
+    queue_app_enter();
+}
+
+static bool color_select_app_render(void) {
+    bool full;
+    if (!queue_app_next(30, &full)) return false;
+    color_select_screen_draw(&g_color_screen);
+    return true;
+}
+
+/* handle_button processes navigation, confirm (A) and cancel (B)
+ * internally, so the result flags are checked afterwards */
+static void color_select_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    color_select_screen_handle_button(&g_color_screen, ev->id);
+
+    if (color_select_screen_is_cancelled(&g_color_screen)) {
+        ESP_LOGI(TAG, "Exiting color selector (cancelled)");
+        app_registry_exit();
+    } else if (color_select_screen_is_confirmed(&g_color_screen)) {
+        uint16_t color = color_select_screen_get_color(&g_color_screen);
+        if (app_registry_current() == APP_STATE_COLOR_SELECT) {
+            ESP_LOGI(TAG, "Saving new accent color: 0x%04X", color);
+            settings_set_accent_color(color);
+        } else {
+            ESP_LOGI(TAG, "Saving new text color: 0x%04X", color);
+            settings_set_text_color(color);
+        }
+        app_registry_exit();
+    } else {
+        /* Navigation – update selection display */
+        request_redraw(DISP_CMD_REDRAW_ITEM);
+    }
+}
+
+/* SAO EEPROM: static data, redraw only on entry or scroll */
+static void sao_eeprom_app_init(void) {
+    sao_eeprom_screen_init(&g_sao_screen);
+    queue_app_enter();
+}
+
+static bool sao_eeprom_app_render(void) {
+    bool full;
+    if (!queue_app_next(50, &full)) return false;
+    sao_eeprom_screen_draw(&g_sao_screen);
+    return true;
+}
+
+/* UP/DOWN scroll, B or LEFT exits */
+static void sao_eeprom_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_B || ev->id == BTN_LEFT) {
+        ESP_LOGI(TAG, "Exiting SAO EEPROM screen");
+        app_registry_exit();
+    } else if (ev->id == BTN_UP) {
+        sao_eeprom_screen_scroll_up(&g_sao_screen);
+        request_redraw(DISP_CMD_REDRAW_FULL);
+    } else if (ev->id == BTN_DOWN) {
+        sao_eeprom_screen_scroll_down(&g_sao_screen);
+        request_redraw(DISP_CMD_REDRAW_FULL);
     }
 }
 
+/* Event schedule: static data, redraw on entry or navigation */
+static void event_schedule_app_init(void) {
+    event_schedule_screen_init(&g_schedule_screen);
+    queue_app_enter();
+}
+
+static bool event_schedule_app_render(void) {
+    bool full;
+    if (!queue_app_next(50, &full)) return false;
+    event_schedule_screen_draw(&g_schedule_screen);
+    return true;
+}
+
+/* LEFT/RIGHT switch day, UP/DOWN scroll, B exits */
+static void event_schedule_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_B) {
+        ESP_LOGI(TAG, "Exiting event schedule");
+        app_registry_exit();
+        return;
+    }
+    if (ev->id == BTN_LEFT) {
+        event_schedule_screen_prev_day(&g_schedule_screen);
+    } else if (ev->id == BTN_RIGHT) {
+        event_schedule_screen_next_day(&g_schedule_screen);
+    } else if (ev->id == BTN_UP) {
+        event_schedule_screen_scroll_up(&g_schedule_screen);
+    } else if (ev->id == BTN_DOWN) {
+        event_schedule_screen_scroll_down(&g_schedule_screen);
+    } else {
+        return;
+    }
+    request_redraw(DISP_CMD_REDRAW_FULL);
+}
+
+/* Audio spectrum: capture task fills g_audio_screen, drawn at 60 FPS */
+static void audio_spectrum_app_init(void) {
+    audio_spectrum_screen_init(&g_audio_screen);
+    audio_spectrum_task_start(&g_audio_screen);
+}
+
+static bool audio_spectrum_app_render(void) {
+    static uint32_t last_audio_frame;
+    bool fresh = (g_audio_screen.frame_count != last_audio_frame);
+    last_audio_frame = g_audio_screen.frame_count;
+    audio_spectrum_screen_draw(&g_audio_screen);
+    return fresh;
+}
+
+static void audio_spectrum_app_exit(void) {
+    audio_spectrum_screen_exit();
+    audio_spectrum_screen_leave();      /* Undo hardware scroll */
+}
+
+static void audio_spectrum_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED) return;
+    if (ev->id == BTN_B) {
+        /* B button: toggle max hold */
+        audio_spectrum_toggle_max_hold(&g_audio_screen);
+    } else if (ev->id == BTN_UP || ev->id == BTN_DOWN) {
+        /* UP/DOWN: FFT size ×2 / ÷2 */
+        audio_spectrum_adjust(ev->id == BTN_UP ? 1 : -1, 0);
+    } else if (ev->id == BTN_LEFT || ev->id == BTN_RIGHT) {
+        /* LEFT/RIGHT: window overlap 0/50/75 % */
+        audio_spectrum_adjust(0, ev->id == BTN_RIGHT ? 1 : -1);
+    } else if (ev->id == BTN_STICK) {
+        /* Stick press: linear / 1/3-octave / mel axis */
+        audio_spectrum_cycle_scale();
+    } else if (ev->id == BTN_START) {
+        /* START: float / Q15 FFT */
+        audio_spectrum_toggle_fft_kind();
+    } else if (ev->id == BTN_SELECT) {
+        /* SELECT: bars / waterfall */
+        audio_spectrum_toggle_view(&g_audio_screen);
+    } else if (ev->id == BTN_A) {
+        /* A: exit spectrum mode */
+        ESP_LOGI(TAG, "Exiting audio spectrum");
+        app_registry_exit();
+    }
+}
+
+/* Settings: nickname editor */
+static void settings_app_init(void) {
+    text_input_init(&g_text_input_screen, "Nickname (Max 10):", 11);
+    text_input_set_text(&g_text_input_screen, settings_get_nickname());
+}
+
+static bool settings_app_render(void) {
+    text_input_draw(&g_text_input_screen);
+    return true;
+}
+
+/* Held directions keep stepping the cursor; SELECT/A confirm */
+static void settings_app_input(const btn_event_t *ev) {
+    if (ev->type != BTN_PRESSED && ev->type != BTN_REPEAT) return;
+    text_input_handle_button(&g_text_input_screen, ev->id);
+
+    if ((ev->id == BTN_A || ev->id == BTN_SELECT) && !text_input_is_editing(&g_text_input_screen)) {
+        ESP_LOGI(TAG, "Settings confirmed: %s", text_input_get_text(&g_text_input_screen));
+        settings_set_nickname(text_input_get_text(&g_text_input_screen));
+        app_registry_exit();
+    }
+}
+
+/* UI test: polls buttons itself through buttons_is_pressed() */
+static void ui_test_app_init(void) {
+    ui_test_screen_init(&g_ui_test_screen);
+}
+
+static bool ui_test_app_render(void) {
+    ui_test_screen_draw(&g_ui_test_screen);
+    if (ui_test_screen_wants_exit(&g_ui_test_screen)) {
+        ESP_LOGI(TAG, "Exiting UI test screen");
+        ui_test_screen_clear();
+        app_registry_exit();
+    }
+    return true;
+}
+
+/* Presses have no other effect so every button can be tested; B and
+ * START held together set wants_exit, which the render acts on */
+static void ui_test_app_input(const btn_event_t *ev) {
+    if (ev->type == BTN_PRESSED) ui_test_screen_handle_press(&g_ui_test_screen, ev->state);
+}
+
+/* ── App registry ────────────────────────────────────────────────────────── */
+/*
+ * Frame-rate policy (target FPS, adaptive idle floor, 0 = never adapt),
+ * heap budget and lifecycle per app_state_t slot.  Every screen draws
+ * through app_registry_frame() and takes its buttons through on_input.
+ * Queue-driven screens (menu, colour select, SAO, schedule) have no
+ * target FPS: their render blocks on g_disp_queue and is not paced.
+ */
+#define GAME_APP(n, hooks, upd, rnd, ext, heap) {                           \
+    .name = n, .frame = { 60, 0 }, .heap_bytes = heap,                      \
+    .init = game_app_init, .update = upd, .render = rnd,                    \
+    .on_input = game_app_input, .suspend = game_app_suspend,                \
+    .resume = game_app_resume, .exit = ext, .ctx = &hooks }
+
+static const app_desc_t s_apps[APP_STATE_COUNT] = {
+    [APP_STATE_IDLE]            = { .name = "idle",            .frame = {  2, 0 },
+                                    .init = idle_app_init,
+                                    .render = idle_app_render,
+                                    .on_input = idle_app_input },
+    [APP_STATE_MENU]            = { .name = "menu",
+                                    .init = queue_app_enter,
+                                    .render = menu_app_render,
+                                    .on_input = menu_app_input },
+    [APP_STATE_AUDIO_SPECTRUM]  = { .name = "audio_spectrum",  .frame = { 60, 5 },
+                                    .init = audio_spectrum_app_init,
+                                    .render = audio_spectrum_app_render,
+                                    .on_input = audio_spectrum_app_input,
+                                    .exit = audio_spectrum_app_exit },
+    [APP_STATE_SETTINGS]        = { .name = "settings",        .frame = { 30, 0 },
+                                    .init = settings_app_init,
+                                    .render = settings_app_render,
+                                    .on_input = settings_app_input },
+    [APP_STATE_UI_TEST]         = { .name = "ui_test",         .frame = { 30, 0 },
+                                    .init = ui_test_app_init,
+                                    .render = ui_test_app_render,
+                                    .on_input = ui_test_app_input },
+    [APP_STATE_SENSOR_READOUT]  = { .name = "sensor_readout",  .frame = { 30, 0 },
+                                    .init = sensor_readout_app_init,
+                                    .render = sensor_readout_app_render,
+                                    .on_input = sensor_readout_app_input },
+    [APP_STATE_SIGNAL_STRENGTH] = { .name = "signal_strength", .frame = { 30, 0 },
+                                    .init = signal_strength_app_init,
+                                    .render = signal_strength_app_render,
+                                    .on_input = signal_strength_app_input },
+    [APP_STATE_WLAN_SPECTRUM]   = { .name = "wlan_spectrum",   .frame = { 10, 0 },
+                                    .init = wlan_spectrum_app_init,
+                                    .render = wlan_spectrum_app_render,
+                                    .on_input = wlan_spectrum_app_input,
+                                    .exit = wlan_spectrum_screen_exit },
+    [APP_STATE_WLAN_LIST]       = { .name = "wlan_list",       .frame = { 10, 0 },
+                                    .init = wlan_list_app_init,
+                                    .render = wlan_list_app_render,
+                                    .on_input = wlan_list_app_input,
+                                    .exit = wlan_list_screen_exit },
+    [APP_STATE_ABOUT]           = { .name = "about",           .frame = { 10, 2 },
+                                    .init = about_app_init,
+                                    .render = about_app_render,
+                                    .on_input = about_app_input },
+    [APP_STATE_COLOR_SELECT]    = { .name = "accent_color",
+                                    .init = accent_color_app_init,
+                                    .render = color_select_app_render,
+                                    .on_input = color_select_app_input },
+    [APP_STATE_TEXT_COLOR_SELECT] = { .name = "text_color",
+                                    .init = text_color_app_init,
+                                    .render = color_select_app_render,
+                                    .on_input = color_select_app_input },
+    [APP_STATE_HACKY_BIRD]      = GAME_APP("hacky_bird", s_hacky_bird_hooks,
+                                           hacky_bird_app_update, hacky_bird_app_render,
+                                           game_app_exit, 0),
+    [APP_STATE_SPACE_SHOOTER]   = GAME_APP("space_shooter", s_space_shooter_hooks,
+                                           space_shooter_app_update, space_shooter_app_render,
+                                           game_app_exit, 0),
+    [APP_STATE_SNAKE]           = GAME_APP("snake", s_snake_hooks,
+                                           snake_app_update, snake_app_render,
+                                           game_app_exit, 0),
+    [APP_STATE_PONG]            = GAME_APP("pong", s_pong_hooks,
+                                           pong_app_update, pong_app_render,
+                                           game_app_exit, 0),
+    [APP_STATE_ARCHANOID]       = GAME_APP("archanoid", s_archanoid_hooks,
+                                           archanoid_app_update, archanoid_app_render,
+                                           game_app_exit, 0),
+    [APP_STATE_RACE_CONDITION]  = GAME_APP("race_condition", s_race_condition_hooks,
+                                           race_condition_app_update, race_condition_app_render,
+                                           race_condition_app_exit, RACE_CONDITION_FB_BYTES),
+    [APP_STATE_PYTHON_DEMO]     = { .name = "python_demo",     .frame = { 10, 2 },
+                                    .heap_bytes = PY_DEMO_HEAP,
+                                    .init = python_demo_app_init,
+                                    .render = python_demo_app_render,
+                                    .on_input = python_demo_app_input },
+    [APP_STATE_TIME_DATE_SET]   = { .name = "time_date_set",   .frame = { 20, 10 },
+                                    .init = time_date_app_init,
+                                    .render = time_date_app_render,
+                                    .on_input = time_date_app_input },
+    [APP_STATE_SAO_EEPROM]      = { .name = "sao_eeprom",
+                                    .init = sao_eeprom_app_init,
+                                    .render = sao_eeprom_app_render,
+                                    .on_input = sao_eeprom_app_input },
+    [APP_STATE_EVENT_SCHEDULE]  = { .name = "event_schedule",
+                                    .init = event_schedule_app_init,
+                                    .render = event_schedule_app_render,
+                                    .on_input = event_schedule_app_input },
+    [APP_STATE_SOUND_LEVEL]     = { .name = "sound_level",     .frame = { 10, 0 },
+                                    .init = audio_spl_screen_init,
+                                    .render = sound_level_app_render,
+                                    .on_input = sound_level_app_input },
+    [APP_STATE_TASK_PROFILER]   = { .name = "task_profiler",   .frame = { 10, 2 },
+                                    .heap_bytes = TASK_PROF_STACK,
+                                    .init = task_profiler_app_init,
+                                    .render = task_prof_screen_draw,
+                                    .on_input = task_profiler_app_input,
+                                    .exit = task_prof_stop },
+};
+
+/* ── Frame completion ────────────────────────────────────────────────────── */
+/* A frame of @p state has been drawn: overlay, then close latency samples */
+static void frame_drawn(app_state_t state) {
+    if (atomic_load(&g_latency_overlay)) {
+        char buf[24];
+        latency_trace_format_overlay((uint8_t)state, buf, sizeof(buf));
+        size_t w = strlen(buf) * 8;
+        st7789_draw_string(SCREEN_WIDTH - w - 2, SCREEN_HEIGHT - 16, buf, 0xFFE0, 0x0000, 1);
+    }
+    latency_trace_frame_end((uint8_t)state);
+}
+
+/* End of a frame; @p changed = something was drawn.  Queue-driven
+ * screens (no target FPS) have already waited in their render. */
+static void frame_done(app_state_t state, bool changed) {
+    if (changed) frame_drawn(state);
+    if (state == s_game.app) game_session_frame_end();
+    if (s_apps[state].frame.target_fps) frame_pacer_wait(state, changed);
+}
+
 /* ── Display task ────────────────────────────────────────────────────────── */
 static void display_task(void *arg) {
     (void)arg;
-    disp_cmd_t cmd;
-    app_state_t last_state = APP_STATE_IDLE;
 
     /* Allow other tasks to initialize */
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    /* Initial draw: idle screen with nickname */
-    idle_screen_draw(settings_get_nickname());
+    app_state_t paced_state = APP_STATE_COUNT;
 
     while (1) {
-        app_state_t state = (app_state_t)atomic_load(&g_app_state);
-
-        if (state == APP_STATE_IDLE) {
-            /* Idle mode: display nickname, respond slowly */
-            if (last_state != APP_STATE_IDLE) {
-                /* Transitioning to idle state - reset display state */
-                idle_screen_reset();
-                last_state = APP_STATE_IDLE;
-            }
-            /* Call draw every loop, but it will skip if time hasn't changed */
-            idle_screen_draw(settings_get_nickname());
-            vTaskDelay(pdMS_TO_TICKS(500));  /* Check every 500ms for time change */
-        } else if (state == APP_STATE_MENU) {
-            /* Menu mode: respond to queue messages */
-            if (last_state != APP_STATE_MENU) {
-                menu_draw(g_current_menu, true);
-                last_state = APP_STATE_MENU;
-            }
-            if (xQueueReceive(g_disp_queue, &cmd, pdMS_TO_TICKS(30)) == pdTRUE) {
-                bool full = (cmd.type == DISP_CMD_REDRAW_FULL);
-                menu_draw(g_current_menu, full);
-            }
-            /* Queue receive already delays for 30ms if empty */
-        } else if (state == APP_STATE_AUDIO_SPECTRUM) {
-            /* Audio spectrum mode: continuous rendering */
-            audio_spectrum_screen_draw(&g_audio_screen);
-            vTaskDelay(pdMS_TO_TICKS(30));  /* ~33 FPS */
-        } else if (state == APP_STATE_SETTINGS) {
-            /* Settings mode: text input screen */
-            text_input_draw(&g_text_input_screen);
-            vTaskDelay(pdMS_TO_TICKS(30));  /* ~33 FPS */
-        } else if (state == APP_STATE_UI_TEST) {
-            /* UI test mode: continuous rendering, polls buttons internally */
-            ui_test_screen_draw(&g_ui_test_screen);
-            if (ui_test_screen_wants_exit(&g_ui_test_screen)) {
-                ESP_LOGI(TAG, "Exiting UI test screen");
-                ui_test_screen_clear();
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-            vTaskDelay(pdMS_TO_TICKS(30));  /* ~33 FPS */
-        } else if (state == APP_STATE_SENSOR_READOUT) {
-            /* Sensor readout mode: continuous rendering */
-            sensor_readout_screen_draw(&g_sensor_screen);
-            vTaskDelay(pdMS_TO_TICKS(30));  /* ~33 FPS */
-        } else if (state == APP_STATE_SAO_EEPROM) {
-            /* SAO EEPROM: static data, redraw only on entry or scroll */
-            if (last_state != APP_STATE_SAO_EEPROM) {
-                sao_eeprom_screen_draw(&g_sao_screen);
-                last_state = APP_STATE_SAO_EEPROM;
-            }
-            if (xQueueReceive(g_disp_queue, &cmd, pdMS_TO_TICKS(50)) == pdTRUE) {
-                sao_eeprom_screen_draw(&g_sao_screen);
-            }
-        } else if (state == APP_STATE_EVENT_SCHEDULE) {
-            /* Event schedule: static data, redraw on entry or navigation */
-            if (last_state != APP_STATE_EVENT_SCHEDULE) {
-                event_schedule_screen_draw(&g_schedule_screen);
-                last_state = APP_STATE_EVENT_SCHEDULE;
-            }
-            if (xQueueReceive(g_disp_queue, &cmd, pdMS_TO_TICKS(50)) == pdTRUE) {
-                event_schedule_screen_draw(&g_schedule_screen);
-            }
-        } else if (state == APP_STATE_SIGNAL_STRENGTH) {
-            /* Signal strength mode: continuous rendering */
-            signal_strength_screen_draw(&g_signal_screen);
-            vTaskDelay(pdMS_TO_TICKS(30));  /* ~33 FPS */
-        } else if (state == APP_STATE_WLAN_SPECTRUM) {
-            /* WLAN spectrum mode: continuous rendering */
-            wlan_spectrum_screen_draw(&g_wlan_spectrum_screen);
-            vTaskDelay(pdMS_TO_TICKS(100));  /* 10 FPS - slower updates for WiFi scanning */
-        } else if (state == APP_STATE_WLAN_LIST) {
-            /* WLAN networks list mode: continuous rendering */
-            wlan_list_screen_draw(&g_wlan_list_screen);
-            vTaskDelay(pdMS_TO_TICKS(100));  /* 10 FPS */
-        } else if (state == APP_STATE_ABOUT) {
-            /* About screen: completely static redraw only once */
-            if (last_state != APP_STATE_ABOUT) {
-                about_screen_draw();
-                last_state = APP_STATE_ABOUT;
-            }
-            vTaskDelay(pdMS_TO_TICKS(100));
-        } else if (state == APP_STATE_COLOR_SELECT || state == APP_STATE_TEXT_COLOR_SELECT) {
-            /* Color select: respond to queue messages */
-            if (last_state != state) {
-                color_select_screen_draw(&g_color_screen);
-                last_state = state;
-            }
-            if (xQueueReceive(g_disp_queue, &cmd, pdMS_TO_TICKS(30)) == pdTRUE) {
-                color_select_screen_draw(&g_color_screen);
-            }
-        } else if (state == APP_STATE_HACKY_BIRD) {
-            /* Hacky Bird game: continuous rendering */
-            if (!g_hacky_bird_game_over) {
-                /* Check if flap button is currently pressed */
-                bool flap = buttons_is_pressed(BTN_A) || buttons_is_pressed(BTN_STICK);
-                
-                /* Update game state */
-                hacky_bird_update(flap);
-                
-                /* Check if game ended */
-                if (!hacky_bird_is_active()) {
-                    g_hacky_bird_game_over = true;
-                    
-                    /* Draw game over screen */
-                    uint16_t score = hacky_bird_get_score();
-                    st7789_fill(0x5D1F);  // Sky blue
-                    st7789_draw_string(SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT/2 - 30, 
-                                     "GAME OVER", 0xFFFF, 0x5D1F, 2);
-                    
-                    char score_str[32];
-                    snprintf(score_str, sizeof(score_str), "Score: %d", score);
-                    st7789_draw_string(SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT/2, 
-                                     score_str, 0xFFFF, 0x5D1F, 2);
-                    
-                    st7789_draw_string(SCREEN_WIDTH/2 - 70, SCREEN_HEIGHT/2 + 30, 
-                                     "Press any key", 0xFFFF, 0x5D1F, 1);
-                }
-                
-                /* Draw game state */
-                if (!g_hacky_bird_game_over) {
-                    hacky_bird_draw();
-                }
-            }
-            vTaskDelay(pdMS_TO_TICKS(16));  /* ~60 FPS for smooth gameplay */
-        } else if (state == APP_STATE_SPACE_SHOOTER) {
-            /* Space Shooter game: continuous rendering */
-            /* Get button states */
-            bool move_left = buttons_is_pressed(BTN_LEFT) || buttons_is_pressed(BTN_STICK);
-            bool move_right = buttons_is_pressed(BTN_RIGHT);
-            bool shoot = buttons_is_pressed(BTN_A);
-            
-            /* Update game state */
-            space_shooter_update(move_left, move_right, shoot);
-            
-            /* Draw game state */
-            space_shooter_draw();
-            
-            vTaskDelay(pdMS_TO_TICKS(16));  /* ~60 FPS for smooth gameplay */
-        } else if (state == APP_STATE_SNAKE) {
-            /* Snake game: variable speed based on game state */
-            static uint32_t last_update = 0;
-            uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-            uint32_t delay = snake_get_speed_delay();
-            
-            if (now - last_update >= delay) {
-                /* Handle direction input */
-                if (buttons_is_pressed(BTN_UP)) {
-                    snake_set_direction(SNAKE_DIR_UP);
-                } else if (buttons_is_pressed(BTN_DOWN)) {
-                    snake_set_direction(SNAKE_DIR_DOWN);
-                } else if (buttons_is_pressed(BTN_LEFT)) {
-                    snake_set_direction(SNAKE_DIR_LEFT);
-                } else if (buttons_is_pressed(BTN_RIGHT)) {
-                    snake_set_direction(SNAKE_DIR_RIGHT);
-                }
-                
-                /* Update game logic */
-                snake_update();
-                
-                /* LED effect when food is eaten */
-                if (snake_ate_food_this_frame()) {
-                    // Flash green on all LEDs briefly
-                    sk6812_color_t green = {0, 255, 0};
-                    for (int i = 0; i < 10; i++) {
-                        sk6812_set(i, green);
-                    }
-                    sk6812_show();
-                    
-                    // Clear LEDs after a brief moment (handled by next frame)
-                    vTaskDelay(pdMS_TO_TICKS(50));
-                    sk6812_clear();
-                }
-                
-                /* Draw game state */
-                snake_draw();
-                
-                last_update = now;
+        /* Switch apps (exit / init) and apply pause requests */
+        app_state_t state = (app_state_t)app_registry_sync();
+
+        /* Re-anchor the frame schedule whenever the screen changes */
+        if (state != paced_state) {
+            if (paced_state < APP_STATE_COUNT) {
+                frame_pacer_log_stats(paced_state);
+                latency_trace_log_stats(paced_state);
+                sk6812_log_stats("LED latency");   /* covers game-loop flashes */
             }
-            
-            vTaskDelay(pdMS_TO_TICKS(16));  /* Check input at 60 FPS */
-        } else if (state == APP_STATE_PONG) {
-            /* Pong game: continuous rendering */
-            if (!g_pong_game_over) {
-                bool up   = buttons_is_pressed(BTN_UP);
-                bool down = buttons_is_pressed(BTN_DOWN);
-
-                pong_update(up, down);
-
-                if (!pong_is_active()) {
-                    g_pong_game_over = true;
-                    /* Red/green flash on game end */
-                    sk6812_color_t c = (pong_get_score() >= 7)
-                        ? (sk6812_color_t){0, 255, 0}
-                        : (sk6812_color_t){255, 0, 0};
-                    sk6812_fill(c);
-                    sk6812_show();
-                    vTaskDelay(pdMS_TO_TICKS(80));
-                    sk6812_clear();
-                }
-
-                /* LED flash when a point is scored */
-                if (pong_is_active() && !g_pong_game_over && pong_scored_this_frame()) {
-                    /* Brief accent-colour flash on the side LEDs */
-                    uint16_t c16 = settings_get_accent_color();
-                    uint8_t r5 = (c16 >> 11) & 0x1F;
-                    uint8_t g6 = (c16 >> 5)  & 0x3F;
-                    uint8_t b5 = c16 & 0x1F;
-                    sk6812_color_t ac = {
-                        (uint8_t)((r5 << 3) | (r5 >> 2)),
-                        (uint8_t)((g6 << 2) | (g6 >> 4)),
-                        (uint8_t)((b5 << 3) | (b5 >> 2))
-                    };
-                    sk6812_fill(sk6812_scale(ac, 100));
-                    sk6812_show();
-                    vTaskDelay(pdMS_TO_TICKS(40));
-                    sk6812_clear();
-                }
-
-                pong_draw();
-            }
-            vTaskDelay(pdMS_TO_TICKS(16));  /* ~60 FPS */
-        } else if (state == APP_STATE_ARCHANOID) {
-            /* Archanoid game: continuous rendering */
-            if (!g_archanoid_game_over) {
-                bool left   = buttons_is_pressed(BTN_LEFT);
-                bool right  = buttons_is_pressed(BTN_RIGHT);
-                bool launch = buttons_is_pressed(BTN_A) || buttons_is_pressed(BTN_STICK);
-
-                archanoid_update(left, right, launch);
-
-                if (!archanoid_is_active()) {
-                    g_archanoid_game_over = true;
-                    /* Flash LEDs on game end */
-                    sk6812_color_t c = (archanoid_get_score() > 0)
-                        ? (sk6812_color_t){0, 0, 255}
-                        : (sk6812_color_t){255, 0, 0};
-                    sk6812_fill(c);
-                    sk6812_show();
-                    vTaskDelay(pdMS_TO_TICKS(80));
-                    sk6812_clear();
-                }
-
-                /* LED effect when a brick is destroyed */
-                if (archanoid_hit_brick_this_frame() && !g_archanoid_game_over) {
-                    /* Rainbow flash — cycle colour with score */
-                    uint8_t hue = (uint8_t)(archanoid_get_score() * 3);
-                    sk6812_color_t brick_c;
-                    if (hue < 85) {
-                        brick_c = (sk6812_color_t){ (uint8_t)(255 - hue * 3), (uint8_t)(hue * 3), 0 };
-                    } else if (hue < 170) {
-                        uint8_t h = hue - 85;
-                        brick_c = (sk6812_color_t){ 0, (uint8_t)(255 - h * 3), (uint8_t)(h * 3) };
-                    } else {
-                        uint8_t h = hue - 170;
-                        brick_c = (sk6812_color_t){ (uint8_t)(h * 3), 0, (uint8_t)(255 - h * 3) };
-                    }
-                    sk6812_fill(sk6812_scale(brick_c, 120));
-                    sk6812_show();
-                    vTaskDelay(pdMS_TO_TICKS(30));
-                    sk6812_clear();
-                }
+            sk6812_reset_stats();
+            frame_pacer_begin(state);
+            paced_state = state;
+        }
 
-                archanoid_draw();
-            }
-            vTaskDelay(pdMS_TO_TICKS(16));  /* ~60 FPS */
-        } else if (state == APP_STATE_RACE_CONDITION) {
-            /* RaceCondition racing game: continuous rendering */
-            if (!g_race_condition_game_over) {
-                /* Get button states */
-                bool steer_left  = buttons_is_pressed(BTN_LEFT);
-                bool steer_right = buttons_is_pressed(BTN_RIGHT);
-                bool accelerate  = buttons_is_pressed(BTN_A) || buttons_is_pressed(BTN_STICK);
-
-                /* Update game state */
-                race_condition_update(steer_left, steer_right, accelerate);
-
-                /* Check if game ended */
-                if (!race_condition_is_active()) {
-                    g_race_condition_game_over = true;
-
-                    /* Flash LEDs red on crash */
-                    sk6812_color_t red = {255, 0, 0};
-                    for (int i = 0; i < 12; i++) {
-                        sk6812_set(i, red);
-                    }
-                    sk6812_show();
-                } else {
-                    /* LED speed indicator: light LEDs proportional to speed */
-                    int16_t spd = race_condition_get_speed();
-                    int num_lit = spd * 12 / 200;  /* 0..12 LEDs based on speed */
-                    if (num_lit > 12) num_lit = 12;
-                    for (int i = 0; i < 12; i++) {
-                        sk6812_color_t c;
-                        if (i < num_lit) {
-                            c = (sk6812_color_t){(uint8_t)(20 + i * 5), 0, 0};
-                        } else {
-                            c = (sk6812_color_t){0, 0, 0};
-                        }
-                        sk6812_set(i, c);
-                    }
-                    sk6812_show();
-                }
+        /* Presses debounced so far are visible to this frame */
+        latency_trace_frame_begin(state);
 
-                /* Draw game state */
-                race_condition_draw();
-            }
-            vTaskDelay(pdMS_TO_TICKS(16));  /* ~60 FPS */
-        } else if (state == APP_STATE_PYTHON_DEMO) {
-            /* Python demo: rendering is done by python_demo_task, just wait */
-            vTaskDelay(pdMS_TO_TICKS(100));
-        } else if (state == APP_STATE_TIME_DATE_SET) {
-            /* Time/date setting: redraw on request */
-            if (s_td_needs_draw) {
-                s_td_needs_draw = false;
-                td_draw();
-            }
-            vTaskDelay(pdMS_TO_TICKS(50));
+        if (app_registry_has_frames()) {
+            frame_done(state, app_registry_frame());
         } else {
-            /* Unknown state: fallback to idle */
+            /* Unregistered state: wait for a switch */
             vTaskDelay(pdMS_TO_TICKS(100));
         }
     }
@@ -1546,344 +2366,14 @@ static void input_task(void *arg) {
 
     while (1) {
         if (xQueueReceive(g_btn_queue, &ev, portMAX_DELAY) != pdTRUE) continue;
-        if (ev.type != BTN_PRESSED) continue;
-
-        app_state_t state = (app_state_t)atomic_load(&g_app_state);
-
-        if (state == APP_STATE_IDLE) {
-            /* Idle mode: any button enters menu */
-            ESP_LOGI(TAG, "Entering menu from idle");
-            atomic_store(&g_app_state, APP_STATE_MENU);
-            request_redraw(DISP_CMD_REDRAW_FULL);
-        } else if (state == APP_STATE_AUDIO_SPECTRUM) {
-            /* In audio spectrum mode: handle button actions */
-            if (ev.id == BTN_B) {
-                /* B button: toggle max hold */
-                audio_spectrum_toggle_max_hold(&g_audio_screen);
-            } else if (ev.id == BTN_SELECT || ev.id == BTN_A || ev.id == BTN_STICK ||
-                ev.id == BTN_UP || ev.id == BTN_DOWN || ev.id == BTN_LEFT || 
-                ev.id == BTN_RIGHT || ev.id == BTN_START) {
-                /* Any other button: exit spectrum mode */
-                ESP_LOGI(TAG, "Exiting audio spectrum");
-                audio_spectrum_screen_exit();
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_SETTINGS) {
-            /* Settings mode: text input button handling */
-            text_input_handle_button(&g_text_input_screen, ev.id);
-            
-            /* If user pressed SELECT/A to confirm */
-            if ((ev.id == BTN_A || ev.id == BTN_SELECT) && !text_input_is_editing(&g_text_input_screen)) {
-                ESP_LOGI(TAG, "Settings confirmed: %s", text_input_get_text(&g_text_input_screen));
-                settings_set_nickname(text_input_get_text(&g_text_input_screen));
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_UI_TEST) {
-            /* UI test polls buttons internally via buttons_is_pressed().
-             * All button events are intentionally ignored here so every
-             * button can be tested without side-effects.
-             * Exit is detected in the draw loop via wants_exit flag. */
-        } else if (state == APP_STATE_SENSOR_READOUT) {
-            /* Sensor readout mode: any button exits back to menu */
-            if (ev.id == BTN_SELECT || ev.id == BTN_A || ev.id == BTN_STICK ||
-                ev.id == BTN_UP || ev.id == BTN_DOWN || ev.id == BTN_LEFT || ev.id == BTN_RIGHT) {
-                ESP_LOGI(TAG, "Exiting sensor readout");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_SAO_EEPROM) {
-            /* SAO EEPROM: UP/DOWN scroll, B exits */
-            if (ev.id == BTN_B || ev.id == BTN_LEFT) {
-                ESP_LOGI(TAG, "Exiting SAO EEPROM screen");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_UP) {
-                sao_eeprom_screen_scroll_up(&g_sao_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_DOWN) {
-                sao_eeprom_screen_scroll_down(&g_sao_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_EVENT_SCHEDULE) {
-            /* Event schedule: LEFT/RIGHT switch day, UP/DOWN scroll, B exits */
-            if (ev.id == BTN_B) {
-                ESP_LOGI(TAG, "Exiting event schedule");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_LEFT) {
-                event_schedule_screen_prev_day(&g_schedule_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_RIGHT) {
-                event_schedule_screen_next_day(&g_schedule_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_UP) {
-                event_schedule_screen_scroll_up(&g_schedule_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_DOWN) {
-                event_schedule_screen_scroll_down(&g_schedule_screen);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_SIGNAL_STRENGTH) {
-            /* Signal strength mode: any button exits back to menu */
-            if (ev.id == BTN_SELECT || ev.id == BTN_A || ev.id == BTN_STICK ||
-                ev.id == BTN_UP || ev.id == BTN_DOWN || ev.id == BTN_LEFT || ev.id == BTN_RIGHT) {
-                ESP_LOGI(TAG, "Exiting signal strength display");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_WLAN_SPECTRUM) {
-            /* WLAN spectrum mode: B exits */
-            if (ev.id == BTN_B || ev.id == BTN_LEFT) {
-                ESP_LOGI(TAG, "Exiting WLAN spectrum analyzer");
-                wlan_spectrum_screen_exit();
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_WLAN_LIST) {
-            /* WLAN list mode: UP/DOWN scroll, B exits */
-            if (ev.id == BTN_UP || ev.id == BTN_DOWN) {
-                wlan_list_screen_handle_button(&g_wlan_list_screen, ev.id);
-            } else if (ev.id == BTN_B || ev.id == BTN_LEFT) {
-                ESP_LOGI(TAG, "Exiting WLAN networks list");
-                wlan_list_screen_exit();
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_ABOUT) {
-            /* About screen mode: any button exits back to menu */
-            if (ev.id == BTN_SELECT || ev.id == BTN_A || ev.id == BTN_STICK || ev.id == BTN_B ||
-                ev.id == BTN_UP || ev.id == BTN_DOWN || ev.id == BTN_LEFT || ev.id == BTN_RIGHT) {
-                ESP_LOGI(TAG, "Exiting about screen");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else if (state == APP_STATE_COLOR_SELECT || state == APP_STATE_TEXT_COLOR_SELECT) {
-            /* Color select: handle button actions.
-             * handle_button processes navigation, confirm (A), and cancel (B)
-             * internally, so we check the result flags afterwards. */
-            color_select_screen_handle_button(&g_color_screen, ev.id);
-
-            if (color_select_screen_is_cancelled(&g_color_screen)) {
-                ESP_LOGI(TAG, "Exiting color selector (cancelled)");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (color_select_screen_is_confirmed(&g_color_screen)) {
-                /* Confirmed color selection */
-                uint16_t color = color_select_screen_get_color(&g_color_screen);
-                if (state == APP_STATE_COLOR_SELECT) {
-                    ESP_LOGI(TAG, "Saving new accent color: 0x%04X", color);
-                    settings_set_accent_color(color);
-                } else {
-                    ESP_LOGI(TAG, "Saving new text color: 0x%04X", color);
-                    settings_set_text_color(color);
-                }
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else {
-                /* Navigation – update selection display */
-                request_redraw(DISP_CMD_REDRAW_ITEM);
-            }
-        } else if (state == APP_STATE_HACKY_BIRD) {
-            /* Hacky Bird game: handle button actions */
-            if (g_hacky_bird_game_over) {
-                /* Game over: any button exits back to menu */
-                ESP_LOGI(TAG, "Exiting Hacky Bird (final score: %d)", hacky_bird_get_score());
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-                sk6812_clear();  // Turn off LEDs
-            } else {
-                /* Game active: A or STICK to flap, B to exit */
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting Hacky Bird (user quit)");
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();  // Turn off LEDs
-                }
-                /* Flap will be handled in display_task on each frame */
-            }
-        } else if (state == APP_STATE_SPACE_SHOOTER) {
-            /* Space Shooter game: B to exit */
-            if (ev.id == BTN_B) {
-                ESP_LOGI(TAG, "Exiting Space Shooter (final score: %lu)", space_shooter_get_score());
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-            /* Movement and shooting are handled continuously in display_task */
-        } else if (state == APP_STATE_SNAKE) {
-            /* Snake game: B to exit */
-            if (ev.id == BTN_B) {
-                ESP_LOGI(TAG, "Exiting Snake (final score: %lu)", snake_get_score());
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-            /* Direction input is handled continuously in display_task */
-        } else if (state == APP_STATE_PONG) {
-            /* Pong game: handle button actions */
-            if (g_pong_game_over) {
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting Pong (final score: %lu)", pong_get_score());
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();
-                }
-            } else {
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting Pong (user quit)");
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();
-                }
-            }
-            /* Paddle movement is handled continuously in display_task */
-        } else if (state == APP_STATE_ARCHANOID) {
-            /* Archanoid game: handle button actions */
-            if (g_archanoid_game_over) {
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting Archanoid (final score: %lu)", archanoid_get_score());
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();
-                }
-            } else {
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting Archanoid (user quit)");
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();
-                }
-            }
-            /* Paddle movement and launch are handled continuously in display_task */
-        } else if (state == APP_STATE_RACE_CONDITION) {
-            /* RaceCondition game: handle button actions */
-            if (g_race_condition_game_over) {
-                /* Game over: any button exits back to menu */
-                ESP_LOGI(TAG, "Exiting RaceCondition (final score: %lu)", race_condition_get_score());
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-                sk6812_clear();
-            } else {
-                if (ev.id == BTN_B) {
-                    ESP_LOGI(TAG, "Exiting RaceCondition (user quit)");
-                    atomic_store(&g_app_state, APP_STATE_MENU);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                    sk6812_clear();
-                }
-            }
-        } else if (state == APP_STATE_PYTHON_DEMO) {
-            /* Python demo handles its own input via polling – ignore queue events */
-        } else if (state == APP_STATE_TIME_DATE_SET) {
-            /* Time/date setting: UP/DOWN adjust field, LEFT/RIGHT move cursor, A confirm, B cancel */
-            if (ev.id == BTN_UP) {
-                s_td_fields[s_td_cursor]++;
-                td_clamp();
-                s_td_needs_draw = true;
-            } else if (ev.id == BTN_DOWN) {
-                s_td_fields[s_td_cursor]--;
-                td_clamp();
-                s_td_needs_draw = true;
-            } else if (ev.id == BTN_LEFT) {
-                s_td_cursor = (s_td_cursor - 1 + TD_NUM_FIELDS) % TD_NUM_FIELDS;
-                s_td_needs_draw = true;
-            } else if (ev.id == BTN_RIGHT) {
-                s_td_cursor = (s_td_cursor + 1) % TD_NUM_FIELDS;
-                s_td_needs_draw = true;
-            } else if (ev.id == BTN_A || ev.id == BTN_START) {
-                /* Apply the new time */
-                struct tm new_time = {0};
-                new_time.tm_hour = s_td_fields[TD_FIELD_HOUR];
-                new_time.tm_min  = s_td_fields[TD_FIELD_MIN];
-                new_time.tm_sec  = 0;
-                new_time.tm_year = s_td_fields[TD_FIELD_YEAR] - 1900;
-                new_time.tm_mon  = s_td_fields[TD_FIELD_MON] - 1;
-                new_time.tm_mday = s_td_fields[TD_FIELD_DAY];
-                new_time.tm_isdst = -1;
-                time_t t = mktime(&new_time);
-                struct timeval tv = { .tv_sec = t, .tv_usec = 0 };
-                settimeofday(&tv, NULL);
-                ESP_LOGI(TAG, "System time set to %04d-%02d-%02d %02d:%02d",
-                         s_td_fields[TD_FIELD_YEAR], s_td_fields[TD_FIELD_MON],
-                         s_td_fields[TD_FIELD_DAY], s_td_fields[TD_FIELD_HOUR],
-                         s_td_fields[TD_FIELD_MIN]);
-                /* Reset idle screen so it picks up the new time */
-                idle_screen_reset();
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            } else if (ev.id == BTN_B) {
-                ESP_LOGI(TAG, "Time/date setting cancelled");
-                atomic_store(&g_app_state, APP_STATE_MENU);
-                request_redraw(DISP_CMD_REDRAW_FULL);
-            }
-        } else {
-            /* Menu mode */
-            switch (ev.id) {
-            case BTN_UP:
-                menu_navigate_up(g_current_menu);
-                request_redraw(DISP_CMD_REDRAW_ITEM);
-                break;
-
-            case BTN_DOWN:
-                menu_navigate_down(g_current_menu);
-                request_redraw(DISP_CMD_REDRAW_ITEM);
-                break;
-
-            case BTN_LEFT:
-                if (g_current_menu->grid_mode) {
-                    /* Grid mode: navigate left within the grid */
-                    menu_navigate_left(g_current_menu);
-                    request_redraw(DISP_CMD_REDRAW_ITEM);
-                } else {
-                    /* List mode: back to parent or idle */
-                    if (menu_back(&g_current_menu)) {
-                        ESP_LOGI(TAG, "Navigated back to parent menu");
-                        request_redraw(DISP_CMD_REDRAW_FULL);
-                    } else {
-                        ESP_LOGI(TAG, "Exiting menu to idle screen");
-                        atomic_store(&g_app_state, APP_STATE_IDLE);
-                        request_redraw(DISP_CMD_REDRAW_FULL);
-                    }
-                }
-                break;
 
-            case BTN_RIGHT:
-                if (g_current_menu->grid_mode) {
-                    /* Grid mode: navigate right within the grid */
-                    menu_navigate_right(g_current_menu);
-                    request_redraw(DISP_CMD_REDRAW_ITEM);
-                }
-                /* List mode: no action for RIGHT */
-                break;
-
-            case BTN_B:
-                /* B always goes back / exits to idle */
-                if (menu_back(&g_current_menu)) {
-                    ESP_LOGI(TAG, "Navigated back to parent menu");
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                } else {
-                    ESP_LOGI(TAG, "Exiting menu to idle screen");
-                    atomic_store(&g_app_state, APP_STATE_IDLE);
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                }
-                break;
-
-            case BTN_A:
-            case BTN_STICK:    /* joystick press also activates */
-            case BTN_SELECT:
-                /* Check for submenu first */
-                if (menu_enter_submenu(&g_current_menu)) {
-                    ESP_LOGI(TAG, "Entered submenu");
-                    request_redraw(DISP_CMD_REDRAW_FULL);
-                } else {
-                    /* No submenu, activate action */
-                    menu_select(g_current_menu);
-                    request_redraw(DISP_CMD_REDRAW_ITEM);
-                }
-                break;
+        app_state_t state = (app_state_t)app_registry_current();
+        if (ev.type == BTN_PRESSED) latency_trace_dispatch(ev.id, (uint8_t)state);
 
-            default:
-                break;
-            }
+        /* Every app takes its events (presses, repeats, releases,
+         * gestures) through on_input */
+        if (!app_registry_input(&ev)) {
+            ESP_LOGD(TAG, "No input handler for app %d", (int)state);
         }
     }
 }
@@ -1895,12 +2385,14 @@ void app_main(void) {
     /* ── Queues ── */
     g_btn_queue  = xQueueCreate(BTN_QUEUE_LEN,  sizeof(btn_event_t));
     g_disp_queue = xQueueCreate(DISP_QUEUE_LEN, sizeof(disp_cmd_t));
-    configASSERT(g_btn_queue && g_disp_queue);
+    g_py_demo_btn_queue = xQueueCreate(8, sizeof(btn_event_t));
+    configASSERT(g_btn_queue && g_disp_queue && g_py_demo_btn_queue);
 
     /* ── Driver init ── */
     st7789_init();
     sk6812_init();
-    audio_init();       /* Microphone driver init */
+    audio_stream_start();   /* Microphone + always-on capture task */
+    audio_spl_start();      /* Sound level meter on the capture tap */
     buttons_init(g_btn_queue);
     settings_init();
 
@@ -1926,6 +2418,8 @@ void app_main(void) {
     esp_err_t fs_ret = pyapps_fs_init();
     if (fs_ret == ESP_OK) {
         ESP_LOGI(TAG, "Python apps filesystem mounted successfully");
+        int fx_count = led_fx_load_dir(LED_FX_DIR);
+        if (fx_count > 0) ESP_LOGI(TAG, "Loaded %d custom LED effect(s)", fx_count);
     } else {
         ESP_LOGW(TAG, "Failed to mount Python apps filesystem: %s", esp_err_to_name(fs_ret));
     }
@@ -1948,10 +2442,15 @@ void app_main(void) {
     menu_add_item(&g_diag_menu, 'Z', NULL, "WiFi Spectrum", action_wlan_spectrum, NULL);
     menu_add_item(&g_diag_menu, 'N', NULL, "WiFi Networks", action_wlan_list, NULL);
     menu_add_item(&g_diag_menu, 'E', NULL, "SAO / EEPROM", action_sao_eeprom, NULL);
+    menu_add_item(&g_diag_menu, 'L', NULL, "Latency Overlay", action_latency_overlay, NULL);
+    menu_add_item(&g_diag_menu, 'R', NULL, "Latency Report", action_latency_report, NULL);
+    menu_add_item(&g_diag_menu, 'P', NULL, "Task Profiler", action_task_profiler, NULL);
 
     /* Tools submenu */
     menu_init(&g_tools_menu, "Tools");
     menu_add_item(&g_tools_menu, '@', NULL, "Audio Spectrum", action_audio_spectrum, NULL);
+    menu_add_item(&g_tools_menu, 'R', NULL, "Record Audio", action_audio_record, NULL);
+    menu_add_item(&g_tools_menu, 'L', NULL, "Sound Level", action_sound_level, NULL);
     menu_add_item(&g_tools_menu, 'E', NULL, "Event Schedule", action_event_schedule, NULL);
     
     /* Games submenu */
@@ -1977,6 +2476,8 @@ void app_main(void) {
     menu_add_item(&g_led_menu, 'i', NULL, "Disobey Identity", action_led_identity, NULL);
     menu_add_item(&g_led_menu, 'f', NULL, "Flame", action_led_flame, NULL);
     menu_add_item(&g_led_menu, 'v', NULL, "VU meter mode (MIC ON!)", action_led_vu, NULL);
+    menu_add_item(&g_led_menu, 'u', NULL, "Beat Pulse (MIC ON!)", action_led_beat, NULL);
+    menu_add_item(&g_led_menu, 'x', NULL, "Custom Effect", action_led_custom, NULL);
     menu_add_item(&g_led_menu, 'x', NULL, "Off", action_led_off, NULL);
 
     /* Settings submenu */
@@ -1990,6 +2491,10 @@ void app_main(void) {
     /* Development submenu */
     menu_init(&g_dev_menu, "Development");
     menu_add_item(&g_dev_menu, 'P', NULL, "Python Demo", action_python_demo, NULL);
+    menu_add_item(&g_dev_menu, 'B', NULL, "Fixed-point Bench", action_fixpt_bench, NULL);
+    menu_add_item(&g_dev_menu, 'F', NULL, "FFT Bench", action_fft_bench, NULL);
+    menu_add_item(&g_dev_menu, 'R', NULL, "Record Games", action_game_record, NULL);
+    menu_add_item(&g_dev_menu, 'Y', NULL, "Replay Games", action_game_replay, NULL);
 
     /* Main menu — icon grid mode */
     menu_init(&g_menu, TITLE_STR);
@@ -2001,10 +2506,29 @@ void app_main(void) {
     menu_add_item(&g_menu, 'X', ICON_DEVELOPMENT, "Development", NULL, &g_dev_menu);
     menu_add_item(&g_menu, '?', ICON_ABOUT,       "About",       action_about, NULL);
 
-    g_current_menu = &g_menu;    /* ── Tasks (all on CPU0; CPU1 reserved for MicroPython) ── */
-    xTaskCreatePinnedToCore(display_task, "display", 4096, NULL, 5, NULL, PRO_CPU_NUM);
-    xTaskCreatePinnedToCore(input_task,   "input",   2048, NULL, 6, NULL, PRO_CPU_NUM);
-    xTaskCreatePinnedToCore(led_task,     "led",     4096, NULL, 4, NULL, PRO_CPU_NUM);
+    g_current_menu = &g_menu;
+
+    /* ── Apps (frame pacing, budgets, lifecycle) ── */
+    for (int i = 0; i < APP_STATE_COUNT; i++) {
+        app_registry_register((uint8_t)i, &s_apps[i]);
+    }
+    app_registry_set_home(APP_STATE_MENU);
+
+    /* ── Tasks (all on CPU0; CPU1 reserved for MicroPython) ── */
+    task_prof_set_stack_size("display",      DISPLAY_STACK);
+    task_prof_set_stack_size("input",        INPUT_STACK);
+    task_prof_set_stack_size("led",          LED_STACK);
+    task_prof_set_stack_size("beat_ctl",     BEAT_CTL_STACK);
+    task_prof_set_stack_size("bench",        BENCH_STACK);
+    task_prof_set_stack_size("py_demo",      PY_DEMO_STACK);
+    task_prof_set_stack_size("audio_stream", AUDIO_STREAM_STACK);
+    task_prof_set_stack_size("ws_scan",      WLAN_SPECTRUM_SCAN_STACK);
+    xTaskCreatePinnedToCore(display_task, "display", DISPLAY_STACK, NULL, 5, NULL, PRO_CPU_NUM);
+    xTaskCreatePinnedToCore(input_task,   "input",   INPUT_STACK,   NULL, 6, NULL, PRO_CPU_NUM);
+    /* beat_ctl first: led_task may ask for the tracker on its first tick */
+    xTaskCreatePinnedToCore(beat_ctl_task, "beat_ctl", BEAT_CTL_STACK, NULL, 3,
+                            &g_beat_ctl_handle, PRO_CPU_NUM);
+    xTaskCreatePinnedToCore(led_task,     "led",     LED_STACK,     NULL, 4, NULL, PRO_CPU_NUM);
 
     ESP_LOGI(TAG, "All tasks launched. UP/DOWN to navigate, A/STICK/SELECT to activate.");
 }